@@ -34,6 +34,14 @@ tfm_invalid_config(TFM_ISOLATION_LEVEL EQUAL 3 AND NOT TFM_PLATFORM IN_LIST TFM_
 tfm_invalid_config(TFM_ISOLATION_LEVEL GREATER 1 AND TFM_LIB_MODEL)
 tfm_invalid_config(TFM_ISOLATION_LEVEL GREATER 1 AND PSA_FRAMEWORK_HAS_MM_IOVEC)
 tfm_invalid_config(TFM_LIB_MODEL AND PSA_FRAMEWORK_HAS_MM_IOVEC)
+tfm_invalid_config(TFM_LIB_MODEL AND CONFIG_TFM_SPM_DEFERRED_INIT)
+tfm_invalid_config(TFM_LIB_MODEL AND CONFIG_TFM_SPM_LAZY_LOAD)
+tfm_invalid_config(TFM_ISOLATION_LEVEL GREATER 1 AND CONFIG_TFM_SPM_LAZY_LOAD)
+tfm_invalid_config(CONFIG_TFM_SPM_LAZY_UNLOAD_TIMEOUT AND NOT CONFIG_TFM_SPM_LAZY_LOAD)
+tfm_invalid_config(CONFIG_TFM_SPM_API_STATS AND NOT TFM_PSA_API)
+tfm_invalid_config(CONFIG_TFM_SPM_TIMER AND (NOT TFM_PSA_API OR CONFIG_TFM_SPM_BACKEND STREQUAL "SFN"))
+tfm_invalid_config(TFM_EXCEPTION_INFO_RECORD AND (NOT TFM_PSA_API OR TFM_MULTI_CORE_TOPOLOGY))
+tfm_invalid_config(CONFIG_TFM_SPM_CPU_STATS AND (NOT TFM_PSA_API OR CONFIG_TFM_SPM_BACKEND STREQUAL "SFN"))
 
 tfm_invalid_config(TFM_MULTI_CORE_TOPOLOGY AND TFM_LIB_MODEL)
 tfm_invalid_config(TFM_PLAT_SPECIFIC_MULTI_CORE_COMM AND NOT TFM_MULTI_CORE_TOPOLOGY)
@@ -43,6 +51,25 @@ tfm_invalid_config((TFM_S_REG_TEST OR TFM_NS_REG_TEST) AND TEST_PSA_API)
 tfm_invalid_config(TFM_PARTITION_PROTECTED_STORAGE AND NOT TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
 tfm_invalid_config((TFM_PARTITION_PROTECTED_STORAGE AND PS_ROLLBACK_PROTECTION) AND NOT TFM_PARTITION_PLATFORM)
 tfm_invalid_config(PS_ROLLBACK_PROTECTION AND NOT PS_ENCRYPTION)
+tfm_invalid_config(ITS_BACKGROUND_ERASE AND NOT TFM_PSA_API)
+tfm_invalid_config(ITS_STATS AND NOT TFM_PSA_API)
+tfm_invalid_config(ITS_SHARED_MAP AND NOT TFM_PSA_API)
+tfm_invalid_config(ITS_SHARED_MAP AND NOT TFM_ISOLATION_LEVEL EQUAL 1)
+tfm_invalid_config(ITS_COALESCE AND NOT TFM_PSA_API)
+tfm_invalid_config(ITS_COALESCE AND NOT CONFIG_TFM_SPM_TIMER)
+tfm_invalid_config(PS_STATS AND NOT TFM_PSA_API)
+tfm_invalid_config(PS_WRITE_BEHIND AND NOT TFM_PSA_API)
+tfm_invalid_config(PS_WRITE_BEHIND AND NOT CONFIG_TFM_SPM_TIMER)
+
+get_property(PLATFORM_DEFAULT_ITS_ENC_ALG_LIST CACHE PLATFORM_DEFAULT_ITS_ENC_ALG PROPERTY STRINGS)
+tfm_invalid_config(PLATFORM_DEFAULT_ITS_ENCRYPTION AND NOT TFM_ITS_ENCRYPTED)
+# The hardware key derivation is built with the Crypto partition
+tfm_invalid_config(PLATFORM_DEFAULT_ITS_ENCRYPTION AND CRYPTO_HW_ACCELERATOR AND NOT TFM_PARTITION_CRYPTO)
+# The HAL keeps its key and its heap in the privileged data of the platform
+tfm_invalid_config(PLATFORM_DEFAULT_ITS_ENCRYPTION AND TFM_ISOLATION_LEVEL GREATER 2)
+tfm_invalid_config(PLATFORM_DEFAULT_ITS_ENCRYPTION AND NOT PLATFORM_DEFAULT_ITS_ENC_ALG IN_LIST PLATFORM_DEFAULT_ITS_ENC_ALG_LIST)
+tfm_invalid_config(PLATFORM_DEFAULT_ITS_ENCRYPTION AND NOT TFM_ITS_ENC_NONCE_LENGTH EQUAL 12)
+tfm_invalid_config(PLATFORM_DEFAULT_ITS_ENCRYPTION AND PLATFORM_DEFAULT_ITS_ENC_ALG STREQUAL "CHACHA20_POLY1305" AND NOT TFM_ITS_AUTH_TAG_LENGTH EQUAL 16)
 
 tfm_invalid_config(SUITE STREQUAL "IPC" AND NOT TEST_PSA_API STREQUAL "IPC")
 
@@ -54,6 +81,30 @@ tfm_invalid_config(TEST_PSA_API STREQUAL "PROTECTED_STORAGE" AND NOT TFM_PARTITI
 tfm_invalid_config(TEST_PSA_API STREQUAL "STORAGE" AND NOT TFM_PARTITION_INTERNAL_TRUSTED_STORAGE)
 tfm_invalid_config(TEST_PSA_API STREQUAL "STORAGE" AND NOT TFM_PARTITION_PROTECTED_STORAGE)
 
+########################## SPM backend #########################################
+
+get_property(CONFIG_TFM_SPM_BACKEND_LIST CACHE CONFIG_TFM_SPM_BACKEND PROPERTY STRINGS)
+tfm_invalid_config(TFM_PSA_API AND NOT CONFIG_TFM_SPM_BACKEND IN_LIST CONFIG_TFM_SPM_BACKEND_LIST)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND TFM_LIB_MODEL)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND TFM_ISOLATION_LEVEL GREATER 1)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND CONFIG_TFM_SPE_FP GREATER 0)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND CONFIG_TFM_SPM_DEFERRED_INIT)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND CONFIG_TFM_SPM_LAZY_LOAD)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND TFM_MULTI_CORE_TOPOLOGY)
+# These partitions only support the IPC model, and IPC and SFN partitions can
+# not be mixed in one build
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND TFM_PARTITION_PSA_PROXY)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND TFM_PARTITION_FIRMWARE_UPDATE)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND (TFM_S_REG_TEST OR TFM_NS_REG_TEST))
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND TEST_PSA_API STREQUAL "IPC")
+# These features run in the idle time of their partition's IPC loop
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND ITS_BACKGROUND_ERASE)
+tfm_invalid_config(CONFIG_TFM_SPM_BACKEND STREQUAL "SFN" AND PS_WRITE_BEHIND)
+
+########################## PSA Proxy ###########################################
+
+tfm_invalid_config(PSA_PROXY_LOCAL_CRYPTO AND NOT TFM_PARTITION_PSA_PROXY)
+
 ########################## FPU ################################################
 
 tfm_invalid_config(CONFIG_TFM_SPE_FP LESS 0 OR CONFIG_TFM_SPE_FP GREATER 2)
@@ -62,6 +113,10 @@ tfm_invalid_config((NOT CONFIG_TFM_FP_ARCH) AND (CONFIG_TFM_SPE_FP GREATER 0))
 tfm_invalid_config((NOT TFM_PSA_API) AND (CONFIG_TFM_SPE_FP GREATER 0))
 tfm_invalid_config(CONFIG_TFM_SPE_FP STREQUAL "0" AND CONFIG_TFM_LAZY_STACKING_SPE)
 
+# MVE shares the FP registers, so it needs the FP context handling of SPE
+tfm_invalid_config(TFM_SYSTEM_MVE AND NOT TFM_SYSTEM_ARCHITECTURE STREQUAL "armv8.1-m.main")
+tfm_invalid_config(TFM_SYSTEM_MVE AND CONFIG_TFM_SPE_FP STREQUAL "0")
+
 ########################## BL2 #################################################
 
 get_property(MCUBOOT_STRATEGY_LIST CACHE MCUBOOT_UPGRADE_STRATEGY PROPERTY STRINGS)
@@ -15,6 +15,7 @@ set(NS                                  ON          CACHE BOOL      "Whether to
 
 set(TEST_S                              OFF         CACHE BOOL      "Whether to build S regression tests")
 set(TEST_NS                             OFF         CACHE BOOL      "Whether to build NS regression tests")
+set(TEST_NS_IN_TREE                     OFF         CACHE BOOL      "Whether to build the in-tree feature tests of the test folder")
 set(TEST_PSA_API                        ""          CACHE STRING    "Which (if any) of the PSA API tests should be compiled")
 
 # TFM_LIB_MODEL is the only user configuration for Library Model selection.
@@ -52,6 +53,17 @@ set(TFM_SP_META_PTR_ENABLE              OFF         CACHE BOOL      "Use Partiti
 set(TFM_PXN_ENABLE                      OFF         CACHE BOOL      "Use Privileged execute never (PXN)")
 
 set(TFM_EXCEPTION_INFO_DUMP             OFF         CACHE BOOL      "On fatal errors in the secure firmware, capture info about the exception. Print the info if the SPM log level is sufficient.")
+set(TFM_EXCEPTION_INFO_RECORD           OFF         CACHE BOOL      "Record the fatal errors in the secure firmware, and count the SVCs, PendSVs, secure interrupts and faults of each partition, in RAM kept across warm reset")
+
+set(CONFIG_TFM_SPM_BACKEND             "IPC"       CACHE STRING    "The SPM backend used by the partitions which support both models [IPC, SFN]")
+set(CONFIG_TFM_SPM_DEFERRED_INIT        OFF         CACHE BOOL      "Start NS before partitions marked with deferred_init complete their initialization")
+set(CONFIG_TFM_SPM_LAZY_LOAD            OFF         CACHE BOOL      "Allocate the stack of partitions marked with lazy_load and start them on first use")
+set(CONFIG_TFM_SPM_LAZY_STACK_POOL_SIZE ""          CACHE STRING    "Size of the stack pool for lazily loaded partitions (defaults to the sum of their stack sizes if not set)")
+set(CONFIG_TFM_SPM_LAZY_UNLOAD_TIMEOUT "0"         CACHE STRING    "Unload lazily loaded partitions unused for this many tfm_hal_get_timestamp ticks when the secure side is idle (0 keeps them loaded)")
+set(CONFIG_TFM_SPM_API_STATS            OFF         CACHE BOOL      "Measure the cycles spent in the PSA client and RoT Service APIs and the idle residency, and serve them through tfm_spm_api_stats_get() and tfm_spm_idle_stats_get()")
+set(CONFIG_TFM_SPM_CPU_STATS            OFF         CACHE BOOL      "Account the cycles each partition runs for and the cycles spent in secure interrupt handling")
+set(CONFIG_TFM_SPM_TIMER                OFF         CACHE BOOL      "Provide one-shot timers to the partitions, delivered as signals and driven by the tickless secure timer of the platform")
+set(CONFIG_TFM_IDLE_MAX_EXIT_LATENCY     "0"         CACHE STRING    "The largest exit latency, in tfm_hal_get_timestamp ticks, of the platform sleep states entered by the idle partition")
 
 set(CONFIG_TFM_SPE_FP                   0           CACHE STRING    "FP ABI type in SPE: 0-software, 1-hybird, 2-hardware")
 set(CONFIG_TFM_LAZY_STACKING_SPE        OFF         CACHE BOOL      "Disable lazy stacking from SPE")
@@ -79,6 +91,8 @@ set(PLATFORM_DEFAULT_NV_SEED            ON          CACHE BOOL      "Use default
 set(PLATFORM_DEFAULT_OTP                ON          CACHE BOOL      "Use trusted on-chip flash to implement OTP memory")
 set(PLATFORM_DEFAULT_OTP_WRITEABLE      ON          CACHE BOOL      "Use OTP memory with write support")
 set(PLATFORM_DEFAULT_PROVISIONING       ON          CACHE BOOL      "Use default provisioning implementation")
+set(PLATFORM_DEFAULT_ITS_ENCRYPTION     OFF         CACHE BOOL      "Use default, Mbed Crypto based, ITS encryption implementation")
+set(PLATFORM_DEFAULT_ITS_ENC_ALG        "AES_CCM"   CACHE STRING    "The AEAD algorithm of the default ITS encryption implementation [AES_CCM, AES_GCM, CHACHA20_POLY1305]")
 
 set(TFM_DUMMY_PROVISIONING              ON          CACHE BOOL      "Provision with dummy values. NOT to be used in production")
 set(PLATFORM_IS_FVP                     FALSE       CACHE BOOL      "Whether to enable FVP or FPGA build of the platform.")
@@ -91,6 +105,10 @@ set(PS_ENCRYPTION                       ON          CACHE BOOL      "Enable encr
 set(PS_RAM_FS                           OFF         CACHE BOOL      "Enable emulated RAM FS for platforms that don't have flash for Protected Storage partition")
 set(PS_ROLLBACK_PROTECTION              ON          CACHE BOOL      "Enable rollback protection for Protected Storage partition")
 set(PS_VALIDATE_METADATA_FROM_FLASH     ON          CACHE BOOL      "Validate filesystem metadata every time it is read from flash")
+set(PS_STATS                            OFF         CACHE BOOL      "Collect request counts and latency histograms in the Protected Storage partition")
+set(PS_WRITE_BEHIND                     OFF         CACHE BOOL      "Encrypt and write the Protected Storage assets which are not write once after the set request completes")
+set(PS_WRITE_BEHIND_QUEUE_LEN           "2"         CACHE STRING    "The number of Protected Storage set requests which can wait to be written")
+set(PS_WRITE_BEHIND_IDLE_TIMEOUT        "100000"    CACHE STRING    "The time in tfm_hal_get_timestamp ticks for which the Protected Storage partition is idle before it writes a queued asset")
 set(PS_MAX_ASSET_SIZE                   "2048"      CACHE STRING    "The maximum asset size to be stored in the Protected Storage area")
 set(PS_NUM_ASSETS                       "10"        CACHE STRING    "The maximum number of assets to be stored in the Protected Storage area")
 set(PS_CRYPTO_AEAD_ALG                  PSA_ALG_GCM CACHE STRING    "The AEAD algorithm to use for authenticated encryption in Protected Storage")
@@ -99,12 +117,28 @@ set(TFM_PARTITION_INTERNAL_TRUSTED_STORAGE ON       CACHE BOOL      "Enable Inte
 set(ITS_CREATE_FLASH_LAYOUT             ON          CACHE BOOL      "Create flash FS if it doesn't exist for Internal Trusted Storage partition")
 set(ITS_RAM_FS                          OFF         CACHE BOOL      "Enable emulated RAM FS for platforms that don't have flash for Internal Trusted Storage partition")
 set(ITS_VALIDATE_METADATA_FROM_FLASH    ON          CACHE BOOL      "Validate filesystem metadata every time it is read from flash")
+set(ITS_FAST_MOUNT                      OFF         CACHE BOOL      "Skip the full filesystem validation at initialization after a clean shutdown")
+set(ITS_APPEND_IN_PLACE                 OFF         CACHE BOOL      "Write data appended to Internal Trusted Storage files in place instead of copying the whole data block")
+set(ITS_APPEND_JOURNAL_RECORDS          "16"        CACHE STRING    "The number of records of the journal of the Internal Trusted Storage appends done in place")
+set(ITS_APPEND_NUM_FILES                "4"         CACHE STRING    "The number of Internal Trusted Storage files which can be appended to in place between two metadata block updates")
+set(ITS_BACKGROUND_ERASE                OFF         CACHE BOOL      "Erase the Internal Trusted Storage scratch blocks one sector after each request instead of before the update returns")
+set(ITS_SHARED_MAP                      OFF         CACHE BOOL      "Allow secure partitions to read published write once Internal Trusted Storage assets in place")
+set(ITS_SHARED_MAP_SIZE                 "512"       CACHE STRING    "The size in bytes of the region holding the published Internal Trusted Storage assets")
+set(ITS_SHARED_MAP_NUM_ASSETS           "4"         CACHE STRING    "The maximum number of published Internal Trusted Storage assets")
+set(ITS_SHARED_MAP_NUM_READERS          "4"         CACHE STRING    "The maximum number of partitions allowed to map each published Internal Trusted Storage asset")
+set(ITS_COALESCE                        OFF         CACHE BOOL      "Hold repeated sets to the same Internal Trusted Storage asset in RAM and only write the last one")
+set(ITS_COALESCE_NUM_ASSETS             "2"         CACHE STRING    "The number of Internal Trusted Storage assets whose sets can be coalesced at the same time")
+set(ITS_COALESCE_MAX_SETS               "8"         CACHE STRING    "The number of coalesced sets after which an Internal Trusted Storage asset is written")
+set(ITS_COALESCE_WINDOW                 "1000000"   CACHE STRING    "The time in tfm_hal_get_timestamp ticks after which coalesced Internal Trusted Storage sets are written")
+set(ITS_STATS                           OFF         CACHE BOOL      "Collect request counts, latency histograms and flash statistics in the Internal Trusted Storage partition")
 set(ITS_MAX_ASSET_SIZE                  "512"       CACHE STRING    "The maximum asset size to be stored in the Internal Trusted Storage area")
 set(ITS_NUM_ASSETS                      "10"        CACHE STRING    "The maximum number of assets to be stored in the Internal Trusted Storage area")
+set(ITS_NUM_SHARDS                      "1"         CACHE STRING    "The number of independent filesystem instances the Internal Trusted Storage assets are distributed over")
 set(ITS_BUF_SIZE                        ""          CACHE STRING    "Size of the ITS internal data transfer buffer (defaults to ITS_MAX_ASSET_SIZE if not set)")
 set(TFM_ITS_ENCRYPTED                   OFF         CACHE BOOL      "Enable authenticated encryption of ITS files using platform specific APIs")
 set(TFM_ITS_AUTH_TAG_LENGTH             "16"        CACHE STRING    "The size of the authentication tag used when authentication/encryption of ITS files is enabled ")
-set(TFM_ITS_ENC_NONCE_LENGTH            "16"        CACHE STRING    "The size of the nonce used when ITS file encryption is enabled")
+set(TFM_ITS_ENC_NONCE_LENGTH            "12"        CACHE STRING    "The size of the nonce used when ITS file encryption is enabled")
+set(TFM_ITS_PLAINTEXT_CACHE_SIZE        "0"         CACHE STRING    "Size in bytes of the cache of decrypted ITS files when ITS file encryption is enabled (0 to disable)")
 
 set(TFM_PARTITION_CRYPTO                ON          CACHE BOOL      "Enable Crypto partition")
 # CRYPTO_ENGINE_BUF_SIZE needs to be >8KB for EC signing by attest module.
@@ -133,6 +167,7 @@ set(PLATFORM_NV_COUNTER_MODULE_DISABLED FALSE       CACHE BOOL      "Disable Non
 set(TFM_PARTITION_AUDIT_LOG             OFF         CACHE BOOL      "Enable Audit Log partition")
 
 set(TFM_PARTITION_PSA_PROXY             OFF         CACHE BOOL      "Enable PSA Proxy partition")
+set(PSA_PROXY_LOCAL_CRYPTO              OFF         CACHE BOOL      "Whether the PSA Proxy serves the keyless crypto requests locally")
 
 set(FORWARD_PROT_MSG                    OFF         CACHE BOOL      "Whether to forward all PSA RoT messages to a Secure Enclave")
 set(TFM_PARTITION_FIRMWARE_UPDATE       OFF         CACHE BOOL      "Enable firmware update partition")
@@ -169,6 +204,14 @@ set(PSA_ARCH_TESTS_VERSION              "v21.10_API1.3_ADAC_ALPHA-1"   CACHE STR
 
 set_property(CACHE TFM_FIH_PROFILE PROPERTY STRINGS "OFF;LOW;MEDIUM;HIGH")
 
+########################## SPM backend #########################################
+
+set_property(CACHE CONFIG_TFM_SPM_BACKEND PROPERTY STRINGS "IPC;SFN")
+
 ########################## FP #################################################
 
 set_property(CACHE CONFIG_TFM_SPE_FP PROPERTY STRINGS "0;1;2")
+
+########################## ITS encryption ######################################
+
+set_property(CACHE PLATFORM_DEFAULT_ITS_ENC_ALG PROPERTY STRINGS "AES_CCM;AES_GCM;CHACHA20_POLY1305")
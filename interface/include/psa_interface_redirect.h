@@ -32,6 +32,18 @@
 #define psa_reset_signal         psa_reset_signal_svc
 #define psa_rot_lifecycle_state  psa_rot_lifecycle_state_svc
 
+#ifdef CONFIG_TFM_SPM_TIMER
+#define tfm_timer_set            tfm_timer_set_svc
+#endif
+#define tfm_timer_get_timestamp  tfm_timer_get_timestamp_svc
+#ifdef CONFIG_TFM_SPM_API_STATS
+#define tfm_spm_api_stats_get    tfm_spm_api_stats_get_svc
+#define tfm_spm_idle_stats_get   tfm_spm_idle_stats_get_svc
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+#define tfm_exc_record_get       tfm_exc_record_get_svc
+#endif
+
 #elif defined(CONFIG_TFM_PSA_API_THREAD_CALL)
 
 #define psa_framework_version    psa_framework_version_thread
@@ -55,6 +67,18 @@
 #define psa_reset_signal         psa_reset_signal_thread
 #define psa_rot_lifecycle_state  psa_rot_lifecycle_state_thread
 
+#ifdef CONFIG_TFM_SPM_TIMER
+#define tfm_timer_set            tfm_timer_set_thread
+#endif
+#define tfm_timer_get_timestamp  tfm_timer_get_timestamp_thread
+#ifdef CONFIG_TFM_SPM_API_STATS
+#define tfm_spm_api_stats_get    tfm_spm_api_stats_get_thread
+#define tfm_spm_idle_stats_get   tfm_spm_idle_stats_get_thread
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+#define tfm_exc_record_get       tfm_exc_record_get_thread
+#endif
+
 #if PSA_FRAMEWORK_HAS_MM_IOVEC
 #define psa_map_invec            psa_map_invec_thread
 #define psa_unmap_invec          psa_unmap_invec_thread
@@ -74,6 +98,14 @@
 #define psa_skip                 psa_skip_sfn
 #define psa_write                psa_write_sfn
 #define psa_panic                psa_panic_sfn
+#define tfm_timer_get_timestamp  tfm_timer_get_timestamp_sfn
+#ifdef CONFIG_TFM_SPM_API_STATS
+#define tfm_spm_api_stats_get    tfm_spm_api_stats_get_sfn
+#define tfm_spm_idle_stats_get   tfm_spm_idle_stats_get_sfn
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+#define tfm_exc_record_get       tfm_exc_record_get_sfn
+#endif
 
 #else
 
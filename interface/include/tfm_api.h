@@ -71,6 +71,9 @@ struct tfm_control_parameter_t {
 
 /********************* Secure function declarations ***************************/
 
+/* Descriptor of a batched call, see tfm_psa_call_pack.h */
+struct tfm_psa_call_desc_t;
+
 /**
  * \brief Assign client ID to the current TZ context.
  *
@@ -125,6 +128,17 @@ psa_status_t tfm_psa_call_veneer(psa_handle_t handle,
                                  const psa_invec *in_vec,
                                  psa_outvec *out_vec);
 
+/**
+ * \brief Call secure functions referenced by the descriptors of a batch.
+ *
+ * \param[in,out] calls         Array of \ref tfm_psa_call_desc_t structures.
+ * \param[in] num               Number of descriptors.
+ *
+ * \return Returns \ref psa_status_t status code.
+ */
+psa_status_t tfm_psa_call_batch_veneer(struct tfm_psa_call_desc_t *calls,
+                                       uint32_t num);
+
 /**
  * \brief Close connection to secure function referenced by a connection handle.
  *
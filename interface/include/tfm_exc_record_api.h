@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_EXC_RECORD_API_H__
+#define __TFM_EXC_RECORD_API_H__
+
+#include <stdint.h>
+#include "psa_config.h"
+#include "psa/error.h"
+#include "psa_manifest/pid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of fault records kept, the oldest ones are overwritten */
+#define EXC_RECORD_ENTRIES          8
+
+/* Number of partitions counted: the user partitions, NS Agent and idle */
+#define EXC_RECORD_PARTITIONS       (TFM_MAX_USER_PARTITIONS + 2)
+
+/* The record of one fatal exception */
+struct tfm_exc_record_entry_t {
+    uint32_t timestamp;         /* tfm_hal_get_timestamp() at the fault     */
+    int32_t  partition_id;      /* Running partition, or -1 if none         */
+    uint32_t exception_type;    /* One of EXCEPTION_TYPE_*                  */
+    uint32_t exc_return;        /* EXC_RETURN value in LR                   */
+    uint32_t pc;                /* PC of the exception frame                */
+    uint32_t lr;                /* LR of the exception frame                */
+    uint32_t fault_status;      /* CFSR, or SFSR for a SecureFault          */
+    uint32_t fault_address;     /* Valid fault address register, or 0       */
+};
+
+/* The events counted for one partition */
+struct tfm_exc_record_counters_t {
+    int32_t  partition_id;      /* Partition counted, or -1 for a free slot */
+    uint32_t svc;               /* SVCs taken while the partition ran       */
+    uint32_t pendsv;            /* PendSVs taken while the partition ran    */
+    uint32_t irq;               /* Secure interrupts of the partition       */
+    uint32_t faults;            /* Fatal exceptions while the partition ran */
+};
+
+/* The exception record, retained across a warm reset */
+struct tfm_exc_record_t {
+    uint32_t magic;             /* Valid once initialized                   */
+    uint32_t boots;             /* Boots since the record was initialized   */
+    uint32_t recorded;          /* Fatal exceptions recorded in total       */
+    struct tfm_exc_record_entry_t entries[EXC_RECORD_ENTRIES];
+    struct tfm_exc_record_counters_t counters[EXC_RECORD_PARTITIONS];
+};
+
+/**
+ * \brief Read the exception record kept by SPM, with
+ *        TFM_EXCEPTION_INFO_RECORD.
+ *
+ * \param[out] record           The copy of the record. The latest entry is at
+ *                              index (recorded - 1) % EXC_RECORD_ENTRIES.
+ *
+ * \note The record holds the addresses of the code of all the partitions, so
+ *       it is only given to privileged partitions, such as a debug service.
+ *
+ * \retval PSA_SUCCESS                  \p record is filled.
+ * \retval PSA_ERROR_NOT_PERMITTED      The caller is not privileged.
+ */
+psa_status_t tfm_exc_record_get(struct tfm_exc_record_t *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_EXC_RECORD_API_H__ */
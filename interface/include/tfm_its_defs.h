@@ -20,6 +20,11 @@ extern "C" {
 #define TFM_ITS_GET                1002
 #define TFM_ITS_GET_INFO           1003
 #define TFM_ITS_REMOVE             1004
+#define TFM_ITS_CREATE             1005
+#define TFM_ITS_APPEND             1006
+#define TFM_ITS_MAP                1007
+#define TFM_ITS_FLUSH              1008
+#define TFM_ITS_PUBLISH            1009
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/** This file describes the TF-M extensions to the PSA Internal Trusted Storage
+ *  API, which are only available to secure partitions.
+ */
+
+#ifndef __TFM_ITS_EXT_API_H__
+#define __TFM_ITS_EXT_API_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+#include "psa/storage_common.h"
+#include "tfm_storage_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Owner argument of \ref tfm_its_ext_map which selects the caller's files */
+#define TFM_ITS_EXT_MAP_OWNER_SELF 0
+
+/**
+ * \brief Create an empty uid/value pair which data can be appended to
+ *
+ * Reserves `capacity` bytes in the internal storage. Data is then added to the
+ * end of the existing data with \ref tfm_its_ext_append, and is read with
+ * psa_its_get(). Replacing the data with psa_its_set() also resets its
+ * capacity to the new data size.
+ *
+ * \param[in] uid           The identifier for the data
+ * \param[in] capacity      The maximum size in bytes of the data
+ * \param[in] create_flags  The flags that the data will be stored with.
+ *                          PSA_STORAGE_FLAG_WRITE_ONCE is not supported.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_ALREADY_EXISTS        The operation failed because the
+ *                                         provided `uid` value already exists
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because one or
+ *                                         more of the flags provided in
+ *                                         `create_flags` is not supported or is
+ *                                         not valid, or because ITS encryption
+ *                                         is enabled
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because there
+ *                                         was insufficient space on the
+ *                                         storage medium
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because
+ *                                         `capacity` is zero or larger than
+ *                                         the maximum asset size
+ */
+psa_status_t tfm_its_ext_create(psa_storage_uid_t uid,
+                                size_t capacity,
+                                psa_storage_create_flags_t create_flags);
+
+/**
+ * \brief Append data to an existing uid/value pair
+ *
+ * \param[in] uid          The identifier for the data
+ * \param[in] data_length  The size in bytes of the data in `p_data`
+ * \param[in] p_data       A buffer containing the data to append
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_DOES_NOT_EXIST        The operation failed because the
+ *                                         provided `uid` value was not found in
+ *                                         the storage
+ * \retval PSA_ERROR_NOT_PERMITTED         The operation failed because the
+ *                                         provided `uid` value was created with
+ *                                         PSA_STORAGE_FLAG_WRITE_ONCE
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because ITS
+ *                                         encryption is enabled
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because the
+ *                                         data does not fit in the capacity of
+ *                                         the uid/value pair
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because one
+ *                                         of the provided pointers (`p_data`)
+ *                                         is invalid, for example is `NULL` or
+ *                                         references memory the caller cannot
+ *                                         access
+ */
+psa_status_t tfm_its_ext_append(psa_storage_uid_t uid,
+                                size_t data_length,
+                                const void *p_data);
+
+/**
+ * \brief Get the runtime statistics of the storage services
+ *
+ * Returns the number of requests, errors and latency histogram of each ITS
+ * request type since boot, together with the flash statistics of the ITS and
+ * PS filesystems.
+ *
+ * \note The statistics are read from the TFM_ITS_STATS_SERVICE, which is only
+ *       accessible to the secure partitions listing it in the dependencies of
+ *       their manifest.
+ *
+ * \param[out] stats  Pointer to the statistics to fill
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because ITS is
+ *                                         not built with ITS_STATS, or TF-M
+ *                                         is not built in IPC mode
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because the
+ *                                         provided pointer (`stats`) is
+ *                                         invalid
+ */
+psa_status_t tfm_its_ext_get_stats(struct tfm_its_stats_t *stats);
+
+/**
+ * \brief Publish a write once uid/value pair to other secure partitions
+ *
+ * Copies the data of a uid/value pair of the caller, created with
+ * PSA_STORAGE_FLAG_WRITE_ONCE, into a read-only region shared with the secure
+ * partitions, if not done yet, and sets the secure partitions allowed to map
+ * it with \ref tfm_its_ext_map. A new call replaces the readers. This only
+ * affects the later mappings: a reader which already mapped the data keeps
+ * its address.
+ *
+ * \note The readers are not enforced by the isolation hardware. The shared
+ *       region is in the ITS partition memory, which every secure partition
+ *       can read at isolation level 1, the only level ITS_SHARED_MAP is
+ *       supported at. The readers only select the partitions
+ *       \ref tfm_its_ext_map returns the address to, so the data must not be
+ *       confidential from the other secure partitions.
+ *
+ * \param[in] uid          The identifier for the data
+ * \param[in] readers      The partition IDs of the secure partitions allowed
+ *                         to map the data
+ * \param[in] num_readers  The number of partition IDs in `readers`
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                    The operation completed successfully
+ * \retval PSA_ERROR_DOES_NOT_EXIST       The operation failed because the
+ *                                        provided `uid` value was not found in
+ *                                        the storage
+ * \retval PSA_ERROR_NOT_PERMITTED        The operation failed because the
+ *                                        provided `uid` value was not created
+ *                                        with PSA_STORAGE_FLAG_WRITE_ONCE, or
+ *                                        because the caller is not a secure
+ *                                        partition
+ * \retval PSA_ERROR_INSUFFICIENT_MEMORY  The operation failed because the
+ *                                        shared region is full
+ * \retval PSA_ERROR_NOT_SUPPORTED        The operation failed because ITS is
+ *                                        not built with ITS_SHARED_MAP, or
+ *                                        TF-M is not built in IPC mode
+ * \retval PSA_ERROR_STORAGE_FAILURE      The operation failed because the
+ *                                        physical storage has failed (Fatal
+ *                                        error)
+ * \retval PSA_ERROR_INVALID_ARGUMENT     The operation failed because there
+ *                                        are more than
+ *                                        ITS_SHARED_MAP_NUM_READERS readers,
+ *                                        or one of them is not a secure
+ *                                        partition ID
+ */
+psa_status_t tfm_its_ext_publish(psa_storage_uid_t uid,
+                                 const int32_t *readers,
+                                 size_t num_readers);
+
+/**
+ * \brief Map a write once uid/value pair for reading in place
+ *
+ * The first time the owner of a uid/value pair created with
+ * PSA_STORAGE_FLAG_WRITE_ONCE maps it, ITS copies its data into a read-only
+ * region shared with the secure partitions, and publishes it with no reader.
+ * The owner, and the secure partitions it declared as readers with
+ * \ref tfm_its_ext_publish, can then map it, and read the data directly at
+ * the returned address instead of calling psa_its_get(). The data stays valid
+ * and unchanged until the next reset.
+ *
+ * \note This function is only available at isolation level 1. The access
+ *       checks only apply to the call: the returned address is readable by
+ *       every secure partition, see \ref tfm_its_ext_publish.
+ *
+ * \param[in]  owner          The partition ID of the owner of the data, or
+ *                            TFM_ITS_EXT_MAP_OWNER_SELF for the caller's data
+ * \param[in]  uid            The identifier for the data
+ * \param[out] p_data         On success, the address of the data
+ * \param[out] p_data_length  On success, the size in bytes of the data
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                    The operation completed successfully
+ * \retval PSA_ERROR_DOES_NOT_EXIST       The operation failed because the
+ *                                        caller's `uid` value was not found in
+ *                                        the storage
+ * \retval PSA_ERROR_NOT_PERMITTED        The operation failed because the
+ *                                        provided `uid` value was not created
+ *                                        with PSA_STORAGE_FLAG_WRITE_ONCE, or
+ *                                        because the caller is neither its
+ *                                        owner nor one of its readers. This is
+ *                                        also returned when another owner's
+ *                                        `uid` value does not exist or is not
+ *                                        published.
+ * \retval PSA_ERROR_INSUFFICIENT_MEMORY  The operation failed because the
+ *                                        shared region is full
+ * \retval PSA_ERROR_NOT_SUPPORTED        The operation failed because ITS is
+ *                                        not built with ITS_SHARED_MAP, or
+ *                                        TF-M is not built in IPC mode
+ * \retval PSA_ERROR_STORAGE_FAILURE      The operation failed because the
+ *                                        physical storage has failed (Fatal
+ *                                        error)
+ * \retval PSA_ERROR_INVALID_ARGUMENT     The operation failed because one
+ *                                        of the provided pointers (`p_data`,
+ *                                        `p_data_length`) is invalid
+ */
+psa_status_t tfm_its_ext_map(int32_t owner,
+                             psa_storage_uid_t uid,
+                             const void **p_data,
+                             size_t *p_data_length);
+
+/**
+ * \brief Write the data of the coalesced sets to the storage
+ *
+ * When ITS is built with ITS_COALESCE, repeated psa_its_set() calls to the
+ * same uid may complete before their data is written to the storage. This
+ * function writes the data of all such calls, of all clients, before it
+ * returns.
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                The operation completed successfully, or
+ *                                    there was no data to write
+ * \retval PSA_ERROR_STORAGE_FAILURE  The operation failed because the physical
+ *                                    storage has failed (Fatal error)
+ */
+psa_status_t tfm_its_ext_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_ITS_EXT_API_H__ */
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/** This file describes the TF-M extensions to the PSA Protected Storage API,
+ *  which are only available to secure partitions.
+ */
+
+#ifndef __TFM_PS_EXT_API_H__
+#define __TFM_PS_EXT_API_H__
+
+#include "psa/error.h"
+#include "tfm_storage_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Get the runtime statistics of the Protected Storage service
+ *
+ * Returns the number of requests, errors and latency histogram of each PS
+ * request type since boot. The flash statistics of the PS filesystem are
+ * reported by \ref tfm_its_ext_get_stats, as it is owned by ITS.
+ *
+ * \note The statistics are read from the TFM_PS_STATS_SERVICE, which is only
+ *       accessible to the secure partitions listing it in the dependencies of
+ *       their manifest.
+ *
+ * \param[out] stats  Pointer to the statistics to fill
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because PS is
+ *                                         not built with PS_STATS, or TF-M is
+ *                                         not built in IPC mode
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because the
+ *                                         provided pointer (`stats`) is
+ *                                         invalid
+ */
+psa_status_t tfm_ps_ext_get_stats(struct tfm_ps_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_PS_EXT_API_H__ */
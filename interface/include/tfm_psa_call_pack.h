@@ -32,6 +32,41 @@ psa_status_t tfm_psa_call_pack(psa_handle_t handle,
                                const psa_invec *in_vec,
                                psa_outvec *out_vec);
 
+/* The maximum number of calls in one batch */
+#define TFM_PSA_CALL_BATCH_MAX  8U
+
+/* Descriptor of one psa_call() in a batch */
+struct tfm_psa_call_desc_t {
+    psa_handle_t handle;        /* Handle of the RoT Service connection     */
+    int32_t type;               /* Request type                             */
+    const psa_invec *in_vec;    /* Array of input vectors                   */
+    size_t in_len;              /* Number of input vectors                  */
+    psa_outvec *out_vec;        /* Array of output vectors                  */
+    size_t out_len;             /* Number of output vectors                 */
+    psa_status_t status;        /* Returned status of the call              */
+};
+
+/**
+ * \brief Call several RoT Services with one entry to the SPE.
+ *
+ * \details The calls are made in order, as by psa_call() with the
+ *          parameters of each descriptor, and the status each call returns
+ *          is written to its descriptor. Every call is made, whatever the
+ *          status of the previous ones.
+ *
+ * \param[in,out] calls         Array of call descriptors
+ * \param[in] num               Number of descriptors, from 1 to
+ *                              \ref TFM_PSA_CALL_BATCH_MAX
+ *
+ * \retval PSA_SUCCESS                  The calls are made, see the status in
+ *                                      each descriptor.
+ * \retval PSA_ERROR_PROGRAMMER_ERROR   The number of descriptors is invalid,
+ *                                      or the descriptors are not accessible
+ *                                      to the caller. No call is made.
+ */
+psa_status_t tfm_psa_call_batch(struct tfm_psa_call_desc_t *calls,
+                                size_t num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_SPM_STATS_API_H__
+#define __TFM_SPM_STATS_API_H__
+
+#include <stdint.h>
+#include "psa_config.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* APIs whose durations are recorded by SPM */
+#define TFM_SPM_API_STATS_CONNECT       0
+#define TFM_SPM_API_STATS_CALL          1
+#define TFM_SPM_API_STATS_CLOSE         2
+#define TFM_SPM_API_STATS_READ          3
+#define TFM_SPM_API_STATS_WRITE         4
+#define TFM_SPM_API_STATS_REPLY         5
+#define TFM_SPM_API_STATS_NUM_APIS      6
+/* Time spent in the SPM SVC handler for a PSA API SVC */
+#define TFM_SPM_API_STATS_SVC           TFM_SPM_API_STATS_NUM_APIS
+
+/*
+ * Number of payload size classes. Class 0 counts the requests which carried no
+ * data, class n counts the requests which carried between 4^(n-1) and
+ * 4^n - 1 bytes, and the last class also counts all the larger requests.
+ */
+#define TFM_SPM_API_STATS_SIZE_CLASSES  8
+
+/* Number of sleep states of the idle partition whose residency is recorded */
+#define TFM_SPM_IDLE_STATS_STATES       4
+
+/* Durations of one API, for one class of requests */
+struct tfm_spm_api_stats_t {
+    uint8_t api;                /* TFM_SPM_API_STATS_xxx                  */
+    uint8_t svc_number;         /* SVC number, for TFM_SPM_API_STATS_SVC  */
+    uint8_t iovecs;             /* Number of vectors, for psa_call        */
+    uint8_t size_class;         /* Payload size class                     */
+    uint32_t count;             /* Number of calls                        */
+    uint32_t min;               /* Shortest duration, in ticks            */
+    uint32_t max;               /* Longest duration, in ticks             */
+    uint64_t total;             /* Sum of the durations, in ticks         */
+};
+
+/* Residency of one sleep state of the idle partition */
+struct tfm_spm_idle_stats_t {
+    uint32_t count;             /* Number of times the state was entered  */
+    uint32_t min;               /* Shortest stay, in ticks                */
+    uint32_t max;               /* Longest stay, in ticks                 */
+    uint64_t total;             /* Time spent in the state, in ticks      */
+};
+
+/**
+ * \brief Read the durations of the PSA APIs recorded by SPM since boot, with
+ *        CONFIG_TFM_SPM_API_STATS.
+ *
+ * \param[in]  index            Index of the record, from 0. Only the classes
+ *                              of requests which were made are recorded.
+ * \param[out] stats            The record.
+ *
+ * \note The durations are in tfm_hal_get_timestamp() ticks. The statistics
+ *       are read without going through the SPM log, so they are available
+ *       whatever the log level.
+ *
+ * \retval PSA_SUCCESS                  \p stats is filled.
+ * \retval PSA_ERROR_DOES_NOT_EXIST     \p index is past the last record.
+ */
+psa_status_t tfm_spm_api_stats_get(uint32_t index,
+                                   struct tfm_spm_api_stats_t *stats);
+
+/**
+ * \brief Read the residency of a sleep state of the platform, entered by the
+ *        idle partition since boot, with CONFIG_TFM_SPM_API_STATS.
+ *
+ * \param[in]  state            Index of the state in the states declared by
+ *                              tfm_hal_get_sleep_states().
+ * \param[out] stats            The residency, with a zero count if the state
+ *                              was never entered.
+ *
+ * \note The stays are in tfm_hal_get_timestamp() ticks, from the entry of
+ *       the state to the time the idle partition runs again.
+ *
+ * \retval PSA_SUCCESS                  \p stats is filled.
+ * \retval PSA_ERROR_DOES_NOT_EXIST     \p state is not below
+ *                                      \ref TFM_SPM_IDLE_STATS_STATES.
+ */
+psa_status_t tfm_spm_idle_stats_get(uint32_t state,
+                                    struct tfm_spm_idle_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_SPM_STATS_API_H__ */
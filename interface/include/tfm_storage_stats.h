@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/** This file describes the runtime statistics reported by the TF-M storage
+ *  services when they are built with ITS_STATS or PS_STATS.
+ */
+
+#ifndef __TFM_STORAGE_STATS_H__
+#define __TFM_STORAGE_STATS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of buckets of the latency histograms. Bucket 0 counts the requests
+ * which took 0 timestamp ticks, bucket n counts the requests which took
+ * between 2^(n-1) and 2^n - 1 ticks, and the last bucket also counts all the
+ * longer requests.
+ */
+#define TFM_STORAGE_STATS_LATENCY_BUCKETS  32
+
+/* Number of filesystem blocks for which the erases are counted individually */
+#ifndef TFM_STORAGE_STATS_MAX_BLOCKS
+#define TFM_STORAGE_STATS_MAX_BLOCKS       16
+#endif
+
+/* Indexes of the ITS requests in \ref tfm_its_stats_t */
+#define TFM_ITS_STATS_OP_SET        0
+#define TFM_ITS_STATS_OP_GET        1
+#define TFM_ITS_STATS_OP_GET_INFO   2
+#define TFM_ITS_STATS_OP_REMOVE     3
+#define TFM_ITS_STATS_OP_CREATE     4
+#define TFM_ITS_STATS_OP_APPEND     5
+#define TFM_ITS_STATS_NUM_OPS       6
+
+/* Indexes of the PS requests in \ref tfm_ps_stats_t */
+#define TFM_PS_STATS_OP_SET         0
+#define TFM_PS_STATS_OP_GET         1
+#define TFM_PS_STATS_OP_GET_INFO    2
+#define TFM_PS_STATS_OP_REMOVE      3
+#define TFM_PS_STATS_NUM_OPS        4
+
+/**
+ * \brief Statistics of one type of request.
+ */
+struct tfm_storage_op_stats_t {
+    uint32_t count;  /*!< Number of requests handled */
+    uint32_t errors; /*!< Number of requests which returned an error */
+    uint32_t latency[TFM_STORAGE_STATS_LATENCY_BUCKETS]; /*!< Histogram of the
+                                                          *   request durations,
+                                                          *   in log2 buckets of
+                                                          *   timestamp ticks
+                                                          */
+};
+
+/**
+ * \brief Flash statistics of one filesystem.
+ */
+struct tfm_storage_flash_stats_t {
+    uint32_t bytes_written;   /*!< Number of bytes programmed */
+    uint32_t erases;          /*!< Number of block erases */
+    uint32_t metablock_swaps; /*!< Number of metadata block updates */
+    uint32_t compactions;     /*!< Number of data block compactions, when a
+                               *   file is deleted
+                               */
+    uint32_t block_erases[TFM_STORAGE_STATS_MAX_BLOCKS]; /*!< Erases of each
+                                                          *   block, indexed by
+                                                          *   physical block ID
+                                                          */
+    uint32_t erase_pending;   /*!< Number of scratch blocks left to erase in
+                               *   the background, with ITS_BACKGROUND_ERASE
+                               */
+};
+
+/**
+ * \brief Statistics of the ITS plaintext cache.
+ */
+struct tfm_storage_cache_stats_t {
+    uint32_t hits;      /*!< Reads served from the cache */
+    uint32_t misses;    /*!< Reads which required a decryption */
+    uint32_t evictions; /*!< Entries evicted to make room for new ones */
+};
+
+/**
+ * \brief Statistics of the Internal Trusted Storage service.
+ */
+struct tfm_its_stats_t {
+    struct tfm_storage_op_stats_t ops[TFM_ITS_STATS_NUM_OPS]; /*!< Requests */
+    struct tfm_storage_flash_stats_t its_flash; /*!< ITS filesystem */
+    struct tfm_storage_flash_stats_t ps_flash;  /*!< PS filesystem, all zero
+                                                 *   if PS is not enabled
+                                                 */
+    struct tfm_storage_cache_stats_t cache;     /*!< Plaintext cache, all
+                                                 *   zero if it is disabled
+                                                 */
+};
+
+/**
+ * \brief Statistics of the Protected Storage service.
+ */
+struct tfm_ps_stats_t {
+    struct tfm_storage_op_stats_t ops[TFM_PS_STATS_NUM_OPS]; /*!< Requests */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_STORAGE_STATS_H__ */
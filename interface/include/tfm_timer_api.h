@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_TIMER_API_H__
+#define __TFM_TIMER_API_H__
+
+#include <stdint.h>
+#include "psa_config.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The signal asserted on a Secure Partition when its timer expires. The
+ * manifest tool allocates the service signals from bit 4 upwards and the
+ * interrupt signals from bit 30 downwards, leaving bit 31 to the timer.
+ */
+#define TFM_TIMER_SIGNAL                (0x80000000u)
+
+/**
+ * \brief Set the one-shot timer of the calling Secure Partition.
+ *
+ * \param[in] timeout           Number of tfm_hal_get_timestamp() ticks after
+ *                              which \ref TFM_TIMER_SIGNAL is asserted on the
+ *                              caller, or 0 to cancel the timer.
+ *
+ * \note Each partition has one timer, a new timeout replaces the previous
+ *       one. The call also clears \ref TFM_TIMER_SIGNAL, which stays asserted
+ *       until then.
+ *
+ * \retval PSA_SUCCESS                  The timer is set or cancelled.
+ * \retval PSA_ERROR_INVALID_ARGUMENT   The timeout is too large.
+ * \retval PSA_ERROR_NOT_SUPPORTED      The platform has no secure timer.
+ * \retval PSA_ERROR_GENERIC_ERROR      The secure timer failed to start. The
+ *                                      previous timeout, if any, still applies.
+ */
+psa_status_t tfm_timer_set(uint32_t timeout);
+
+/**
+ * \brief Get the current secure timestamp.
+ *
+ * \note The timestamp is read by SPM, so it is available to the Secure
+ *       Partitions at all isolation levels, and whether the platform secure
+ *       timer is provided or not.
+ *
+ * \return The current timestamp, in tfm_hal_get_timestamp() ticks. It is 0
+ *         if the platform has no timestamp source.
+ */
+uint32_t tfm_timer_get_timestamp(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_TIMER_API_H__ */
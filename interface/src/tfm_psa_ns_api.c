@@ -63,6 +63,21 @@ psa_status_t psa_call(psa_handle_t handle, int32_t type,
                                 (uint32_t)out_vec);
 }
 
+psa_status_t tfm_psa_call_batch(struct tfm_psa_call_desc_t *calls,
+                                size_t num)
+{
+    if ((num == 0) || (num > TFM_PSA_CALL_BATCH_MAX)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return tfm_ns_interface_dispatch(
+                                (veneer_fn)tfm_psa_call_batch_veneer,
+                                (uint32_t)calls,
+                                (uint32_t)num,
+                                0,
+                                0);
+}
+
 void psa_close(psa_handle_t handle)
 {
     (void)tfm_ns_interface_dispatch(
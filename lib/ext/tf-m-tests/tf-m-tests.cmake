@@ -7,6 +7,14 @@
 
 get_cmake_property(CACHE_VARS CACHE_VARIABLES)
 
+# The in-tree feature tests are an extra NS test suite and extra test
+# partitions, each built only when the feature it tests is enabled.
+if (TEST_NS_IN_TREE)
+    list(APPEND EXTRA_NS_TEST_SUITES_PATHS ${CMAKE_SOURCE_DIR}/test/non_secure)
+    list(APPEND TFM_EXTRA_PARTITION_PATHS ${CMAKE_SOURCE_DIR}/test/services)
+    list(APPEND TFM_EXTRA_MANIFEST_LIST_FILES ${CMAKE_SOURCE_DIR}/test/extra_manifest_list.yaml)
+endif()
+
 # By default all non-secure regression tests are disabled.
 # If TEST_NS or TEST_NS_XXX flag is passed via command line and set to ON,
 # selected corresponding features to support non-secure regression tests.
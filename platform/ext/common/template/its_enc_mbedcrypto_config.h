@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Minimal configuration of the Mbed Crypto instance of the default ITS
+ * encryption HAL, which only runs the AEAD algorithm selected by
+ * PLATFORM_DEFAULT_ITS_ENC_ALG and the HKDF of the file keys.
+ */
+
+#ifndef __ITS_ENC_MBEDCRYPTO_CONFIG_H__
+#define __ITS_ENC_MBEDCRYPTO_CONFIG_H__
+
+/* System support */
+#define MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_NO_PLATFORM_ENTROPY
+
+/* mbed TLS feature support */
+#define MBEDTLS_AES_ROM_TABLES
+#define MBEDTLS_AES_FEWER_TABLES
+#define MBEDTLS_SHA256_SMALLER
+
+/* mbed TLS modules */
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+#define MBEDTLS_AES_C
+#define MBEDTLS_CCM_C
+#define MBEDTLS_CIPHER_C
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+#define MBEDTLS_AES_C
+#define MBEDTLS_GCM_C
+#define MBEDTLS_CIPHER_C
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_CHACHA20_POLY1305)
+#define MBEDTLS_CHACHA20_C
+#define MBEDTLS_POLY1305_C
+#define MBEDTLS_CHACHAPOLY_C
+#endif
+#define MBEDTLS_HKDF_C
+#define MBEDTLS_MD_C
+#define MBEDTLS_MEMORY_BUFFER_ALLOC_C
+#define MBEDTLS_PLATFORM_C
+#define MBEDTLS_SHA256_C
+
+/*
+ * The instance is linked in the same image as the one of the Crypto partition,
+ * so all its external symbols are renamed. The HAL includes the Mbed Crypto
+ * headers with this configuration, so it calls the renamed functions.
+ */
+
+/* aes.c */
+#define mbedtls_aes_init                its_enc_mbedtls_aes_init
+#define mbedtls_aes_free                its_enc_mbedtls_aes_free
+#define mbedtls_aes_setkey_enc          its_enc_mbedtls_aes_setkey_enc
+#define mbedtls_aes_setkey_dec          its_enc_mbedtls_aes_setkey_dec
+#define mbedtls_internal_aes_encrypt    its_enc_mbedtls_internal_aes_encrypt
+#define mbedtls_internal_aes_decrypt    its_enc_mbedtls_internal_aes_decrypt
+#define mbedtls_aes_crypt_ecb           its_enc_mbedtls_aes_crypt_ecb
+
+/* ccm.c */
+#define mbedtls_ccm_init                its_enc_mbedtls_ccm_init
+#define mbedtls_ccm_setkey              its_enc_mbedtls_ccm_setkey
+#define mbedtls_ccm_free                its_enc_mbedtls_ccm_free
+#define mbedtls_ccm_starts              its_enc_mbedtls_ccm_starts
+#define mbedtls_ccm_set_lengths         its_enc_mbedtls_ccm_set_lengths
+#define mbedtls_ccm_update_ad           its_enc_mbedtls_ccm_update_ad
+#define mbedtls_ccm_update              its_enc_mbedtls_ccm_update
+#define mbedtls_ccm_finish              its_enc_mbedtls_ccm_finish
+#define mbedtls_ccm_encrypt_and_tag     its_enc_mbedtls_ccm_encrypt_and_tag
+#define mbedtls_ccm_star_encrypt_and_tag \
+                                        its_enc_mbedtls_ccm_star_encrypt_and_tag
+#define mbedtls_ccm_auth_decrypt        its_enc_mbedtls_ccm_auth_decrypt
+#define mbedtls_ccm_star_auth_decrypt   its_enc_mbedtls_ccm_star_auth_decrypt
+
+/* gcm.c */
+#define mbedtls_gcm_init                its_enc_mbedtls_gcm_init
+#define mbedtls_gcm_setkey              its_enc_mbedtls_gcm_setkey
+#define mbedtls_gcm_starts              its_enc_mbedtls_gcm_starts
+#define mbedtls_gcm_update_ad           its_enc_mbedtls_gcm_update_ad
+#define mbedtls_gcm_update              its_enc_mbedtls_gcm_update
+#define mbedtls_gcm_finish              its_enc_mbedtls_gcm_finish
+#define mbedtls_gcm_crypt_and_tag       its_enc_mbedtls_gcm_crypt_and_tag
+#define mbedtls_gcm_auth_decrypt        its_enc_mbedtls_gcm_auth_decrypt
+#define mbedtls_gcm_free                its_enc_mbedtls_gcm_free
+
+/* cipher.c and cipher_wrap.c */
+#define mbedtls_cipher_list             its_enc_mbedtls_cipher_list
+#define mbedtls_cipher_info_from_type   its_enc_mbedtls_cipher_info_from_type
+#define mbedtls_cipher_info_from_string its_enc_mbedtls_cipher_info_from_string
+#define mbedtls_cipher_info_from_values its_enc_mbedtls_cipher_info_from_values
+#define mbedtls_cipher_init             its_enc_mbedtls_cipher_init
+#define mbedtls_cipher_free             its_enc_mbedtls_cipher_free
+#define mbedtls_cipher_setup            its_enc_mbedtls_cipher_setup
+#define mbedtls_cipher_setkey           its_enc_mbedtls_cipher_setkey
+#define mbedtls_cipher_set_iv           its_enc_mbedtls_cipher_set_iv
+#define mbedtls_cipher_reset            its_enc_mbedtls_cipher_reset
+#define mbedtls_cipher_update_ad        its_enc_mbedtls_cipher_update_ad
+#define mbedtls_cipher_update           its_enc_mbedtls_cipher_update
+#define mbedtls_cipher_finish           its_enc_mbedtls_cipher_finish
+#define mbedtls_cipher_write_tag        its_enc_mbedtls_cipher_write_tag
+#define mbedtls_cipher_check_tag        its_enc_mbedtls_cipher_check_tag
+#define mbedtls_cipher_crypt            its_enc_mbedtls_cipher_crypt
+#define mbedtls_cipher_auth_encrypt_ext its_enc_mbedtls_cipher_auth_encrypt_ext
+#define mbedtls_cipher_auth_decrypt_ext its_enc_mbedtls_cipher_auth_decrypt_ext
+#define mbedtls_cipher_definitions      its_enc_mbedtls_cipher_definitions
+#define mbedtls_cipher_supported        its_enc_mbedtls_cipher_supported
+
+/* chacha20.c, poly1305.c and chachapoly.c */
+#define mbedtls_chacha20_init           its_enc_mbedtls_chacha20_init
+#define mbedtls_chacha20_free           its_enc_mbedtls_chacha20_free
+#define mbedtls_chacha20_setkey         its_enc_mbedtls_chacha20_setkey
+#define mbedtls_chacha20_starts         its_enc_mbedtls_chacha20_starts
+#define mbedtls_chacha20_update         its_enc_mbedtls_chacha20_update
+#define mbedtls_chacha20_crypt          its_enc_mbedtls_chacha20_crypt
+#define mbedtls_poly1305_init           its_enc_mbedtls_poly1305_init
+#define mbedtls_poly1305_free           its_enc_mbedtls_poly1305_free
+#define mbedtls_poly1305_starts         its_enc_mbedtls_poly1305_starts
+#define mbedtls_poly1305_update         its_enc_mbedtls_poly1305_update
+#define mbedtls_poly1305_finish         its_enc_mbedtls_poly1305_finish
+#define mbedtls_poly1305_mac            its_enc_mbedtls_poly1305_mac
+#define mbedtls_chachapoly_init         its_enc_mbedtls_chachapoly_init
+#define mbedtls_chachapoly_free         its_enc_mbedtls_chachapoly_free
+#define mbedtls_chachapoly_setkey       its_enc_mbedtls_chachapoly_setkey
+#define mbedtls_chachapoly_starts       its_enc_mbedtls_chachapoly_starts
+#define mbedtls_chachapoly_update_aad   its_enc_mbedtls_chachapoly_update_aad
+#define mbedtls_chachapoly_update       its_enc_mbedtls_chachapoly_update
+#define mbedtls_chachapoly_finish       its_enc_mbedtls_chachapoly_finish
+#define mbedtls_chachapoly_encrypt_and_tag \
+                                        its_enc_mbedtls_chachapoly_encrypt_and_tag
+#define mbedtls_chachapoly_auth_decrypt its_enc_mbedtls_chachapoly_auth_decrypt
+
+/* md.c, sha256.c and hkdf.c */
+#define mbedtls_md_list                 its_enc_mbedtls_md_list
+#define mbedtls_md_info_from_string     its_enc_mbedtls_md_info_from_string
+#define mbedtls_md_info_from_type       its_enc_mbedtls_md_info_from_type
+#define mbedtls_md_init                 its_enc_mbedtls_md_init
+#define mbedtls_md_free                 its_enc_mbedtls_md_free
+#define mbedtls_md_clone                its_enc_mbedtls_md_clone
+#define mbedtls_md_setup                its_enc_mbedtls_md_setup
+#define mbedtls_md_starts               its_enc_mbedtls_md_starts
+#define mbedtls_md_update               its_enc_mbedtls_md_update
+#define mbedtls_md_finish               its_enc_mbedtls_md_finish
+#define mbedtls_md                      its_enc_mbedtls_md
+#define mbedtls_md_get_size             its_enc_mbedtls_md_get_size
+#define mbedtls_md_get_type             its_enc_mbedtls_md_get_type
+#define mbedtls_md_get_name             its_enc_mbedtls_md_get_name
+#define mbedtls_md_hmac_starts          its_enc_mbedtls_md_hmac_starts
+#define mbedtls_md_hmac_update          its_enc_mbedtls_md_hmac_update
+#define mbedtls_md_hmac_finish          its_enc_mbedtls_md_hmac_finish
+#define mbedtls_md_hmac_reset           its_enc_mbedtls_md_hmac_reset
+#define mbedtls_md_hmac                 its_enc_mbedtls_md_hmac
+#define mbedtls_md_process              its_enc_mbedtls_md_process
+#define mbedtls_sha256_info             its_enc_mbedtls_sha256_info
+#define mbedtls_sha256_init             its_enc_mbedtls_sha256_init
+#define mbedtls_sha256_free             its_enc_mbedtls_sha256_free
+#define mbedtls_sha256_clone            its_enc_mbedtls_sha256_clone
+#define mbedtls_sha256_starts           its_enc_mbedtls_sha256_starts
+#define mbedtls_internal_sha256_process its_enc_mbedtls_internal_sha256_process
+#define mbedtls_sha256_update           its_enc_mbedtls_sha256_update
+#define mbedtls_sha256_finish           its_enc_mbedtls_sha256_finish
+#define mbedtls_sha256                  its_enc_mbedtls_sha256
+#define mbedtls_hkdf                    its_enc_mbedtls_hkdf
+#define mbedtls_hkdf_extract            its_enc_mbedtls_hkdf_extract
+#define mbedtls_hkdf_expand             its_enc_mbedtls_hkdf_expand
+
+/* platform.c, platform_util.c and memory_buffer_alloc.c */
+#define mbedtls_calloc                  its_enc_mbedtls_calloc
+#define mbedtls_free                    its_enc_mbedtls_free
+#define mbedtls_calloc_func             its_enc_mbedtls_calloc_func
+#define mbedtls_free_func               its_enc_mbedtls_free_func
+#define mbedtls_platform_set_calloc_free \
+                                        its_enc_mbedtls_platform_set_calloc_free
+#define mbedtls_platform_setup          its_enc_mbedtls_platform_setup
+#define mbedtls_platform_teardown       its_enc_mbedtls_platform_teardown
+#define mbedtls_platform_zeroize        its_enc_mbedtls_platform_zeroize
+#define memset_func                     its_enc_memset_func
+#define mbedtls_memory_buffer_alloc_init \
+                                        its_enc_mbedtls_memory_buffer_alloc_init
+#define mbedtls_memory_buffer_alloc_free \
+                                        its_enc_mbedtls_memory_buffer_alloc_free
+#define mbedtls_memory_buffer_alloc_verify \
+                                        its_enc_mbedtls_memory_buffer_alloc_verify
+#define mbedtls_memory_buffer_set_verify \
+                                        its_enc_mbedtls_memory_buffer_set_verify
+
+#include "mbedtls/check_config.h"
+
+#endif /* __ITS_ENC_MBEDCRYPTO_CONFIG_H__ */
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * The default implementation of the ITS encryption HAL, based on Mbed Crypto.
+ * Each file is encrypted with its own key, derived from the HUK with the
+ * derivation label of the file. The key context of the last file is kept, so
+ * that consecutive operations on the same file skip the key derivation and
+ * the key schedule.
+ *
+ * The HAL runs in the ITS partition, so it is built on a private instance of
+ * Mbed Crypto, configured by its_enc_mbedcrypto_config.h, with its own
+ * allocator. It shares no state with the Crypto partition.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "tfm_hal_its.h"
+#include "mbedtls/memory_buffer_alloc.h"
+
+#ifdef CRYPTO_HW_ACCELERATOR
+#include "tfm_plat_crypto_keys.h"
+#else
+#include "tfm_plat_otp.h"
+#include "mbedtls/hkdf.h"
+#endif /* CRYPTO_HW_ACCELERATOR */
+
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+#include "mbedtls/ccm.h"
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+#include "mbedtls/gcm.h"
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_CHACHA20_POLY1305)
+#include "mbedtls/chachapoly.h"
+#else
+#error "No AEAD algorithm is selected for the ITS encryption"
+#endif
+
+/*
+ * The nonce is made of a seed taken once per boot and of a counter. Without the
+ * entropy source of a hardware accelerator the seed is constant, which is only safe when the
+ * files do not survive a reset.
+ */
+#if !defined(CRYPTO_HW_ACCELERATOR) && !defined(ITS_RAM_FS)
+#error "The default ITS encryption requires a hardware entropy source, or ITS_RAM_FS"
+#endif
+
+#define ITS_ENC_NONCE_SIZE          12
+#define ITS_ENC_KEY_SIZE            32
+#define ITS_ENC_DERIV_LABEL_MAX     32
+#define ITS_ENC_HUK_SIZE            32
+
+/*
+ * Size of the heap of the private Mbed Crypto instance. It holds the cipher
+ * context of the cached key, and the HMAC contexts during a key derivation.
+ */
+#define ITS_ENC_HEAP_SIZE           1024
+
+/* The label of the HUK derivation, the file label is used as its context */
+#define ITS_ENC_KEY_LABEL           "ITS_ENC_KEY"
+
+#if (TFM_ITS_ENC_NONCE_LENGTH != ITS_ENC_NONCE_SIZE)
+#error "The default ITS encryption requires TFM_ITS_ENC_NONCE_LENGTH to be 12"
+#endif
+
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+typedef mbedtls_ccm_context its_enc_aead_ctx_t;
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+typedef mbedtls_gcm_context its_enc_aead_ctx_t;
+#else
+typedef mbedtls_chachapoly_context its_enc_aead_ctx_t;
+#endif
+
+/* The key context of the last file */
+static struct {
+    bool valid;
+    uint8_t deriv_label[ITS_ENC_DERIV_LABEL_MAX];
+    size_t deriv_label_size;
+    its_enc_aead_ctx_t aead;
+} g_key_cache;
+
+/* Global encryption counter which resets per boot. The counter ensures that
+ * the nonce will not be identical for consecutive file writes during the same
+ * boot.
+ */
+static uint32_t g_enc_counter;
+
+/* The seed of the nonces, taken on the first encryption of each boot */
+static uint8_t g_enc_nonce_seed[ITS_ENC_NONCE_SIZE - sizeof(g_enc_counter)];
+static bool g_enc_nonce_seeded;
+
+/* The heap of the private Mbed Crypto instance, set up on the first key */
+static uint8_t g_mbedcrypto_heap[ITS_ENC_HEAP_SIZE];
+static bool g_mbedcrypto_heap_ready;
+
+#ifdef CRYPTO_HW_ACCELERATOR
+/* The entropy source of the hardware accelerator */
+int mbedtls_hardware_poll(void *data, unsigned char *output, size_t len,
+                          size_t *olen);
+#endif
+
+static enum tfm_hal_status_t its_enc_seed_nonce(void)
+{
+#ifdef CRYPTO_HW_ACCELERATOR
+    size_t olen = 0;
+
+    if (mbedtls_hardware_poll(NULL, g_enc_nonce_seed, sizeof(g_enc_nonce_seed),
+                              &olen) != 0 ||
+        olen != sizeof(g_enc_nonce_seed)) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+#else
+    memset(g_enc_nonce_seed, 0, sizeof(g_enc_nonce_seed));
+#endif
+
+    g_enc_nonce_seeded = true;
+
+    return TFM_HAL_SUCCESS;
+}
+
+/*
+ * Derives the key of a file from the HUK. The hardware accelerator derives it
+ * itself, otherwise the HUK is read and the key derived by HKDF-SHA256 on the
+ * private Mbed Crypto instance, as the default tfm_plat_get_huk_derived_key()
+ * does on the one of the Crypto partition.
+ */
+static enum tfm_hal_status_t its_enc_derive_key(const uint8_t *context,
+                                                size_t context_size,
+                                                uint8_t *key, size_t key_size)
+{
+#ifdef CRYPTO_HW_ACCELERATOR
+    if (tfm_plat_get_huk_derived_key((const uint8_t *)ITS_ENC_KEY_LABEL,
+                                     sizeof(ITS_ENC_KEY_LABEL) - 1,
+                                     context, context_size,
+                                     key, key_size) != TFM_PLAT_ERR_SUCCESS) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    return TFM_HAL_SUCCESS;
+#else
+    uint8_t huk[ITS_ENC_HUK_SIZE];
+    enum tfm_hal_status_t err = TFM_HAL_SUCCESS;
+
+    if (tfm_plat_otp_read(PLAT_OTP_ID_HUK, sizeof(huk),
+                          huk) != TFM_PLAT_ERR_SUCCESS) {
+        err = TFM_HAL_ERROR_GENERIC;
+        goto out;
+    }
+
+    if (mbedtls_hkdf(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                     (const uint8_t *)ITS_ENC_KEY_LABEL,
+                     sizeof(ITS_ENC_KEY_LABEL) - 1, huk, sizeof(huk),
+                     context, context_size, key, key_size) != 0) {
+        err = TFM_HAL_ERROR_GENERIC;
+    }
+
+out:
+    memset(huk, 0, sizeof(huk));
+
+    return err;
+#endif /* CRYPTO_HW_ACCELERATOR */
+}
+
+static void its_enc_aead_init(its_enc_aead_ctx_t *aead)
+{
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+    mbedtls_ccm_init(aead);
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+    mbedtls_gcm_init(aead);
+#else
+    mbedtls_chachapoly_init(aead);
+#endif
+}
+
+static void its_enc_aead_free(its_enc_aead_ctx_t *aead)
+{
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+    mbedtls_ccm_free(aead);
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+    mbedtls_gcm_free(aead);
+#else
+    mbedtls_chachapoly_free(aead);
+#endif
+}
+
+static int its_enc_aead_setkey(its_enc_aead_ctx_t *aead, const uint8_t *key)
+{
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+    return mbedtls_ccm_setkey(aead, MBEDTLS_CIPHER_ID_AES, key,
+                              ITS_ENC_KEY_SIZE * 8);
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+    return mbedtls_gcm_setkey(aead, MBEDTLS_CIPHER_ID_AES, key,
+                              ITS_ENC_KEY_SIZE * 8);
+#else
+    return mbedtls_chachapoly_setkey(aead, key);
+#endif
+}
+
+/*
+ * Returns the key context of the file, from the cache when the label is the
+ * one of the last file, or derived from the HUK otherwise.
+ */
+static enum tfm_hal_status_t its_enc_get_key(
+                                         struct tfm_hal_its_auth_crypt_ctx *ctx,
+                                         its_enc_aead_ctx_t **aead)
+{
+    uint8_t key[ITS_ENC_KEY_SIZE];
+    enum tfm_hal_status_t hal_err;
+    int err;
+
+    if (ctx->deriv_label_size > ITS_ENC_DERIV_LABEL_MAX) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    if (g_key_cache.valid &&
+        g_key_cache.deriv_label_size == ctx->deriv_label_size &&
+        memcmp(g_key_cache.deriv_label, ctx->deriv_label,
+               ctx->deriv_label_size) == 0) {
+        *aead = &g_key_cache.aead;
+        return TFM_HAL_SUCCESS;
+    }
+
+    if (!g_mbedcrypto_heap_ready) {
+        mbedtls_memory_buffer_alloc_init(g_mbedcrypto_heap,
+                                         sizeof(g_mbedcrypto_heap));
+        g_mbedcrypto_heap_ready = true;
+    }
+
+    if (g_key_cache.valid) {
+        its_enc_aead_free(&g_key_cache.aead);
+        g_key_cache.valid = false;
+    }
+
+    hal_err = its_enc_derive_key(ctx->deriv_label, ctx->deriv_label_size,
+                                 key, sizeof(key));
+    if (hal_err != TFM_HAL_SUCCESS) {
+        memset(key, 0, sizeof(key));
+        return hal_err;
+    }
+
+    its_enc_aead_init(&g_key_cache.aead);
+    err = its_enc_aead_setkey(&g_key_cache.aead, key);
+    memset(key, 0, sizeof(key));
+    if (err != 0) {
+        its_enc_aead_free(&g_key_cache.aead);
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    memcpy(g_key_cache.deriv_label, ctx->deriv_label, ctx->deriv_label_size);
+    g_key_cache.deriv_label_size = ctx->deriv_label_size;
+    g_key_cache.valid = true;
+
+    *aead = &g_key_cache.aead;
+
+    return TFM_HAL_SUCCESS;
+}
+
+static bool ctx_is_valid(struct tfm_hal_its_auth_crypt_ctx *ctx)
+{
+    if (ctx == NULL) {
+        return false;
+    }
+
+    if ((ctx->deriv_label == NULL && ctx->deriv_label_size != 0) ||
+        (ctx->add == NULL && ctx->add_size != 0) ||
+        (ctx->nonce == NULL) || (ctx->nonce_size != ITS_ENC_NONCE_SIZE)) {
+        return false;
+    }
+
+    return true;
+}
+
+enum tfm_hal_status_t tfm_hal_its_aead_generate_nonce(uint8_t *nonce,
+                                                      size_t nonce_size)
+{
+    enum tfm_hal_status_t err;
+
+    if (nonce == NULL || nonce_size < ITS_ENC_NONCE_SIZE) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    if (!g_enc_nonce_seeded) {
+        err = its_enc_seed_nonce();
+        if (err != TFM_HAL_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* A nonce must never be reused within a boot */
+    if (g_enc_counter == UINT32_MAX) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    memcpy(nonce, g_enc_nonce_seed, sizeof(g_enc_nonce_seed));
+    memcpy(nonce + sizeof(g_enc_nonce_seed), &g_enc_counter,
+           sizeof(g_enc_counter));
+
+    g_enc_counter++;
+
+    return TFM_HAL_SUCCESS;
+}
+
+enum tfm_hal_status_t tfm_hal_its_aead_set_deriv_label(
+                                         struct tfm_hal_its_auth_crypt_ctx *ctx,
+                                         uint8_t *deriv_label,
+                                         size_t deriv_label_size)
+{
+    if (ctx == NULL || deriv_label == NULL ||
+        deriv_label_size > ITS_ENC_DERIV_LABEL_MAX) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    ctx->deriv_label = deriv_label;
+    ctx->deriv_label_size = deriv_label_size;
+
+    return TFM_HAL_SUCCESS;
+}
+
+enum tfm_hal_status_t tfm_hal_its_aead_set_nonce(
+                                         struct tfm_hal_its_auth_crypt_ctx *ctx,
+                                         uint8_t *nonce,
+                                         size_t nonce_size)
+{
+    if (ctx == NULL || nonce == NULL || nonce_size != ITS_ENC_NONCE_SIZE) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    ctx->nonce = nonce;
+    ctx->nonce_size = nonce_size;
+
+    return TFM_HAL_SUCCESS;
+}
+
+enum tfm_hal_status_t tfm_hal_its_aead_set_add(
+                                         struct tfm_hal_its_auth_crypt_ctx *ctx,
+                                         uint8_t *add,
+                                         size_t add_size)
+{
+    if (ctx == NULL || (add == NULL && add_size != 0)) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    ctx->add = add;
+    ctx->add_size = add_size;
+
+    return TFM_HAL_SUCCESS;
+}
+
+enum tfm_hal_status_t tfm_hal_its_aead_encrypt(
+                                         struct tfm_hal_its_auth_crypt_ctx *ctx,
+                                         uint8_t *plaintext,
+                                         size_t plaintext_size,
+                                         uint8_t *ciphertext,
+                                         size_t ciphertext_size,
+                                         uint8_t *tag,
+                                         size_t tag_size)
+{
+    its_enc_aead_ctx_t *aead;
+    enum tfm_hal_status_t err;
+    int mbedtls_err;
+
+    if (!ctx_is_valid(ctx) || tag == NULL) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    if (plaintext_size > ciphertext_size) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    err = its_enc_get_key(ctx, &aead);
+    if (err != TFM_HAL_SUCCESS) {
+        return err;
+    }
+
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+    mbedtls_err = mbedtls_ccm_encrypt_and_tag(aead, plaintext_size,
+                                              ctx->nonce, ctx->nonce_size,
+                                              ctx->add, ctx->add_size,
+                                              plaintext, ciphertext,
+                                              tag, tag_size);
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+    mbedtls_err = mbedtls_gcm_crypt_and_tag(aead, MBEDTLS_GCM_ENCRYPT,
+                                            plaintext_size,
+                                            ctx->nonce, ctx->nonce_size,
+                                            ctx->add, ctx->add_size,
+                                            plaintext, ciphertext,
+                                            tag_size, tag);
+#else
+    if (tag_size != 16) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+    mbedtls_err = mbedtls_chachapoly_encrypt_and_tag(aead, plaintext_size,
+                                                     ctx->nonce,
+                                                     ctx->add, ctx->add_size,
+                                                     plaintext, ciphertext,
+                                                     tag);
+#endif
+
+    if (mbedtls_err != 0) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    return TFM_HAL_SUCCESS;
+}
+
+enum tfm_hal_status_t tfm_hal_its_aead_decrypt(
+                                         struct tfm_hal_its_auth_crypt_ctx *ctx,
+                                         uint8_t *ciphertext,
+                                         size_t ciphertext_size,
+                                         uint8_t *tag,
+                                         size_t tag_size,
+                                         uint8_t *plaintext,
+                                         size_t plaintext_size)
+{
+    its_enc_aead_ctx_t *aead;
+    enum tfm_hal_status_t err;
+    int mbedtls_err;
+
+    if (!ctx_is_valid(ctx) || tag == NULL) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    if (plaintext_size < ciphertext_size) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+
+    err = its_enc_get_key(ctx, &aead);
+    if (err != TFM_HAL_SUCCESS) {
+        return err;
+    }
+
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+    mbedtls_err = mbedtls_ccm_auth_decrypt(aead, ciphertext_size,
+                                           ctx->nonce, ctx->nonce_size,
+                                           ctx->add, ctx->add_size,
+                                           ciphertext, plaintext,
+                                           tag, tag_size);
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+    mbedtls_err = mbedtls_gcm_auth_decrypt(aead, ciphertext_size,
+                                           ctx->nonce, ctx->nonce_size,
+                                           ctx->add, ctx->add_size,
+                                           tag, tag_size,
+                                           ciphertext, plaintext);
+#else
+    if (tag_size != 16) {
+        return TFM_HAL_ERROR_INVALID_INPUT;
+    }
+    mbedtls_err = mbedtls_chachapoly_auth_decrypt(aead, ciphertext_size,
+                                                  ctx->nonce,
+                                                  ctx->add, ctx->add_size,
+                                                  tag, ciphertext, plaintext);
+#endif
+
+    if (mbedtls_err != 0) {
+        return TFM_HAL_ERROR_GENERIC;
+    }
+
+    return TFM_HAL_SUCCESS;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_ITS_ENCRYPTION_H__
+#define __TFM_HAL_ITS_ENCRYPTION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Struct containing information required from the platform to perform
+ *        encryption/decryption of ITS files.
+ */
+struct tfm_hal_its_auth_crypt_ctx {
+    uint8_t *deriv_label;    /* The derivation label for AEAD */
+    size_t deriv_label_size; /* Size of the deriv_label in bytes */
+    uint8_t *add;            /* The additional authenticated data for AEAD */
+    size_t add_size;         /* Size of the add in bytes */
+    uint8_t *nonce;          /* The nonce for AEAD */
+    size_t nonce_size;       /* Size of the nonce in bytes */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TFM_HAL_ITS_ENCRYPTION_H__ */
@@ -5,10 +5,160 @@
  *
  */
 
+#include <stdbool.h>
+
 #include "cmsis.h"
 #include "tfm_hal_platform.h"
+#include "tfm_hal_timer.h"
 
 __WEAK void tfm_hal_system_reset(void)
 {
     NVIC_SystemReset();
 }
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk) && defined(CONFIG_TFM_SPM_CPU_STATS)
+/* Period of the SysTick, with the reload value set by systick_timestamp() */
+#define SYSTICK_PERIOD      (SysTick_LOAD_RELOAD_Msk + 1U)
+
+/* SysTick periods elapsed, in ticks */
+static volatile uint32_t systick_high_count;
+
+/* Whether SysTick was enabled by systick_timestamp() */
+static volatile bool systick_owned;
+
+/*
+ * Counts the SysTick wraps, so that the CPU time accounting stays right
+ * however long the timestamps are not read for. A platform which uses SysTick
+ * itself overrides this handler.
+ */
+__WEAK void SysTick_Handler(void)
+{
+    if (systick_owned) {
+        systick_high_count += SYSTICK_PERIOD;
+    }
+}
+
+/*
+ * Counts the processor cycles with the 24-bit SysTick, extended to 32 bits by
+ * its interrupt. SysTick is only taken if it is not enabled yet, otherwise it
+ * belongs to the platform and no timestamp is given.
+ */
+static uint32_t systick_timestamp(void)
+{
+    uint32_t primask, count, high_count;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if ((SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) == 0) {
+        NVIC_SetPriority(SysTick_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+        SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+        SysTick->VAL = 0;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk |
+                        SysTick_CTRL_TICKINT_Msk |
+                        SysTick_CTRL_ENABLE_Msk;
+        systick_owned = true;
+    }
+
+    if (!systick_owned) {
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    /* SysTick counts down */
+    high_count = systick_high_count;
+    count = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+
+    /*
+     * The interrupt of a wrap is pending while the interrupts are disabled,
+     * or when called from a higher priority exception. Read the count again,
+     * as it may have been read just before the wrap.
+     */
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0) {
+        high_count += SYSTICK_PERIOD;
+        count = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+    }
+
+    __set_PRIMASK(primask);
+
+    return high_count + count;
+}
+#endif
+
+__WEAK uint32_t tfm_hal_get_timestamp(void)
+{
+#ifdef DWT_CTRL_CYCCNTENA_Msk
+    /* The DWT and SysTick registers can only be accessed from privileged code */
+    if ((__get_IPSR() == 0) && ((__get_CONTROL() & 1U) != 0)) {
+        return 0;
+    }
+
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        /* The cycle counter is not implemented, such as on QEMU */
+        if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+#ifdef CONFIG_TFM_SPM_CPU_STATS
+            return systick_timestamp();
+#else
+            return 0;
+#endif
+        }
+    }
+
+    return DWT->CYCCNT;
+#else
+    return 0;
+#endif
+}
+
+/* A single sleep state, entered with WFI */
+static const struct tfm_hal_sleep_state_t default_sleep_states[] = {
+    {
+        .entry_latency = 0,
+        .exit_latency  = 0,
+        .min_residency = 0,
+    },
+};
+
+__WEAK const struct tfm_hal_sleep_state_t *tfm_hal_get_sleep_states(
+                                                        uint32_t *num_states)
+{
+    *num_states = sizeof(default_sleep_states) /
+                  sizeof(default_sleep_states[0]);
+
+    return default_sleep_states;
+}
+
+__WEAK void tfm_hal_sleep(uint32_t state)
+{
+    (void)state;
+
+    __DSB();
+    __WFI();
+}
+
+__WEAK enum tfm_hal_status_t tfm_hal_timer_start(uint32_t ticks)
+{
+    (void)ticks;
+
+    return TFM_HAL_ERROR_NOT_SUPPORTED;
+}
+
+__WEAK uint32_t tfm_hal_timer_elapsed(void)
+{
+    return 0;
+}
+
+__WEAK enum tfm_hal_status_t tfm_hal_timer_get_remaining(uint32_t *ticks)
+{
+    (void)ticks;
+
+    return TFM_HAL_ERROR_NOT_SUPPORTED;
+}
+
+__WEAK void tfm_hal_timer_stop(void)
+{
+}
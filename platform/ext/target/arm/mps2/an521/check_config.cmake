@@ -0,0 +1,9 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2021, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+## TIMER1 is either the secure timer of SPM or the timer of the NS tests
+tfm_invalid_config(CONFIG_TFM_SPM_TIMER AND TFM_NS_REG_TEST)
@@ -26,6 +26,16 @@
 #define ARG_UNUSED(arg)  ((void)arg)
 #endif
 
+/*
+ * Number of busy-wait iterations spent in each sector erase, to model the
+ * duration of a real flash sector erase when running on an emulator, for
+ * instance to measure the latency impact of erases on the storage services.
+ * The default of 0 keeps the emulated erases instantaneous.
+ */
+#ifndef FLASH_EMU_SECTOR_ERASE_DELAY
+#define FLASH_EMU_SECTOR_ERASE_DELAY 0
+#endif
+
 /* Driver version */
 #define ARM_FLASH_DRV_VERSION      ARM_DRIVER_VERSION_MAJOR_MINOR(1, 1)
 #define ARM_FLASH_DRV_ERASE_VALUE  0xFF
@@ -216,6 +226,7 @@ static int32_t ARM_Flash_EraseSector(uint32_t addr)
 {
     uint32_t start_addr = FLASH0_DEV->memory_base + addr;
     uint32_t rc = 0;
+    volatile uint32_t delay;
 
     rc  = is_range_valid(FLASH0_DEV, addr);
     rc |= is_sector_aligned(FLASH0_DEV, addr);
@@ -227,6 +238,13 @@ static int32_t ARM_Flash_EraseSector(uint32_t addr)
     memset((void *)start_addr,
            FLASH0_DEV->data->erased_value,
            FLASH0_DEV->data->sector_size);
+
+    /* Model the erase duration, during which the flash is busy */
+    FlashStatus.busy = 1;
+    for (delay = 0; delay < FLASH_EMU_SECTOR_ERASE_DELAY; delay++) {
+    }
+    FlashStatus.busy = 0;
+
     return ARM_DRIVER_OK;
 }
 
@@ -464,7 +464,11 @@ void ppc_init_cfg(void)
      * (timer0 and 1, dualtimer, watchdog, mhu 0 and 1)
      */
      spctrl->apbnsppc0 |= (1U << CMSDK_TIMER0_APB_PPC_POS) |
+#ifdef CONFIG_TFM_SPM_TIMER
+    /* TIMER1 is the secure timer of SPM, so it is kept secure */
+#else
                           (1U << CMSDK_TIMER1_APB_PPC_POS) |
+#endif
                           (1U << CMSDK_DTIMER_APB_PPC_POS) |
                           (1U << CMSDK_MHU0_APB_PPC_POS) |
                           (1U << CMSDK_MHU1_APB_PPC_POS);
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "cmsis.h"
+#include "platform_retarget_dev.h"
+#include "tfm_hal_timer.h"
+#include "tfm_peripherals_def.h"
+#include "timer_cmsdk.h"
+#include "ffm/spm_timer.h"
+
+/*
+ * TIMER1 is the secure timer. It runs from the system clock, at the rate of
+ * the DWT cycle counter used for the timestamps.
+ */
+#define SECURE_TIMER_DEV                CMSDK_TIMER1_DEV_S
+#define SECURE_TIMER_IRQ                TIMER1_IRQn
+
+void TIMER1_Handler(void)
+{
+    cmsdk_timer_disable(&SECURE_TIMER_DEV);
+    cmsdk_timer_clear_interrupt(&SECURE_TIMER_DEV);
+    NVIC_ClearPendingIRQ(SECURE_TIMER_IRQ);
+
+    spm_timer_expired();
+}
+
+enum tfm_hal_status_t tfm_hal_timer_start(uint32_t ticks)
+{
+    if (!cmsdk_timer_is_initialized(&SECURE_TIMER_DEV)) {
+        cmsdk_timer_init(&SECURE_TIMER_DEV);
+        cmsdk_timer_set_clock_to_internal(&SECURE_TIMER_DEV);
+
+        NVIC_SetPriority(SECURE_TIMER_IRQ, DEFAULT_IRQ_PRIORITY);
+        NVIC_ClearTargetState(SECURE_TIMER_IRQ);
+        NVIC_EnableIRQ(SECURE_TIMER_IRQ);
+    }
+
+    cmsdk_timer_disable(&SECURE_TIMER_DEV);
+    cmsdk_timer_clear_interrupt(&SECURE_TIMER_DEV);
+    NVIC_ClearPendingIRQ(SECURE_TIMER_IRQ);
+
+    /* The 32-bit counter covers every timeout SPM requests */
+    cmsdk_timer_set_reload_value(&SECURE_TIMER_DEV, ticks);
+    cmsdk_timer_reset(&SECURE_TIMER_DEV);
+    cmsdk_timer_enable_interrupt(&SECURE_TIMER_DEV);
+    cmsdk_timer_enable(&SECURE_TIMER_DEV);
+
+    return TFM_HAL_SUCCESS;
+}
+
+uint32_t tfm_hal_timer_elapsed(void)
+{
+    /* The counter reloads on expiry, the elapsed time saturates instead */
+    if (!cmsdk_timer_is_enabled(&SECURE_TIMER_DEV) ||
+        cmsdk_timer_is_interrupt_active(&SECURE_TIMER_DEV)) {
+        return cmsdk_timer_get_reload_value(&SECURE_TIMER_DEV);
+    }
+
+    return cmsdk_timer_get_elapsed_value(&SECURE_TIMER_DEV);
+}
+
+enum tfm_hal_status_t tfm_hal_timer_get_remaining(uint32_t *ticks)
+{
+    if (!cmsdk_timer_is_initialized(&SECURE_TIMER_DEV) ||
+        !cmsdk_timer_is_enabled(&SECURE_TIMER_DEV)) {
+        return TFM_HAL_ERROR_BAD_STATE;
+    }
+
+    if (cmsdk_timer_is_interrupt_active(&SECURE_TIMER_DEV)) {
+        *ticks = 0;
+    } else {
+        /* The counter counts down to 0 from the reload value */
+        *ticks = cmsdk_timer_get_current_value(&SECURE_TIMER_DEV);
+    }
+
+    return TFM_HAL_SUCCESS;
+}
+
+void tfm_hal_timer_stop(void)
+{
+    if (!cmsdk_timer_is_initialized(&SECURE_TIMER_DEV)) {
+        return;
+    }
+
+    cmsdk_timer_disable(&SECURE_TIMER_DEV);
+    cmsdk_timer_disable_interrupt(&SECURE_TIMER_DEV);
+    cmsdk_timer_clear_interrupt(&SECURE_TIMER_DEV);
+    NVIC_ClearPendingIRQ(SECURE_TIMER_IRQ);
+}
@@ -13,4 +13,4 @@
 # Set architecture and CPU
 set(TFM_SYSTEM_PROCESSOR cortex-m55)
 set(TFM_SYSTEM_ARCHITECTURE armv8.1-m.main)
-set(TFM_SYSTEM_MVE OFF)
+set(TFM_SYSTEM_MVE OFF CACHE BOOL "Whether to use the M-profile Vector Extension")
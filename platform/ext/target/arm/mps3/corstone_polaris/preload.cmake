@@ -12,4 +12,4 @@
 
 # Set architecture
 set(TFM_SYSTEM_ARCHITECTURE armv8.1-m.main)
-set(TFM_SYSTEM_MVE OFF)
+set(TFM_SYSTEM_MVE OFF CACHE BOOL "Whether to use the M-profile Vector Extension")
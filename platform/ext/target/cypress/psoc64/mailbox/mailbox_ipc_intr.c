@@ -37,12 +37,9 @@ static void mailbox_clear_intr(void)
 
 void NvicMux7_IRQHandler(void)
 {
-    uint32_t magic;
-
     mailbox_clear_intr();
 
-    platform_mailbox_fetch_msg_data(&magic);
-    if (magic == PSA_CLIENT_CALL_REQ_MAGIC) {
+    if (platform_mailbox_doorbell_rung()) {
         tfm_trigger_pendsv();
     }
 }
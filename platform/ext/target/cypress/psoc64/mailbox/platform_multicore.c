@@ -12,12 +12,28 @@
 
 #include "cy_ipc_drv.h"
 #include "cy_sysint.h"
+#include "cy_syslib.h"
 #if CY_SYSTEM_CPU_CM0P
 #include "spe_ipc_config.h"
 #else
 #include "ns_ipc_config.h"
 #endif
 
+static struct platform_mailbox_stats_t mailbox_stats;
+
+/* Last value written to the doorbell word of the current core */
+static uint32_t doorbell_sent;
+/* Last value read from the doorbell word of the peer core */
+static uint32_t doorbell_seen;
+
+/* Wakes up the peer core if it waits for a notify event in WFE */
+static void mailbox_wake_peer(void)
+{
+    /* Make sure the notify event is set before the peer core wakes up */
+    __DSB();
+    __SEV();
+}
+
 int platform_mailbox_fetch_msg_ptr(void **msg_ptr)
 {
     cy_en_ipcdrv_status_t status;
@@ -69,6 +85,8 @@ int platform_mailbox_send_msg_ptr(const void *msg_ptr)
         return PLATFORM_MAILBOX_TX_ERROR;
     }
 
+    mailbox_wake_peer();
+
     return PLATFORM_MAILBOX_SUCCESS;
 }
 
@@ -82,6 +100,8 @@ int platform_mailbox_send_msg_data(uint32_t data)
         return PLATFORM_MAILBOX_TX_ERROR;
     }
 
+    mailbox_wake_peer();
+
     return PLATFORM_MAILBOX_SUCCESS;
 }
 
@@ -89,6 +109,8 @@ void platform_mailbox_wait_for_notify(void)
 {
     uint32_t status;
 
+    mailbox_stats.notify_waits++;
+
     while (1) {
         status = Cy_IPC_Drv_GetInterruptStatusMasked(
                             Cy_IPC_Drv_GetIntrBaseAddr(IPC_RX_INTR_STRUCT));
@@ -96,12 +118,121 @@ void platform_mailbox_wait_for_notify(void)
         if (status & IPC_RX_INT_MASK) {
             break;
         }
+
+        /*
+         * The peer core executes SEV after setting the notify event. If it
+         * did so since the check above, the event register is already set and
+         * WFE returns immediately.
+         */
+        __WFE();
+        mailbox_stats.notify_wfes++;
     }
 
     Cy_IPC_Drv_ClearInterrupt(Cy_IPC_Drv_GetIntrBaseAddr(IPC_RX_INTR_STRUCT),
                               0, IPC_RX_INT_MASK);
 }
 
+void platform_mailbox_ring_doorbell(void)
+{
+    IPC_STRUCT_Type *ipc_struct =
+        Cy_IPC_Drv_GetIpcBaseAddress(IPC_TX_DOORBELL_CHAN);
+    uint32_t saved_irq_state;
+
+    /*
+     * Only the current core writes its doorbell word, so the IPC channel is
+     * never locked. The local critical section keeps the increments of two
+     * threads of the current core apart.
+     */
+    saved_irq_state = Cy_SysLib_EnterCriticalSection();
+    doorbell_sent++;
+    Cy_IPC_Drv_WriteDataValue(ipc_struct, doorbell_sent);
+    mailbox_stats.doorbell_rings++;
+    Cy_SysLib_ExitCriticalSection(saved_irq_state);
+
+    /* Make sure the doorbell word is written before the notify event */
+    __DSB();
+    Cy_IPC_Drv_AcquireNotify(ipc_struct, IPC_TX_NOTIFY_MASK);
+
+    mailbox_wake_peer();
+}
+
+bool platform_mailbox_doorbell_rung(void)
+{
+    uint32_t doorbell;
+
+    doorbell = Cy_IPC_Drv_ReadDataValue(
+                        Cy_IPC_Drv_GetIpcBaseAddress(IPC_RX_DOORBELL_CHAN));
+    if (doorbell == doorbell_seen) {
+        return false;
+    }
+
+    doorbell_seen = doorbell;
+    return true;
+}
+
+void platform_mailbox_lock_acquire(void)
+{
+    IPC_STRUCT_Type *ipc_struct =
+        Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN);
+    IPC_INTR_STRUCT_Type *intr_struct =
+        Cy_IPC_Drv_GetIntrBaseAddr(IPC_RX_INTR_STRUCT);
+    uint32_t waits = 0;
+    uint32_t wfes = 0;
+
+    while (1) {
+        /*
+         * Drop the release events raised before this attempt. A release after
+         * the attempt below fails leaves its event pending, so that the wait
+         * below does not miss it.
+         */
+        Cy_IPC_Drv_ClearInterrupt(intr_struct,
+                                  IPC_PSA_MAILBOX_LOCK_RELEASE_MASK, 0);
+
+        if (Cy_IPC_Drv_LockAcquire(ipc_struct) == CY_IPC_DRV_SUCCESS) {
+            break;
+        }
+
+        waits++;
+
+        /*
+         * Sleep until the peer core releases the lock. It raises the release
+         * event before executing SEV. If it did so since the check below, the
+         * event register is already set and WFE returns immediately.
+         */
+        while ((Cy_IPC_Drv_GetInterruptStatus(intr_struct) &
+                IPC_PSA_MAILBOX_LOCK_RELEASE_MASK) == 0) {
+            __WFE();
+            wfes++;
+        }
+    }
+
+    /* The statistics are updated while the lock is held */
+    mailbox_stats.lock_acquires++;
+    if (waits != 0) {
+        mailbox_stats.lock_contended++;
+        mailbox_stats.lock_waits += waits;
+        mailbox_stats.lock_wfes += wfes;
+        if (waits > mailbox_stats.lock_max_waits) {
+            mailbox_stats.lock_max_waits = waits;
+        }
+    }
+}
+
+void platform_mailbox_lock_release(void)
+{
+    /* Raise the release event in the IPC interrupt structure of the peer */
+    Cy_IPC_Drv_LockRelease(
+                    Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN),
+                    IPC_TX_NOTIFY_MASK);
+
+    mailbox_wake_peer();
+}
+
+void platform_mailbox_get_stats(struct platform_mailbox_stats_t *stats)
+{
+    *stats = mailbox_stats;
+}
+
 static int platform_ns_ipc_init(void)
 {
     Cy_IPC_Drv_SetInterruptMask(Cy_IPC_Drv_GetIntrBaseAddr(IPC_RX_INTR_STRUCT),
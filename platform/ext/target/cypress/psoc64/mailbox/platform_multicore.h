@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
  * Copyright (c) 2019, 2021, Cypress Semiconductor Corporation. All rights reserved
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -9,30 +9,38 @@
 #ifndef _TFM_PLATFORM_MULTICORE_
 #define _TFM_PLATFORM_MULTICORE_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "cy_device_headers.h"
 
 #define IPC_PSA_CLIENT_CALL_CHAN         (8)
+#define IPC_PSA_CLIENT_CALL_DOORBELL_CHAN (11)
 #define IPC_PSA_CLIENT_CALL_INTR_STRUCT  (6)
-#define IPC_PSA_CLIENT_CALL_INTR_MASK    (1 << IPC_PSA_CLIENT_CALL_CHAN)
+#define IPC_PSA_CLIENT_CALL_INTR_MASK    \
+            ((1 << IPC_PSA_CLIENT_CALL_CHAN) | \
+             (1 << IPC_PSA_CLIENT_CALL_DOORBELL_CHAN))
 #define IPC_PSA_CLIENT_CALL_NOTIFY_MASK  (1 << IPC_PSA_CLIENT_CALL_INTR_STRUCT)
 #define IPC_PSA_CLIENT_CALL_IPC_INTR     cpuss_interrupts_ipc_6_IRQn
 
 #define IPC_PSA_CLIENT_REPLY_CHAN        (9)
+#define IPC_PSA_CLIENT_REPLY_DOORBELL_CHAN (12)
 #define IPC_PSA_CLIENT_REPLY_INTR_STRUCT (8)
-#define IPC_PSA_CLIENT_REPLY_INTR_MASK   (1 << IPC_PSA_CLIENT_REPLY_CHAN)
+#define IPC_PSA_CLIENT_REPLY_INTR_MASK   \
+            ((1 << IPC_PSA_CLIENT_REPLY_CHAN) | \
+             (1 << IPC_PSA_CLIENT_REPLY_DOORBELL_CHAN))
 #define IPC_PSA_CLIENT_REPLY_NOTIFY_MASK (1 << IPC_PSA_CLIENT_REPLY_INTR_STRUCT)
 #define IPC_PSA_CLIENT_REPLY_IPC_INTR    cpuss_interrupts_ipc_8_IRQn
 
 #define IPC_PSA_MAILBOX_LOCK_CHAN        (10)
+/* Release event of the mailbox lock, in the release bits of an IPC interrupt
+ * structure.
+ */
+#define IPC_PSA_MAILBOX_LOCK_RELEASE_MASK (1 << IPC_PSA_MAILBOX_LOCK_CHAN)
 
 #define IPC_RX_RELEASE_MASK              (0)
 
 #define CY_IPC_NOTIFY_SHIFT              (16)
 
-#define PSA_CLIENT_CALL_REQ_MAGIC        (0xA5CF50C6)
-#define PSA_CLIENT_CALL_REPLY_MAGIC      (0xC605FC5A)
-
 #define NS_MAILBOX_INIT_ENABLE           (0xAE)
 #define S_MAILBOX_READY                  (0xC3)
 
@@ -48,6 +56,20 @@
 
 #define IPC_SYNC_MAGIC                   0x7DADE011
 
+/**
+ * \brief Mailbox HAL statistics of the current core.
+ */
+struct platform_mailbox_stats_t {
+    uint32_t lock_acquires;  /*!< Number of mailbox lock acquisitions */
+    uint32_t lock_contended; /*!< Acquisitions which found the lock taken */
+    uint32_t lock_waits;     /*!< Waits for the release of the lock */
+    uint32_t lock_max_waits; /*!< Most waits of one acquisition */
+    uint32_t lock_wfes;      /*!< WFE executed while waiting for a release */
+    uint32_t notify_waits;   /*!< Number of waits for a notify event */
+    uint32_t notify_wfes;    /*!< WFE executed while waiting for an event */
+    uint32_t doorbell_rings; /*!< Doorbell rings sent to the peer core */
+};
+
 /**
  * \brief Fetch a pointer from mailbox message
  *
@@ -90,7 +112,57 @@ int platform_mailbox_send_msg_data(uint32_t data);
 
 /**
  * \brief Wait for a mailbox notify event.
+ *
+ * \note The core sleeps in WFE between two checks of the notify event. The
+ *       peer core executes SEV after sending each notify event.
  */
 void platform_mailbox_wait_for_notify(void);
 
+/**
+ * \brief Ring the doorbell of the peer core.
+ *
+ * \note The doorbell word is the data register of an IPC channel which only
+ *       the current core writes, and which is never locked. The current core
+ *       increments it, then triggers the notify event of the channel and
+ *       executes SEV. Ringing the doorbell never fails, even if the peer core
+ *       has not yet handled the previous ring.
+ */
+void platform_mailbox_ring_doorbell(void);
+
+/**
+ * \brief Check whether the peer core rang the doorbell of the current core.
+ *
+ * \note The rings since the previous check are reported once.
+ *
+ * \retval true            The doorbell was rung since the previous check.
+ * \retval false           Otherwise.
+ */
+bool platform_mailbox_doorbell_rung(void);
+
+/**
+ * \brief Acquire the inter-core mailbox lock.
+ *
+ * \note The lock is an IPC channel lock, as the Cortex-M0+ has no exclusive
+ *       access instructions to implement a lock in shared memory. While the
+ *       peer core holds the lock, the current core sleeps in WFE until the
+ *       release event of the lock, which the peer core raises in the IPC
+ *       interrupt structure of the current core before executing SEV.
+ */
+void platform_mailbox_lock_acquire(void);
+
+/**
+ * \brief Release the inter-core mailbox lock.
+ *
+ * \note The release event of the lock is raised in the IPC interrupt
+ *       structure of the peer core, and SEV wakes it up if it waits for it.
+ */
+void platform_mailbox_lock_release(void);
+
+/**
+ * \brief Get the mailbox HAL statistics of the current core since boot.
+ *
+ * \param[out] stats       The statistics to fill.
+ */
+void platform_mailbox_get_stats(struct platform_mailbox_stats_t *stats);
+
 #endif
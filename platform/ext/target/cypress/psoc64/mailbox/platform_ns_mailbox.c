@@ -38,17 +38,9 @@ static void mailbox_ipc_config(void)
 
 int32_t tfm_ns_mailbox_hal_notify_peer(void)
 {
-    cy_en_ipcdrv_status_t status;
+    platform_mailbox_ring_doorbell();
 
-    status = Cy_IPC_Drv_SendMsgWord(Cy_IPC_Drv_GetIpcBaseAddress(IPC_TX_CHAN),
-                                    IPC_TX_NOTIFY_MASK,
-                                    PSA_CLIENT_CALL_REQ_MAGIC);
-
-    if (status == CY_IPC_DRV_SUCCESS) {
-        return MAILBOX_SUCCESS;
-    } else {
-        return MAILBOX_CHAN_BUSY;
-    }
+    return MAILBOX_SUCCESS;
 }
 
 int32_t tfm_ns_mailbox_hal_init(struct ns_mailbox_queue_t *queue)
@@ -102,35 +94,23 @@ void tfm_ns_mailbox_hal_enter_critical(void)
 {
     saved_irq_state = Cy_SysLib_EnterCriticalSection();
 
-    IPC_STRUCT_Type* ipc_struct =
-        Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN);
-    while(CY_IPC_DRV_SUCCESS != Cy_IPC_Drv_LockAcquire (ipc_struct))
-    {
-    }
+    platform_mailbox_lock_acquire();
 }
 
 void tfm_ns_mailbox_hal_exit_critical(void)
 {
-    IPC_STRUCT_Type* ipc_struct =
-        Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN);
-    Cy_IPC_Drv_LockRelease(ipc_struct, CY_IPC_NO_NOTIFICATION);
+    platform_mailbox_lock_release();
     Cy_SysLib_ExitCriticalSection(saved_irq_state);
 }
 
 void tfm_ns_mailbox_hal_enter_critical_isr(void)
 {
-    IPC_STRUCT_Type* ipc_struct =
-        Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN);
-    while(CY_IPC_DRV_SUCCESS != Cy_IPC_Drv_LockAcquire (ipc_struct))
-    {
-    }
+    platform_mailbox_lock_acquire();
 }
 
 void tfm_ns_mailbox_hal_exit_critical_isr(void)
 {
-    IPC_STRUCT_Type* ipc_struct =
-        Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN);
-    Cy_IPC_Drv_LockRelease(ipc_struct, CY_IPC_NO_NOTIFICATION);
+    platform_mailbox_lock_release();
 }
 
 static bool mailbox_clear_intr(void)
@@ -151,13 +131,10 @@ static bool mailbox_clear_intr(void)
 
 void cpuss_interrupts_ipc_8_IRQHandler(void)
 {
-    uint32_t magic;
-
     if (!mailbox_clear_intr())
         return;
 
-    platform_mailbox_fetch_msg_data(&magic);
-    if (magic == PSA_CLIENT_CALL_REPLY_MAGIC) {
+    if (platform_mailbox_doorbell_rung()) {
         /* Handle all the pending replies */
         tfm_ns_mailbox_wake_reply_owner_isr();
     }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
  * Copyright (c) 2019, Cypress Semiconductor Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -22,17 +22,9 @@
 
 int32_t tfm_mailbox_hal_notify_peer(void)
 {
-    cy_en_ipcdrv_status_t status;
+    platform_mailbox_ring_doorbell();
 
-    status = Cy_IPC_Drv_SendMsgWord(Cy_IPC_Drv_GetIpcBaseAddress(IPC_TX_CHAN),
-                                    IPC_TX_NOTIFY_MASK,
-                                    PSA_CLIENT_CALL_REPLY_MAGIC);
-
-    if (status == CY_IPC_DRV_SUCCESS) {
-        return MAILBOX_SUCCESS;
-    } else {
-        return MAILBOX_CHAN_BUSY;
-    }
+    return MAILBOX_SUCCESS;
 }
 
 static void mailbox_ipc_config(void)
@@ -74,16 +66,10 @@ int32_t tfm_mailbox_hal_init(struct secure_mailbox_queue_t *s_queue)
 
 void tfm_mailbox_hal_enter_critical(void)
 {
-    IPC_STRUCT_Type* ipc_struct =
-        Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN);
-    while(CY_IPC_DRV_SUCCESS != Cy_IPC_Drv_LockAcquire (ipc_struct))
-    {
-    }
+    platform_mailbox_lock_acquire();
 }
 
 void tfm_mailbox_hal_exit_critical(void)
 {
-    IPC_STRUCT_Type* ipc_struct =
-        Cy_IPC_Drv_GetIpcBaseAddress(IPC_PSA_MAILBOX_LOCK_CHAN);
-    Cy_IPC_Drv_LockRelease(ipc_struct, CY_IPC_NO_NOTIFICATION);
+    platform_mailbox_lock_release();
 }
@@ -13,9 +13,11 @@
 #define IPC_RX_CHAN                             IPC_PSA_CLIENT_CALL_CHAN
 #define IPC_RX_INTR_STRUCT                      IPC_PSA_CLIENT_CALL_INTR_STRUCT
 #define IPC_RX_INT_MASK                         IPC_PSA_CLIENT_CALL_INTR_MASK
+#define IPC_RX_DOORBELL_CHAN                    IPC_PSA_CLIENT_CALL_DOORBELL_CHAN
 
 #define IPC_TX_CHAN                             IPC_PSA_CLIENT_REPLY_CHAN
 #define IPC_TX_NOTIFY_MASK                      IPC_PSA_CLIENT_REPLY_NOTIFY_MASK
+#define IPC_TX_DOORBELL_CHAN                    IPC_PSA_CLIENT_REPLY_DOORBELL_CHAN
 
 #define PSA_CLIENT_CALL_NVIC_IRQn               NvicMux7_IRQn
 #define PSA_CLIENT_CALL_IRQ_PRIORITY            3
@@ -64,4 +64,58 @@ int32_t tfm_hal_random_init(void);
  */
 int32_t tfm_hal_random_generate(uint8_t *rand, size_t size);
 
+/**
+ * \brief Get a free-running timestamp, used to measure durations.
+ *
+ * \note The default implementation returns the DWT cycle counter when called
+ *       from privileged code on a core which has one, and 0 otherwise.
+ *       Where the cycle counter can not be enabled, and with
+ *       CONFIG_TFM_SPM_CPU_STATS, it counts with the secure SysTick instead
+ *       if the platform has not enabled it, and defines a weak
+ *       SysTick_Handler() to count its wraps.
+ *       Platforms can override it to use another timer.
+ *
+ * \note The timestamp wraps every 2^32 ticks, so only durations shorter than
+ *       that can be measured.
+ *
+ * \return The current timestamp, in platform specific ticks.
+ */
+uint32_t tfm_hal_get_timestamp(void);
+
+/**
+ * \brief A low power state the platform can enter while the secure side is
+ *        idle. The durations are in \ref tfm_hal_get_timestamp ticks.
+ */
+struct tfm_hal_sleep_state_t {
+    uint32_t entry_latency;     /* Time to enter the state                  */
+    uint32_t exit_latency;      /* Time to resume from the state            */
+    uint32_t min_residency;     /* Shortest stay for which the state saves
+                                 * energy, entry and exit excluded          */
+};
+
+/**
+ * \brief Get the low power states the idle partition can choose from.
+ *
+ * \param[out] num_states        Number of states in the returned array
+ *
+ * \note The states are ordered from the shallowest to the deepest. The first
+ *       state must have no latency. The default implementation declares a
+ *       single state, entered with WFI.
+ *
+ * \return The array of the sleep states of the platform.
+ */
+const struct tfm_hal_sleep_state_t *tfm_hal_get_sleep_states(
+                                                        uint32_t *num_states);
+
+/**
+ * \brief Enter a low power state until an interrupt is pending.
+ *
+ * \param[in] state              Index of the state in the array returned by
+ *                               \ref tfm_hal_get_sleep_states
+ *
+ * \note It is called with interrupts masked by PRIMASK, and shall return when
+ *       an interrupt is pending. The interrupt is handled once it returns.
+ */
+void tfm_hal_sleep(uint32_t state);
+
 #endif /* __TFM_HAL_PLATFORM_H__ */
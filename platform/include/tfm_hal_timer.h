@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TFM_HAL_TIMER_H__
+#define __TFM_HAL_TIMER_H__
+
+#include <stdint.h>
+
+#include "tfm_hal_defs.h"
+
+/*
+ * The secure timer is a one-shot timer owned by SPM, which only programs it
+ * for the nearest deadline requested by the partitions. It counts at the rate
+ * of tfm_hal_get_timestamp(), and its interrupt handler calls
+ * spm_timer_expired().
+ */
+
+/**
+ * \brief Start the secure timer, to raise its interrupt once after the given
+ *        number of ticks. A timer which is already running is restarted.
+ *
+ * \param[in] ticks               Number of ticks until the interrupt, not 0
+ *
+ * \note A number of ticks beyond the range of the timer can be clamped to its
+ *       maximum. SPM then finds no deadline reached when the interrupt is
+ *       raised, and starts the timer again for the remaining ticks.
+ *
+ * \retval TFM_HAL_SUCCESS              The timer is started.
+ * \retval TFM_HAL_ERROR_NOT_SUPPORTED  The platform has no secure timer.
+ */
+enum tfm_hal_status_t tfm_hal_timer_start(uint32_t ticks);
+
+/**
+ * \brief Get the number of ticks elapsed since the secure timer was last
+ *        started.
+ *
+ * \return The number of elapsed ticks, which is only meaningful until the
+ *         programmed number of ticks is reached.
+ */
+uint32_t tfm_hal_timer_elapsed(void);
+
+/**
+ * \brief Get the number of ticks until the secure timer raises its interrupt.
+ *
+ * \param[out] ticks              Number of ticks until the interrupt, 0 if
+ *                                it is already pending
+ *
+ * \note SPM programs the timer for the nearest deadline of the partitions,
+ *       so this is also the time the core can stay idle for.
+ *
+ * \retval TFM_HAL_SUCCESS              The timer is running, \p ticks is
+ *                                      valid.
+ * \retval TFM_HAL_ERROR_BAD_STATE      The timer is stopped.
+ * \retval TFM_HAL_ERROR_NOT_SUPPORTED  The platform has no secure timer.
+ */
+enum tfm_hal_status_t tfm_hal_timer_get_remaining(uint32_t *ticks);
+
+/**
+ * \brief Stop the secure timer, and clear its pending interrupt.
+ */
+void tfm_hal_timer_stop(void);
+
+#endif /* __TFM_HAL_TIMER_H__ */
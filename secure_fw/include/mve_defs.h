@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __MVE_DEFS_H__
+#define __MVE_DEFS_H__
+
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+
+/*
+ * Number of bytes in an MVE vector. The MVE versions of the memory functions
+ * handle any alignment and the tail of the buffers with predicated vector
+ * accesses, which compile to tail-predicated loops.
+ */
+#define MVE_VECTOR_BYTES            16
+
+/* Number of bytes left after one vector is processed */
+#define MVE_BYTES_LEFT(n)           \
+    (((n) > MVE_VECTOR_BYTES) ? ((n) - MVE_VECTOR_BYTES) : 0)
+#endif /* __ARM_FEATURE_MVE */
+
+#endif /* __MVE_DEFS_H__ */
@@ -111,7 +111,7 @@ void tfm_crypto_clear_scratch(void)
     scratch.alloc_index = 0;
 }
 
-static psa_status_t tfm_crypto_call_sfn(psa_msg_t *msg,
+static psa_status_t tfm_crypto_call_sfn(const psa_msg_t *msg,
                                         struct tfm_crypto_pack_iovec *iov,
                                         const uint32_t sfn_id)
 {
@@ -183,7 +183,7 @@ static psa_status_t tfm_crypto_call_sfn(psa_msg_t *msg,
     return status;
 }
 
-static psa_status_t tfm_crypto_parse_msg(psa_msg_t *msg,
+static psa_status_t tfm_crypto_parse_msg(const psa_msg_t *msg,
                                          struct tfm_crypto_pack_iovec *iov,
                                          uint32_t *sfn_id_p)
 {
@@ -209,13 +209,44 @@ static psa_status_t tfm_crypto_parse_msg(psa_msg_t *msg,
     return PSA_SUCCESS;
 }
 
+static psa_status_t tfm_crypto_handle_msg(const psa_msg_t *msg)
+{
+    psa_status_t status;
+    uint32_t sfn_id = TFM_CRYPTO_SID_INVALID;
+    struct tfm_crypto_pack_iovec iov = {0};
+
+    /* Parse the message */
+    status = tfm_crypto_parse_msg(msg, &iov, &sfn_id);
+    /* Call the dispatcher based on the SID passed as type */
+    if (sfn_id != TFM_CRYPTO_SID_INVALID) {
+        status = tfm_crypto_call_sfn(msg, &iov, sfn_id);
+    } else {
+        status = PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return status;
+}
+
+#if TFM_SP_CRYPTO_MODEL_SFN == 1
+psa_status_t tfm_crypto_sfn(const psa_msg_t *msg)
+{
+    /* Process the message type */
+    switch (msg->type) {
+    case PSA_IPC_CALL:
+        return tfm_crypto_handle_msg(msg);
+    default:
+        psa_panic();
+    }
+
+    /* NOTREACHED */
+    return PSA_ERROR_PROGRAMMER_ERROR;
+}
+#else /* TFM_SP_CRYPTO_MODEL_SFN == 1 */
 static void tfm_crypto_ipc_handler(void)
 {
     psa_signal_t signals = 0;
     psa_msg_t msg;
     psa_status_t status = PSA_SUCCESS;
-    uint32_t sfn_id = TFM_CRYPTO_SID_INVALID;
-    struct tfm_crypto_pack_iovec iov = {0};
 
     while (1) {
         signals = psa_wait(PSA_WAIT_ANY, PSA_BLOCK);
@@ -231,14 +262,7 @@ static void tfm_crypto_ipc_handler(void)
             /* Process the message type */
             switch (msg.type) {
             case PSA_IPC_CALL:
-                /* Parse the message */
-                status = tfm_crypto_parse_msg(&msg, &iov, &sfn_id);
-                /* Call the dispatcher based on the SID passed as type */
-                if (sfn_id != TFM_CRYPTO_SID_INVALID) {
-                    status = tfm_crypto_call_sfn(&msg, &iov, sfn_id);
-                } else {
-                    status = PSA_ERROR_GENERIC_ERROR;
-                }
+                status = tfm_crypto_handle_msg(&msg);
                 psa_reply(msg.handle, status);
                 break;
             default:
@@ -258,6 +282,7 @@ static void tfm_crypto_ipc_handler(void)
     /* NOTREACHED */
     return;
 }
+#endif /* TFM_SP_CRYPTO_MODEL_SFN == 1 */
 #endif /* TFM_PSA_API */
 
 /**
@@ -349,7 +374,7 @@ psa_status_t tfm_crypto_init(void)
         return status;
     }
 
-#ifdef TFM_PSA_API
+#if defined(TFM_PSA_API) && (TFM_SP_CRYPTO_MODEL_IPC == 1)
     /* Should not return in normal operations */
     tfm_crypto_ipc_handler();
 #endif
@@ -5,9 +5,112 @@
  *
  */
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "cmsis.h"
 #include "fih.h"
 #include "psa/service.h"
+#include "tfm_hal_platform.h"
+#include "tfm_hal_timer.h"
+#include "tfm_spm_stats_api.h"
+#ifdef CONFIG_TFM_SPM_API_STATS
+#include "ffm/spm_api_stats.h"
+#endif
+
+#ifndef CONFIG_TFM_IDLE_MAX_EXIT_LATENCY
+#define CONFIG_TFM_IDLE_MAX_EXIT_LATENCY    0
+#endif
+
+/* Number of sleep states accounted for. Deeper states are not entered. */
+#define IDLE_SLEEP_STATES_MAX               TFM_SPM_IDLE_STATS_STATES
+
+/* The idle time when no secure timer deadline is known */
+#define IDLE_NO_DEADLINE                    UINT32_MAX
+
+/* Returns true if an enabled interrupt is already pending */
+static bool idle_work_pending(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(NVIC->ISPR) / sizeof(NVIC->ISPR[0]); i++) {
+        if ((NVIC->ISPR[i] & NVIC->ISER[i]) != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Selects the deepest state whose exit latency is within the configured limit
+ * and which saves energy for the given idle time. The first state is taken
+ * when work is pending.
+ */
+static uint32_t idle_select_state(const struct tfm_hal_sleep_state_t *states,
+                                  uint32_t num_states, uint32_t idle_time,
+                                  bool work_pending)
+{
+    uint32_t i, selected = 0;
+    uint64_t cost;
+
+    if (work_pending) {
+        return 0;
+    }
+
+    for (i = 1; (i < num_states) && (i < IDLE_SLEEP_STATES_MAX); i++) {
+        if (states[i].exit_latency > CONFIG_TFM_IDLE_MAX_EXIT_LATENCY) {
+            continue;
+        }
+
+        cost = (uint64_t)states[i].entry_latency + states[i].exit_latency +
+               states[i].min_residency;
+        if ((idle_time != IDLE_NO_DEADLINE) && (cost > idle_time)) {
+            continue;
+        }
+
+        selected = i;
+    }
+
+    return selected;
+}
+
+static void idle_sleep(void)
+{
+    const struct tfm_hal_sleep_state_t *states;
+    uint32_t num_states, state, idle_time;
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t start;
+#endif
+
+    states = tfm_hal_get_sleep_states(&num_states);
+
+    /*
+     * Interrupts are masked from the selection to the wake up, so that an
+     * interrupt raised in between keeps the core from sleeping.
+     */
+    __disable_irq();
+
+    /*
+     * SPM programs the secure timer for the nearest partition timer deadline,
+     * when the core must be awake.
+     */
+    if (tfm_hal_timer_get_remaining(&idle_time) != TFM_HAL_SUCCESS) {
+        idle_time = IDLE_NO_DEADLINE;
+    }
+
+    state = idle_select_state(states, num_states, idle_time,
+                              idle_work_pending());
+
+#ifdef CONFIG_TFM_SPM_API_STATS
+    start = tfm_hal_get_timestamp();
+    tfm_hal_sleep(state);
+    spm_api_stats_record_idle(state, start);
+#else
+    tfm_hal_sleep(state);
+#endif
+
+    __enable_irq();
+}
 
 void tfm_idle_thread(void)
 {
@@ -18,7 +121,7 @@ void tfm_idle_thread(void)
          * It does not expect any signals.
          */
         if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
-            __WFI();
+            idle_sleep();
         }
     }
 
@@ -32,7 +135,7 @@ void tfm_idle_thread(void)
          * It does not expect any signals.
          */
         if (psa_wait(PSA_WAIT_ANY, PSA_POLL) == 0) {
-            __WFI();
+            idle_sleep();
         }
     }
 #endif
@@ -109,6 +109,22 @@ static void tfm_abort(void)
         ;
 }
 
+#if TFM_SP_INITIAL_ATTESTATION_MODEL_SFN == 1
+psa_status_t tfm_attestation_service_sfn(const psa_msg_t *msg)
+{
+    switch (msg->type) {
+    case TFM_ATTEST_GET_TOKEN:
+        return psa_attest_get_token(msg);
+    case TFM_ATTEST_GET_TOKEN_SIZE:
+        return psa_attest_get_token_size(msg);
+    default:
+        tfm_abort();
+    }
+
+    /* NOTREACHED */
+    return PSA_ERROR_PROGRAMMER_ERROR;
+}
+#else /* TFM_SP_INITIAL_ATTESTATION_MODEL_SFN == 1 */
 static void attest_signal_handle(psa_signal_t signal)
 {
     psa_msg_t msg;
@@ -128,8 +144,10 @@ static void attest_signal_handle(psa_signal_t signal)
         tfm_abort();
     }
 }
+#endif /* TFM_SP_INITIAL_ATTESTATION_MODEL_SFN == 1 */
 #endif
 
+#if !defined(TFM_PSA_API) || (TFM_SP_INITIAL_ATTESTATION_MODEL_IPC == 1)
 psa_status_t attest_partition_init(void)
 {
     psa_status_t err = attest_init();
@@ -152,3 +170,4 @@ psa_status_t attest_partition_init(void)
     return err;
 #endif
 }
+#endif /* !defined(TFM_PSA_API) || (TFM_SP_INITIAL_ATTESTATION_MODEL_IPC == 1) */
@@ -31,6 +31,15 @@ extern struct its_flash_nand_dev_t its_flash_nand_dev;
 #define ITS_FLASH_DEV its_flash_nand_dev
 #define ITS_FLASH_ALIGNMENT 1
 #define ITS_FLASH_OPS its_flash_fs_ops_nand
+#ifdef ITS_FAST_MOUNT
+#error "ITS_FAST_MOUNT requires a flash device that supports partial programming"
+#endif
+#ifdef ITS_APPEND_IN_PLACE
+#error "ITS_APPEND_IN_PLACE requires a flash device that supports partial programming"
+#endif
+#if defined(ITS_NUM_SHARDS) && (ITS_NUM_SHARDS > 1)
+#error "ITS_NUM_SHARDS > 1 is not supported with the NAND flash block buffers"
+#endif
 
 #else
 /* NOR flash: no write buffering, require each file in the filesystem to be
@@ -61,6 +70,12 @@ extern struct its_flash_nand_dev_t ps_flash_nand_dev;
 #define PS_FLASH_DEV ps_flash_nand_dev
 #define PS_FLASH_ALIGNMENT 1
 #define PS_FLASH_OPS its_flash_fs_ops_nand
+#ifdef ITS_FAST_MOUNT
+#error "ITS_FAST_MOUNT requires a flash device that supports partial programming"
+#endif
+#ifdef ITS_APPEND_IN_PLACE
+#error "ITS_APPEND_IN_PLACE requires a flash device that supports partial programming"
+#endif
 
 #else
 /* NOR flash: no write buffering, require each file in the filesystem to be
@@ -79,19 +79,31 @@ static psa_status_t its_flash_nor_flush(const struct its_flash_fs_config_t *cfg,
     return PSA_SUCCESS;
 }
 
+static psa_status_t its_flash_nor_erase_sector(
+                                        const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id, size_t offset)
+{
+    int32_t err;
+    uint32_t addr = get_phys_address(cfg, block_id, offset);
+
+    err = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->EraseSector(addr);
+    if (err != ARM_DRIVER_OK) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    return PSA_SUCCESS;
+}
+
 static psa_status_t its_flash_nor_erase(const struct its_flash_fs_config_t *cfg,
                                         uint32_t block_id)
 {
-    int32_t err;
-    uint32_t addr;
+    psa_status_t err;
     size_t offset;
 
     for (offset = 0; offset < cfg->block_size; offset += cfg->sector_size) {
-        addr = get_phys_address(cfg, block_id, offset);
-
-        err = ((ARM_DRIVER_FLASH *)cfg->flash_dev)->EraseSector(addr);
-        if (err != ARM_DRIVER_OK) {
-            return PSA_ERROR_STORAGE_FAILURE;
+        err = its_flash_nor_erase_sector(cfg, block_id, offset);
+        if (err != PSA_SUCCESS) {
+            return err;
         }
     }
 
@@ -104,4 +116,5 @@ const struct its_flash_fs_ops_t its_flash_fs_ops_nor = {
     .write = its_flash_nor_write,
     .flush = its_flash_nor_flush,
     .erase = its_flash_nor_erase,
+    .erase_sector = its_flash_nor_erase_sector,
 };
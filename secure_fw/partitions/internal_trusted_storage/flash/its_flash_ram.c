@@ -77,10 +77,23 @@ static psa_status_t its_flash_ram_erase(const struct its_flash_fs_config_t *cfg,
     return PSA_SUCCESS;
 }
 
+static psa_status_t its_flash_ram_erase_sector(
+                                        const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id, size_t offset)
+{
+    uint32_t idx = get_phys_address(cfg, block_id, offset);
+
+    (void)tfm_memset((uint8_t *)cfg->flash_dev + idx, cfg->erase_val,
+                     cfg->sector_size);
+
+    return PSA_SUCCESS;
+}
+
 const struct its_flash_fs_ops_t its_flash_fs_ops_ram = {
     .init = its_flash_ram_init,
     .read = its_flash_ram_read,
     .write = its_flash_ram_write,
     .flush = its_flash_ram_flush,
     .erase = its_flash_ram_erase,
+    .erase_sector = its_flash_ram_erase_sector,
 };
@@ -83,7 +83,9 @@ static size_t its_flash_fs_all_metadata_size(
     return sizeof(struct its_metadata_block_header_t)
            + (its_flash_fs_num_active_dblocks(cfg)
               * sizeof(struct its_block_meta_t))
-           + (cfg->max_num_files * sizeof(struct its_file_meta_t));
+           + (cfg->max_num_files * sizeof(struct its_file_meta_t))
+           /* Area reserved at the end of the metadata block */
+           + ITS_MBLOCK_END_RESERVED_SIZE;
 }
 
 /**
@@ -174,18 +176,37 @@ psa_status_t its_flash_fs_prepare(its_flash_fs_ctx_t *fs_ctx)
         return err;
     }
 
+#ifdef ITS_FAST_MOUNT
+    /* The clean marker is only written once all pending deletions have
+     * completed, so there is nothing left behind to check for.
+     */
+    if (fs_ctx->clean_marker) {
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Check if a file marked for deletion has been left behind by a power
      * failure. If so, delete it.
      */
     err = its_flash_fs_mblock_get_file_idx_flag(fs_ctx,
                                                 ITS_FLASH_FS_FLAG_DELETE, &idx);
     if (err == PSA_SUCCESS) {
-        return its_flash_fs_delete_idx(fs_ctx, idx);
+        err = its_flash_fs_delete_idx(fs_ctx, idx);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
     } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
         return err;
     }
 
+#ifdef ITS_FAST_MOUNT
+    /* The filesystem has been fully validated, so the next initialization
+     * can take the fast path.
+     */
+    return its_flash_fs_mblock_set_clean_marker(fs_ctx);
+#else
     return PSA_SUCCESS;
+#endif
 }
 
 psa_status_t its_flash_fs_wipe_all(struct its_flash_fs_ctx_t *fs_ctx)
@@ -245,6 +266,137 @@ psa_status_t its_flash_fs_file_get_info(struct its_flash_fs_ctx_t *fs_ctx,
     return PSA_SUCCESS;
 }
 
+#ifdef ITS_APPEND_IN_PLACE
+/**
+ * \brief Appends data to a file in place, after the end of the file in its
+ *        active data block, without updating the metadata block.
+ *
+ * \details The full program units after the end of the file are programmed
+ *          in the data block, and the bytes after the last full program unit
+ *          are kept in the append journal record, which also holds the new
+ *          size of the file. So no program unit is programmed twice.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     fid        File ID
+ * \param[in]     data_size  Size of the incoming write data
+ * \param[in]     offset     Offset in the file to write
+ * \param[in]     data       Pointer to buffer containing data to be written
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the data cannot be appended in
+ *         place, in which case nothing is programmed. Otherwise, it returns
+ *         error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_flash_fs_file_append_in_place(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             const uint8_t *fid,
+                                             size_t data_size,
+                                             size_t offset,
+                                             const uint8_t *data)
+{
+    struct its_block_meta_t block_meta;
+    struct its_file_meta_t file_meta;
+    uint8_t unit[ITS_FLASH_MAX_ALIGNMENT];
+    uint8_t new_tail[ITS_FLASH_MAX_ALIGNMENT] = {0};
+    const uint8_t *tail;
+    size_t program_unit = fs_ctx->cfg->program_unit;
+    size_t new_size;
+    size_t start;
+    size_t end;
+    size_t tail_size;
+    size_t head_size;
+    psa_status_t err;
+    uint32_t idx;
+
+    err = its_flash_fs_mblock_get_file_idx(fs_ctx, fid, &idx);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    err = its_flash_fs_mblock_read_file_meta(fs_ctx, idx, &file_meta);
+    if (err != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    if ((data_size == 0) || (offset != file_meta.cur_size) ||
+        (file_meta.lblock == ITS_LOGICAL_DBLOCK0) ||
+        (its_utils_check_contained_in(file_meta.max_size, offset, data_size)
+         != PSA_SUCCESS)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* Program units from the one holding the end of the file up to the one
+     * holding the new end of the file.
+     */
+    new_size = offset + data_size;
+    start = offset - (offset % program_unit);
+    end = new_size - (new_size % program_unit);
+
+    /* Get the bytes of the last, partially written, program unit */
+    tail_size = offset - start;
+    if (tail_size != 0) {
+        if (its_flash_fs_mblock_append_get_tail(fs_ctx, idx, &tail)
+            == tail_size) {
+            tfm_memcpy(unit, tail, tail_size);
+        } else {
+            err = its_flash_fs_dblock_read_file(fs_ctx, &file_meta, start,
+                                                tail_size, unit);
+            if (err != PSA_SUCCESS) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+    }
+
+    /* Complete that program unit with the start of the data */
+    head_size = ITS_UTILS_MIN(data_size, program_unit - tail_size);
+    tfm_memcpy(unit + tail_size, data, head_size);
+
+    if (end == start) {
+        tfm_memcpy(new_tail, unit, new_size - start);
+    } else {
+        tfm_memcpy(new_tail, data + (data_size - (new_size - end)),
+                   new_size - end);
+
+        err = its_flash_fs_mblock_read_block_metadata(fs_ctx, file_meta.lblock,
+                                                      &block_meta);
+        if (err != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        err = its_flash_fs_dblock_check_erased(fs_ctx, &block_meta, &file_meta,
+                                               start, end - start);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Program the record with the new size first, so that an interrupted
+     * append is known at the next initialization.
+     */
+    err = its_flash_fs_mblock_append_begin(fs_ctx, idx, &file_meta, new_size,
+                                           new_tail);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (end != start) {
+        err = its_flash_fs_dblock_append_file(fs_ctx, &block_meta, &file_meta,
+                                              start, program_unit, unit);
+        if ((err == PSA_SUCCESS) && (end - start > program_unit)) {
+            err = its_flash_fs_dblock_append_file(fs_ctx, &block_meta,
+                                                  &file_meta,
+                                                  start + program_unit,
+                                                  end - start - program_unit,
+                                                  data + head_size);
+        }
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    return its_flash_fs_mblock_append_commit(fs_ctx, idx, new_size, new_tail);
+}
+#endif /* ITS_APPEND_IN_PLACE */
+
 psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
                                      const uint8_t *fid,
                                      struct its_flash_fs_file_info_t *finfo,
@@ -260,17 +412,48 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
     uint32_t old_idx = ITS_METADATA_INVALID_INDEX;
     uint32_t new_idx = ITS_METADATA_INVALID_INDEX;
     bool use_spare;
+    size_t program_size;
+#ifdef ITS_APPEND_IN_PLACE
+    uint8_t tail[ITS_FLASH_MAX_ALIGNMENT] = {0};
+    size_t tail_size;
+#endif
 
     /* Do not permit the user to pass filesystem-internal flags */
     if (finfo->flags & ITS_FLASH_FS_INTERNAL_FLAGS_MASK) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#ifdef ITS_APPEND_IN_PLACE
+    if (finfo->flags & ITS_FLASH_FS_FLAG_APPEND) {
+        err = its_flash_fs_file_append_in_place(fs_ctx, fid, data_size, offset,
+                                                data);
+        if (err != PSA_ERROR_NOT_SUPPORTED) {
+            return err;
+        }
+
+        /* Otherwise, the data block is copied, from a program unit boundary */
+        if (!ITS_UTILS_IS_ALIGNED(offset, fs_ctx->cfg->program_unit)) {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
+    }
+
+    /* Changes staged by a failed update are not applied */
+    its_flash_fs_mblock_append_discard(fs_ctx);
+#endif
+
 #if (ITS_FLASH_MAX_ALIGNMENT != 1)
     /* Set the max_size to be aligned with the flash program unit */
     finfo->size_max = ITS_UTILS_ALIGN(finfo->size_max, fs_ctx->cfg->program_unit);
 #endif
 
+#ifdef ITS_BACKGROUND_ERASE
+    /* The scratch blocks must be fully erased before they are modified */
+    err = its_flash_fs_mblock_erase_complete(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
     /* Check if the file already exists */
     err = its_flash_fs_mblock_get_file_idx(fs_ctx, fid, &old_idx);
     if (err == PSA_SUCCESS) {
@@ -280,6 +463,11 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
             return PSA_ERROR_DOES_NOT_EXIST;
         }
 
+#ifdef ITS_APPEND_IN_PLACE
+        /* The file data is rewritten by this update */
+        its_flash_fs_mblock_append_drop(fs_ctx, old_idx);
+#endif
+
         if (finfo->flags & ITS_FLASH_FS_FLAG_TRUNCATE) {
             if (file_meta.max_size == finfo->size_max) {
                 /* Truncate and reuse the existing file, which is already the
@@ -295,6 +483,12 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
                  * deletion will be re-attempted based on this flag.
                  */
                 file_meta.flags |= ITS_FLASH_FS_FLAG_DELETE;
+#ifdef ITS_FAST_MOUNT
+                err = its_flash_fs_mblock_clear_clean_marker(fs_ctx);
+                if (err != PSA_SUCCESS) {
+                    return err;
+                }
+#endif
                 err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx,
                                                                    old_idx,
                                                                    &file_meta);
@@ -341,21 +535,41 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         }
     }
 
+#ifdef ITS_FAST_MOUNT
+    /* The scratch blocks are about to be modified */
+    err = its_flash_fs_mblock_clear_clean_marker(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
     if (data_size != 0) {
+        program_size = data_size;
+
+#ifdef ITS_APPEND_IN_PLACE
+        /* Keep the bytes after the last full program unit of appended data in
+         * the journal, so that the next append can be done in place.
+         */
+        tail_size = (offset + data_size) % fs_ctx->cfg->program_unit;
+        if ((finfo->flags & ITS_FLASH_FS_FLAG_APPEND) &&
+            (file_meta.lblock != ITS_LOGICAL_DBLOCK0) && (tail_size != 0)) {
+            tfm_memcpy(tail, data + (data_size - tail_size), tail_size);
+            if (its_flash_fs_mblock_append_stage(fs_ctx, new_idx,
+                                                 offset + data_size, tail)
+                == PSA_SUCCESS) {
+                program_size -= tail_size;
+            }
+        }
+#endif
+
         /* Write the content into scratch data block */
         err = its_flash_fs_file_write_aligned_data(fs_ctx, &block_meta,
                                                    &file_meta, offset,
-                                                   data_size, data);
+                                                   program_size, data);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
         }
 
-        /* Update the file's current size if required */
-        if (offset + data_size > file_meta.cur_size) {
-            /* Update the file metadata */
-            file_meta.cur_size = offset + data_size;
-        }
-
         cur_phys_block = block_meta.phy_id;
 
         /* Cur scratch block become the active datablock */
@@ -365,6 +579,12 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         /* Swap the scratch data block */
         its_flash_fs_mblock_set_data_scratch(fs_ctx, cur_phys_block,
                                              file_meta.lblock);
+
+        /* Update the file's current size if required */
+        if (offset + data_size > file_meta.cur_size) {
+            /* Update the file metadata */
+            file_meta.cur_size = offset + data_size;
+        }
     }
 
     /* Update block metadata in scratch metadata block */
@@ -444,6 +664,12 @@ psa_status_t its_flash_fs_file_write(struct its_flash_fs_ctx_t *fs_ctx,
         err = its_flash_fs_delete_idx(fs_ctx, old_idx);
     }
 
+#ifdef ITS_FAST_MOUNT
+    if (err == PSA_SUCCESS) {
+        err = its_flash_fs_mblock_set_clean_marker(fs_ctx);
+    }
+#endif
+
     return err;
 }
 
@@ -468,6 +694,12 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
         return PSA_ERROR_DOES_NOT_EXIST;
     }
 
+#ifdef ITS_APPEND_IN_PLACE
+    /* Changes staged by a failed update are not applied */
+    its_flash_fs_mblock_append_discard(fs_ctx);
+    its_flash_fs_mblock_append_drop(fs_ctx, del_file_idx);
+#endif
+
     /* Save logical block, data_index and max_size to be used later on */
     del_file_lblock = file_meta.lblock;
     del_file_data_idx = file_meta.data_idx;
@@ -476,6 +708,22 @@ static psa_status_t its_flash_fs_delete_idx(struct its_flash_fs_ctx_t *fs_ctx,
     /* Remove file metadata */
     file_meta = (struct its_file_meta_t){0};
 
+#ifdef ITS_BACKGROUND_ERASE
+    /* The scratch blocks must be fully erased before they are modified */
+    err = its_flash_fs_mblock_erase_complete(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
+#ifdef ITS_FAST_MOUNT
+    /* The scratch blocks are about to be modified */
+    err = its_flash_fs_mblock_clear_clean_marker(fs_ctx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
+
     /* Update file metadata in to the scratch block */
     err = its_flash_fs_mblock_update_scratch_file_meta(fs_ctx, del_file_idx,
                                                        &file_meta);
@@ -571,9 +819,41 @@ psa_status_t its_flash_fs_file_delete(struct its_flash_fs_ctx_t *fs_ctx,
         return PSA_ERROR_DOES_NOT_EXIST;
     }
 
+#ifdef ITS_FAST_MOUNT
+    err = its_flash_fs_delete_idx(fs_ctx, del_file_idx);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return its_flash_fs_mblock_set_clean_marker(fs_ctx);
+#else
     return its_flash_fs_delete_idx(fs_ctx, del_file_idx);
+#endif
 }
 
+#ifdef ITS_STATS
+void its_flash_fs_get_stats(const struct its_flash_fs_ctx_t *fs_ctx,
+                            struct tfm_storage_flash_stats_t *stats)
+{
+    *stats = fs_ctx->stats;
+#ifdef ITS_BACKGROUND_ERASE
+    stats->erase_pending = fs_ctx->erase_pending;
+#endif
+}
+#endif
+
+#ifdef ITS_BACKGROUND_ERASE
+bool its_flash_fs_erase_pending(const struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return (fs_ctx->erase_pending != 0);
+}
+
+psa_status_t its_flash_fs_erase_step(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return its_flash_fs_mblock_erase_step(fs_ctx);
+}
+#endif /* ITS_BACKGROUND_ERASE */
+
 psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
                                     const uint8_t *fid,
                                     size_t size,
@@ -583,6 +863,12 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
     psa_status_t err;
     uint32_t idx;
     struct its_file_meta_t tmp_metadata;
+#ifdef ITS_APPEND_IN_PLACE
+    const uint8_t *tail;
+    size_t tail_size;
+    size_t tail_start;
+    size_t pos;
+#endif
 
     /* Get the file index */
     err = its_flash_fs_mblock_get_file_idx(fs_ctx, fid, &idx);
@@ -614,5 +900,16 @@ psa_status_t its_flash_fs_file_read(struct its_flash_fs_ctx_t *fs_ctx,
         return PSA_ERROR_GENERIC_ERROR;
     }
 
+#ifdef ITS_APPEND_IN_PLACE
+    /* The bytes after the last full program unit may only be in the journal */
+    tail_size = its_flash_fs_mblock_append_get_tail(fs_ctx, idx, &tail);
+    tail_start = tmp_metadata.cur_size - tail_size;
+    if ((tail_size != 0) && (offset + size > tail_start)) {
+        pos = ITS_UTILS_MAX(offset, tail_start);
+        tfm_memcpy(data + (pos - offset), tail + (pos - tail_start),
+                   (offset + size) - pos);
+    }
+#endif
+
     return PSA_SUCCESS;
 }
@@ -22,6 +22,9 @@
 
 #include "its_flash_fs_mblock.h"
 #include "psa/error.h"
+#ifdef ITS_STATS
+#include "tfm_storage_stats.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +41,8 @@ extern "C" {
 #define ITS_FLASH_FS_FLAG_CREATE       (1U << 16)
 /* Remove existing file data if it exists */
 #define ITS_FLASH_FS_FLAG_TRUNCATE     (1U << 17)
+/* Write the data in place after the end of the file, if possible */
+#define ITS_FLASH_FS_FLAG_APPEND       (1U << 18)
 
 /* Invalid block index */
 #define ITS_BLOCK_INVALID_ID 0xFFFFFFFFU
@@ -153,6 +158,24 @@ struct its_flash_fs_ops_t {
      */
     psa_status_t (*erase)(const struct its_flash_fs_config_t *cfg,
                           uint32_t block_id);
+
+    /**
+     * \brief Erases one sector of a block, so that the erase of a block can be
+     *        split. May be NULL if the flash device can only erase whole
+     *        blocks.
+     *
+     * \param[in] cfg       Filesystem configuration
+     * \param[in] block_id  Block ID
+     * \param[in] offset    Offset of the sector from the init of the block, a
+     *                      multiple of the sector size
+     *
+     * \note This function assumes the input values are valid.
+     *
+     * \return Returns PSA_SUCCESS if the function is executed correctly.
+     *         Otherwise, it returns PSA_ERROR_STORAGE_FAILURE.
+     */
+    psa_status_t (*erase_sector)(const struct its_flash_fs_config_t *cfg,
+                                 uint32_t block_id, size_t offset);
 };
 
 /**
@@ -261,6 +284,14 @@ psa_status_t its_flash_fs_file_get_info(its_flash_fs_ctx_t *fs_ctx,
  *                           equal to the current file size.
  * \param[in]     data       Pointer to buffer containing data to be written
  *
+ * \note When ITS_APPEND_IN_PLACE is defined, ITS_FLASH_FS_FLAG_APPEND is set
+ *       and the offset is the current file size, the data is written in place
+ *       in the active data block, and the new size is committed in the append
+ *       journal of the active metadata block, instead of copying the whole
+ *       block to the scratch data block. The offset does not have to be
+ *       aligned to the program unit then. PSA_ERROR_NOT_SUPPORTED is returned
+ *       if the append cannot be done in place and the offset is not aligned.
+ *
  * \return Returns error code as specified in \ref psa_status_t
  */
 psa_status_t its_flash_fs_file_write(its_flash_fs_ctx_t *fs_ctx,
@@ -298,6 +329,44 @@ psa_status_t its_flash_fs_file_read(its_flash_fs_ctx_t *fs_ctx,
 psa_status_t its_flash_fs_file_delete(its_flash_fs_ctx_t *fs_ctx,
                                       const uint8_t *fid);
 
+#ifdef ITS_STATS
+/**
+ * \brief Gets the flash statistics of the filesystem since it was initialised.
+ *
+ * \param[in]  fs_ctx  Filesystem context
+ * \param[out] stats   Pointer to the statistics to fill
+ */
+void its_flash_fs_get_stats(const its_flash_fs_ctx_t *fs_ctx,
+                            struct tfm_storage_flash_stats_t *stats);
+#endif
+
+#ifdef ITS_BACKGROUND_ERASE
+/**
+ * \brief Checks if the erase of the scratch blocks released by the last update
+ *        is still incomplete.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ *
+ * \return Returns true if part of the scratch blocks is still to be erased.
+ */
+bool its_flash_fs_erase_pending(const its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Erases the next sector of the scratch blocks released by the last
+ *        update, if any.
+ *
+ * \details Updates leave the erase of the scratch blocks pending, so that
+ *          it can be performed one sector at a time between other operations.
+ *          Any part of the erase not performed by this function is completed
+ *          at the start of the next update.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_erase_step(its_flash_fs_ctx_t *fs_ctx);
+#endif /* ITS_BACKGROUND_ERASE */
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,7 @@
 #include "its_flash_fs_dblock.h"
 
 #include "its_flash_fs.h"
+#include "its_utils.h"
 
 /**
  * \brief Converts logical data block number to physical number.
@@ -57,6 +58,10 @@ psa_status_t its_flash_fs_dblock_compact_block(
 
     /* Check if there are bytes to be compacted */
     if (size > 0) {
+#ifdef ITS_STATS
+        fs_ctx->stats.compactions++;
+#endif
+
         /* Move data from source offset in current data block to scratch block
          * destination offset.
          */
@@ -161,9 +166,11 @@ psa_status_t its_flash_fs_dblock_write_file(
     }
 
     /* Write the new file data */
-    err = fs_ctx->ops->write(fs_ctx->cfg, scratch_id, data, pos, size);
-    if (err != PSA_SUCCESS) {
-        return err;
+    if (size != 0) {
+        err = its_flash_fs_write(fs_ctx, scratch_id, data, pos, size);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
     }
 
     /* Calculate the position of the end of the file */
@@ -189,3 +196,65 @@ psa_status_t its_flash_fs_dblock_write_file(
 
     return err;
 }
+
+#ifdef ITS_APPEND_IN_PLACE
+psa_status_t its_flash_fs_dblock_check_erased(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t offset,
+                                      size_t size)
+{
+    psa_status_t err;
+    uint8_t buf[16];
+    size_t pos;
+    size_t bytes_to_read;
+    size_t i;
+
+    /* Calculate the position of the area in the block */
+    pos = file_meta->data_idx + offset;
+
+    /* The area after the end of the file is not erased if the file was
+     * written with a partial last program unit.
+     */
+    while (size > 0) {
+        bytes_to_read = ITS_UTILS_MIN(size, sizeof(buf));
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, block_meta->phy_id, buf, pos,
+                                bytes_to_read);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        for (i = 0; i < bytes_to_read; i++) {
+            if (buf[i] != fs_ctx->cfg->erase_val) {
+                return PSA_ERROR_NOT_SUPPORTED;
+            }
+        }
+
+        pos += bytes_to_read;
+        size -= bytes_to_read;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_dblock_append_file(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t offset,
+                                      size_t size,
+                                      const uint8_t *data)
+{
+    psa_status_t err;
+
+    err = its_flash_fs_write(fs_ctx, block_meta->phy_id, data,
+                             file_meta->data_idx + offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    return fs_ctx->ops->flush(fs_ctx->cfg, block_meta->phy_id);
+}
+#endif /* ITS_APPEND_IN_PLACE */
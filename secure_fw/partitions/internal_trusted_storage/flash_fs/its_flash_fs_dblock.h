@@ -81,6 +81,56 @@ psa_status_t its_flash_fs_dblock_write_file(
                                       size_t size,
                                       const uint8_t *data);
 
+#ifdef ITS_APPEND_IN_PLACE
+/**
+ * \brief Checks that an area after the end of the file data is erased in the
+ *        active data block, so that it can be programmed in place.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     block_meta  Block metadata
+ * \param[in]     file_meta   File metadata
+ * \param[in]     offset      Offset of the area in the file
+ * \param[in]     size        Size of the area
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the area is not erased.
+ *         Otherwise, it returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_dblock_check_erased(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t offset,
+                                      size_t size);
+
+/**
+ * \brief Writes data in place in the active data block, after the end of the
+ *        file data.
+ *
+ * \details The area must have been checked to be erased with
+ *          \ref its_flash_fs_dblock_check_erased. The data is not referenced
+ *          by the file until the append journal record is committed, so a
+ *          power failure before that leaves the file unchanged.
+ *
+ * \param[in,out] fs_ctx      Filesystem context
+ * \param[in]     block_meta  Block metadata
+ * \param[in]     file_meta   File metadata
+ * \param[in]     offset      Offset in the file where to write the incoming
+ *                            data. Must be aligned to the program unit.
+ * \param[in]     size        Size of the incoming data. Must be a multiple
+ *                            of the program unit.
+ * \param[in]     data        Pointer to data buffer to write
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_dblock_append_file(
+                                      struct its_flash_fs_ctx_t *fs_ctx,
+                                      const struct its_block_meta_t *block_meta,
+                                      const struct its_file_meta_t *file_meta,
+                                      size_t offset,
+                                      size_t size,
+                                      const uint8_t *data);
+#endif /* ITS_APPEND_IN_PLACE */
+
 #ifdef __cplusplus
 }
 #endif
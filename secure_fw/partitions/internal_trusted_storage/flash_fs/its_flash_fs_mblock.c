@@ -34,6 +34,64 @@
 #define ITS_BLOCK_METADATA_SIZE     sizeof(struct its_block_meta_t)
 #define ITS_FILE_METADATA_SIZE      sizeof(struct its_file_meta_t)
 
+#ifdef ITS_FAST_MOUNT
+#define ITS_MBLOCK_CLEAN_MARKER_MAGIC  0x434C4E4DU /* "CLNM" */
+#define ITS_MBLOCK_CLEAN_MARKER_SIZE   sizeof(struct its_mblock_clean_marker_t)
+#endif
+
+#ifdef ITS_APPEND_IN_PLACE
+#define ITS_MBLOCK_APPEND_COMMIT_MAGIC  0x41504E44U /* "APND" */
+#define ITS_MBLOCK_APPEND_RECORD_SIZE   sizeof(struct its_mblock_append_record_t)
+#endif
+
+#ifdef ITS_STATS
+/**
+ * \brief Counts the erase of a block in the filesystem statistics.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Block ID
+ */
+static void its_flash_fs_count_erase(struct its_flash_fs_ctx_t *fs_ctx,
+                                     uint32_t block_id)
+{
+    fs_ctx->stats.erases++;
+    if (block_id < TFM_STORAGE_STATS_MAX_BLOCKS) {
+        fs_ctx->stats.block_erases[block_id]++;
+    }
+}
+#endif
+
+psa_status_t its_flash_fs_write(struct its_flash_fs_ctx_t *fs_ctx,
+                                uint32_t block_id, const uint8_t *buf,
+                                size_t offset, size_t size)
+{
+#ifdef ITS_STATS
+    fs_ctx->stats.bytes_written += size;
+#endif
+    return fs_ctx->ops->write(fs_ctx->cfg, block_id, buf, offset, size);
+}
+
+psa_status_t its_flash_fs_erase(struct its_flash_fs_ctx_t *fs_ctx,
+                                uint32_t block_id)
+{
+#ifdef ITS_STATS
+    its_flash_fs_count_erase(fs_ctx, block_id);
+#endif
+    return fs_ctx->ops->erase(fs_ctx->cfg, block_id);
+}
+
+psa_status_t its_flash_fs_erase_sector(struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t block_id, size_t offset)
+{
+#ifdef ITS_STATS
+    /* The erase of a block is counted when its first sector is erased */
+    if (offset == 0) {
+        its_flash_fs_count_erase(fs_ctx, block_id);
+    }
+#endif
+    return fs_ctx->ops->erase_sector(fs_ctx->cfg, block_id, offset);
+}
+
 /* FIXME: Precompute these for each context */
 /**
  * \brief Gets the physical block ID of the initial position of the scratch
@@ -146,6 +204,10 @@ static void its_mblock_swap_metablocks(struct its_flash_fs_ctx_t *fs_ctx)
     tmp_block = fs_ctx->scratch_metablock;
     fs_ctx->scratch_metablock = fs_ctx->active_metablock;
     fs_ctx->active_metablock = tmp_block;
+
+#ifdef ITS_STATS
+    fs_ctx->stats.metablock_swaps++;
+#endif
 }
 
 /**
@@ -521,7 +583,7 @@ static psa_status_t its_mblock_erase_scratch_blocks(
      * and power-failure-safe operation, it is necessary that
      * metadata scratch block is erased before data block.
      */
-    err = fs_ctx->ops->erase(fs_ctx->cfg, fs_ctx->scratch_metablock);
+    err = its_flash_fs_erase(fs_ctx, fs_ctx->scratch_metablock);
     if (err != PSA_SUCCESS) {
         return err;
     }
@@ -535,12 +597,97 @@ static psa_status_t its_mblock_erase_scratch_blocks(
         scratch_datablock =
             its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
                                                     (ITS_LOGICAL_DBLOCK0 + 1));
-        err = fs_ctx->ops->erase(fs_ctx->cfg, scratch_datablock);
+        err = its_flash_fs_erase(fs_ctx, scratch_datablock);
     }
 
     return err;
 }
 
+#ifdef ITS_BACKGROUND_ERASE
+/**
+ * \brief Gets the number of scratch blocks to erase after an update.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ *
+ * \return Returns 2 if there is a scratch data block, and 1 otherwise.
+ */
+static uint32_t its_mblock_num_scratch_blocks(
+                                        const struct its_flash_fs_ctx_t *fs_ctx)
+{
+    return (fs_ctx->cfg->num_blocks > 2) ? 2 : 1;
+}
+
+psa_status_t its_flash_fs_mblock_erase_step(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+    uint32_t block_id;
+
+    if (fs_ctx->erase_pending == 0) {
+        return PSA_SUCCESS;
+    }
+
+    /* Keep the same order as its_mblock_erase_scratch_blocks(): the metadata
+     * scratch block is erased before the data scratch block.
+     */
+    if (fs_ctx->erase_pending == its_mblock_num_scratch_blocks(fs_ctx)) {
+        block_id = fs_ctx->scratch_metablock;
+    } else {
+        block_id = its_flash_fs_mblock_cur_data_scratch_id(fs_ctx,
+                                                    (ITS_LOGICAL_DBLOCK0 + 1));
+    }
+
+    if (fs_ctx->ops->erase_sector != NULL) {
+        err = its_flash_fs_erase_sector(fs_ctx, block_id,
+                                        fs_ctx->erase_offset);
+        fs_ctx->erase_offset += fs_ctx->cfg->sector_size;
+    } else {
+        err = its_flash_fs_erase(fs_ctx, block_id);
+        fs_ctx->erase_offset = fs_ctx->cfg->block_size;
+    }
+    if (err != PSA_SUCCESS) {
+        /* Restart the erase of this block at the next attempt */
+        fs_ctx->erase_offset = 0;
+        return err;
+    }
+
+    if (fs_ctx->erase_offset >= fs_ctx->cfg->block_size) {
+        fs_ctx->erase_offset = 0;
+        fs_ctx->erase_pending--;
+    }
+
+#ifdef ITS_FAST_MOUNT
+    if ((fs_ctx->erase_pending == 0) && fs_ctx->clean_marker_deferred) {
+        fs_ctx->clean_marker_deferred = false;
+        return its_flash_fs_mblock_set_clean_marker(fs_ctx);
+    }
+#endif
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_mblock_erase_complete(
+                                              struct its_flash_fs_ctx_t *fs_ctx)
+{
+    psa_status_t err;
+
+#ifdef ITS_FAST_MOUNT
+    /* The scratch blocks are about to be modified, so there is no point in
+     * setting the clean marker once they are erased.
+     */
+    fs_ctx->clean_marker_deferred = false;
+#endif
+
+    while (fs_ctx->erase_pending != 0) {
+        err = its_flash_fs_mblock_erase_step(fs_ctx);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_BACKGROUND_ERASE */
+
 /**
  * \brief Updates scratch block meta.
  *
@@ -560,7 +707,7 @@ static psa_status_t its_mblock_update_scratch_block_meta(
 
     /* Calculate the position */
     pos = its_mblock_block_meta_offset(lblock);
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
+    return its_flash_fs_write(fs_ctx, fs_ctx->scratch_metablock,
                               (const uint8_t *)block_meta, pos,
                               ITS_BLOCK_METADATA_SIZE);
 }
@@ -770,7 +917,7 @@ static psa_status_t its_mblock_write_scratch_meta_header(
 #endif
 
     /* Write the metadata block header */
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
+    return its_flash_fs_write(fs_ctx, fs_ctx->scratch_metablock,
                               (uint8_t *)(&fs_ctx->meta_block_header), 0,
                               ITS_BLOCK_META_HEADER_SIZE);
 }
@@ -880,13 +1027,24 @@ static psa_status_t its_mblock_reserve_file(struct its_flash_fs_ctx_t *fs_ctx,
     psa_status_t err;
     uint32_t i;
 
+    size_t reserved;
+
     for (i = 0; i < its_num_active_dblocks(fs_ctx); i++) {
         err = its_flash_fs_mblock_read_block_metadata(fs_ctx, i, block_meta);
         if (err != PSA_SUCCESS) {
             return PSA_ERROR_GENERIC_ERROR;
         }
 
-        if (block_meta->free_size >= size) {
+        reserved = 0;
+        /* The end of the metadata blocks is kept free for the append journal
+         * and the clean marker.
+         */
+        if (i == ITS_LOGICAL_DBLOCK0) {
+            reserved = ITS_MBLOCK_END_RESERVED_SIZE;
+        }
+
+        if ((block_meta->free_size >= reserved) &&
+            (block_meta->free_size - reserved >= size)) {
             /* Set file metadata */
             file_meta->lblock = i;
             file_meta->data_idx = fs_ctx->cfg->block_size
@@ -965,6 +1123,548 @@ static psa_status_t its_init_get_active_metablock(
     return PSA_SUCCESS;
 }
 
+#if defined(ITS_FAST_MOUNT) || defined(ITS_APPEND_IN_PLACE)
+/**
+ * \brief Calculates the FNV-1a hash of a buffer.
+ *
+ * \param[in] data  Pointer to the buffer
+ * \param[in] len   Size of the buffer
+ *
+ * \return Returns the hash value.
+ */
+static uint32_t its_mblock_hash(const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t hash = 0x811C9DC5U;
+
+    while (len-- > 0) {
+        hash = (hash ^ *p++) * 0x01000193U;
+    }
+
+    return hash;
+}
+
+/**
+ * \brief Checks whether a flash area is in the erased state.
+ *
+ * \param[in] fs_ctx    Filesystem context
+ * \param[in] block_id  Block ID
+ * \param[in] offset    Offset position from the init of the block
+ * \param[in] size      Number of bytes to check
+ *
+ * \return Returns PSA_SUCCESS if the area is erased. Otherwise, it returns
+ *         an error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_check_erased(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t block_id, size_t offset,
+                                            size_t size)
+{
+    psa_status_t err;
+    size_t i;
+    size_t bytes_to_read;
+    uint8_t buf[32];
+
+    while (size > 0) {
+        bytes_to_read = ITS_UTILS_MIN(size, sizeof(buf));
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, block_id, buf, offset,
+                                bytes_to_read);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        for (i = 0; i < bytes_to_read; i++) {
+            if (buf[i] != fs_ctx->cfg->erase_val) {
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+        }
+
+        offset += bytes_to_read;
+        size -= bytes_to_read;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_FAST_MOUNT || ITS_APPEND_IN_PLACE */
+
+#ifdef ITS_FAST_MOUNT
+/**
+ * \brief Calculates the check value of a clean marker.
+ *
+ * \note The check only has to detect a marker which was partially programmed
+ *       when the power failed, or disturbed since. It is not a MAC: the rest
+ *       of the metadata, including the XOR checked by
+ *       ITS_VALIDATE_METADATA_FROM_FLASH, is not authenticated either, and ITS
+ *       relies on its flash area not being writable outside of the SPE. Any
+ *       single byte change in the marker changes the FNV-1a hash.
+ *
+ * \param[in] marker  Pointer to the clean marker
+ *
+ * \return Returns the FNV-1a hash of the marker fields preceding the check.
+ */
+static uint32_t its_mblock_clean_marker_check(
+                                const struct its_mblock_clean_marker_t *marker)
+{
+    return its_mblock_hash(marker,
+                           offsetof(struct its_mblock_clean_marker_t, check));
+}
+
+/**
+ * \brief Reads and validates the clean marker of a metadata block.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Metadata block ID
+ * \param[out]    marker    Pointer to the clean marker
+ *
+ * \return Returns PSA_SUCCESS if the block holds a valid clean marker, which
+ *         has not been cancelled, and has not been written since. Otherwise,
+ *         it returns an error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_read_clean_marker(
+                                       struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t block_id,
+                                       struct its_mblock_clean_marker_t *marker)
+{
+    psa_status_t err;
+    size_t marker_offset = fs_ctx->cfg->block_size
+                           - ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE;
+
+    err = fs_ctx->ops->read(fs_ctx->cfg, block_id, (uint8_t *)marker,
+                            marker_offset, ITS_MBLOCK_CLEAN_MARKER_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if ((marker->magic != ITS_MBLOCK_CLEAN_MARKER_MAGIC) ||
+        (marker->active_metablock != ITS_OTHER_META_BLOCK(block_id)) ||
+        (marker->check != its_mblock_clean_marker_check(marker))) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    /* The marker must not have been cancelled */
+    err = its_mblock_check_erased(fs_ctx, block_id,
+                                  marker_offset + ITS_MBLOCK_CLEAN_MARKER_SIZE,
+                                  ITS_MBLOCK_CLEAN_MARKER_CANCEL_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* The block must still be a scratch block, i.e. no metadata block header
+     * has been written to it after the marker.
+     */
+    return its_mblock_check_erased(fs_ctx, block_id, 0,
+                                   ITS_BLOCK_META_HEADER_SIZE);
+}
+
+/**
+ * \brief Initializes the context from the clean marker, without validating the
+ *        metadata or erasing the scratch blocks.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns PSA_SUCCESS if the filesystem was cleanly shut down and the
+ *         context has been initialized. Otherwise, the full initialization must
+ *         be performed.
+ */
+static psa_status_t its_mblock_fast_mount(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_mblock_clean_marker_t marker;
+    struct its_mblock_clean_marker_t tmp_marker;
+    struct its_metadata_block_header_t h_meta;
+    uint32_t marker_block = ITS_BLOCK_INVALID_ID;
+    uint32_t i;
+    psa_status_t err;
+
+    for (i = ITS_METADATA_BLOCK0; i <= ITS_METADATA_BLOCK1; i++) {
+        if (its_mblock_read_clean_marker(fs_ctx, i, &tmp_marker)
+            == PSA_SUCCESS) {
+            if (marker_block != ITS_BLOCK_INVALID_ID) {
+                /* Only the scratch metadata block can hold a clean marker */
+                return PSA_ERROR_GENERIC_ERROR;
+            }
+            marker_block = i;
+            marker = tmp_marker;
+        }
+    }
+
+    if (marker_block == ITS_BLOCK_INVALID_ID) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    err = fs_ctx->ops->read(fs_ctx->cfg, marker.active_metablock,
+                            (uint8_t *)&h_meta, 0, ITS_BLOCK_META_HEADER_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    /* The marker is only valid for the exact header it was written for */
+    if ((h_meta.fs_version != ITS_SUPPORTED_VERSION) ||
+        (tfm_memcmp(&h_meta, &marker.header, ITS_BLOCK_META_HEADER_SIZE) != 0)
+        || (its_mblock_validate_swap_count(fs_ctx, h_meta.active_swap_count)
+            != PSA_SUCCESS)) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    fs_ctx->meta_block_header = h_meta;
+    fs_ctx->active_metablock = marker.active_metablock;
+    fs_ctx->scratch_metablock = marker_block;
+    fs_ctx->clean_marker = true;
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_FAST_MOUNT */
+
+#ifdef ITS_APPEND_IN_PLACE
+/**
+ * \brief Gets the offset of a record of the append journal in a metadata
+ *        block.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] rec     Index of the record
+ *
+ * \return Return offset value in metadata block
+ */
+static size_t its_mblock_append_record_offset(struct its_flash_fs_ctx_t *fs_ctx,
+                                              uint32_t rec)
+{
+    return fs_ctx->cfg->block_size - ITS_MBLOCK_END_RESERVED_SIZE
+           + rec * (ITS_MBLOCK_APPEND_RECORD_SIZE
+                    + ITS_MBLOCK_APPEND_COMMIT_SIZE);
+}
+
+/**
+ * \brief Finds the append slot of a file.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] idx     File metadata entry index
+ *
+ * \return Returns the slot, or NULL if the file has none.
+ */
+static struct its_mblock_append_slot_t *its_mblock_append_find(
+                                       const struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t idx)
+{
+    uint32_t i;
+
+    for (i = 0; i < ITS_APPEND_NUM_FILES; i++) {
+        if (fs_ctx->append_slots[i].file_idx == idx) {
+            return (struct its_mblock_append_slot_t *)&fs_ctx->append_slots[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Finds the append slot of a file, or allocates a free one.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     idx     File metadata entry index
+ *
+ * \return Returns the slot, or NULL if all the slots are in use.
+ */
+static struct its_mblock_append_slot_t *its_mblock_append_alloc(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t idx)
+{
+    struct its_mblock_append_slot_t *slot;
+
+    slot = its_mblock_append_find(fs_ctx, idx);
+    if (slot == NULL) {
+        slot = its_mblock_append_find(fs_ctx, ITS_METADATA_INVALID_INDEX);
+        if (slot != NULL) {
+            slot->file_idx = idx;
+            slot->flags = 0;
+        }
+    }
+
+    return slot;
+}
+
+/**
+ * \brief Frees all the append slots, for an empty journal.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+static void its_mblock_append_reset(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    uint32_t i;
+
+    for (i = 0; i < ITS_APPEND_NUM_FILES; i++) {
+        fs_ctx->append_slots[i].file_idx = ITS_METADATA_INVALID_INDEX;
+        fs_ctx->append_slots[i].flags = 0;
+    }
+
+    fs_ctx->append_next = 0;
+}
+
+/**
+ * \brief Checks that the journal area of the active metadata block is not used
+ *        by logical data block 0 data, which is the case for a filesystem
+ *        created without the reserved area.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns true if the journal can be used.
+ */
+static bool its_mblock_append_journal_reserved(
+                                              struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_block_meta_t block_meta_0;
+
+    if (its_flash_fs_mblock_read_block_metadata(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                                &block_meta_0)
+        != PSA_SUCCESS) {
+        return false;
+    }
+
+    return (block_meta_0.free_size >= ITS_MBLOCK_END_RESERVED_SIZE);
+}
+
+/**
+ * \brief Commits a journal record.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Metadata block ID
+ * \param[in]     rec       Index of the record
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_append_commit_record(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t block_id,
+                                             uint32_t rec)
+{
+    uint8_t commit[ITS_MBLOCK_APPEND_COMMIT_SIZE] = {0};
+    uint32_t magic = ITS_MBLOCK_APPEND_COMMIT_MAGIC;
+
+    tfm_memcpy(commit, &magic, sizeof(magic));
+
+    return its_flash_fs_write(fs_ctx, block_id, commit,
+                              its_mblock_append_record_offset(fs_ctx, rec)
+                              + ITS_MBLOCK_APPEND_RECORD_SIZE,
+                              sizeof(commit));
+}
+
+/**
+ * \brief Programs a journal record, and optionally commits it.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Metadata block ID
+ * \param[in]     rec       Index of the record
+ * \param[in]     idx       File metadata entry index
+ * \param[in]     size      Size of the file
+ * \param[in]     tail      Bytes of the file after its last full program unit
+ * \param[in]     commit    True to commit the record
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_append_write_record(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t block_id,
+                                             uint32_t rec,
+                                             uint32_t idx,
+                                             size_t size,
+                                             const uint8_t *tail,
+                                             bool commit)
+{
+    struct its_mblock_append_record_t record;
+    size_t offset = its_mblock_append_record_offset(fs_ctx, rec);
+    psa_status_t err;
+
+    (void)tfm_memset(&record, 0, ITS_MBLOCK_APPEND_RECORD_SIZE);
+    record.file_idx = idx;
+    record.cur_size = (uint32_t)size;
+    tfm_memcpy(record.tail, tail, sizeof(record.tail));
+    record.check = its_mblock_hash(&record,
+                           offsetof(struct its_mblock_append_record_t, check));
+
+    err = its_flash_fs_write(fs_ctx, block_id, (const uint8_t *)&record,
+                             offset, ITS_MBLOCK_APPEND_RECORD_SIZE);
+    if ((err != PSA_SUCCESS) || !commit) {
+        return err;
+    }
+
+    return its_mblock_append_commit_record(fs_ctx, block_id, rec);
+}
+
+/**
+ * \brief Replays the append journal of the active metadata block into the
+ *        append slots.
+ *
+ * \details A record which was not fully programmed is skipped, as nothing is
+ *          programmed after it. The file of a record which was not committed
+ *          is marked as dirty, as its data may have been partially programmed
+ *          after the end of the file, so that it is only appended to by
+ *          copying its data block.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_append_load(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_mblock_append_record_t record;
+    struct its_mblock_append_slot_t *slot;
+    uint32_t magic;
+    size_t offset;
+    psa_status_t err;
+    uint32_t rec;
+
+    its_mblock_append_reset(fs_ctx);
+
+    if (!its_mblock_append_journal_reserved(fs_ctx)) {
+        /* Never append in place */
+        fs_ctx->append_next = ITS_APPEND_JOURNAL_RECORDS;
+        return PSA_SUCCESS;
+    }
+
+    for (rec = 0; rec < ITS_APPEND_JOURNAL_RECORDS; rec++) {
+        offset = its_mblock_append_record_offset(fs_ctx, rec);
+
+        if (its_mblock_check_erased(fs_ctx, fs_ctx->active_metablock, offset,
+                                    ITS_MBLOCK_APPEND_RECORD_SIZE)
+            == PSA_SUCCESS) {
+            break;
+        }
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
+                                (uint8_t *)&record, offset,
+                                ITS_MBLOCK_APPEND_RECORD_SIZE);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if ((record.check != its_mblock_hash(&record,
+                           offsetof(struct its_mblock_append_record_t, check)))
+            || (record.file_idx >= fs_ctx->cfg->max_num_files)) {
+            continue;
+        }
+
+        slot = its_mblock_append_alloc(fs_ctx, record.file_idx);
+        if (slot == NULL) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        err = fs_ctx->ops->read(fs_ctx->cfg, fs_ctx->active_metablock,
+                                (uint8_t *)&magic,
+                                offset + ITS_MBLOCK_APPEND_RECORD_SIZE,
+                                sizeof(magic));
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        if (magic == ITS_MBLOCK_APPEND_COMMIT_MAGIC) {
+            slot->cur_size = record.cur_size;
+            tfm_memcpy(slot->tail, record.tail, sizeof(slot->tail));
+            slot->flags |= ITS_MBLOCK_APPEND_SIZE;
+        } else {
+            slot->flags |= ITS_MBLOCK_APPEND_DIRTY;
+        }
+    }
+
+    fs_ctx->append_next = rec;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Programs the state of the append slots in the journal of the scratch
+ *        metadata block, so that it is carried to the next active metadata
+ *        block. The dropped files are not carried, and the staged state is
+ *        carried instead of the current one.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[out]    num     Number of records programmed
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_mblock_append_carry(struct its_flash_fs_ctx_t *fs_ctx,
+                                            uint32_t *num)
+{
+    const struct its_mblock_append_slot_t *slot;
+    psa_status_t err;
+    uint32_t rec = 0;
+    uint32_t i;
+
+    for (i = 0; i < ITS_APPEND_NUM_FILES; i++) {
+        slot = &fs_ctx->append_slots[i];
+        if ((slot->file_idx == ITS_METADATA_INVALID_INDEX) ||
+            (slot->flags & ITS_MBLOCK_APPEND_DROPPED)) {
+            continue;
+        }
+
+        if (slot->flags & ITS_MBLOCK_APPEND_STAGED) {
+            err = its_mblock_append_write_record(fs_ctx,
+                                                 fs_ctx->scratch_metablock,
+                                                 rec++, slot->file_idx,
+                                                 slot->staged_size,
+                                                 slot->staged_tail, true);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+            continue;
+        }
+
+        if (slot->flags & ITS_MBLOCK_APPEND_SIZE) {
+            err = its_mblock_append_write_record(fs_ctx,
+                                                 fs_ctx->scratch_metablock,
+                                                 rec++, slot->file_idx,
+                                                 slot->cur_size, slot->tail,
+                                                 true);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+
+        if (slot->flags & ITS_MBLOCK_APPEND_DIRTY) {
+            /* A record which is not committed keeps the file dirty */
+            err = its_mblock_append_write_record(fs_ctx,
+                                                 fs_ctx->scratch_metablock,
+                                                 rec++, slot->file_idx,
+                                                 slot->cur_size, slot->tail,
+                                                 false);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+        }
+    }
+
+    *num = rec;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Applies the staged and dropped state of the append slots, once the
+ *        metadata blocks have been swapped.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     num     Number of records carried to the journal
+ */
+static void its_mblock_append_apply(struct its_flash_fs_ctx_t *fs_ctx,
+                                    uint32_t num)
+{
+    struct its_mblock_append_slot_t *slot;
+    uint32_t i;
+
+    for (i = 0; i < ITS_APPEND_NUM_FILES; i++) {
+        slot = &fs_ctx->append_slots[i];
+        if (slot->flags & ITS_MBLOCK_APPEND_DROPPED) {
+            slot->file_idx = ITS_METADATA_INVALID_INDEX;
+            slot->flags = 0;
+        } else if (slot->flags & ITS_MBLOCK_APPEND_STAGED) {
+            /* The file data after the staged size is erased in the copy */
+            slot->cur_size = slot->staged_size;
+            tfm_memcpy(slot->tail, slot->staged_tail, sizeof(slot->tail));
+            slot->flags = ITS_MBLOCK_APPEND_SIZE;
+        }
+    }
+
+    fs_ctx->append_next = num;
+}
+#endif /* ITS_APPEND_IN_PLACE */
+
 psa_status_t its_flash_fs_mblock_cp_file_meta(struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t idx_start,
                                               uint32_t idx_end)
@@ -1053,6 +1753,31 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
         return err;
     }
 
+#ifdef ITS_BACKGROUND_ERASE
+    /* The scratch blocks are erased below, or known to be erased from the
+     * clean marker.
+     */
+    fs_ctx->erase_pending = 0;
+#ifdef ITS_FAST_MOUNT
+    fs_ctx->clean_marker_deferred = false;
+#endif
+#endif
+
+#ifdef ITS_FAST_MOUNT
+    /* If the filesystem was cleanly shut down, the active metadata block and
+     * the erased scratch blocks are known from the clean marker.
+     */
+    if (its_mblock_fast_mount(fs_ctx) == PSA_SUCCESS) {
+#ifdef ITS_APPEND_IN_PLACE
+        return its_mblock_append_load(fs_ctx);
+#else
+        return PSA_SUCCESS;
+#endif
+    }
+
+    fs_ctx->clean_marker = false;
+#endif
+
     err = its_init_get_active_metablock(fs_ctx);
     if (err != PSA_SUCCESS) {
         return PSA_ERROR_GENERIC_ERROR;
@@ -1071,14 +1796,35 @@ psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx)
         return PSA_ERROR_GENERIC_ERROR;
     }
 
+#ifdef ITS_APPEND_IN_PLACE
+    /* Nothing is appended in place to a filesystem to be upgraded */
+    its_mblock_append_reset(fs_ctx);
+#endif
+
     /* Upgrade the metadata header if required. */
-    return its_mblock_upgrade_meta_header(fs_ctx);
+    err = its_mblock_upgrade_meta_header(fs_ctx);
+#ifdef ITS_APPEND_IN_PLACE
+    if (err == PSA_SUCCESS) {
+        err = its_mblock_append_load(fs_ctx);
+    }
+#endif
+
+    return err;
 }
 
 psa_status_t its_flash_fs_mblock_meta_update_finalize(
                                               struct its_flash_fs_ctx_t *fs_ctx)
 {
     psa_status_t err;
+#ifdef ITS_APPEND_IN_PLACE
+    uint32_t num_records;
+
+    /* Carry the state of the files appended in place to the new journal */
+    err = its_mblock_append_carry(fs_ctx, &num_records);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+#endif
 
     /* Write the metadata block header to flash */
     err = its_mblock_write_scratch_meta_header(fs_ctx);
@@ -1094,9 +1840,23 @@ psa_status_t its_flash_fs_mblock_meta_update_finalize(
 
     /* Update the running context */
     its_mblock_swap_metablocks(fs_ctx);
+#ifdef ITS_APPEND_IN_PLACE
+    its_mblock_append_apply(fs_ctx, num_records);
+#endif
 
+#ifdef ITS_BACKGROUND_ERASE
+    /* Leave the erase of the meta block and current scratch block pending, to
+     * be performed by its_flash_fs_mblock_erase_step() or before the next
+     * update.
+     */
+    fs_ctx->erase_pending = its_mblock_num_scratch_blocks(fs_ctx);
+    fs_ctx->erase_offset = 0;
+
+    return PSA_SUCCESS;
+#else
     /* Erase meta block and current scratch block */
     return its_mblock_erase_scratch_blocks(fs_ctx);
+#endif
 }
 
 psa_status_t its_flash_fs_mblock_migrate_lb0_data_to_scratch(
@@ -1141,6 +1901,18 @@ psa_status_t its_flash_fs_mblock_read_file_meta(
     }
 #endif
 
+#ifdef ITS_APPEND_IN_PLACE
+    if (err == PSA_SUCCESS) {
+        const struct its_mblock_append_slot_t *slot =
+                                          its_mblock_append_find(fs_ctx, idx);
+
+        /* The size committed in the journal supersedes the metadata one */
+        if ((slot != NULL) && (slot->flags & ITS_MBLOCK_APPEND_SIZE)) {
+            file_meta->cur_size = slot->cur_size;
+        }
+    }
+#endif
+
     return err;
 }
 
@@ -1231,17 +2003,28 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
         metablock_to_erase_first = fs_ctx->scratch_metablock;
     }
 
-    err = fs_ctx->ops->erase(fs_ctx->cfg, metablock_to_erase_first);
+    err = its_flash_fs_erase(fs_ctx, metablock_to_erase_first);
     if (err != PSA_SUCCESS) {
         return err;
     }
 
-    err = fs_ctx->ops->erase(fs_ctx->cfg,
+    err = its_flash_fs_erase(fs_ctx,
                              ITS_OTHER_META_BLOCK(metablock_to_erase_first));
     if (err != PSA_SUCCESS) {
         return err;
     }
 
+#ifdef ITS_FAST_MOUNT
+    fs_ctx->clean_marker = false;
+#endif
+#ifdef ITS_BACKGROUND_ERASE
+    /* All blocks are erased below */
+    fs_ctx->erase_pending = 0;
+#ifdef ITS_FAST_MOUNT
+    fs_ctx->clean_marker_deferred = false;
+#endif
+#endif
+
     fs_ctx->meta_block_header.active_swap_count =
                                     (fs_ctx->cfg->erase_val == 0x00U) ? 1U : 0U;
     fs_ctx->meta_block_header.scratch_dblock = its_init_scratch_dblock(fs_ctx);
@@ -1276,7 +2059,7 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
         /* If a flash error is detected, the code erases the rest
          * of the blocks anyway to remove all data stored in them.
          */
-        err |= fs_ctx->ops->erase(fs_ctx->cfg,
+        err |= its_flash_fs_erase(fs_ctx,
                                   i + its_init_dblock_start(fs_ctx));
     }
 
@@ -1321,9 +2104,107 @@ psa_status_t its_flash_fs_mblock_reset_metablock(
 
     /* Swap active and scratch metablocks */
     its_mblock_swap_metablocks(fs_ctx);
+#ifdef ITS_APPEND_IN_PLACE
+    its_mblock_append_reset(fs_ctx);
+#endif
+
+    return PSA_SUCCESS;
+}
+
+#ifdef ITS_FAST_MOUNT
+psa_status_t its_flash_fs_mblock_set_clean_marker(
+                                              struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_mblock_clean_marker_t marker;
+    struct its_block_meta_t block_meta_0;
+    psa_status_t err;
+
+    if (fs_ctx->clean_marker) {
+        return PSA_SUCCESS;
+    }
+
+#ifdef ITS_BACKGROUND_ERASE
+    /* The marker is programmed in the scratch metadata block, so it is set
+     * once the erase of the scratch blocks has completed.
+     */
+    if (fs_ctx->erase_pending != 0) {
+        fs_ctx->clean_marker_deferred = true;
+        return PSA_SUCCESS;
+    }
+#endif
+
+    /* A filesystem created without the reserved area may store logical data
+     * block 0 data where the marker would be programmed. In that case, the
+     * full validation is always performed.
+     */
+    err = its_flash_fs_mblock_read_block_metadata(fs_ctx, ITS_LOGICAL_DBLOCK0,
+                                                  &block_meta_0);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    if (block_meta_0.free_size < ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE) {
+        return PSA_SUCCESS;
+    }
+
+    (void)tfm_memset(&marker, 0, ITS_MBLOCK_CLEAN_MARKER_SIZE);
+    marker.magic = ITS_MBLOCK_CLEAN_MARKER_MAGIC;
+    marker.active_metablock = fs_ctx->active_metablock;
+    marker.header = fs_ctx->meta_block_header;
+    marker.check = its_mblock_clean_marker_check(&marker);
+
+    err = its_flash_fs_write(fs_ctx, fs_ctx->scratch_metablock,
+                             (uint8_t *)&marker,
+                             fs_ctx->cfg->block_size
+                             - ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE,
+                             ITS_MBLOCK_CLEAN_MARKER_SIZE);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = fs_ctx->ops->flush(fs_ctx->cfg, fs_ctx->scratch_metablock);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    fs_ctx->clean_marker = true;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_flash_fs_mblock_clear_clean_marker(
+                                              struct its_flash_fs_ctx_t *fs_ctx)
+{
+    uint8_t cancel[ITS_MBLOCK_CLEAN_MARKER_CANCEL_SIZE];
+    psa_status_t err;
+
+    if (!fs_ctx->clean_marker) {
+        return PSA_SUCCESS;
+    }
+
+    /* Program the area after the marker, which is left erased while the
+     * marker is valid. This does not require the block to be erased.
+     */
+    (void)tfm_memset(cancel, (uint8_t)~fs_ctx->cfg->erase_val, sizeof(cancel));
+
+    err = its_flash_fs_write(fs_ctx, fs_ctx->scratch_metablock, cancel,
+                             fs_ctx->cfg->block_size
+                             - ITS_MBLOCK_CLEAN_MARKER_CANCEL_SIZE,
+                             sizeof(cancel));
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = fs_ctx->ops->flush(fs_ctx->cfg, fs_ctx->scratch_metablock);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    fs_ctx->clean_marker = false;
 
     return PSA_SUCCESS;
 }
+#endif /* ITS_FAST_MOUNT */
 
 void its_flash_fs_mblock_set_data_scratch(struct its_flash_fs_ctx_t *fs_ctx,
                                           uint32_t phy_id, uint32_t lblock)
@@ -1365,11 +2246,183 @@ psa_status_t its_flash_fs_mblock_update_scratch_file_meta(
 
     /* Calculate the position */
     pos = its_mblock_file_meta_offset(fs_ctx, idx);
-    return fs_ctx->ops->write(fs_ctx->cfg, fs_ctx->scratch_metablock,
+    return its_flash_fs_write(fs_ctx, fs_ctx->scratch_metablock,
                               (const uint8_t *)file_meta, pos,
                               ITS_FILE_METADATA_SIZE);
 }
 
+#ifdef ITS_APPEND_IN_PLACE
+psa_status_t its_flash_fs_mblock_append_begin(
+                                     struct its_flash_fs_ctx_t *fs_ctx,
+                                     uint32_t idx,
+                                     const struct its_file_meta_t *file_meta,
+                                     size_t new_size,
+                                     const uint8_t *tail)
+{
+    struct its_mblock_append_slot_t *slot;
+    psa_status_t err;
+
+    /* Changes staged by a failed update are not applied */
+    its_flash_fs_mblock_append_discard(fs_ctx);
+
+    /* The data of logical data block 0 is in the metadata block, which is
+     * copied by each update.
+     */
+    if ((file_meta->lblock == ITS_LOGICAL_DBLOCK0) ||
+        (fs_ctx->append_next >= ITS_APPEND_JOURNAL_RECORDS)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    slot = its_mblock_append_find(fs_ctx, idx);
+    if (slot == NULL) {
+        if (!its_mblock_append_journal_reserved(fs_ctx)) {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
+        slot = its_mblock_append_alloc(fs_ctx, idx);
+        if (slot == NULL) {
+            return PSA_ERROR_NOT_SUPPORTED;
+        }
+    } else if (slot->flags & ITS_MBLOCK_APPEND_DIRTY) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* The file stays dirty until the record is committed */
+    slot->flags |= ITS_MBLOCK_APPEND_DIRTY;
+
+    err = its_mblock_append_write_record(fs_ctx, fs_ctx->active_metablock,
+                                         fs_ctx->append_next, idx, new_size,
+                                         tail, false);
+
+    /* The record is used, even if it was only partially programmed */
+    fs_ctx->append_next++;
+
+    return err;
+}
+
+psa_status_t its_flash_fs_mblock_append_commit(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t idx,
+                                             size_t new_size,
+                                             const uint8_t *tail)
+{
+    struct its_mblock_append_slot_t *slot;
+    psa_status_t err;
+
+    slot = its_mblock_append_find(fs_ctx, idx);
+    if ((slot == NULL) || (fs_ctx->append_next == 0)) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    err = its_mblock_append_commit_record(fs_ctx, fs_ctx->active_metablock,
+                                          fs_ctx->append_next - 1);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = fs_ctx->ops->flush(fs_ctx->cfg, fs_ctx->active_metablock);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    slot->cur_size = new_size;
+    tfm_memcpy(slot->tail, tail, sizeof(slot->tail));
+    slot->flags = ITS_MBLOCK_APPEND_SIZE;
+
+    return PSA_SUCCESS;
+}
+
+size_t its_flash_fs_mblock_append_get_tail(
+                                       const struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t idx,
+                                       const uint8_t **tail)
+{
+    const struct its_mblock_append_slot_t *slot;
+
+    slot = its_mblock_append_find(fs_ctx, idx);
+    if ((slot == NULL) || !(slot->flags & ITS_MBLOCK_APPEND_SIZE)) {
+        return 0;
+    }
+
+    *tail = slot->tail;
+
+    return slot->cur_size % fs_ctx->cfg->program_unit;
+}
+
+void its_flash_fs_mblock_append_discard(struct its_flash_fs_ctx_t *fs_ctx)
+{
+    struct its_mblock_append_slot_t *slot;
+    uint32_t i;
+
+    for (i = 0; i < ITS_APPEND_NUM_FILES; i++) {
+        slot = &fs_ctx->append_slots[i];
+        slot->flags &= ~(ITS_MBLOCK_APPEND_DROPPED | ITS_MBLOCK_APPEND_STAGED);
+        if (slot->flags == 0) {
+            slot->file_idx = ITS_METADATA_INVALID_INDEX;
+        }
+    }
+}
+
+psa_status_t its_flash_fs_mblock_append_stage(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t idx,
+                                             size_t new_size,
+                                             const uint8_t *tail)
+{
+    struct its_mblock_append_slot_t *slot;
+
+    if (!its_mblock_append_journal_reserved(fs_ctx)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    slot = its_mblock_append_alloc(fs_ctx, idx);
+    if (slot == NULL) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    slot->staged_size = new_size;
+    tfm_memcpy(slot->staged_tail, tail, sizeof(slot->staged_tail));
+    slot->flags &= ~ITS_MBLOCK_APPEND_DROPPED;
+    slot->flags |= ITS_MBLOCK_APPEND_STAGED;
+
+    return PSA_SUCCESS;
+}
+
+void its_flash_fs_mblock_append_drop(struct its_flash_fs_ctx_t *fs_ctx,
+                                     uint32_t idx)
+{
+    struct its_mblock_append_slot_t *slot;
+
+    slot = its_mblock_append_find(fs_ctx, idx);
+    if (slot != NULL) {
+        slot->flags &= ~ITS_MBLOCK_APPEND_STAGED;
+        slot->flags |= ITS_MBLOCK_APPEND_DROPPED;
+    }
+}
+
+/**
+ * \brief Checks whether a buffer only holds the erased value.
+ *
+ * \param[in] fs_ctx  Filesystem context
+ * \param[in] buf     Pointer to the buffer
+ * \param[in] size    Size of the buffer
+ *
+ * \return Returns true if all the bytes hold the erased value.
+ */
+static bool its_mblock_buf_is_erased(const struct its_flash_fs_ctx_t *fs_ctx,
+                                     const uint8_t *buf, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        if (buf[i] != fs_ctx->cfg->erase_val) {
+            return false;
+        }
+    }
+
+    return true;
+}
+#endif /* ITS_APPEND_IN_PLACE */
+
 psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
                                               uint32_t dst_block,
                                               size_t dst_offset,
@@ -1380,6 +2433,11 @@ psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
     psa_status_t status;
     size_t bytes_to_move;
     uint8_t dst_block_data_copy[ITS_MAX_BLOCK_DATA_COPY];
+#ifdef ITS_APPEND_IN_PLACE
+    size_t start;
+    size_t end;
+    size_t unit;
+#endif
 
     while (size > 0) {
         /* Calculates the number of bytes to move */
@@ -1394,12 +2452,41 @@ psa_status_t its_flash_fs_block_to_block_move(struct its_flash_fs_ctx_t *fs_ctx,
             return status;
         }
 
+#ifdef ITS_APPEND_IN_PLACE
+        /* Writes in flash the runs of program units which are not erased */
+        for (start = 0; start < bytes_to_move; start = end) {
+            unit = ITS_UTILS_MIN(fs_ctx->cfg->program_unit,
+                                 bytes_to_move - start);
+            if (its_mblock_buf_is_erased(fs_ctx, &dst_block_data_copy[start],
+                                         unit)) {
+                end = start + unit;
+                continue;
+            }
+
+            for (end = start + unit; end < bytes_to_move; end += unit) {
+                unit = ITS_UTILS_MIN(fs_ctx->cfg->program_unit,
+                                     bytes_to_move - end);
+                if (its_mblock_buf_is_erased(fs_ctx, &dst_block_data_copy[end],
+                                             unit)) {
+                    break;
+                }
+            }
+
+            status = its_flash_fs_write(fs_ctx, dst_block,
+                                        &dst_block_data_copy[start],
+                                        dst_offset + start, end - start);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+        }
+#else
         /* Writes in flash the in-memory block content after modification */
-        status = fs_ctx->ops->write(fs_ctx->cfg, dst_block, dst_block_data_copy,
+        status = its_flash_fs_write(fs_ctx, dst_block, dst_block_data_copy,
                                     dst_offset, bytes_to_move);
         if (status != PSA_SUCCESS) {
             return status;
         }
+#endif
 
         /* Updates pointers to the source and destination flash regions */
         dst_offset += bytes_to_move;
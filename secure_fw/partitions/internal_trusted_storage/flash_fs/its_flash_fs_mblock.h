@@ -16,6 +16,9 @@
 #include "its_flash_fs.h"
 #include "its_utils.h"
 #include "psa/error.h"
+#ifdef ITS_STATS
+#include "tfm_storage_stats.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -180,6 +183,174 @@ struct its_file_meta_t {
 };
 #undef _T3
 
+#ifdef ITS_FAST_MOUNT
+/*!
+ * \struct its_mblock_clean_marker_t
+ *
+ * \brief Structure to store the clean marker, which is programmed at the end of
+ *        the erased scratch metadata block once an update has completed. It
+ *        binds the clean state to the header of the active metadata block.
+ *
+ * \note The check must be the last member to allow it to be programmed last.
+ *
+ * \note This structure is programmed to flash, so its size must be padded
+ *       to a multiple of the maximum required flash program unit.
+ */
+#define _T4 \
+    uint32_t magic;             /*!< ITS_MBLOCK_CLEAN_MARKER_MAGIC */ \
+    uint32_t active_metablock;  /*!< Active metadata block ID */ \
+    struct its_metadata_block_header_t header; /*!< Copy of the active \
+                                                *   metadata block header \
+                                                */ \
+    uint32_t check;             /*!< Check value of the fields above */
+
+struct its_mblock_clean_marker_t {
+    _T4
+#if ((ITS_FLASH_MAX_ALIGNMENT) > 4)
+    uint8_t roundup[sizeof(struct __attribute__((__aligned__(ITS_FLASH_MAX_ALIGNMENT))) { _T4 }) -
+                    sizeof(struct { _T4 })];
+#endif
+};
+#undef _T4
+
+/*!
+ * \def ITS_MBLOCK_CLEAN_MARKER_CANCEL_SIZE
+ *
+ * \brief Size of the area, following the clean marker, which is programmed to
+ *        cancel it before the scratch metadata block is modified.
+ */
+#define ITS_MBLOCK_CLEAN_MARKER_CANCEL_SIZE \
+    ITS_UTILS_MAX(ITS_FLASH_MAX_ALIGNMENT, 4)
+
+/*!
+ * \def ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE
+ *
+ * \brief Size reserved at the end of the metadata blocks for the clean marker.
+ *        Logical data block 0 data is never allocated in this area.
+ */
+#define ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE \
+    (sizeof(struct its_mblock_clean_marker_t) + \
+     ITS_MBLOCK_CLEAN_MARKER_CANCEL_SIZE)
+#endif /* ITS_FAST_MOUNT */
+
+#ifdef ITS_APPEND_IN_PLACE
+#ifndef ITS_APPEND_JOURNAL_RECORDS
+#define ITS_APPEND_JOURNAL_RECORDS  16
+#endif
+
+#ifndef ITS_APPEND_NUM_FILES
+#define ITS_APPEND_NUM_FILES        4
+#endif
+
+/* Each file can be carried to the next journal with two records */
+#if (2 * ITS_APPEND_NUM_FILES) >= ITS_APPEND_JOURNAL_RECORDS
+#error "ITS_APPEND_JOURNAL_RECORDS must be more than twice ITS_APPEND_NUM_FILES"
+#endif
+
+/*!
+ * \struct its_mblock_append_record_t
+ *
+ * \brief Structure to store an append journal record. A record is programmed
+ *        in the active metadata block for each append done in place, and
+ *        holds the new size of the file and the bytes of its last program
+ *        unit, which is only programmed once it is full. The record is
+ *        committed by programming the word which follows it, once the data
+ *        has been programmed.
+ *
+ * \note The check must be the last member to allow it to be programmed last.
+ *
+ * \note This structure is programmed to flash, so its size must be padded
+ *       to a multiple of the maximum required flash program unit.
+ */
+#define _T5 \
+    uint32_t file_idx;          /*!< Index of the file metadata entry */ \
+    uint32_t cur_size;          /*!< Size of the file after the append */ \
+    uint8_t tail[ITS_FLASH_MAX_ALIGNMENT]; /*!< Bytes of the file after the \
+                                            *   last full program unit \
+                                            */ \
+    uint32_t check;             /*!< Check value of the fields above */
+
+struct its_mblock_append_record_t {
+    _T5
+#if ((ITS_FLASH_MAX_ALIGNMENT) > 4)
+    uint8_t roundup[sizeof(struct __attribute__((__aligned__(ITS_FLASH_MAX_ALIGNMENT))) { _T5 }) -
+                    sizeof(struct { _T5 })];
+#endif
+};
+#undef _T5
+
+/*!
+ * \def ITS_MBLOCK_APPEND_COMMIT_SIZE
+ *
+ * \brief Size of the area, following each journal record, which is programmed
+ *        to commit it.
+ */
+#define ITS_MBLOCK_APPEND_COMMIT_SIZE  ITS_UTILS_MAX(ITS_FLASH_MAX_ALIGNMENT, 4)
+
+/*!
+ * \def ITS_MBLOCK_APPEND_JOURNAL_SIZE
+ *
+ * \brief Size reserved in the metadata blocks for the append journal, before
+ *        the clean marker. Logical data block 0 data is never allocated in
+ *        this area.
+ */
+#define ITS_MBLOCK_APPEND_JOURNAL_SIZE \
+    (ITS_APPEND_JOURNAL_RECORDS * \
+     (sizeof(struct its_mblock_append_record_t) + \
+      ITS_MBLOCK_APPEND_COMMIT_SIZE))
+
+/* Flags of the append slots */
+#define ITS_MBLOCK_APPEND_SIZE     (1U << 0) /* The slot holds the file size */
+#define ITS_MBLOCK_APPEND_DIRTY    (1U << 1) /* An append was interrupted */
+#define ITS_MBLOCK_APPEND_DROPPED  (1U << 2) /* Freed by the next finalize */
+#define ITS_MBLOCK_APPEND_STAGED   (1U << 3) /* Set by the next finalize */
+
+/*!
+ * \struct its_mblock_append_slot_t
+ *
+ * \brief Structure to store the state of a file appended in place, as
+ *        replayed from the append journal.
+ */
+struct its_mblock_append_slot_t {
+    uint32_t file_idx;          /*!< Index of the file metadata entry, or
+                                 *   ITS_METADATA_INVALID_INDEX if unused
+                                 */
+    size_t cur_size;            /*!< Size of the file */
+    uint8_t tail[ITS_FLASH_MAX_ALIGNMENT]; /*!< Bytes of the file after the
+                                            *   last full program unit
+                                            */
+    size_t staged_size;         /*!< Size of the file once the current
+                                 *   metadata update is finalized
+                                 */
+    uint8_t staged_tail[ITS_FLASH_MAX_ALIGNMENT]; /*!< Bytes after the last
+                                                   *   full program unit once
+                                                   *   the update is finalized
+                                                   */
+    uint32_t flags;             /*!< ITS_MBLOCK_APPEND_* flags */
+};
+#endif /* ITS_APPEND_IN_PLACE */
+
+#ifdef ITS_FAST_MOUNT
+#define ITS_MBLOCK_MARKER_AREA_SIZE   ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE
+#else
+#define ITS_MBLOCK_MARKER_AREA_SIZE   0
+#endif
+
+#ifdef ITS_APPEND_IN_PLACE
+#define ITS_MBLOCK_JOURNAL_AREA_SIZE  ITS_MBLOCK_APPEND_JOURNAL_SIZE
+#else
+#define ITS_MBLOCK_JOURNAL_AREA_SIZE  0
+#endif
+
+/*!
+ * \def ITS_MBLOCK_END_RESERVED_SIZE
+ *
+ * \brief Size reserved at the end of the metadata blocks, for the append
+ *        journal followed by the clean marker.
+ */
+#define ITS_MBLOCK_END_RESERVED_SIZE \
+    (ITS_MBLOCK_JOURNAL_AREA_SIZE + ITS_MBLOCK_MARKER_AREA_SIZE)
+
 /**
  * \struct its_flash_fs_ctx_t
  *
@@ -193,17 +364,141 @@ struct its_flash_fs_ctx_t {
                                                            */
     uint32_t active_metablock;  /**< Active metadata block */
     uint32_t scratch_metablock; /**< Scratch metadata block */
+#ifdef ITS_FAST_MOUNT
+    bool clean_marker;          /**< True if the scratch metadata block holds
+                                 *   a valid clean marker
+                                 */
+#endif
+#ifdef ITS_STATS
+    struct tfm_storage_flash_stats_t stats; /**< Flash statistics */
+#endif
+#ifdef ITS_BACKGROUND_ERASE
+    uint32_t erase_pending;     /**< Number of scratch blocks still to be
+                                 *   erased, the metadata block first
+                                 */
+    uint32_t erase_offset;      /**< Offset of the next sector to erase in the
+                                 *   first scratch block still to be erased
+                                 */
+#ifdef ITS_FAST_MOUNT
+    bool clean_marker_deferred; /**< True if the clean marker is to be set
+                                 *   once the scratch blocks are erased
+                                 */
+#endif
+#endif
+#ifdef ITS_APPEND_IN_PLACE
+    struct its_mblock_append_slot_t append_slots[ITS_APPEND_NUM_FILES];
+                                /**< Files appended in place */
+    uint32_t append_next;       /**< Index of the next free record of the
+                                 *   append journal of the active metadata
+                                 *   block
+                                 */
+#endif
 };
 
+/**
+ * \brief Programs data in a block with the write flash operation, and updates
+ *        the filesystem statistics.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Block ID
+ * \param[in]     buf       Buffer pointer to the write data
+ * \param[in]     offset    Offset position from the init of the block
+ * \param[in]     size      Number of bytes to write
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_write(struct its_flash_fs_ctx_t *fs_ctx,
+                                uint32_t block_id, const uint8_t *buf,
+                                size_t offset, size_t size);
+
+/**
+ * \brief Erases a block with the erase flash operation, and updates the
+ *        filesystem statistics.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Block ID
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_erase(struct its_flash_fs_ctx_t *fs_ctx,
+                                uint32_t block_id);
+
+/**
+ * \brief Erases one sector of a block with the erase_sector flash operation,
+ *        and updates the filesystem statistics.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     block_id  Block ID
+ * \param[in]     offset    Offset of the sector from the init of the block
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_erase_sector(struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t block_id, size_t offset);
+
 /**
  * \brief Initializes metadata block with the valid/active metablock.
  *
+ * \note If ITS_FAST_MOUNT is defined and a valid clean marker is found, the
+ *       metadata validation and the scratch blocks erase are skipped.
+ *
  * \param[in,out] fs_ctx  Filesystem context
  *
  * \return Returns value as specified in \ref psa_status_t
  */
 psa_status_t its_flash_fs_mblock_init(struct its_flash_fs_ctx_t *fs_ctx);
 
+#ifdef ITS_FAST_MOUNT
+/**
+ * \brief Programs the clean marker in the scratch metadata block, so that the
+ *        next initialization can skip the full filesystem validation.
+ *
+ * \note Must only be called once a filesystem operation has completed and the
+ *       scratch blocks have been erased.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_set_clean_marker(
+                                             struct its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Cancels the clean marker, if present. Must be called before the
+ *        scratch blocks are modified.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_clear_clean_marker(
+                                             struct its_flash_fs_ctx_t *fs_ctx);
+#endif /* ITS_FAST_MOUNT */
+
+#ifdef ITS_BACKGROUND_ERASE
+/**
+ * \brief Erases the next sector of the scratch blocks left to be erased by the
+ *        last metadata update, if any.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_erase_step(struct its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Completes the erase of the scratch blocks left to be erased by the
+ *        last metadata update. Must be called before the scratch blocks are
+ *        modified.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_erase_complete(
+                                             struct its_flash_fs_ctx_t *fs_ctx);
+#endif /* ITS_BACKGROUND_ERASE */
+
 /**
  * \brief Copies the file metadata entries between two indexes from the active
  *        metadata block to the scratch metadata block.
@@ -288,6 +583,9 @@ psa_status_t its_flash_fs_mblock_migrate_lb0_data_to_scratch(
 /**
  * \brief Reads specified file metadata.
  *
+ * \note With ITS_APPEND_IN_PLACE, the current size of the file is the one
+ *       committed in the append journal, if any.
+ *
  * \param[in,out] fs_ctx     Filesystem context
  * \param[in]     idx        File metadata entry index
  * \param[out]    file_meta  Pointer to file meta structure
@@ -401,6 +699,109 @@ psa_status_t its_flash_fs_mblock_update_scratch_file_meta(
                                        uint32_t idx,
                                        const struct its_file_meta_t *file_meta);
 
+#ifdef ITS_APPEND_IN_PLACE
+/**
+ * \brief Starts an append done in place, by programming a journal record
+ *        with the new size of the file in the active metadata block.
+ *
+ * \details The append is only done in place if the file is not in the logical
+ *          data block 0, the journal has a free record, and no previous
+ *          append to the file was interrupted. The record is not applied
+ *          until it is committed by \ref its_flash_fs_mblock_append_commit.
+ *
+ * \param[in,out] fs_ctx     Filesystem context
+ * \param[in]     idx        File metadata entry index
+ * \param[in]     file_meta  File metadata, as returned by
+ *                           \ref its_flash_fs_mblock_read_file_meta
+ * \param[in]     new_size   Size of the file after the append
+ * \param[in]     tail       Bytes of the file after its last full program
+ *                           unit once appended
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the append cannot be done in
+ *         place, in which case nothing is programmed. Otherwise, it returns
+ *         error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_append_begin(
+                                     struct its_flash_fs_ctx_t *fs_ctx,
+                                     uint32_t idx,
+                                     const struct its_file_meta_t *file_meta,
+                                     size_t new_size,
+                                     const uint8_t *tail);
+
+/**
+ * \brief Commits the journal record programmed by
+ *        \ref its_flash_fs_mblock_append_begin, once the appended data has
+ *        been programmed.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     idx       File metadata entry index
+ * \param[in]     new_size  Size of the file after the append
+ * \param[in]     tail      Bytes of the file after its last full program unit
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_flash_fs_mblock_append_commit(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t idx,
+                                             size_t new_size,
+                                             const uint8_t *tail);
+
+/**
+ * \brief Gets the bytes of a file after its last full program unit, when they
+ *        are held in the append journal rather than in the data block.
+ *
+ * \param[in]  fs_ctx  Filesystem context
+ * \param[in]  idx     File metadata entry index
+ * \param[out] tail    Pointer to the bytes after the last full program unit
+ *
+ * \return Returns the number of bytes, which is 0 if the end of the file is in
+ *         the data block.
+ */
+size_t its_flash_fs_mblock_append_get_tail(
+                                       const struct its_flash_fs_ctx_t *fs_ctx,
+                                       uint32_t idx,
+                                       const uint8_t **tail);
+
+/**
+ * \brief Discards the journal changes staged by a metadata update which failed
+ *        before it was finalized. Must be called before a metadata update
+ *        stages or drops files.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ */
+void its_flash_fs_mblock_append_discard(struct its_flash_fs_ctx_t *fs_ctx);
+
+/**
+ * \brief Stages the bytes of a file after its last full program unit to be
+ *        kept in the journal, instead of being programmed in the data block,
+ *        when the current metadata update is finalized.
+ *
+ * \param[in,out] fs_ctx    Filesystem context
+ * \param[in]     idx       File metadata entry index
+ * \param[in]     new_size  Size of the file after the update
+ * \param[in]     tail      Bytes of the file after its last full program unit
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the journal cannot hold them, in
+ *         which case they must be programmed in the data block. Otherwise,
+ *         returns PSA_SUCCESS.
+ */
+psa_status_t its_flash_fs_mblock_append_stage(
+                                             struct its_flash_fs_ctx_t *fs_ctx,
+                                             uint32_t idx,
+                                             size_t new_size,
+                                             const uint8_t *tail);
+
+/**
+ * \brief Drops the journal state of a file which is rewritten or deleted by
+ *        the current metadata update, once it is finalized.
+ *
+ * \param[in,out] fs_ctx  Filesystem context
+ * \param[in]     idx     File metadata entry index
+ */
+void its_flash_fs_mblock_append_drop(struct its_flash_fs_ctx_t *fs_ctx,
+                                     uint32_t idx);
+#endif /* ITS_APPEND_IN_PLACE */
+
 /**
  * \brief Moves data from source block ID to destination block ID.
  *
@@ -418,6 +819,10 @@ psa_status_t its_flash_fs_mblock_update_scratch_file_meta(
  *       It also assumes that the destination block is already erased and ready
  *       to be written.
  *
+ * \note With ITS_APPEND_IN_PLACE, the program units which are erased in the
+ *       source block are not programmed, so that data can still be appended
+ *       in place after the moved files.
+ *
  * \return Returns PSA_SUCCESS if the function is executed correctly. Otherwise,
  *         it returns PSA_ERROR_STORAGE_FAILURE.
  */
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "its_coalesce.h"
+
+#include "its_utils.h"
+#include "tfm_internal_trusted_storage.h"
+#include "tfm_its_req_mngr.h"
+#include "tfm_memory_utils.h"
+#include "tfm_timer_api.h"
+
+/* Coalescing window of a file, opened when a set is written to flash */
+struct its_coalesce_entry_t {
+    bool in_use;                      /*!< True if the window is open */
+    bool pending;                     /*!< True if data is waiting to be
+                                       *   written
+                                       */
+    int32_t client_id;                /*!< Owner of the file */
+    psa_storage_uid_t uid;            /*!< UID of the file */
+    psa_storage_create_flags_t flags; /*!< Create flags of the file */
+    size_t size;                      /*!< Size of the file data */
+    uint32_t start;                   /*!< Timestamp of the window opening */
+    uint32_t sets;                    /*!< Number of sets waiting to be
+                                       *   written
+                                       */
+    uint8_t data[ITS_MAX_ASSET_SIZE]; /*!< Latest data of the file */
+};
+
+static struct its_coalesce_entry_t its_coalesce[ITS_COALESCE_NUM_ASSETS];
+
+/* The windows are only opened if the timer can close them */
+static bool its_coalesce_enabled;
+
+/**
+ * \brief Finds the open coalescing window of a file.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] uid        Identifier for the data
+ *
+ * \return Pointer to the window, or NULL if there is none
+ */
+static struct its_coalesce_entry_t *its_coalesce_find(int32_t client_id,
+                                                      psa_storage_uid_t uid)
+{
+    uint32_t i;
+
+    for (i = 0; i < ITS_COALESCE_NUM_ASSETS; i++) {
+        if (its_coalesce[i].in_use && (its_coalesce[i].client_id == client_id)
+            && (its_coalesce[i].uid == uid)) {
+            return &its_coalesce[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Closes a coalescing window, discarding any data waiting in it.
+ *
+ * \param[in] entry  Window to close
+ */
+static void its_coalesce_close(struct its_coalesce_entry_t *entry)
+{
+    (void)tfm_memset(entry, 0, sizeof(*entry));
+}
+
+/**
+ * \brief Writes the data waiting in a coalescing window, if any. The window
+ *        stays open.
+ *
+ * \param[in] entry  Window to write
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+static psa_status_t its_coalesce_write(struct its_coalesce_entry_t *entry)
+{
+    psa_status_t status;
+
+    if (!entry->pending) {
+        return PSA_SUCCESS;
+    }
+
+    status = tfm_its_set_file(entry->client_id, entry->uid, entry->size,
+                              entry->flags, entry->data);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    entry->pending = false;
+    entry->sets = 0;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Writes the data waiting in a coalescing window, if any, and closes
+ *        it. The window is left open if the write fails, so that the data is
+ *        not lost.
+ *
+ * \param[in] entry  Window to commit
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+static psa_status_t its_coalesce_drain(struct its_coalesce_entry_t *entry)
+{
+    psa_status_t status;
+
+    status = its_coalesce_write(entry);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    its_coalesce_close(entry);
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Opens a coalescing window for a file which was just written, if a
+ *        window is free.
+ *
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] uid           Identifier for the data
+ * \param[in] data_length   Size of the file data in bytes
+ * \param[in] create_flags  Flags indicating the properties of the data
+ */
+static void its_coalesce_open(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_length,
+                              psa_storage_create_flags_t create_flags)
+{
+    uint32_t i;
+
+    for (i = 0; i < ITS_COALESCE_NUM_ASSETS; i++) {
+        if (!its_coalesce[i].in_use) {
+            its_coalesce[i].in_use = true;
+            its_coalesce[i].client_id = client_id;
+            its_coalesce[i].uid = uid;
+            its_coalesce[i].flags = create_flags;
+            its_coalesce[i].size = data_length;
+            its_coalesce[i].start = tfm_timer_get_timestamp();
+            return;
+        }
+    }
+}
+
+bool its_coalesce_init(void)
+{
+    /* Without a timer, the windows would only be closed by the next request,
+     * which may never come, and a timestamp of 0 would never expire them.
+     */
+    its_coalesce_enabled = (tfm_timer_set(0) == PSA_SUCCESS);
+
+    return its_coalesce_enabled;
+}
+
+psa_status_t its_coalesce_set(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_length,
+                              psa_storage_create_flags_t create_flags)
+{
+    psa_status_t status;
+    struct its_coalesce_entry_t *entry;
+
+    entry = its_coalesce_find(client_id, uid);
+
+    /* A set with the same size and flags as the file written when the window
+     * was opened replaces the file with the same layout, which can not fail
+     * for lack of space, so it can be completed before it is written.
+     */
+    if ((entry != NULL) && (entry->size == data_length) &&
+        (entry->flags == create_flags)) {
+        (void)its_req_mngr_read(entry->data, data_length);
+        entry->pending = true;
+        entry->sets++;
+
+        if (entry->sets >= ITS_COALESCE_MAX_SETS) {
+            return its_coalesce_write(entry);
+        }
+
+        return PSA_SUCCESS;
+    }
+
+    status = tfm_its_set_file(client_id, uid, data_length, create_flags, NULL);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* The data waiting in the window, if any, is older than the data just
+     * written.
+     */
+    if (entry != NULL) {
+        its_coalesce_close(entry);
+    }
+
+    /* Write once files can not be replaced, so there is nothing to coalesce */
+    if (its_coalesce_enabled &&
+        !(create_flags & PSA_STORAGE_FLAG_WRITE_ONCE) &&
+        (data_length <= ITS_MAX_ASSET_SIZE)) {
+        its_coalesce_open(client_id, uid, data_length, create_flags);
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_coalesce_get(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_offset,
+                              size_t data_size,
+                              size_t *p_data_length)
+{
+    struct its_coalesce_entry_t *entry;
+
+    entry = its_coalesce_find(client_id, uid);
+    if ((entry == NULL) || !entry->pending) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    /* Boundary check the incoming request */
+    if (data_offset > entry->size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    data_size = ITS_UTILS_MIN(data_size, entry->size - data_offset);
+
+    its_req_mngr_write(entry->data + data_offset, data_size);
+
+    *p_data_length = data_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_coalesce_get_info(int32_t client_id,
+                                   psa_storage_uid_t uid,
+                                   struct psa_storage_info_t *p_info)
+{
+    struct its_coalesce_entry_t *entry;
+
+    entry = its_coalesce_find(client_id, uid);
+    if ((entry == NULL) || !entry->pending) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    p_info->capacity = entry->size;
+    p_info->size = entry->size;
+    p_info->flags = entry->flags;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t its_coalesce_commit(int32_t client_id, psa_storage_uid_t uid)
+{
+    struct its_coalesce_entry_t *entry;
+
+    entry = its_coalesce_find(client_id, uid);
+    if (entry == NULL) {
+        return PSA_SUCCESS;
+    }
+
+    return its_coalesce_drain(entry);
+}
+
+void its_coalesce_discard(int32_t client_id, psa_storage_uid_t uid)
+{
+    struct its_coalesce_entry_t *entry;
+
+    entry = its_coalesce_find(client_id, uid);
+    if (entry != NULL) {
+        its_coalesce_close(entry);
+    }
+}
+
+psa_status_t its_coalesce_flush(void)
+{
+    psa_status_t status;
+    psa_status_t ret = PSA_SUCCESS;
+    uint32_t i;
+
+    for (i = 0; i < ITS_COALESCE_NUM_ASSETS; i++) {
+        if (its_coalesce[i].in_use) {
+            status = its_coalesce_drain(&its_coalesce[i]);
+            if (status != PSA_SUCCESS) {
+                ret = status;
+            }
+        }
+    }
+
+    return ret;
+}
+
+void its_coalesce_expire(void)
+{
+    uint32_t now = tfm_timer_get_timestamp();
+    uint32_t i;
+
+    for (i = 0; i < ITS_COALESCE_NUM_ASSETS; i++) {
+        if (its_coalesce[i].in_use &&
+            (now - its_coalesce[i].start >= ITS_COALESCE_WINDOW)) {
+            if (its_coalesce_drain(&its_coalesce[i]) != PSA_SUCCESS) {
+                /* Retry the write once the window has run again, rather than
+                 * on every tick.
+                 */
+                its_coalesce[i].start = now;
+            }
+        }
+    }
+}
+
+void its_coalesce_set_timer(void)
+{
+    uint32_t now = tfm_timer_get_timestamp();
+    uint32_t timeout = 0;
+    uint32_t elapsed;
+    uint32_t remaining;
+    uint32_t i;
+
+    if (!its_coalesce_enabled) {
+        return;
+    }
+
+    for (i = 0; i < ITS_COALESCE_NUM_ASSETS; i++) {
+        if (!its_coalesce[i].in_use) {
+            continue;
+        }
+
+        /* A window which is already due is closed on the next tick */
+        elapsed = now - its_coalesce[i].start;
+        remaining = (elapsed < ITS_COALESCE_WINDOW) ?
+                    (ITS_COALESCE_WINDOW - elapsed) : 1;
+
+        if ((timeout == 0) || (remaining < timeout)) {
+            timeout = remaining;
+        }
+    }
+
+    (void)tfm_timer_set(timeout);
+}
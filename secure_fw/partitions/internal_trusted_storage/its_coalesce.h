@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/**
+ * \file its_coalesce.h
+ *
+ * \brief Coalescing of repeated sets to the same ITS file. When a file is
+ *        written, a coalescing window is opened for it, if one is free. The
+ *        following sets of the file with the same size and flags complete
+ *        straight away, and only replace the data held in RAM by the window.
+ *        The data is written every ITS_COALESCE_MAX_SETS sets, and when the
+ *        window is closed by the partition timer, ITS_COALESCE_WINDOW
+ *        timestamp ticks after it was opened.
+ */
+
+#ifndef __ITS_COALESCE_H__
+#define __ITS_COALESCE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+#include "psa/storage_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ITS_COALESCE_NUM_ASSETS
+#define ITS_COALESCE_NUM_ASSETS 2
+#endif
+
+#ifndef ITS_COALESCE_MAX_SETS
+#define ITS_COALESCE_MAX_SETS 8
+#endif
+
+#ifndef ITS_COALESCE_WINDOW
+#define ITS_COALESCE_WINDOW 1000000
+#endif
+
+/**
+ * \brief Enables the coalescing if the partition timer is available, so
+ *        that the windows are closed. Otherwise, the sets are written
+ *        straight away.
+ *
+ * \return Returns true if the coalescing is enabled.
+ */
+bool its_coalesce_init(void);
+
+/**
+ * \brief Sets a file, reading its data from the client request. The data is
+ *        held in the open window of the file if it has the same size and
+ *        flags, and written otherwise, in which case a window is opened for
+ *        the file if one is free.
+ *
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] uid           Identifier for the data
+ * \param[in] data_length   Size of the file data in bytes
+ * \param[in] create_flags  Flags indicating the properties of the data
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+psa_status_t its_coalesce_set(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_length,
+                              psa_storage_create_flags_t create_flags);
+
+/**
+ * \brief Reads the data held in the window of a file, which is newer than
+ *        the data stored, and writes it to the client.
+ *
+ * \param[in]  client_id      Identifier of the asset's owner (client)
+ * \param[in]  uid            Identifier for the data
+ * \param[in]  data_offset    Offset within the data to start the read from
+ * \param[in]  data_size      Size of the data to read, in bytes
+ * \param[out] p_data_length  On success, the size of the data read
+ *
+ * \return Returns PSA_ERROR_DOES_NOT_EXIST if no data of the file is held, in
+ *         which case it must be read from the storage, or another error code
+ *         as specified in \ref psa_status_t
+ */
+psa_status_t its_coalesce_get(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_offset,
+                              size_t data_size,
+                              size_t *p_data_length);
+
+/**
+ * \brief Gets the information of the data held in the window of a file.
+ *
+ * \param[in]  client_id  Identifier of the asset's owner (client)
+ * \param[in]  uid        Identifier for the data
+ * \param[out] p_info     Information of the data held
+ *
+ * \return Returns PSA_ERROR_DOES_NOT_EXIST if no data of the file is held, in
+ *         which case the information must be read from the storage, or
+ *         PSA_SUCCESS
+ */
+psa_status_t its_coalesce_get_info(int32_t client_id,
+                                   psa_storage_uid_t uid,
+                                   struct psa_storage_info_t *p_info);
+
+/**
+ * \brief Writes the data held in the window of a file, if any, and closes
+ *        the window. The window is left open if the write fails, so that the
+ *        data is not lost.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] uid        Identifier for the data
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+psa_status_t its_coalesce_commit(int32_t client_id, psa_storage_uid_t uid);
+
+/**
+ * \brief Closes the window of a file, if any, discarding the data held in it.
+ *        Called once the file is removed.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] uid        Identifier for the data
+ */
+void its_coalesce_discard(int32_t client_id, psa_storage_uid_t uid);
+
+/**
+ * \brief Writes the data held in all the windows, and closes them.
+ *
+ * \note The windows whose data fails to be written are left open, so that
+ *       the write is retried later.
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+psa_status_t its_coalesce_flush(void);
+
+/**
+ * \brief Writes the data of the windows opened ITS_COALESCE_WINDOW timestamp
+ *        ticks ago or more, and closes them. A window whose data fails to be
+ *        written stays open for another ITS_COALESCE_WINDOW ticks. Called when
+ *        the partition timer expires.
+ */
+void its_coalesce_expire(void);
+
+/**
+ * \brief Sets the partition timer to expire when the oldest open window is
+ *        due to be closed, or cancels it if no window is open. Called after
+ *        each signal is handled, which also clears the timer signal.
+ */
+void its_coalesce_set_timer(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_COALESCE_H__ */
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "its_plaintext_cache.h"
+
+#include <string.h>
+
+#include "its_utils.h"
+#include "tfm_memory_utils.h"
+
+#ifndef ITS_PLAINTEXT_CACHE_ENTRIES
+/* By default, allow one entry per asset */
+#define ITS_PLAINTEXT_CACHE_ENTRIES ITS_NUM_ASSETS
+#endif
+
+struct its_plaintext_cache_entry_t {
+    uint8_t fid[ITS_FILE_ID_SIZE]; /*!< Identifier of the cached file */
+    uint32_t offset;               /*!< Offset of the plaintext in the pool */
+    uint32_t size;                 /*!< Plaintext size, 0 if entry is free */
+    uint32_t last_use;             /*!< Value of use_counter at last access */
+};
+
+/* Plaintext of the cached files. The plaintext of the entries in use is packed
+ * from the start of the pool, and the unused part is kept zeroed.
+ */
+static uint8_t cache_pool[TFM_ITS_PLAINTEXT_CACHE_SIZE];
+static uint32_t cache_pool_used;
+
+static struct its_plaintext_cache_entry_t
+                                    cache_entries[ITS_PLAINTEXT_CACHE_ENTRIES];
+static uint32_t use_counter;
+static struct tfm_storage_cache_stats_t cache_stats;
+
+static struct its_plaintext_cache_entry_t *find_entry(const uint8_t *fid)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < ITS_PLAINTEXT_CACHE_ENTRIES; idx++) {
+        if (cache_entries[idx].size != 0 &&
+            tfm_memcmp(cache_entries[idx].fid, fid, ITS_FILE_ID_SIZE) == 0) {
+            return &cache_entries[idx];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Frees a cache entry, compacting the pool and zeroising the freed
+ *        plaintext.
+ *
+ * \param[in,out] entry  Entry to free
+ */
+static void remove_entry(struct its_plaintext_cache_entry_t *entry)
+{
+    uint32_t idx;
+    uint32_t end = entry->offset + entry->size;
+
+    /* Move the plaintext stored after the entry down over it */
+    memmove(&cache_pool[entry->offset], &cache_pool[end],
+            cache_pool_used - end);
+
+    for (idx = 0; idx < ITS_PLAINTEXT_CACHE_ENTRIES; idx++) {
+        if (cache_entries[idx].size != 0 &&
+            cache_entries[idx].offset > entry->offset) {
+            cache_entries[idx].offset -= entry->size;
+        }
+    }
+
+    cache_pool_used -= entry->size;
+
+    /* Zeroise the tail of the pool which is now unused */
+    tfm_memset(&cache_pool[cache_pool_used], 0, entry->size);
+    tfm_memset(entry, 0, sizeof(*entry));
+}
+
+static void evict_lru_entry(void)
+{
+    uint32_t idx;
+    struct its_plaintext_cache_entry_t *lru = NULL;
+
+    for (idx = 0; idx < ITS_PLAINTEXT_CACHE_ENTRIES; idx++) {
+        if (cache_entries[idx].size != 0 &&
+            (lru == NULL ||
+             (use_counter - cache_entries[idx].last_use) >
+             (use_counter - lru->last_use))) {
+            lru = &cache_entries[idx];
+        }
+    }
+
+    if (lru != NULL) {
+        remove_entry(lru);
+        cache_stats.evictions++;
+    }
+}
+
+psa_status_t its_plaintext_cache_get(const uint8_t *fid, uint8_t *data,
+                                     size_t data_size)
+{
+    struct its_plaintext_cache_entry_t *entry = find_entry(fid);
+
+    if (entry != NULL && entry->size != data_size) {
+        /* Stale entry, should not happen as long as the cache is invalidated
+         * on every update of the file.
+         */
+        remove_entry(entry);
+        entry = NULL;
+    }
+
+    if (entry == NULL) {
+        cache_stats.misses++;
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    tfm_memcpy(data, &cache_pool[entry->offset], data_size);
+    entry->last_use = ++use_counter;
+    cache_stats.hits++;
+
+    return PSA_SUCCESS;
+}
+
+void its_plaintext_cache_put(const uint8_t *fid, const uint8_t *data,
+                             size_t data_size)
+{
+    uint32_t idx;
+    struct its_plaintext_cache_entry_t *entry;
+
+    /* Empty files are not cached as the size marks the entry as free */
+    if (data_size == 0 || data_size > sizeof(cache_pool)) {
+        return;
+    }
+
+    its_plaintext_cache_invalidate(fid);
+
+    /* Evict entries until both a free entry and enough pool space exist */
+    for (;;) {
+        entry = NULL;
+        for (idx = 0; idx < ITS_PLAINTEXT_CACHE_ENTRIES; idx++) {
+            if (cache_entries[idx].size == 0) {
+                entry = &cache_entries[idx];
+                break;
+            }
+        }
+
+        if (entry != NULL &&
+            data_size <= sizeof(cache_pool) - cache_pool_used) {
+            break;
+        }
+
+        evict_lru_entry();
+    }
+
+    tfm_memcpy(entry->fid, fid, ITS_FILE_ID_SIZE);
+    entry->offset = cache_pool_used;
+    entry->size = data_size;
+    entry->last_use = ++use_counter;
+    tfm_memcpy(&cache_pool[cache_pool_used], data, data_size);
+    cache_pool_used += data_size;
+}
+
+void its_plaintext_cache_invalidate(const uint8_t *fid)
+{
+    struct its_plaintext_cache_entry_t *entry = find_entry(fid);
+
+    if (entry != NULL) {
+        remove_entry(entry);
+    }
+}
+
+void its_plaintext_cache_get_stats(struct tfm_storage_cache_stats_t *stats)
+{
+    *stats = cache_stats;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __ITS_PLAINTEXT_CACHE_H__
+#define __ITS_PLAINTEXT_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+#include "tfm_storage_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Copies the cached plaintext of a file into a buffer.
+ *
+ * \param[in]  fid       Identifier of the file
+ * \param[out] data      Buffer to copy the plaintext into
+ * \param[in]  data_size Plaintext size of the file, in bytes
+ *
+ * \return Returns PSA_SUCCESS if the file was found in the cache, and
+ *         PSA_ERROR_DOES_NOT_EXIST otherwise.
+ */
+psa_status_t its_plaintext_cache_get(const uint8_t *fid, uint8_t *data,
+                                     size_t data_size);
+
+/**
+ * \brief Adds the plaintext of a file to the cache, evicting the least
+ *        recently used entries if needed. Files larger than the cache are
+ *        not added.
+ *
+ * \param[in] fid       Identifier of the file
+ * \param[in] data      Plaintext of the file
+ * \param[in] data_size Plaintext size of the file, in bytes
+ */
+void its_plaintext_cache_put(const uint8_t *fid, const uint8_t *data,
+                             size_t data_size);
+
+/**
+ * \brief Removes a file from the cache, if present. Must be called before the
+ *        file is modified or deleted.
+ *
+ * \param[in] fid  Identifier of the file
+ */
+void its_plaintext_cache_invalidate(const uint8_t *fid);
+
+/**
+ * \brief Gets the cache statistics since boot.
+ *
+ * \param[out] stats  Pointer to the statistics to fill
+ */
+void its_plaintext_cache_get_stats(struct tfm_storage_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_PLAINTEXT_CACHE_H__ */
@@ -0,0 +1,593 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "its_shards.h"
+
+#include "its_utils.h"
+#include "tfm_memory_utils.h"
+#include "tfm_sp_log.h"
+
+/* Magic number of the root records, "ITSR" */
+#define ITS_SHARDS_ROOT_MAGIC       0x52535449U
+
+/* Number of words of a root record before the spilled asset counts */
+#define ITS_SHARDS_ROOT_HDR_WORDS   5
+
+/* Size of the largest root record, with its check word */
+#define ITS_SHARDS_ROOT_MAX_SIZE \
+    ITS_UTILS_ALIGN((ITS_SHARDS_ROOT_HDR_WORDS + ITS_NUM_SHARDS + 1) * \
+                    sizeof(uint32_t), ITS_FLASH_MAX_ALIGNMENT)
+
+/**
+ * \brief Root of a layout with more than one shard.
+ *
+ * It is stored as a record of words in the same order, followed by the spilled
+ * asset counts of the shards of the layout and a check word. The records are
+ * written one after the other in a root block, and in the other root block,
+ * once erased, when the block is full. The valid record with the highest
+ * sequence number is the root.
+ */
+struct its_shards_root_t {
+    uint32_t magic;            /*!< ITS_SHARDS_ROOT_MAGIC */
+    uint32_t seq;              /*!< Sequence number of the record */
+    uint32_t num_shards;       /*!< Number of shards of the layout */
+    uint32_t shard_num_blocks; /*!< Number of blocks of each shard */
+    uint32_t shard_num_files;  /*!< Maximum number of files of each shard */
+    uint32_t spilled[ITS_NUM_SHARDS];
+                               /*!< Number of the assets hashed to each shard
+                                *   which are stored in another shard
+                                */
+};
+
+static its_flash_fs_ctx_t shards_ctx[ITS_NUM_SHARDS];
+static struct its_flash_fs_config_t shards_cfg[ITS_NUM_SHARDS];
+static uint32_t shards_num = 1;
+static const struct its_flash_fs_ops_t *shards_ops;
+
+static struct its_shards_root_t shards_root;
+static struct its_flash_fs_config_t root_cfg;
+static uint32_t root_block;
+static size_t root_free[ITS_SHARDS_ROOT_NUM_BLOCKS];
+static uint32_t root_buf[ITS_SHARDS_ROOT_MAX_SIZE / sizeof(uint32_t)];
+
+/**
+ * \brief Computes the FNV-1a hash of a buffer.
+ *
+ * \param[in] data  Buffer to hash
+ * \param[in] size  Size of the buffer, in bytes
+ *
+ * \return Returns the hash.
+ */
+static uint32_t its_shards_fnv(const uint8_t *data, size_t size)
+{
+    uint32_t hash = 2166136261U; /* FNV-1a offset basis */
+    size_t idx;
+
+    for (idx = 0; idx < size; idx++) {
+        hash = (hash ^ data[idx]) * 16777619U; /* FNV-1a prime */
+    }
+
+    return hash;
+}
+
+/**
+ * \brief Gets the size of a root record, padded to the program unit.
+ *
+ * \param[in] num_shards  Number of shards of the layout
+ *
+ * \return Returns the size of the record, in bytes.
+ */
+static size_t its_shards_root_size(uint32_t num_shards)
+{
+    return ITS_UTILS_ALIGN((ITS_SHARDS_ROOT_HDR_WORDS + num_shards + 1) *
+                           sizeof(uint32_t), root_cfg.program_unit);
+}
+
+static bool its_shards_root_is_erased(size_t size)
+{
+    const uint8_t *buf = (const uint8_t *)root_buf;
+    size_t idx;
+
+    for (idx = 0; idx < size; idx++) {
+        if (buf[idx] != root_cfg.erase_val) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Reads the root records of both root blocks, and loads the valid one
+ *        with the highest sequence number.
+ *
+ * The free space of each root block starts after its last valid record. A
+ * block with a record which is not valid, such as one interrupted by a power
+ * failure, has no free space, as the record may be partially programmed.
+ *
+ * \return Returns PSA_ERROR_DOES_NOT_EXIST if there is no valid record,
+ *         PSA_ERROR_NOT_SUPPORTED if there is none but there are records with
+ *         more than ITS_NUM_SHARDS shards, or another error code as specified
+ *         in \ref psa_status_t
+ */
+static psa_status_t its_shards_root_load(void)
+{
+    const size_t hdr_size = ITS_SHARDS_ROOT_HDR_WORDS * sizeof(uint32_t);
+    bool found = false;
+    bool too_many_shards = false;
+    psa_status_t err;
+    uint32_t block;
+    uint32_t num_shards;
+    size_t offset;
+    size_t size;
+
+    for (block = 0; block < ITS_SHARDS_ROOT_NUM_BLOCKS; block++) {
+        root_free[block] = root_cfg.block_size;
+
+        for (offset = 0; offset + hdr_size <= root_cfg.block_size;
+             offset += size) {
+            err = shards_ops->read(&root_cfg, block, (uint8_t *)root_buf,
+                                   offset, hdr_size);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            if (its_shards_root_is_erased(hdr_size)) {
+                root_free[block] = offset;
+                break;
+            }
+
+            num_shards = root_buf[2];
+            if ((root_buf[0] != ITS_SHARDS_ROOT_MAGIC) || (num_shards < 2)) {
+                break;
+            }
+            if (num_shards > ITS_NUM_SHARDS) {
+                /* Written by a build with more shards, or interrupted */
+                too_many_shards = true;
+                break;
+            }
+
+            size = its_shards_root_size(num_shards);
+            if (offset + size > root_cfg.block_size) {
+                break;
+            }
+
+            err = shards_ops->read(&root_cfg, block, (uint8_t *)root_buf,
+                                   offset, size);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            if (root_buf[ITS_SHARDS_ROOT_HDR_WORDS + num_shards] !=
+                its_shards_fnv((const uint8_t *)root_buf,
+                               (ITS_SHARDS_ROOT_HDR_WORDS + num_shards) *
+                               sizeof(uint32_t))) {
+                break;
+            }
+
+            if (!found || (root_buf[1] > shards_root.seq)) {
+                tfm_memset(&shards_root, 0, sizeof(shards_root));
+                tfm_memcpy(&shards_root, root_buf,
+                           (ITS_SHARDS_ROOT_HDR_WORDS + num_shards) *
+                           sizeof(uint32_t));
+                root_block = block;
+                found = true;
+            }
+        }
+    }
+
+    if (found) {
+        return PSA_SUCCESS;
+    }
+
+    return too_many_shards ? PSA_ERROR_NOT_SUPPORTED : PSA_ERROR_DOES_NOT_EXIST;
+}
+
+/**
+ * \brief Writes the root in a new record, after the last record or at the
+ *        start of the other root block, which is erased first.
+ *
+ * A power failure leaves either the previous or the new record as the root.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_shards_root_write(void)
+{
+    size_t size = its_shards_root_size(shards_root.num_shards);
+    uint32_t block = root_block;
+    size_t offset = root_free[block];
+    psa_status_t err;
+
+    tfm_memset(root_buf, 0, size);
+    shards_root.seq++;
+    tfm_memcpy(root_buf, &shards_root,
+               (ITS_SHARDS_ROOT_HDR_WORDS + shards_root.num_shards) *
+               sizeof(uint32_t));
+    root_buf[ITS_SHARDS_ROOT_HDR_WORDS + shards_root.num_shards] =
+        its_shards_fnv((const uint8_t *)root_buf,
+                       (ITS_SHARDS_ROOT_HDR_WORDS + shards_root.num_shards) *
+                       sizeof(uint32_t));
+
+    if (offset + size > root_cfg.block_size) {
+        block = (block + 1) % ITS_SHARDS_ROOT_NUM_BLOCKS;
+        offset = 0;
+
+        root_free[block] = root_cfg.block_size;
+        err = shards_ops->erase(&root_cfg, block);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* A failed write may leave a partial record, after which nothing else is
+     * written until the block is erased.
+     */
+    root_free[block] = root_cfg.block_size;
+
+    err = shards_ops->write(&root_cfg, block, (const uint8_t *)root_buf,
+                            offset, size);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = shards_ops->flush(&root_cfg, block);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    root_block = block;
+    root_free[block] = offset + size;
+
+    return PSA_SUCCESS;
+}
+
+/**
+ * \brief Sets the configuration of a part of the ITS area.
+ *
+ * \param[in]  area_cfg       Configuration of the whole ITS area
+ * \param[in]  first_block    First block of the part
+ * \param[in]  num_blocks     Number of blocks of the part
+ * \param[in]  max_num_files  Maximum number of files of the part
+ * \param[out] cfg            Configuration of the part
+ */
+static void its_shards_set_cfg(const struct its_flash_fs_config_t *area_cfg,
+                               uint32_t first_block, uint32_t num_blocks,
+                               uint32_t max_num_files,
+                               struct its_flash_fs_config_t *cfg)
+{
+    *cfg = *area_cfg;
+
+    cfg->flash_area_addr = area_cfg->flash_area_addr
+                           + first_block * area_cfg->block_size;
+#ifdef ITS_RAM_FS
+    /* The RAM filesystem operations ignore the flash area address and
+     * address the buffer passed as flash device directly.
+     */
+    cfg->flash_dev = (uint8_t *)area_cfg->flash_dev
+                     + first_block * area_cfg->block_size;
+#endif
+    cfg->num_blocks = num_blocks;
+    cfg->max_num_files = max_num_files;
+}
+
+/**
+ * \brief Mounts the filesystem of a shard, or creates an empty one if it is
+ *        not valid and create_layout is set.
+ *
+ * \param[in] shard          Index of the shard
+ * \param[in] create_layout  True to create the filesystem if it is not valid
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_shards_mount(uint32_t shard, bool create_layout)
+{
+    psa_status_t err;
+
+    err = its_flash_fs_init_ctx(&shards_ctx[shard], &shards_cfg[shard],
+                                shards_ops);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    err = its_flash_fs_prepare(&shards_ctx[shard]);
+    if ((err != PSA_SUCCESS) && create_layout) {
+        LOG_INFFMT("Creating an empty ITS flash layout.\r\n");
+        err = its_flash_fs_wipe_all(&shards_ctx[shard]);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_flash_fs_prepare(&shards_ctx[shard]);
+    }
+
+    return err;
+}
+
+/**
+ * \brief Creates an empty layout with the given number of shards, and its
+ *        root.
+ *
+ * \param[in] area_cfg    Configuration of the whole ITS area
+ * \param[in] num_shards  Number of shards, at least 2
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_shards_create_layout(
+                                  const struct its_flash_fs_config_t *area_cfg,
+                                  uint32_t num_shards)
+{
+    uint32_t shard_num_blocks;
+    uint32_t shard;
+    uint32_t block;
+    psa_status_t err;
+
+    /* Each shard needs at least the metadata block and the scratch metadata
+     * block. A shard with data blocks also needs a scratch data block, so a
+     * shard cannot have 3 blocks.
+     */
+    shard_num_blocks = (area_cfg->num_blocks - ITS_SHARDS_ROOT_NUM_BLOCKS)
+                       / num_shards;
+    if (shard_num_blocks == 3) {
+        shard_num_blocks = 2;
+    }
+    if ((area_cfg->num_blocks < ITS_SHARDS_ROOT_NUM_BLOCKS) ||
+        (shard_num_blocks < 2)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    tfm_memset(&shards_root, 0, sizeof(shards_root));
+    shards_root.magic = ITS_SHARDS_ROOT_MAGIC;
+    shards_root.num_shards = num_shards;
+    shards_root.shard_num_blocks = shard_num_blocks;
+    /* The files of the whole area, less the extra file for atomic replacement,
+     * are split between the shards, which each have their own extra file.
+     */
+    shards_root.shard_num_files = (area_cfg->max_num_files - 1 + num_shards - 1)
+                                  / num_shards + 1;
+
+    LOG_INFFMT("Creating an empty ITS flash layout.\r\n");
+
+    /* The shards are created before the root, so that a root is only found
+     * with valid shards.
+     */
+    shards_num = num_shards;
+    for (shard = 0; shard < num_shards; shard++) {
+        its_shards_set_cfg(area_cfg,
+                           ITS_SHARDS_ROOT_NUM_BLOCKS
+                           + shard * shard_num_blocks,
+                           shard_num_blocks, shards_root.shard_num_files,
+                           &shards_cfg[shard]);
+
+        err = its_flash_fs_init_ctx(&shards_ctx[shard], &shards_cfg[shard],
+                                    shards_ops);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_flash_fs_wipe_all(&shards_ctx[shard]);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        err = its_flash_fs_prepare(&shards_ctx[shard]);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+    }
+
+    for (block = 0; block < ITS_SHARDS_ROOT_NUM_BLOCKS; block++) {
+        err = shards_ops->erase(&root_cfg, block);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+        root_free[block] = 0;
+    }
+    root_block = 0;
+
+    return its_shards_root_write();
+}
+
+psa_status_t its_shards_init(const struct its_flash_fs_config_t *area_cfg,
+                             const struct its_flash_fs_ops_t *ops,
+                             uint32_t num_shards,
+                             bool create_layout)
+{
+    psa_status_t err;
+    uint32_t shard;
+
+    if ((num_shards == 0) || (num_shards > ITS_NUM_SHARDS)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    shards_ops = ops;
+    tfm_memset(&shards_root, 0, sizeof(shards_root));
+    its_shards_set_cfg(area_cfg, 0, ITS_SHARDS_ROOT_NUM_BLOCKS, 0, &root_cfg);
+
+    if (area_cfg->num_blocks > ITS_SHARDS_ROOT_NUM_BLOCKS) {
+        err = ops->init(&root_cfg);
+        if (err != PSA_SUCCESS) {
+            return err;
+        }
+
+        /* The layout recorded in the root is used even if it has another
+         * number of shards, as the assets of one layout cannot be moved to
+         * another one in place.
+         */
+        err = its_shards_root_load();
+        if (err == PSA_SUCCESS) {
+            if (shards_root.num_shards != num_shards) {
+                LOG_INFFMT("Keeping the existing ITS flash layout.\r\n");
+            }
+
+            shards_num = shards_root.num_shards;
+            for (shard = 0; shard < shards_num; shard++) {
+                its_shards_set_cfg(area_cfg,
+                                   ITS_SHARDS_ROOT_NUM_BLOCKS
+                                   + shard * shards_root.shard_num_blocks,
+                                   shards_root.shard_num_blocks,
+                                   shards_root.shard_num_files,
+                                   &shards_cfg[shard]);
+
+                err = its_shards_mount(shard, create_layout);
+                if (err != PSA_SUCCESS) {
+                    return err;
+                }
+            }
+
+            return PSA_SUCCESS;
+        } else if (err != PSA_ERROR_DOES_NOT_EXIST) {
+            return err;
+        }
+    }
+
+    /* Without a root, the ITS area holds a single filesystem, which is kept
+     * if it is valid.
+     */
+    shards_num = 1;
+    shards_cfg[0] = *area_cfg;
+
+    err = its_flash_fs_init_ctx(&shards_ctx[0], &shards_cfg[0], ops);
+    if (err == PSA_SUCCESS) {
+        err = its_flash_fs_prepare(&shards_ctx[0]);
+        if ((err == PSA_SUCCESS) && (num_shards > 1)) {
+            LOG_INFFMT("Keeping the existing ITS flash layout.\r\n");
+        }
+    }
+
+    if ((err == PSA_SUCCESS) || !create_layout) {
+        return err;
+    }
+
+    if (num_shards == 1) {
+        return its_shards_mount(0, true);
+    }
+
+    return its_shards_create_layout(area_cfg, num_shards);
+}
+
+uint32_t its_shards_num(void)
+{
+    return shards_num;
+}
+
+its_flash_fs_ctx_t *its_shards_get_ctx(uint32_t shard)
+{
+    return &shards_ctx[shard];
+}
+
+const struct its_flash_fs_config_t *its_shards_get_cfg(uint32_t shard)
+{
+    return &shards_cfg[shard];
+}
+
+uint32_t its_shards_hash(const uint8_t *fid)
+{
+    if (shards_num == 1) {
+        return 0;
+    }
+
+    return its_shards_fnv(fid, ITS_FILE_ID_SIZE) % shards_num;
+}
+
+psa_status_t its_shards_get_info(const uint8_t *fid,
+                                 struct its_flash_fs_file_info_t *info,
+                                 uint32_t *shard)
+{
+    uint32_t hashed = its_shards_hash(fid);
+    psa_status_t err;
+    uint32_t probe;
+
+    *shard = hashed;
+
+    err = its_flash_fs_file_get_info(&shards_ctx[hashed], fid, info);
+    if ((err != PSA_ERROR_DOES_NOT_EXIST) || (shards_num == 1) ||
+        (shards_root.spilled[hashed] == 0)) {
+        return err;
+    }
+
+    /* Some assets of the hashed shard are stored in other shards */
+    for (probe = 1; probe < shards_num; probe++) {
+        *shard = (hashed + probe) % shards_num;
+        err = its_flash_fs_file_get_info(&shards_ctx[*shard], fid, info);
+        if (err != PSA_ERROR_DOES_NOT_EXIST) {
+            return err;
+        }
+    }
+
+    *shard = hashed;
+
+    return PSA_ERROR_DOES_NOT_EXIST;
+}
+
+psa_status_t its_shards_create(const uint8_t *fid,
+                               struct its_flash_fs_file_info_t *info,
+                               size_t size,
+                               const uint8_t *data,
+                               uint32_t *shard)
+{
+    uint32_t hashed = its_shards_hash(fid);
+    psa_status_t err;
+    uint32_t probe;
+
+    *shard = hashed;
+
+    err = its_flash_fs_file_write(&shards_ctx[hashed], fid, info, size, 0,
+                                  data);
+    if ((err != PSA_ERROR_INSUFFICIENT_STORAGE) || (shards_num == 1)) {
+        return err;
+    }
+
+    /* The root records the spilled asset before it is created, so that it is
+     * always looked up in the other shards. A power failure may leave the
+     * count too high, which only costs extra lookups.
+     */
+    shards_root.spilled[hashed]++;
+    err = its_shards_root_write();
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    for (probe = 1; probe < shards_num; probe++) {
+        *shard = (hashed + probe) % shards_num;
+        err = its_flash_fs_file_write(&shards_ctx[*shard], fid, info, size, 0,
+                                      data);
+        if (err != PSA_ERROR_INSUFFICIENT_STORAGE) {
+            return err;
+        }
+    }
+
+    *shard = hashed;
+
+    shards_root.spilled[hashed]--;
+    (void)its_shards_root_write();
+
+    return PSA_ERROR_INSUFFICIENT_STORAGE;
+}
+
+psa_status_t its_shards_delete(const uint8_t *fid, uint32_t shard)
+{
+    uint32_t hashed = its_shards_hash(fid);
+    psa_status_t err;
+
+    err = its_flash_fs_file_delete(&shards_ctx[shard], fid);
+    if ((err != PSA_SUCCESS) || (shard == hashed) ||
+        (shards_root.spilled[hashed] == 0)) {
+        return err;
+    }
+
+    /* The asset is deleted before the root, so that a power failure in between
+     * leaves the count too high rather than too low.
+     */
+    shards_root.spilled[hashed]--;
+
+    return its_shards_root_write();
+}
+
+uint32_t its_shards_num_spilled(uint32_t shard)
+{
+    return shards_root.spilled[shard];
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/**
+ * \file its_shards.h
+ *
+ * \brief Two-level metadata of the ITS filesystem. The ITS area holds a root
+ *        and a number of shards. Each shard is an independent filesystem,
+ *        whose metadata block is the second level of the metadata, and holds
+ *        the assets whose file id is hashed to it. The root records the
+ *        layout of the shards, and the number of assets stored out of their
+ *        hashed shard because it was full.
+ *
+ *        An update only rewrites the metadata of the shard holding the asset,
+ *        and the root when an asset is stored out of its hashed shard. A
+ *        lookup only scans the metadata of the hashed shard, unless some of
+ *        its assets are stored in other shards.
+ *
+ *        An ITS area without a root holds a single filesystem over the whole
+ *        area, which is the layout with a single shard.
+ */
+
+#ifndef __ITS_SHARDS_H__
+#define __ITS_SHARDS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flash_fs/its_flash_fs.h"
+#include "psa/error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ITS_NUM_SHARDS
+#define ITS_NUM_SHARDS 1
+#endif
+
+/* Number of blocks at the start of the ITS area holding the root of a layout
+ * with more than one shard. The root is written to each block in turn.
+ */
+#define ITS_SHARDS_ROOT_NUM_BLOCKS 2
+
+/**
+ * \brief Mounts the ITS layout found in the ITS area, or creates one.
+ *
+ * The layout recorded in the root is kept if it differs from the requested
+ * number of shards, so that the stored assets are not lost, and so is an ITS
+ * area without a root holding a single filesystem. A layout is only created
+ * if none is found.
+ *
+ * \param[in] area_cfg       Configuration of a single filesystem over the
+ *                           whole ITS area, with the maximum number of files
+ *                           of the whole ITS area
+ * \param[in] ops            Flash operations of the ITS area
+ * \param[in] num_shards     Number of shards of a new layout, at most
+ *                           ITS_NUM_SHARDS
+ * \param[in] create_layout  True to create a layout if none is found
+ *
+ * \return Returns PSA_ERROR_NOT_SUPPORTED if the layout found has more than
+ *         ITS_NUM_SHARDS shards, or another error code as specified in
+ *         \ref psa_status_t
+ */
+psa_status_t its_shards_init(const struct its_flash_fs_config_t *area_cfg,
+                             const struct its_flash_fs_ops_t *ops,
+                             uint32_t num_shards,
+                             bool create_layout);
+
+/**
+ * \brief Gets the number of shards of the mounted layout.
+ *
+ * \return Returns the number of shards.
+ */
+uint32_t its_shards_num(void);
+
+/**
+ * \brief Gets the filesystem context of a shard.
+ *
+ * \param[in] shard  Index of the shard, lower than its_shards_num()
+ *
+ * \return Returns the filesystem context.
+ */
+its_flash_fs_ctx_t *its_shards_get_ctx(uint32_t shard);
+
+/**
+ * \brief Gets the filesystem configuration of a shard.
+ *
+ * \param[in] shard  Index of the shard, lower than its_shards_num()
+ *
+ * \return Returns the filesystem configuration.
+ */
+const struct its_flash_fs_config_t *its_shards_get_cfg(uint32_t shard);
+
+/**
+ * \brief Gets the shard a file is hashed to.
+ *
+ * \param[in] fid  Identifier of the file
+ *
+ * \return Returns the index of the shard.
+ */
+uint32_t its_shards_hash(const uint8_t *fid);
+
+/**
+ * \brief Gets the information of a file, and the shard holding it.
+ *
+ * \param[in]  fid    Identifier of the file
+ * \param[out] info   Information of the file
+ * \param[out] shard  Shard holding the file, or the shard it is hashed to if
+ *                    it does not exist
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_shards_get_info(const uint8_t *fid,
+                                 struct its_flash_fs_file_info_t *info,
+                                 uint32_t *shard);
+
+/**
+ * \brief Creates a file, which does not exist, and writes the first chunk of
+ *        its data.
+ *
+ * The file is created in the shard it is hashed to, or in the next shard
+ * which has enough space if that one is full. The root then records that an
+ * asset of the hashed shard is stored in another shard, before the file is
+ * created.
+ *
+ * \param[in]  fid    Identifier of the file
+ * \param[in]  info   Information of the file, as for its_flash_fs_file_write()
+ * \param[in]  size   Size of the data to write, in bytes
+ * \param[in]  data   Data to write, or NULL if size is 0
+ * \param[out] shard  Shard holding the file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_shards_create(const uint8_t *fid,
+                               struct its_flash_fs_file_info_t *info,
+                               size_t size,
+                               const uint8_t *data,
+                               uint32_t *shard);
+
+/**
+ * \brief Deletes a file.
+ *
+ * \param[in] fid    Identifier of the file
+ * \param[in] shard  Shard holding the file
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t its_shards_delete(const uint8_t *fid, uint32_t shard);
+
+/**
+ * \brief Gets the number of assets hashed to a shard and stored in another
+ *        one, as recorded in the root. It can be higher than the actual
+ *        number after a power failure.
+ *
+ * \param[in] shard  Index of the shard, lower than its_shards_num()
+ *
+ * \return Returns the number of assets.
+ */
+uint32_t its_shards_num_spilled(uint32_t shard);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_SHARDS_H__ */
@@ -15,17 +15,25 @@
 #include "tfm_memory_utils.h"
 #include "tfm_its_defs.h"
 #include "tfm_its_req_mngr.h"
+#include "its_shards.h"
 #include "its_utils.h"
 #include "tfm_sp_log.h"
 
 #ifdef TFM_ITS_ENCRYPTED
 #include "its_crypto_interface.h"
+#ifdef TFM_ITS_PLAINTEXT_CACHE_SIZE
+#include "its_plaintext_cache.h"
+#endif
 #endif
 
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
 #include "ps_object_defs.h"
 #endif
 
+#ifdef ITS_COALESCE
+#include "its_coalesce.h"
+#endif
+
 #ifndef ITS_BUF_SIZE
 /* By default, set the ITS buffer size to the max asset size so that all
  * requests can be handled in one iteration.
@@ -53,7 +61,9 @@ static uint8_t enc_asset_data[ITS_UTILS_ALIGN(ITS_BUF_SIZE,
 static uint8_t g_fid[ITS_FILE_ID_SIZE];
 static struct its_flash_fs_file_info_t g_file_info;
 
-static its_flash_fs_ctx_t fs_ctx_its;
+/* Configuration of a single filesystem over the whole ITS area, from which
+ * the configuration of each ITS shard is derived.
+ */
 static struct its_flash_fs_config_t fs_cfg_its = {
     .flash_dev = &ITS_FLASH_DEV,
     .program_unit = ITS_FLASH_ALIGNMENT,
@@ -61,6 +71,15 @@ static struct its_flash_fs_config_t fs_cfg_its = {
     .max_num_files = ITS_NUM_ASSETS + 1, /* Extra file for atomic replacement */
 };
 
+#ifdef ITS_CREATE_FLASH_LAYOUT
+#define ITS_CREATE_LAYOUT true
+#else
+#define ITS_CREATE_LAYOUT false
+#endif
+
+/* Shard of the file identified by g_fid, set by its_file_get_info() */
+static uint32_t g_shard;
+
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
 static its_flash_fs_ctx_t fs_ctx_ps;
 static struct its_flash_fs_config_t fs_cfg_ps = {
@@ -74,11 +93,90 @@ static struct its_flash_fs_config_t fs_cfg_ps = {
 static its_flash_fs_ctx_t *get_fs_ctx(int32_t client_id)
 {
 #ifdef TFM_PARTITION_PROTECTED_STORAGE
-    return (client_id == TFM_SP_PS) ? &fs_ctx_ps : &fs_ctx_its;
+    if (client_id == TFM_SP_PS) {
+        return &fs_ctx_ps;
+    }
+#else
+    (void)client_id;
+#endif
+    return its_shards_get_ctx(g_shard);
+}
+
+static const struct its_flash_fs_config_t *get_fs_cfg(int32_t client_id)
+{
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (client_id == TFM_SP_PS) {
+        return &fs_cfg_ps;
+    }
+#else
+    (void)client_id;
+#endif
+    return its_shards_get_cfg(g_shard);
+}
+
+/**
+ * \brief Gets the information of the file identified by g_fid into
+ *        g_file_info, and selects the shard holding it for the next
+ *        operations on the file.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_file_get_info(int32_t client_id)
+{
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (client_id == TFM_SP_PS) {
+        return its_flash_fs_file_get_info(&fs_ctx_ps, g_fid, &g_file_info);
+    }
+#else
+    (void)client_id;
+#endif
+    return its_shards_get_info(g_fid, &g_file_info, &g_shard);
+}
+
+/**
+ * \brief Creates the file identified by g_fid, which does not exist, with
+ *        g_file_info, and writes the first chunk of its data.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] size       Size of the data to write, in bytes
+ * \param[in] data       Data to write, or NULL if size is 0
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_file_create(int32_t client_id,
+                                    size_t size,
+                                    const uint8_t *data)
+{
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (client_id == TFM_SP_PS) {
+        return its_flash_fs_file_write(&fs_ctx_ps, g_fid, &g_file_info, size,
+                                       0, data);
+    }
 #else
     (void)client_id;
-    return &fs_ctx_its;
 #endif
+    return its_shards_create(g_fid, &g_file_info, size, data, &g_shard);
+}
+
+/**
+ * \brief Deletes the file identified by g_fid.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+static psa_status_t its_file_delete(int32_t client_id)
+{
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if (client_id == TFM_SP_PS) {
+        return its_flash_fs_file_delete(&fs_ctx_ps, g_fid);
+    }
+#else
+    (void)client_id;
+#endif
+    return its_shards_delete(g_fid, g_shard);
 }
 
 /**
@@ -96,6 +194,57 @@ static void tfm_its_get_fid(int32_t client_id,
     tfm_memcpy(fid + sizeof(client_id), (const void *)&uid, sizeof(uid));
 }
 
+#ifdef TFM_ITS_ENCRYPTED
+/**
+ * \brief Reads the whole encrypted file identified by g_fid and g_file_info,
+ *        and decrypts it into asset_data.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ *
+ * \return Returns PSA_SUCCESS if the plaintext is in asset_data, or an error
+ *         code otherwise.
+ */
+static psa_status_t tfm_its_read_decrypt_file(int32_t client_id)
+{
+    psa_status_t status;
+
+#ifdef TFM_ITS_PLAINTEXT_CACHE_SIZE
+    /* Skip the read and decryption if the plaintext is cached */
+    if (its_plaintext_cache_get(g_fid, asset_data, g_file_info.size_max)
+        == PSA_SUCCESS) {
+        return PSA_SUCCESS;
+    }
+#endif
+
+    status = its_flash_fs_file_read(get_fs_ctx(client_id),
+                                    g_fid,
+                                    g_file_info.size_max,
+                                    0,
+                                    enc_asset_data);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    status = tfm_its_crypt_file(&g_file_info,
+                                g_fid,
+                                sizeof(g_fid),
+                                enc_asset_data,
+                                g_file_info.size_max,
+                                asset_data,
+                                sizeof(asset_data),
+                                false);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+#ifdef TFM_ITS_PLAINTEXT_CACHE_SIZE
+    its_plaintext_cache_put(g_fid, asset_data, g_file_info.size_max);
+#endif
+
+    return PSA_SUCCESS;
+}
+#endif /* TFM_ITS_ENCRYPTED */
+
 /**
  * \brief Initialise the static filesystem configurations.
  *
@@ -163,16 +312,8 @@ psa_status_t tfm_its_init(void)
         return status;
     }
 
-    /* Initialise the ITS filesystem context */
-    status = its_flash_fs_init_ctx(&fs_ctx_its, &fs_cfg_its, &ITS_FLASH_OPS);
-    if (status != PSA_SUCCESS) {
-        return status;
-    }
-
-    /* Prepare the ITS filesystem */
-    status = its_flash_fs_prepare(&fs_ctx_its);
-#ifdef ITS_CREATE_FLASH_LAYOUT
-    /* If ITS_CREATE_FLASH_LAYOUT is set, it indicates that it is required to
+    /* Mount the ITS shards and their root.
+     * If ITS_CREATE_FLASH_LAYOUT is set, it indicates that it is required to
      * create a ITS flash layout. ITS service will generate an empty and valid
      * ITS flash layout to store assets. It will erase all data located in the
      * assigned ITS memory area before generating the ITS layout.
@@ -181,29 +322,19 @@ psa_status_t tfm_its_init(void)
      * This flag can be set if the ITS memory area is located in persistent
      * memory without a previous valid ITS flash layout in it. That is the case
      * when it is the first time in the device life that the ITS service is
-     * executed.
+     * executed. A valid layout with another number of shards is kept.
      */
-     if (status != PSA_SUCCESS) {
-        /* Remove all data in the ITS memory area and create a valid ITS flash
-         * layout in that area.
-         */
-        LOG_INFFMT("Creating an empty ITS flash layout.\r\n");
-        status = its_flash_fs_wipe_all(&fs_ctx_its);
-        if (status != PSA_SUCCESS) {
-            return status;
-        }
-
-        /* Attempt to prepare again */
-        status = its_flash_fs_prepare(&fs_ctx_its);
+    status = its_shards_init(&fs_cfg_its, &ITS_FLASH_OPS, ITS_NUM_SHARDS,
+                             ITS_CREATE_LAYOUT);
+    if (status == PSA_ERROR_NOT_SUPPORTED) {
+        LOG_ERRFMT("[ITS] The ITS flash layout has more shards than "
+                   "ITS_NUM_SHARDS.\r\n");
     }
-#endif /* ITS_CREATE_FLASH_LAYOUT */
-
-#ifdef TFM_PARTITION_PROTECTED_STORAGE
-    /* Check status of ITS initialisation before continuing with PS */
     if (status != PSA_SUCCESS) {
         return status;
     }
 
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
     /* Initialise the PS filesystem context */
     status = its_flash_fs_init_ctx(&fs_ctx_ps, &fs_cfg_ps, &PS_FLASH_OPS);
     if (status != PSA_SUCCESS) {
@@ -243,15 +374,17 @@ psa_status_t tfm_its_init(void)
     return status;
 }
 
-psa_status_t tfm_its_set(int32_t client_id,
-                         psa_storage_uid_t uid,
-                         size_t data_length,
-                         psa_storage_create_flags_t create_flags)
+psa_status_t tfm_its_set_file(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_length,
+                              psa_storage_create_flags_t create_flags,
+                              const uint8_t *data)
 {
     psa_status_t status;
     size_t write_size;
     size_t offset;
     uint8_t *buffer_pnt = asset_data;
+    bool is_new;
 
 #ifdef TFM_ITS_ENCRYPTED
     /* The PS may also encrypt the data so we don't encrypt it's content. Thus
@@ -283,8 +416,8 @@ psa_status_t tfm_its_set(int32_t client_id,
     tfm_its_get_fid(client_id, uid, g_fid);
 
     /* Read file info */
-    status = its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
-                                        &g_file_info);
+    status = its_file_get_info(client_id);
+    is_new = (status == PSA_ERROR_DOES_NOT_EXIST);
     if (status == PSA_SUCCESS) {
         /* If the object exists and has the write once flag set, then it
          * cannot be modified.
@@ -299,6 +432,13 @@ psa_status_t tfm_its_set(int32_t client_id,
         return status;
     }
 
+#ifdef TFM_ITS_PLAINTEXT_CACHE_SIZE
+    /* Drop the cached plaintext before the file is modified, so that it is
+     * never stale even if the write fails.
+     */
+    its_plaintext_cache_invalidate(g_fid);
+#endif
+
     offset = 0;
     /* Populate the file info for the new file */
     g_file_info.size_max = data_length;
@@ -312,8 +452,12 @@ psa_status_t tfm_its_set(int32_t client_id,
     do {
         write_size = ITS_UTILS_MIN(data_length, sizeof(asset_data));
 
-        /* Read asset data from the caller */
-        (void)its_req_mngr_read(asset_data, write_size);
+        if (data != NULL) {
+            tfm_memcpy(asset_data, data + offset, write_size);
+        } else {
+            /* Read asset data from the caller */
+            (void)its_req_mngr_read(asset_data, write_size);
+        }
 
 #ifdef TFM_ITS_ENCRYPTED
         if (client_id != TFM_SP_PS) {
@@ -339,15 +483,202 @@ psa_status_t tfm_its_set(int32_t client_id,
 #endif
 
         /* Write to the file in the file system */
-        status = its_flash_fs_file_write(get_fs_ctx(client_id), g_fid,
-                                         &g_file_info, write_size, offset,
-                                         buffer_pnt);
+        if (is_new && (offset == 0)) {
+            status = its_file_create(client_id, write_size, buffer_pnt);
+        } else {
+            status = its_flash_fs_file_write(get_fs_ctx(client_id), g_fid,
+                                             &g_file_info, write_size, offset,
+                                             buffer_pnt);
+        }
         if (status != PSA_SUCCESS) {
             return status;
         }
 
         /* Do not create or truncate after the first iteration */
-        g_file_info.flags &= ~(ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE);
+        g_file_info.flags &= ~(ITS_FLASH_FS_FLAG_CREATE |
+                               ITS_FLASH_FS_FLAG_TRUNCATE);
+
+        offset += write_size;
+        data_length -= write_size;
+    } while (data_length > 0);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_set(int32_t client_id,
+                         psa_storage_uid_t uid,
+                         size_t data_length,
+                         psa_storage_create_flags_t create_flags)
+{
+#ifdef ITS_COALESCE
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    /* The files of PS are not coalesced, as PS relies on the order of its
+     * writes to keep its object table consistent with its objects.
+     */
+    if (client_id == TFM_SP_PS) {
+        return tfm_its_set_file(client_id, uid, data_length, create_flags,
+                                NULL);
+    }
+#endif
+
+    return its_coalesce_set(client_id, uid, data_length, create_flags);
+#else
+    return tfm_its_set_file(client_id, uid, data_length, create_flags, NULL);
+#endif
+}
+
+psa_status_t tfm_its_create(int32_t client_id,
+                            psa_storage_uid_t uid,
+                            size_t capacity,
+                            psa_storage_create_flags_t create_flags)
+{
+    psa_status_t status;
+
+#ifdef TFM_ITS_ENCRYPTED
+    /* Encrypted files are authenticated as a whole, so they cannot be
+     * appended to.
+     */
+    if (client_id != TFM_SP_PS) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    /* Check that the UID is valid */
+    if (uid == TFM_ITS_INVALID_UID) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (capacity == 0) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* A write once file could never be appended to */
+    if (create_flags & ~(PSA_STORAGE_FLAG_NO_CONFIDENTIALITY |
+                         PSA_STORAGE_FLAG_NO_REPLAY_PROTECTION)) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+
+    /* Set file id */
+    tfm_its_get_fid(client_id, uid, g_fid);
+
+    /* Read file info */
+    status = its_file_get_info(client_id);
+    if (status == PSA_SUCCESS) {
+        return PSA_ERROR_ALREADY_EXISTS;
+    } else if (status != PSA_ERROR_DOES_NOT_EXIST) {
+        return status;
+    }
+
+    /* Create an empty file of the requested capacity */
+    g_file_info.size_max = capacity;
+    g_file_info.flags = (uint32_t)create_flags | ITS_FLASH_FS_FLAG_CREATE;
+
+    return its_file_create(client_id, 0, NULL);
+}
+
+psa_status_t tfm_its_append(int32_t client_id,
+                            psa_storage_uid_t uid,
+                            size_t data_length)
+{
+    psa_status_t status;
+    size_t write_size;
+    size_t offset;
+    size_t head_size;
+    size_t program_unit;
+
+#ifdef TFM_ITS_ENCRYPTED
+    /* Encrypted files are authenticated as a whole, so they cannot be
+     * appended to.
+     */
+    if (client_id != TFM_SP_PS) {
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    /* Check that the UID is valid */
+    if (uid == TFM_ITS_INVALID_UID) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+#ifdef ITS_COALESCE
+    /* The data is appended to the latest data of the file */
+    status = its_coalesce_commit(client_id, uid);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+#endif
+    /* Set file id */
+    tfm_its_get_fid(client_id, uid, g_fid);
+
+    /* Read file info */
+    status = its_file_get_info(client_id);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    if (g_file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    /* Check that the data fits in the remaining capacity of the file */
+    if (data_length > g_file_info.size_max - g_file_info.size_current) {
+        return PSA_ERROR_INSUFFICIENT_STORAGE;
+    }
+
+    if (data_length == 0) {
+        return PSA_SUCCESS;
+    }
+
+    program_unit = get_fs_cfg(client_id)->program_unit;
+    offset = g_file_info.size_current;
+    g_file_info.flags = ITS_FLASH_FS_FLAG_APPEND;
+
+    /* Iteratively read data from the caller and append it to the file, in
+     * chunks no larger than the size of the asset_data buffer, less one
+     * program unit kept in front of the data.
+     */
+    do {
+        write_size = ITS_UTILS_MIN(data_length,
+                                   sizeof(asset_data) - program_unit);
+
+        /* Read asset data from the caller */
+        (void)its_req_mngr_read(asset_data + program_unit, write_size);
+
+#ifdef ITS_APPEND_IN_PLACE
+        /* Append the data in place, from the end of the file */
+        status = its_flash_fs_file_write(get_fs_ctx(client_id), g_fid,
+                                         &g_file_info, write_size, offset,
+                                         asset_data + program_unit);
+        if (status == PSA_ERROR_NOT_SUPPORTED)
+#endif
+        {
+            /* Writes to the filesystem must start on a program unit
+             * boundary, so the data already stored in the last, partially
+             * written, program unit of the file is written again in front of
+             * the new data.
+             */
+            head_size = offset % program_unit;
+            if (head_size != 0) {
+                status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid,
+                                                head_size, offset - head_size,
+                                                asset_data + program_unit
+                                                - head_size);
+                if (status != PSA_SUCCESS) {
+                    return status;
+                }
+            }
+
+            status = its_flash_fs_file_write(get_fs_ctx(client_id), g_fid,
+                                             &g_file_info,
+                                             head_size + write_size,
+                                             offset - head_size,
+                                             asset_data + program_unit
+                                             - head_size);
+        }
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
 
         offset += write_size;
         data_length -= write_size;
@@ -396,9 +727,17 @@ psa_status_t tfm_its_get(int32_t client_id,
     }
 #endif
 
+#ifdef ITS_COALESCE
+    /* Read the data waiting to be written, if any, as it is the latest */
+    status = its_coalesce_get(client_id, uid, data_offset, data_size,
+                              p_data_length);
+    if (status != PSA_ERROR_DOES_NOT_EXIST) {
+        return status;
+    }
+#endif
+
     /* Read file info */
-    status = its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
-                                        &g_file_info);
+    status = its_file_get_info(client_id);
     if (status != PSA_SUCCESS) {
         return status;
     }
@@ -431,29 +770,12 @@ psa_status_t tfm_its_get(int32_t client_id,
         }
 
         /* When encryption is enabled we need to read the whole file */
-        status = its_flash_fs_file_read(get_fs_ctx(client_id),
-                                        g_fid,
-                                        g_file_info.size_max,
-                                        0,
-                                        enc_asset_data);
+        status = tfm_its_read_decrypt_file(client_id);
         if (status != PSA_SUCCESS) {
             *p_data_length = 0;
             return status;
         }
 
-        status = tfm_its_crypt_file(&g_file_info,
-                                    g_fid,
-                                    sizeof(g_fid),
-                                    enc_asset_data,
-                                    g_file_info.size_max,
-                                    asset_data,
-                                    sizeof(asset_data),
-                                    false);
-
-        if (status != PSA_SUCCESS) {
-            return status;
-        }
-
         tfm_memcpy(asset_data, asset_data + data_offset, data_size);
         tfm_memset(asset_data + data_size,
                    0,
@@ -499,12 +821,18 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#ifdef ITS_COALESCE
+    /* The data waiting to be written, if any, is the latest */
+    if (its_coalesce_get_info(client_id, uid, p_info) == PSA_SUCCESS) {
+        return PSA_SUCCESS;
+    }
+#endif
+
     /* Set file id */
     tfm_its_get_fid(client_id, uid, g_fid);
 
     /* Read file info */
-    status = its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
-                                        &g_file_info);
+    status = its_file_get_info(client_id);
     if (status != PSA_SUCCESS) {
         return status;
     }
@@ -538,8 +866,7 @@ psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
     /* Set file id */
     tfm_its_get_fid(client_id, uid, g_fid);
 
-    status = its_flash_fs_file_get_info(get_fs_ctx(client_id), g_fid,
-                                        &g_file_info);
+    status = its_file_get_info(client_id);
     if (status != PSA_SUCCESS) {
         return status;
     }
@@ -551,6 +878,305 @@ psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid)
         return PSA_ERROR_NOT_PERMITTED;
     }
 
+#ifdef TFM_ITS_PLAINTEXT_CACHE_SIZE
+    its_plaintext_cache_invalidate(g_fid);
+#endif
+
+#ifdef ITS_COALESCE
     /* Delete old file from the persistent area */
-    return its_flash_fs_file_delete(get_fs_ctx(client_id), g_fid);
+    status = its_file_delete(client_id);
+
+    /* Drop the data waiting to be written, once the file is deleted */
+    if (status == PSA_SUCCESS) {
+        its_coalesce_discard(client_id, uid);
+    }
+
+    return status;
+#else
+    /* Delete old file from the persistent area */
+    return its_file_delete(client_id);
+#endif
+}
+
+#ifdef ITS_SHARED_MAP
+#ifndef ITS_SHARED_MAP_SIZE
+#define ITS_SHARED_MAP_SIZE ITS_MAX_ASSET_SIZE
+#endif
+
+#ifndef ITS_SHARED_MAP_NUM_ASSETS
+#define ITS_SHARED_MAP_NUM_ASSETS 4
+#endif
+
+/* Published copy of a write once file */
+struct its_shared_map_entry_t {
+    int32_t owner;          /*!< Owner of the file */
+    psa_storage_uid_t uid;  /*!< UID of the file */
+    const uint8_t *data;    /*!< Start of the file data in the pool */
+    size_t size;            /*!< Size of the file data */
+    int32_t readers[ITS_SHARED_MAP_NUM_READERS]; /*!< Allowed readers */
+    size_t num_readers;     /*!< Number of allowed readers */
+};
+
+/* Pool holding the published file data. Entries are never removed, as write
+ * once files can be neither replaced nor removed, so the data stays valid
+ * until the next reset. At isolation level 1 every secure partition can read
+ * the pool, so the readers of an entry only select the partitions
+ * tfm_its_map() returns its address to.
+ */
+static uint8_t its_shared_map_pool[ITS_UTILS_ALIGN(ITS_SHARED_MAP_SIZE, 4)]
+                                                    __attribute__((aligned(4)));
+static size_t its_shared_map_used;
+
+static struct its_shared_map_entry_t
+                                its_shared_map[ITS_SHARED_MAP_NUM_ASSETS];
+static uint32_t its_shared_map_count;
+
+static struct its_shared_map_entry_t *its_shared_map_find(int32_t owner,
+                                                          psa_storage_uid_t uid)
+{
+    uint32_t i;
+
+    for (i = 0; i < its_shared_map_count; i++) {
+        if ((its_shared_map[i].owner == owner) &&
+            (its_shared_map[i].uid == uid)) {
+            return &its_shared_map[i];
+        }
+    }
+
+    return NULL;
+}
+
+static bool its_shared_map_is_reader(const struct its_shared_map_entry_t *entry,
+                                     int32_t client_id)
+{
+    size_t i;
+
+    for (i = 0; i < entry->num_readers; i++) {
+        if (entry->readers[i] == client_id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * \brief Reads a write once file of the caller into the shared map pool, and
+ *        adds it to the published files with no reader.
+ */
+static psa_status_t its_shared_map_add(int32_t client_id,
+                                       psa_storage_uid_t uid,
+                                       struct its_shared_map_entry_t **p_entry)
+{
+    psa_status_t status;
+    struct its_shared_map_entry_t *entry;
+    uint8_t *data;
+
+    /* Set file id */
+    tfm_its_get_fid(client_id, uid, g_fid);
+
+    /* Read file info */
+    status = its_file_get_info(client_id);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* The published copy is never updated, so the file must be immutable */
+    if (!(g_file_info.flags & PSA_STORAGE_FLAG_WRITE_ONCE)) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    if ((its_shared_map_count == ITS_SHARED_MAP_NUM_ASSETS) ||
+        (g_file_info.size_current >
+         sizeof(its_shared_map_pool) - its_shared_map_used)) {
+        return PSA_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    data = its_shared_map_pool + its_shared_map_used;
+
+#ifdef TFM_ITS_ENCRYPTED
+    if (client_id != TFM_SP_PS) {
+        if (g_file_info.size_max > sizeof(enc_asset_data)) {
+            return PSA_ERROR_BUFFER_TOO_SMALL;
+        }
+
+        status = tfm_its_read_decrypt_file(client_id);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+
+        tfm_memcpy(data, asset_data, g_file_info.size_current);
+    } else {
+        status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid,
+                                        g_file_info.size_current, 0, data);
+    }
+#else
+    status = its_flash_fs_file_read(get_fs_ctx(client_id), g_fid,
+                                    g_file_info.size_current, 0, data);
+#endif
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    entry = &its_shared_map[its_shared_map_count++];
+    entry->owner = client_id;
+    entry->uid = uid;
+    entry->data = data;
+    entry->size = g_file_info.size_current;
+    entry->num_readers = 0;
+
+    its_shared_map_used += ITS_UTILS_ALIGN(g_file_info.size_current, 4);
+
+    *p_entry = entry;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_publish(int32_t client_id,
+                             psa_storage_uid_t uid,
+                             const int32_t *readers,
+                             size_t num_readers)
+{
+    psa_status_t status;
+    struct its_shared_map_entry_t *entry;
+    size_t i;
+
+    /* Check that the UID is valid */
+    if (uid == TFM_ITS_INVALID_UID) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (num_readers > ITS_SHARED_MAP_NUM_READERS) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* Only secure partitions can read the shared map pool */
+    for (i = 0; i < num_readers; i++) {
+        if (readers[i] <= 0) {
+            return PSA_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
+    entry = its_shared_map_find(client_id, uid);
+    if (entry == NULL) {
+        status = its_shared_map_add(client_id, uid, &entry);
+        if (status != PSA_SUCCESS) {
+            return status;
+        }
+    }
+
+    /* The readers only control the next mappings. A partition which already
+     * mapped the file keeps its address.
+     */
+    for (i = 0; i < num_readers; i++) {
+        entry->readers[i] = readers[i];
+    }
+    entry->num_readers = num_readers;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_its_map(int32_t client_id,
+                         int32_t owner,
+                         psa_storage_uid_t uid,
+                         const void **p_data,
+                         size_t *p_data_length)
+{
+    psa_status_t status;
+    struct its_shared_map_entry_t *entry;
+
+    /* Check that the UID is valid */
+    if (uid == TFM_ITS_INVALID_UID) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    entry = its_shared_map_find(owner, uid);
+
+    if (owner == client_id) {
+        /* The owner publishes its file with no reader on first mapping */
+        if (entry == NULL) {
+            status = its_shared_map_add(client_id, uid, &entry);
+            if (status != PSA_SUCCESS) {
+                return status;
+            }
+        }
+    } else if ((entry == NULL) || !its_shared_map_is_reader(entry, client_id)) {
+        /* Other partitions must be declared as readers by the owner. Whether
+         * the file exists is not disclosed to them.
+         */
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    *p_data = entry->data;
+    *p_data_length = entry->size;
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_SHARED_MAP */
+
+#ifdef ITS_STATS
+void tfm_its_get_flash_stats(struct tfm_storage_flash_stats_t *its_stats,
+                             struct tfm_storage_flash_stats_t *ps_stats)
+{
+    struct tfm_storage_flash_stats_t shard_stats;
+    uint32_t shard;
+    uint32_t block;
+    uint32_t first_block;
+
+    tfm_memset(its_stats, 0, sizeof(*its_stats));
+
+    for (shard = 0; shard < its_shards_num(); shard++) {
+        its_flash_fs_get_stats(its_shards_get_ctx(shard), &shard_stats);
+
+        its_stats->bytes_written += shard_stats.bytes_written;
+        its_stats->erases += shard_stats.erases;
+        its_stats->metablock_swaps += shard_stats.metablock_swaps;
+        its_stats->compactions += shard_stats.compactions;
+        its_stats->erase_pending += shard_stats.erase_pending;
+
+        /* The block IDs of a shard are relative to its part of the ITS area */
+        first_block = (its_shards_get_cfg(shard)->flash_area_addr
+                       - fs_cfg_its.flash_area_addr) / fs_cfg_its.block_size;
+        for (block = 0;
+             (block < TFM_STORAGE_STATS_MAX_BLOCKS) &&
+             (first_block + block < TFM_STORAGE_STATS_MAX_BLOCKS);
+             block++) {
+            its_stats->block_erases[first_block + block] =
+                                                shard_stats.block_erases[block];
+        }
+    }
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    its_flash_fs_get_stats(&fs_ctx_ps, ps_stats);
+#else
+    tfm_memset(ps_stats, 0, sizeof(*ps_stats));
+#endif
+}
+#endif /* ITS_STATS */
+
+#ifdef ITS_BACKGROUND_ERASE
+bool tfm_its_erase_step(void)
+{
+    uint32_t shard;
+    its_flash_fs_ctx_t *fs_ctx = NULL;
+
+    for (shard = 0; shard < its_shards_num(); shard++) {
+        if (its_flash_fs_erase_pending(its_shards_get_ctx(shard))) {
+            fs_ctx = its_shards_get_ctx(shard);
+            break;
+        }
+    }
+
+#ifdef TFM_PARTITION_PROTECTED_STORAGE
+    if ((fs_ctx == NULL) && its_flash_fs_erase_pending(&fs_ctx_ps)) {
+        fs_ctx = &fs_ctx_ps;
+    }
+#endif
+
+    if (fs_ctx == NULL) {
+        return false;
+    }
+
+    return (its_flash_fs_erase_step(fs_ctx) == PSA_SUCCESS);
 }
+#endif /* ITS_BACKGROUND_ERASE */
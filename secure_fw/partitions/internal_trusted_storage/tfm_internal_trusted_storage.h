@@ -8,11 +8,15 @@
 #ifndef __TFM_INTERNAL_TRUSTED_STORAGE_H__
 #define __TFM_INTERNAL_TRUSTED_STORAGE_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #include "psa/error.h"
 #include "psa/storage_common.h"
+#ifdef ITS_STATS
+#include "tfm_storage_stats.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -71,6 +75,78 @@ psa_status_t tfm_its_set(int32_t client_id,
                          size_t data_length,
                          psa_storage_create_flags_t create_flags);
 
+/**
+ * \brief Create an empty uid/value pair which data can be appended to
+ *
+ * Reserves `capacity` bytes in the internal storage for data appended with
+ * \ref tfm_its_append.
+ *
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] uid           The identifier for the data
+ * \param[in] capacity      The maximum size in bytes of the data
+ * \param[in] create_flags  The flags that the data will be stored with
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_ALREADY_EXISTS        The operation failed because the
+ *                                         provided `uid` value already exists
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because one or
+ *                                         more of the flags provided in
+ *                                         `create_flags` is not supported or is
+ *                                         not valid, or because the file would
+ *                                         be encrypted
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because there
+ *                                         was insufficient space on the
+ *                                         storage medium
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because
+ *                                         `capacity` is zero or larger than
+ *                                         the maximum asset size
+ */
+psa_status_t tfm_its_create(int32_t client_id,
+                            psa_storage_uid_t uid,
+                            size_t capacity,
+                            psa_storage_create_flags_t create_flags);
+
+/**
+ * \brief Append data to an existing uid/value pair
+ *
+ * The cost of the operation in the storage is proportional to the size of the
+ * appended data when ITS_APPEND_IN_PLACE is enabled, rather than to the size
+ * of the existing data.
+ *
+ * \param[in] client_id    Identifier of the asset's owner (client)
+ * \param[in] uid          The identifier for the data
+ * \param[in] data_length  The size in bytes of the data to append
+ *
+ * \return A status indicating the success/failure of the operation
+ *
+ * \retval PSA_SUCCESS                     The operation completed successfully
+ * \retval PSA_ERROR_DOES_NOT_EXIST        The operation failed because the
+ *                                         provided `uid` value was not found in
+ *                                         the storage
+ * \retval PSA_ERROR_NOT_PERMITTED         The operation failed because the
+ *                                         provided `uid` value was created with
+ *                                         PSA_STORAGE_FLAG_WRITE_ONCE
+ * \retval PSA_ERROR_NOT_SUPPORTED         The operation failed because the
+ *                                         file is encrypted
+ * \retval PSA_ERROR_INSUFFICIENT_STORAGE  The operation failed because the
+ *                                         data does not fit in the capacity of
+ *                                         the file
+ * \retval PSA_ERROR_STORAGE_FAILURE       The operation failed because the
+ *                                         physical storage has failed (Fatal
+ *                                         error)
+ * \retval PSA_ERROR_INVALID_ARGUMENT      The operation failed because one or
+ *                                         more of the given arguments were
+ *                                         invalid
+ */
+psa_status_t tfm_its_append(int32_t client_id,
+                            psa_storage_uid_t uid,
+                            size_t data_length);
+
 /**
  * \brief Retrieve data associated with a provided UID
  *
@@ -163,6 +239,122 @@ psa_status_t tfm_its_get_info(int32_t client_id, psa_storage_uid_t uid,
  */
 psa_status_t tfm_its_remove(int32_t client_id, psa_storage_uid_t uid);
 
+/**
+ * \brief Creates or replaces a file, straight away.
+ *
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] uid           Identifier for the data
+ * \param[in] data_length   Size of the file data in bytes
+ * \param[in] create_flags  Flags indicating the properties of the data
+ * \param[in] data          Buffer containing the file data, or NULL to read
+ *                          it from the client request
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+psa_status_t tfm_its_set_file(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_length,
+                              psa_storage_create_flags_t create_flags,
+                              const uint8_t *data);
+
+#ifdef ITS_SHARED_MAP
+#ifndef ITS_SHARED_MAP_NUM_READERS
+#define ITS_SHARED_MAP_NUM_READERS 4
+#endif
+
+/**
+ * \brief Publishes a write once file of the caller, and sets the partitions
+ *        allowed to map it. If the file is not published yet, ITS reads it
+ *        once into its shared map pool.
+ *
+ * \param[in] client_id    Identifier of the caller, owner of the file
+ * \param[in] uid          Identifier for the data
+ * \param[in] readers      Identifiers of the secure partitions allowed to map
+ *                         the file, replacing the previous ones
+ * \param[in] num_readers  Number of identifiers in readers
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ *
+ * \retval PSA_SUCCESS                    The operation completed successfully
+ * \retval PSA_ERROR_DOES_NOT_EXIST       The file does not exist
+ * \retval PSA_ERROR_NOT_PERMITTED        The file does not have the
+ *                                        PSA_STORAGE_FLAG_WRITE_ONCE flag
+ * \retval PSA_ERROR_INSUFFICIENT_MEMORY  The shared map pool is full
+ * \retval PSA_ERROR_INVALID_ARGUMENT     The UID is invalid, there are more
+ *                                        than ITS_SHARED_MAP_NUM_READERS
+ *                                        readers, or a reader is not a secure
+ *                                        partition
+ */
+psa_status_t tfm_its_publish(int32_t client_id,
+                             psa_storage_uid_t uid,
+                             const int32_t *readers,
+                             size_t num_readers);
+
+/**
+ * \brief Maps a published write once file for reading in place. If the owner
+ *        maps a file which is not published yet, ITS reads it once into its
+ *        shared map pool and publishes it with no reader. Other partitions
+ *        can only map the file once the owner has published it with them as
+ *        readers.
+ *
+ * \param[in]  client_id      Identifier of the caller
+ * \param[in]  owner          Identifier of the file's owner
+ * \param[in]  uid            Identifier for the data
+ * \param[out] p_data         On success, address of the file data, which stays
+ *                            valid and unchanged until the next reset
+ * \param[out] p_data_length  On success, size of the file data
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ *
+ * \retval PSA_SUCCESS                    The operation completed successfully
+ * \retval PSA_ERROR_DOES_NOT_EXIST       The caller owns the file, and it
+ *                                        does not exist
+ * \retval PSA_ERROR_NOT_PERMITTED        The file does not have the
+ *                                        PSA_STORAGE_FLAG_WRITE_ONCE flag, or
+ *                                        the caller is neither its owner nor
+ *                                        one of its readers
+ * \retval PSA_ERROR_INSUFFICIENT_MEMORY  The shared map pool is full
+ * \retval PSA_ERROR_INVALID_ARGUMENT     The UID is invalid
+ */
+psa_status_t tfm_its_map(int32_t client_id,
+                         int32_t owner,
+                         psa_storage_uid_t uid,
+                         const void **p_data,
+                         size_t *p_data_length);
+#endif
+
+#ifdef ITS_STATS
+/**
+ * \brief Gets the flash statistics of the ITS and PS filesystems.
+ *
+ * \param[out] its_stats  Statistics of the ITS filesystem, summed over the
+ *                        ITS shards
+ * \param[out] ps_stats   Statistics of the PS filesystem, all zero if PS is
+ *                        not enabled
+ */
+void tfm_its_get_flash_stats(struct tfm_storage_flash_stats_t *its_stats,
+                             struct tfm_storage_flash_stats_t *ps_stats);
+#endif
+
+#ifdef ITS_BACKGROUND_ERASE
+/**
+ * \brief Erases the next sector of the filesystem scratch blocks left to be
+ *        erased by the last updates, if any. Called once after each request,
+ *        so that neither the requests nor the lower priority partitions are
+ *        delayed by whole block erases.
+ *
+ * \note Erase failures are not reported here, the erase is instead retried
+ *       and the failure reported by the next update of the filesystem.
+ *
+ * \return Returns true if a sector was erased, and false if there is nothing
+ *         left to erase or the erase failed.
+ */
+bool tfm_its_erase_step(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,6 +17,21 @@
 #include "psa/service.h"
 #include "psa_manifest/tfm_internal_trusted_storage.h"
 #include "tfm_its_defs.h"
+#ifdef ITS_STATS
+#include "tfm_memory_utils.h"
+#include "tfm_storage_stats.h"
+#include "tfm_timer_api.h"
+#if defined(TFM_ITS_ENCRYPTED) && defined(TFM_ITS_PLAINTEXT_CACHE_SIZE)
+#include "its_plaintext_cache.h"
+#endif
+#endif
+#ifdef ITS_SHARED_MAP
+#include "tfm_its_ext_api.h"
+#endif
+#ifdef ITS_COALESCE
+#include "its_coalesce.h"
+#include "tfm_timer_api.h"
+#endif
 #else
 #include <stdbool.h>
 #include "tfm_secure_api.h"
@@ -179,6 +194,82 @@ psa_status_t tfm_its_remove_req(psa_invec *in_vec, size_t in_len,
     return tfm_its_remove(client_id, uid);
 }
 
+psa_status_t tfm_its_create_req(psa_invec *in_vec, size_t in_len,
+                                psa_outvec *out_vec, size_t out_len)
+{
+    psa_storage_uid_t uid;
+    size_t capacity;
+    psa_storage_create_flags_t create_flags;
+    int32_t client_id;
+
+    (void)out_vec;
+
+    if (!its_is_init) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    if ((in_len != 3) || (out_len != 0)) {
+        /* The number of arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (in_vec[0].len != sizeof(uid) ||
+        in_vec[1].len != sizeof(capacity) ||
+        in_vec[2].len != sizeof(create_flags)) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    uid = *((psa_storage_uid_t *)in_vec[0].base);
+
+    capacity = *((size_t *)in_vec[1].base);
+
+    create_flags = *(psa_storage_create_flags_t *)in_vec[2].base;
+
+    /* Get the caller's client ID */
+    if (tfm_core_get_caller_client_id(&client_id) != (int32_t)TFM_SUCCESS) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return tfm_its_create(client_id, uid, capacity, create_flags);
+}
+
+psa_status_t tfm_its_append_req(psa_invec *in_vec, size_t in_len,
+                                psa_outvec *out_vec, size_t out_len)
+{
+    psa_storage_uid_t uid;
+    size_t data_length;
+    int32_t client_id;
+
+    (void)out_vec;
+
+    if (!its_is_init) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    if ((in_len != 2) || (out_len != 0)) {
+        /* The number of arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (in_vec[0].len != sizeof(uid)) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    uid = *((psa_storage_uid_t *)in_vec[0].base);
+
+    p_data = (uint8_t *)in_vec[1].base;
+    data_length = in_vec[1].len;
+
+    /* Get the caller's client ID */
+    if (tfm_core_get_caller_client_id(&client_id) != (int32_t)TFM_SUCCESS) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return tfm_its_append(client_id, uid, data_length);
+}
+
 #else /* !defined(TFM_PSA_API) */
 typedef psa_status_t (*its_func_t)(void);
 static psa_msg_t msg;
@@ -285,38 +376,311 @@ static psa_status_t tfm_its_remove_ipc(void)
     return tfm_its_remove(msg.client_id, uid);
 }
 
-static void its_signal_handle(psa_signal_t signal)
+static psa_status_t tfm_its_create_ipc(void)
 {
-    psa_status_t status;
+    psa_storage_uid_t uid;
+    size_t capacity;
+    psa_storage_create_flags_t create_flags;
+    size_t num;
 
-    status = psa_get(signal, &msg);
-    if (status != PSA_SUCCESS) {
+    if (msg.in_size[0] != sizeof(uid) ||
+        msg.in_size[1] != sizeof(capacity) ||
+        msg.in_size[2] != sizeof(create_flags)) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num = psa_read(msg.handle, 0, &uid, sizeof(uid));
+    if (num != sizeof(uid)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num = psa_read(msg.handle, 1, &capacity, sizeof(capacity));
+    if (num != sizeof(capacity)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num = psa_read(msg.handle, 2, &create_flags, sizeof(create_flags));
+    if (num != sizeof(create_flags)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return tfm_its_create(msg.client_id, uid, capacity, create_flags);
+}
+
+static psa_status_t tfm_its_append_ipc(void)
+{
+    psa_storage_uid_t uid;
+    size_t data_length;
+    size_t num;
+
+    if (msg.in_size[0] != sizeof(uid)) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    data_length = msg.in_size[1];
+
+    num = psa_read(msg.handle, 0, &uid, sizeof(uid));
+    if (num != sizeof(uid)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return tfm_its_append(msg.client_id, uid, data_length);
+}
+
+#ifdef ITS_STATS
+static struct tfm_storage_op_stats_t its_op_stats[TFM_ITS_STATS_NUM_OPS];
+
+/**
+ * \brief Records a handled request in the ITS statistics.
+ *
+ * \param[in] type    Type of the request
+ * \param[in] status  Status returned to the client
+ * \param[in] start   Timestamp taken when the request was received
+ */
+static void its_stats_record(int32_t type, psa_status_t status,
+                             uint32_t start)
+{
+    struct tfm_storage_op_stats_t *op_stats;
+    uint32_t ticks = tfm_timer_get_timestamp() - start;
+    uint32_t bucket = 0;
+
+    /* The ITS message types are numbered in the same order as the statistics,
+     * from TFM_ITS_SET.
+     */
+    if ((type < TFM_ITS_SET) ||
+        (type >= TFM_ITS_SET + TFM_ITS_STATS_NUM_OPS)) {
         return;
     }
+    op_stats = &its_op_stats[type - TFM_ITS_SET];
+
+    /* The bucket is the number of significant bits of the duration */
+    while ((ticks != 0) && (bucket < TFM_STORAGE_STATS_LATENCY_BUCKETS - 1)) {
+        ticks >>= 1;
+        bucket++;
+    }
+
+    op_stats->count++;
+    if (status != PSA_SUCCESS) {
+        op_stats->errors++;
+    }
+    op_stats->latency[bucket]++;
+}
+
+static psa_status_t tfm_its_get_stats_ipc(void)
+{
+    struct tfm_its_stats_t stats;
+
+    if ((msg.type != PSA_IPC_CALL) || (msg.out_size[0] != sizeof(stats))) {
+        /* The message type or the size of the output is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    tfm_memcpy(stats.ops, its_op_stats, sizeof(stats.ops));
+    tfm_its_get_flash_stats(&stats.its_flash, &stats.ps_flash);
+#if defined(TFM_ITS_ENCRYPTED) && defined(TFM_ITS_PLAINTEXT_CACHE_SIZE)
+    its_plaintext_cache_get_stats(&stats.cache);
+#else
+    tfm_memset(&stats.cache, 0, sizeof(stats.cache));
+#endif
+
+    psa_write(msg.handle, 0, &stats, sizeof(stats));
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_STATS */
+
+#ifdef ITS_SHARED_MAP
+static psa_status_t tfm_its_map_ipc(void)
+{
+    psa_status_t status;
+    int32_t owner;
+    psa_storage_uid_t uid;
+    const void *data;
+    size_t data_length;
+    size_t num;
+
+    /* The shared region is only readable by secure partitions */
+    if (msg.client_id < 0) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    if (msg.in_size[0] != sizeof(owner) ||
+        msg.in_size[1] != sizeof(uid) ||
+        msg.out_size[0] != sizeof(data) ||
+        msg.out_size[1] != sizeof(data_length)) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num = psa_read(msg.handle, 0, &owner, sizeof(owner));
+    if (num != sizeof(owner)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num = psa_read(msg.handle, 1, &uid, sizeof(uid));
+    if (num != sizeof(uid)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (owner == TFM_ITS_EXT_MAP_OWNER_SELF) {
+        owner = msg.client_id;
+    }
+
+    status = tfm_its_map(msg.client_id, owner, uid, &data, &data_length);
+    if (status == PSA_SUCCESS) {
+        psa_write(msg.handle, 0, &data, sizeof(data));
+        psa_write(msg.handle, 1, &data_length, sizeof(data_length));
+    }
+
+    return status;
+}
+
+static psa_status_t tfm_its_publish_ipc(void)
+{
+    psa_storage_uid_t uid;
+    int32_t readers[ITS_SHARED_MAP_NUM_READERS];
+    size_t readers_size;
+    size_t num;
+
+    /* Only secure partitions can publish their files */
+    if (msg.client_id < 0) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    readers_size = msg.in_size[1];
+
+    if (msg.in_size[0] != sizeof(uid) ||
+        readers_size % sizeof(readers[0]) != 0) {
+        /* The size of one of the arguments is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (readers_size > sizeof(readers)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    num = psa_read(msg.handle, 0, &uid, sizeof(uid));
+    if (num != sizeof(uid)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    num = psa_read(msg.handle, 1, readers, readers_size);
+    if (num != readers_size) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return tfm_its_publish(msg.client_id, uid, readers,
+                           readers_size / sizeof(readers[0]));
+}
+#endif /* ITS_SHARED_MAP */
+
+static psa_status_t its_handle_msg(void)
+{
+    psa_status_t status;
+#ifdef ITS_STATS
+    uint32_t start = tfm_timer_get_timestamp();
+#endif
 
     switch (msg.type) {
     case TFM_ITS_SET:
         status = tfm_its_set_ipc();
-        psa_reply(msg.handle, status);
         break;
     case TFM_ITS_GET:
         status = tfm_its_get_ipc();
-        psa_reply(msg.handle, status);
         break;
     case TFM_ITS_GET_INFO:
         status = tfm_its_get_info_ipc();
-        psa_reply(msg.handle, status);
         break;
     case TFM_ITS_REMOVE:
         status = tfm_its_remove_ipc();
-        psa_reply(msg.handle, status);
+        break;
+    case TFM_ITS_CREATE:
+        status = tfm_its_create_ipc();
+        break;
+    case TFM_ITS_APPEND:
+        status = tfm_its_append_ipc();
+        break;
+    case TFM_ITS_FLUSH:
+#ifdef ITS_COALESCE
+        status = its_coalesce_flush();
+#else
+        status = PSA_SUCCESS;
+#endif
+        break;
+    case TFM_ITS_MAP:
+#ifdef ITS_SHARED_MAP
+        status = tfm_its_map_ipc();
+#else
+        status = PSA_ERROR_NOT_SUPPORTED;
+#endif
+        break;
+    case TFM_ITS_PUBLISH:
+#ifdef ITS_SHARED_MAP
+        status = tfm_its_publish_ipc();
+#else
+        status = PSA_ERROR_NOT_SUPPORTED;
+#endif
         break;
     default:
         psa_panic();
     }
+
+#ifdef ITS_STATS
+    its_stats_record(msg.type, status, start);
+#endif
+
+    return status;
+}
+
+/* The statistics service is only accessible to the secure partitions which
+ * declare it as a dependency in their manifest.
+ */
+static psa_status_t its_stats_handle_msg(void)
+{
+#ifdef ITS_STATS
+    return tfm_its_get_stats_ipc();
+#else
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+#if TFM_SP_ITS_MODEL_SFN == 1
+psa_status_t tfm_its_stats_service_sfn(const psa_msg_t *p_msg)
+{
+    msg = *p_msg;
+
+    return its_stats_handle_msg();
+}
+
+psa_status_t tfm_internal_trusted_storage_service_sfn(const psa_msg_t *p_msg)
+{
+    msg = *p_msg;
+
+    return its_handle_msg();
+}
+#else /* TFM_SP_ITS_MODEL_SFN == 1 */
+static void its_signal_handle(psa_signal_t signal)
+{
+    psa_status_t status;
+
+    status = psa_get(signal, &msg);
+    if (status != PSA_SUCCESS) {
+        return;
+    }
+
+    if (signal == TFM_ITS_STATS_SERVICE_SIGNAL) {
+        status = its_stats_handle_msg();
+    } else {
+        status = its_handle_msg();
+    }
+    psa_reply(msg.handle, status);
 }
+#endif /* TFM_SP_ITS_MODEL_SFN == 1 */
 #endif /* !defined(TFM_PSA_API) */
 
+#if !defined(TFM_PSA_API) || (TFM_SP_ITS_MODEL_IPC == 1)
 psa_status_t tfm_its_req_mngr_init(void)
 {
 #ifdef TFM_PSA_API
@@ -326,13 +690,39 @@ psa_status_t tfm_its_req_mngr_init(void)
         psa_panic();
     }
 
+#ifdef ITS_COALESCE
+    /* The sets are written straight away if the platform has no timer */
+    (void)its_coalesce_init();
+#endif
+
     while (1) {
         signals = psa_wait(PSA_WAIT_ANY, PSA_BLOCK);
         if (signals & TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_SIGNAL) {
             its_signal_handle(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_SIGNAL);
+        } else if (signals & TFM_ITS_STATS_SERVICE_SIGNAL) {
+            its_signal_handle(TFM_ITS_STATS_SERVICE_SIGNAL);
+#ifdef ITS_COALESCE
+        } else if (signals & TFM_TIMER_SIGNAL) {
+            /* The oldest coalescing window is due to be closed */
+            its_coalesce_expire();
+#endif
         } else {
             psa_panic();
         }
+#ifdef ITS_COALESCE
+        /* Setting the timer also clears its signal, and cancels it once no
+         * window is open.
+         */
+        its_coalesce_set_timer();
+#endif
+#ifdef ITS_BACKGROUND_ERASE
+        /* Erase one sector of the filesystem scratch blocks after each
+         * request, once the client has been replied to. The partition then
+         * blocks again, so that the lower priority partitions and the NS
+         * agent are not held off by the erase of whole blocks.
+         */
+        (void)tfm_its_erase_step();
+#endif
     }
 #else
     if (tfm_its_init() != PSA_SUCCESS) {
@@ -342,6 +732,7 @@ psa_status_t tfm_its_req_mngr_init(void)
     return PSA_SUCCESS;
 #endif
 }
+#endif /* !defined(TFM_PSA_API) || (TFM_SP_ITS_MODEL_IPC == 1) */
 
 size_t its_req_mngr_read(uint8_t *buf, size_t num_bytes)
 {
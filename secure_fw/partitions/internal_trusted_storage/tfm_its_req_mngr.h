@@ -80,6 +80,38 @@ psa_status_t tfm_its_get_info_req(psa_invec *in_vec, size_t in_len,
 psa_status_t tfm_its_remove_req(psa_invec *in_vec, size_t in_len,
                                 psa_outvec *out_vec, size_t out_len);
 
+/**
+ * \brief Handles the create request.
+ *
+ * \param[in]  in_vec  Pointer to the input vector which contains the input
+ *                     parameters.
+ * \param[in]  in_len  Number of input parameters in the input vector.
+ * \param[out] out_vec Pointer to the output vector which contains the output
+ *                     parameters.
+ * \param[in]  out_len Number of output parameters in the output vector.
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+psa_status_t tfm_its_create_req(psa_invec *in_vec, size_t in_len,
+                                psa_outvec *out_vec, size_t out_len);
+
+/**
+ * \brief Handles the append request.
+ *
+ * \param[in]  in_vec  Pointer to the input vector which contains the input
+ *                     parameters.
+ * \param[in]  in_len  Number of input parameters in the input vector.
+ * \param[out] out_vec Pointer to the output vector which contains the output
+ *                     parameters.
+ * \param[in]  out_len Number of output parameters in the output vector.
+ *
+ * \return A status indicating the success/failure of the operation as specified
+ *         in \ref psa_status_t
+ */
+psa_status_t tfm_its_append_req(psa_invec *in_vec, size_t in_len,
+                                psa_outvec *out_vec, size_t out_len);
+
 /**
  * \brief Reads asset data from the caller.
  *
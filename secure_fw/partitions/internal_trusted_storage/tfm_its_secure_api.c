@@ -8,6 +8,7 @@
 #include "array.h"
 #include "psa/internal_trusted_storage.h"
 #include "tfm_api.h"
+#include "tfm_its_ext_api.h"
 
 #ifdef TFM_PSA_API
 #include "psa/client.h"
@@ -153,3 +154,149 @@ psa_status_t psa_its_remove(psa_storage_uid_t uid)
 
     return status;
 }
+
+psa_status_t tfm_its_ext_create(psa_storage_uid_t uid,
+                                size_t capacity,
+                                psa_storage_create_flags_t create_flags)
+{
+    psa_status_t status;
+
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+        { .base = &capacity, .len = sizeof(capacity) },
+        { .base = &create_flags, .len = sizeof(create_flags) }
+    };
+
+#ifdef TFM_PSA_API
+
+    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                      TFM_ITS_CREATE, in_vec, IOVEC_LEN(in_vec), NULL, 0);
+
+#else
+    status = tfm_its_create_req_veneer(in_vec, IOVEC_LEN(in_vec), NULL, 0);
+#endif
+
+    return status;
+}
+
+psa_status_t tfm_its_ext_append(psa_storage_uid_t uid,
+                                size_t data_length,
+                                const void *p_data)
+{
+    psa_status_t status;
+
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+        { .base = p_data, .len = data_length }
+    };
+
+#ifdef TFM_PSA_API
+
+    status = psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                      TFM_ITS_APPEND, in_vec, IOVEC_LEN(in_vec), NULL, 0);
+
+#else
+    status = tfm_its_append_req_veneer(in_vec, IOVEC_LEN(in_vec), NULL, 0);
+
+    /* A parameter with a buffer pointer where its data length is longer than
+     * maximum permitted, it is treated as a secure violation.
+     * TF-M framework rejects the request with TFM_ERROR_INVALID_PARAMETER.
+     * The ITS secure PSA implementation returns PSA_ERROR_INVALID_ARGUMENT in
+     * that case.
+     */
+    if (status == (psa_status_t)TFM_ERROR_INVALID_PARAMETER) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+#endif
+
+    return status;
+}
+
+psa_status_t tfm_its_ext_get_stats(struct tfm_its_stats_t *stats)
+{
+#ifdef TFM_PSA_API
+    psa_outvec out_vec[] = {
+        { .base = stats, .len = sizeof(*stats) }
+    };
+
+    if (stats == NULL) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return psa_call(TFM_ITS_STATS_SERVICE_HANDLE, PSA_IPC_CALL, NULL, 0,
+                    out_vec, IOVEC_LEN(out_vec));
+#else
+    (void)stats;
+
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+psa_status_t tfm_its_ext_publish(psa_storage_uid_t uid,
+                                 const int32_t *readers,
+                                 size_t num_readers)
+{
+#ifdef TFM_PSA_API
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+        { .base = readers, .len = num_readers * sizeof(readers[0]) }
+    };
+
+    if ((readers == NULL) && (num_readers != 0)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_PUBLISH, in_vec, IOVEC_LEN(in_vec), NULL, 0);
+#else
+    (void)uid;
+    (void)readers;
+    (void)num_readers;
+
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+psa_status_t tfm_its_ext_map(int32_t owner,
+                             psa_storage_uid_t uid,
+                             const void **p_data,
+                             size_t *p_data_length)
+{
+#ifdef TFM_PSA_API
+    psa_invec in_vec[] = {
+        { .base = &owner, .len = sizeof(owner) },
+        { .base = &uid, .len = sizeof(uid) }
+    };
+
+    psa_outvec out_vec[] = {
+        { .base = p_data, .len = sizeof(*p_data) },
+        { .base = p_data_length, .len = sizeof(*p_data_length) }
+    };
+
+    if ((p_data == NULL) || (p_data_length == NULL)) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_MAP, in_vec, IOVEC_LEN(in_vec),
+                    out_vec, IOVEC_LEN(out_vec));
+#else
+    (void)owner;
+    (void)uid;
+    (void)p_data;
+    (void)p_data_length;
+
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+psa_status_t tfm_its_ext_flush(void)
+{
+#ifdef TFM_PSA_API
+    return psa_call(TFM_INTERNAL_TRUSTED_STORAGE_SERVICE_HANDLE,
+                    TFM_ITS_FLUSH, NULL, 0, NULL, 0);
+#else
+    /* Sets are never coalesced in library mode */
+    return PSA_SUCCESS;
+#endif
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2021, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "mve_defs.h"
 
 #define GET_MEM_ADDR_BIT0(x)        ((x) & 0x1)
 #define GET_MEM_ADDR_BIT1(x)        ((x) & 0x2)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,7 +7,33 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "crt_impl_private.h"
 
+#if defined(__ARM_FEATURE_MVE)
+int memcmp(const void *s1, const void *s2, size_t n)
+{
+    const uint8_t *p1 = (const uint8_t *)s1;
+    const uint8_t *p2 = (const uint8_t *)s2;
+    mve_pred16_t pred, diff;
+    uint32_t i;
+
+    while (n > 0) {
+        pred = vctp8q(n);
+        diff = vcmpneq_m_u8(vldrbq_z_u8(p1, pred), vldrbq_z_u8(p2, pred),
+                            pred);
+        if (diff != 0) {
+            /* One predicate bit per byte, the lowest is the first mismatch */
+            i = (uint32_t)__builtin_ctz(diff);
+            return p1[i] - p2[i];
+        }
+        p1 += MVE_VECTOR_BYTES;
+        p2 += MVE_VECTOR_BYTES;
+        n = MVE_BYTES_LEFT(n);
+    }
+
+    return 0;
+}
+#else
 int memcmp(const void *s1, const void *s2, size_t n)
 {
     int result = 0;
@@ -23,3 +49,4 @@ int memcmp(const void *s1, const void *s2, size_t n)
     }
     return result;
 }
+#endif
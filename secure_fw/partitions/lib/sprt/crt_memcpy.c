@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,24 @@
 
 #include "crt_impl_private.h"
 
+#if defined(__ARM_FEATURE_MVE)
+void *memcpy(void *dest, const void *src, size_t n)
+{
+    uint8_t *p_dest = (uint8_t *)dest;
+    const uint8_t *p_src = (const uint8_t *)src;
+    mve_pred16_t pred;
+
+    while (n > 0) {
+        pred = vctp8q(n);
+        vstrbq_p_u8(p_dest, vldrbq_z_u8(p_src, pred), pred);
+        p_dest += MVE_VECTOR_BYTES;
+        p_src += MVE_VECTOR_BYTES;
+        n = MVE_BYTES_LEFT(n);
+    }
+
+    return dest;
+}
+#else
 void *memcpy(void *dest, const void *src, size_t n)
 {
     union tfm_mem_addr_t p_dest, p_src;
@@ -44,3 +62,4 @@ void *memcpy(void *dest, const void *src, size_t n)
 
     return dest;
 }
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2021, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,21 @@
 
 #include "crt_impl_private.h"
 
+#if defined(__ARM_FEATURE_MVE)
+void *memset(void *s, int c, size_t n)
+{
+    uint8_t *p_mem = (uint8_t *)s;
+    uint8x16_t pattern = vdupq_n_u8((uint8_t)c);
+
+    while (n > 0) {
+        vstrbq_p_u8(p_mem, pattern, vctp8q(n));
+        p_mem += MVE_VECTOR_BYTES;
+        n = MVE_BYTES_LEFT(n);
+    }
+
+    return s;
+}
+#else
 void *memset(void *s, int c, size_t n)
 {
     union tfm_mem_addr_t p_mem;
@@ -32,3 +47,4 @@ void *memset(void *s, int c, size_t n)
 
     return s;
 }
+#endif
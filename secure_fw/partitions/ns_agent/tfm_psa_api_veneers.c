@@ -5,8 +5,10 @@
  *
  */
 
+#include <arm_cmse.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include "compiler_ext_defs.h"
 #include "config_impl.h"
 #include "security_defs.h"
 #include "svc_num.h"
@@ -28,6 +30,8 @@
 
 #if defined(__ICCARM__)
 
+#pragma required = tfm_psa_call_batch_execute
+
 #ifdef CONFIG_TFM_PSA_API_THREAD_CALL
 
 #pragma required = tfm_spm_client_psa_framework_version
@@ -214,6 +218,112 @@ psa_status_t tfm_psa_call_veneer(psa_handle_t handle,
     );
 }
 
+#ifdef CONFIG_TFM_PSA_API_THREAD_CALL
+/*
+ * Makes one call of a batch as tfm_psa_call_veneer() does: through the thread
+ * call dispatcher, on the stack the veneer runs on. The frame has the layout
+ * of the registers the veneer pushes, the arguments then two unused words.
+ */
+static psa_status_t batch_call_dispatch(psa_handle_t handle,
+                                        uint32_t ctrl_param,
+                                        const psa_invec *in_vec,
+                                        psa_outvec *out_vec)
+{
+    uint32_t frame[6] = {
+        (uint32_t)handle, ctrl_param, (uint32_t)in_vec, (uint32_t)out_vec,
+        0, 0
+    };
+
+    spm_interface_thread_dispatcher((uintptr_t)tfm_spm_client_psa_call,
+                                    (uintptr_t)frame, 0);
+
+    return (psa_status_t)frame[0];
+}
+#else
+/*
+ * The SVC and SFN calls are the ones tfm_psa_call_veneer() makes, and do not
+ * depend on the stack they are made from.
+ */
+#define batch_call_dispatch     tfm_psa_call_pack
+#endif
+
+/*
+ * Makes the calls of a batch in the context of the NS Agent, through the same
+ * interface as tfm_psa_call_veneer(). SPM checks the vectors of each call as
+ * for a single call from NSPE, only the descriptors are checked here.
+ */
+__used
+psa_status_t tfm_psa_call_batch_execute(struct tfm_psa_call_desc_t *calls,
+                                        uint32_t num)
+{
+    struct tfm_psa_call_desc_t call;
+    psa_status_t status;
+    uint32_t i;
+
+    if ((num == 0) || (num > TFM_PSA_CALL_BATCH_MAX)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    /* The status of each call is written back to the descriptors */
+    if (cmse_check_address_range(calls, num * sizeof(*calls),
+                                 CMSE_NONSECURE | CMSE_MPU_READWRITE) == NULL) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    for (i = 0; i < num; i++) {
+        /* Copy the descriptor out to avoid TOCTOU attacks. */
+        call = calls[i];
+
+        if ((call.type > INT16_MAX) ||
+            (call.type < INT16_MIN) ||
+            (call.in_len > UINT8_MAX) ||
+            (call.out_len > UINT8_MAX)) {
+            status = PSA_ERROR_PROGRAMMER_ERROR;
+        } else {
+            status = batch_call_dispatch(call.handle,
+                                         PARAM_PACK(call.type, call.in_len,
+                                                    call.out_len),
+                                         call.in_vec, call.out_vec);
+        }
+
+        calls[i].status = status;
+    }
+
+    return PSA_SUCCESS;
+}
+
+__tfm_psa_secure_gateway_attributes__
+psa_status_t tfm_psa_call_batch_veneer(struct tfm_psa_call_desc_t *calls,
+                                       uint32_t num)
+{
+    __ASM volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                      \n"
+#endif
+
+#if !defined(__ARM_ARCH_8_1M_MAIN__)
+        "   ldr    r2, [sp]                                   \n"
+        "   ldr    r3, ="M2S(STACK_SEAL_PATTERN)"             \n"
+        "   cmp    r2, r3                                     \n"
+        "   bne    reent_panic6                               \n"
+#endif
+
+        "   push   {r4, lr}                                   \n"
+        "   bl     tfm_psa_call_batch_execute                 \n"
+        "   pop    {r2, r3}                                   \n"
+        "   mov    lr, r3                                     \n"
+        /* Do not leave secure values in the scratch registers */
+        "   movs   r1, #0                                     \n"
+        "   mov    r12, r1                                    \n"
+        "   bxns   lr                                         \n"
+#if !defined(__ARM_ARCH_8_1M_MAIN__)
+        "reent_panic6:                                        \n"
+        "   svc    "M2S(TFM_SVC_PSA_PANIC)"                   \n"
+        "   b      .                                          \n"
+#endif
+    );
+}
+
 __tfm_psa_secure_gateway_attributes__
 void tfm_psa_close_veneer(psa_handle_t handle)
 {
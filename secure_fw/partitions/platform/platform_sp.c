@@ -11,6 +11,9 @@
 #include "tfm_secure_api.h"
 #include "psa_manifest/pid.h"
 #include "load/partition_defs.h"
+#ifdef ITS_COALESCE
+#include "tfm_its_ext_api.h"
+#endif
 
 #ifndef TFM_PLATFORM_NV_COUNTER_MODULE_DISABLED
 #include "tfm_plat_nv_counters.h"
@@ -86,6 +89,11 @@ enum tfm_platform_err_t platform_sp_system_reset(void)
      *        level 1.
      */
 
+#ifdef ITS_COALESCE
+    /* Write the ITS data coalesced in RAM, which the reset would lose */
+    (void)tfm_its_ext_flush();
+#endif
+
     tfm_platform_hal_system_reset();
 
     return TFM_PLATFORM_ERR_SUCCESS;
@@ -332,6 +340,41 @@ platform_sp_ioctl_ipc(const psa_msg_t *msg)
     return ret;
 }
 
+#if TFM_SP_PLATFORM_MODEL_SFN == 1
+static psa_status_t platform_sfn_handle(const psa_msg_t *msg, plat_func_t pfn)
+{
+    switch (msg->type) {
+    case PSA_IPC_CONNECT:
+        return PSA_SUCCESS;
+    case PSA_IPC_CALL:
+    case TFM_PLATFORM_API_ID_NV_READ:
+    case TFM_PLATFORM_API_ID_NV_INCREMENT:
+        return (psa_status_t)pfn(msg);
+    case PSA_IPC_DISCONNECT:
+        return PSA_SUCCESS;
+    default:
+        psa_panic();
+    }
+
+    /* NOTREACHED */
+    return PSA_ERROR_PROGRAMMER_ERROR;
+}
+
+psa_status_t tfm_sp_platform_system_reset_sfn(const psa_msg_t *msg)
+{
+    return platform_sfn_handle(msg, platform_sp_system_reset_ipc);
+}
+
+psa_status_t tfm_sp_platform_ioctl_sfn(const psa_msg_t *msg)
+{
+    return platform_sfn_handle(msg, platform_sp_ioctl_ipc);
+}
+
+psa_status_t tfm_sp_platform_nv_counter_sfn(const psa_msg_t *msg)
+{
+    return platform_sfn_handle(msg, platform_sp_nv_counter_ipc);
+}
+#else /* TFM_SP_PLATFORM_MODEL_SFN == 1 */
 static void platform_signal_handle(psa_signal_t signal, plat_func_t pfn)
 {
     psa_msg_t msg;
@@ -355,9 +398,23 @@ static void platform_signal_handle(psa_signal_t signal, plat_func_t pfn)
         psa_panic();
     }
 }
+#endif /* TFM_SP_PLATFORM_MODEL_SFN == 1 */
 
 #endif /* TFM_PSA_API */
 
+#if defined(TFM_PSA_API) && (TFM_SP_PLATFORM_MODEL_SFN == 1)
+psa_status_t platform_sp_sfn_init(void)
+{
+#ifndef TFM_PLATFORM_NV_COUNTER_MODULE_DISABLED
+    /* Initialise the non-volatile counters */
+    if (tfm_plat_init_nv_counter() != TFM_PLAT_ERR_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+#endif /* TFM_PLATFORM_NV_COUNTER_MODULE_DISABLED */
+
+    return PSA_SUCCESS;
+}
+#else /* defined(TFM_PSA_API) && (TFM_SP_PLATFORM_MODEL_SFN == 1) */
 enum tfm_platform_err_t platform_sp_init(void)
 {
 #ifndef TFM_PLATFORM_NV_COUNTER_MODULE_DISABLED
@@ -396,3 +453,4 @@ enum tfm_platform_err_t platform_sp_init(void)
     return TFM_PLATFORM_ERR_SUCCESS;
 #endif /* TFM_PSA_API */
 }
+#endif /* defined(TFM_PSA_API) && (TFM_SP_PLATFORM_MODEL_SFN == 1) */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2019, Arm Limited. All rights reserved.
+ * Copyright (c) 2018-2021, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -21,6 +21,13 @@ extern "C" {
  */
 enum tfm_platform_err_t platform_sp_init(void);
 
+/*!
+ * \brief Initializes the secure partition when it is built for the SFN model.
+ *
+ * \return Returns error code as specified in \ref psa_status_t
+ */
+psa_status_t platform_sp_sfn_init(void);
+
 /*!
  * \brief Resets the system.
  *
@@ -229,9 +229,23 @@ clear_data_and_return:
     return err;
 }
 
-psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
-                              psa_storage_create_flags_t create_flags,
-                              uint32_t size)
+/**
+ * \brief Creates or replaces the object with the provided UID and client ID.
+ *
+ * \param[in] uid           Unique identifier for the data
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] create_flags  Flags indicating the properties of the data
+ * \param[in] size          Size of the contents of `data` in bytes
+ * \param[in] data          Buffer containing the object data, or NULL to read
+ *                          it from the client request
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+static psa_status_t ps_object_create_common(psa_storage_uid_t uid,
+                                            int32_t client_id,
+                                       psa_storage_create_flags_t create_flags,
+                                            uint32_t size,
+                                            const uint8_t *data)
 {
     psa_status_t err;
     uint32_t old_fid = PS_INVALID_FID;
@@ -298,9 +312,13 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
     }
 
     /* Update the object data */
-    err = ps_req_mngr_read_asset_data(g_ps_object.data, size);
-    if (err != PSA_SUCCESS) {
-        goto clear_data_and_return;
+    if (data != NULL) {
+        (void)tfm_memcpy(g_ps_object.data, data, size);
+    } else {
+        err = ps_req_mngr_read_asset_data(g_ps_object.data, size);
+        if (err != PSA_SUCCESS) {
+            goto clear_data_and_return;
+        }
     }
 
     /* Update the current object size */
@@ -364,6 +382,24 @@ clear_data_and_return:
     return err;
 }
 
+psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
+                              psa_storage_create_flags_t create_flags,
+                              uint32_t size)
+{
+    return ps_object_create_common(uid, client_id, create_flags, size, NULL);
+}
+
+#ifdef PS_WRITE_BEHIND
+psa_status_t ps_object_create_from_buffer(psa_storage_uid_t uid,
+                                          int32_t client_id,
+                                       psa_storage_create_flags_t create_flags,
+                                          uint32_t size,
+                                          const uint8_t *data)
+{
+    return ps_object_create_common(uid, client_id, create_flags, size, data);
+}
+#endif
+
 psa_status_t ps_object_write(psa_storage_uid_t uid, int32_t client_id,
                              uint32_t offset, uint32_t size)
 {
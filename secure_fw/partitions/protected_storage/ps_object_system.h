@@ -39,6 +39,26 @@ psa_status_t ps_object_create(psa_storage_uid_t uid, int32_t client_id,
                               psa_storage_create_flags_t create_flags,
                               uint32_t size);
 
+#ifdef PS_WRITE_BEHIND
+/**
+ * \brief Creates a new object with the provided UID and client ID, from data
+ *        already copied into the PS partition.
+ *
+ * \param[in] uid           Unique identifier for the data
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] create_flags  Flags indicating the properties of the data
+ * \param[in] size          Size of the contents of `data` in bytes
+ * \param[in] data          Buffer containing the object data
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_object_create_from_buffer(psa_storage_uid_t uid,
+                                          int32_t client_id,
+                                       psa_storage_create_flags_t create_flags,
+                                          uint32_t size,
+                                          const uint8_t *data);
+#endif
+
 /**
  * \brief Gets the data of the object with the provided UID and client ID.
  *
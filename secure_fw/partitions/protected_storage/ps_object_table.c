@@ -945,6 +945,13 @@ psa_status_t ps_object_table_get_free_fid(uint32_t fid_num,
     return PSA_SUCCESS;
 }
 
+psa_status_t ps_object_table_check_free_fids(uint32_t fid_num)
+{
+    uint32_t idx;
+
+    return ps_table_free_idx(fid_num, &idx);
+}
+
 psa_status_t ps_object_table_set_obj_tbl_info(psa_storage_uid_t uid,
                                               int32_t client_id,
                                 const struct ps_obj_table_info_t *obj_tbl_info)
@@ -78,6 +78,16 @@ psa_status_t ps_object_table_obj_exist(psa_storage_uid_t uid,
  */
 psa_status_t ps_object_table_get_free_fid(uint32_t fid_num, uint32_t *p_fid);
 
+/**
+ * \brief Checks if the table has enough free entries to get a new file ID.
+ *
+ * \param[in] fid_num  Amount of file IDs that must be free
+ *
+ * \return Returns PSA_SUCCESS if fid_num entries are free in the table, and
+ *         PSA_ERROR_INSUFFICIENT_STORAGE otherwise.
+ */
+psa_status_t ps_object_table_check_free_fids(uint32_t fid_num);
+
 /**
  * \brief Sets object table information in the object table and stores it
  *        persistently, for the provided UID and client ID pair.
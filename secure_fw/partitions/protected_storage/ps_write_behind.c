@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "ps_write_behind.h"
+
+#include "ps_object_system.h"
+#include "ps_object_table.h"
+#include "ps_utils.h"
+#include "tfm_memory_utils.h"
+#include "tfm_ps_req_mngr.h"
+
+#ifndef PS_WRITE_BEHIND_QUEUE_LEN
+#define PS_WRITE_BEHIND_QUEUE_LEN 2
+#endif
+
+struct ps_write_behind_entry_t {
+    psa_storage_uid_t uid;                   /*!< Object UID */
+    int32_t client_id;                       /*!< Owner of the object */
+    psa_storage_create_flags_t create_flags; /*!< Object create flags */
+    uint32_t size;                           /*!< Object size, in bytes */
+    bool is_new;                             /*!< True if no version of the
+                                              *   object was stored or queued
+                                              *   when the entry was added
+                                              */
+    uint8_t data[PS_MAX_ASSET_SIZE];         /*!< Object data */
+};
+
+struct ps_write_behind_failure_t {
+    psa_storage_uid_t uid;                   /*!< Object UID */
+    int32_t client_id;                       /*!< Owner of the object */
+    psa_status_t status;                     /*!< Error of the failed commit */
+};
+
+/* Circular queue of the objects set but not committed yet, oldest first */
+static struct ps_write_behind_entry_t queue[PS_WRITE_BEHIND_QUEUE_LEN];
+static uint32_t queue_head;
+static uint32_t queue_count;
+
+/* Objects whose last commit failed, oldest first */
+static struct ps_write_behind_failure_t failures[PS_WRITE_BEHIND_QUEUE_LEN];
+static uint32_t failure_count;
+
+/**
+ * \brief Gets the n-th oldest entry of the queue.
+ *
+ * \param[in] n  Position of the entry from the head of the queue
+ *
+ * \return Pointer to the entry
+ */
+static struct ps_write_behind_entry_t *queue_entry(uint32_t n)
+{
+    return &queue[(queue_head + n) % PS_WRITE_BEHIND_QUEUE_LEN];
+}
+
+/**
+ * \brief Finds the latest queued version of an object.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] uid        Unique identifier for the data
+ *
+ * \return Pointer to the entry, or NULL if the object is not queued
+ */
+static struct ps_write_behind_entry_t *find_latest_entry(int32_t client_id,
+                                                         psa_storage_uid_t uid)
+{
+    struct ps_write_behind_entry_t *entry;
+    uint32_t n;
+
+    for (n = queue_count; n > 0; n--) {
+        entry = queue_entry(n - 1);
+        if (entry->uid == uid && entry->client_id == client_id) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * \brief Finds the failed commit of an object.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] uid        Unique identifier for the data
+ *
+ * \return Index of the failure, or failure_count if there is none
+ */
+static uint32_t find_failure(int32_t client_id, psa_storage_uid_t uid)
+{
+    uint32_t n;
+
+    for (n = 0; n < failure_count; n++) {
+        if (failures[n].uid == uid && failures[n].client_id == client_id) {
+            break;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * \brief Records the failed commit of an object, replacing the oldest record
+ *        if all are used.
+ *
+ * \param[in] entry   Queue entry of the object
+ * \param[in] status  Error of the commit
+ */
+static void record_failure(const struct ps_write_behind_entry_t *entry,
+                           psa_status_t status)
+{
+    ps_write_behind_clear_failure(entry->client_id, entry->uid);
+
+    if (failure_count == PS_WRITE_BEHIND_QUEUE_LEN) {
+        ps_write_behind_clear_failure(failures[0].client_id, failures[0].uid);
+    }
+
+    /* PSA_ERROR_DOES_NOT_EXIST would read as no failure to the callers */
+    if (status == PSA_ERROR_DOES_NOT_EXIST) {
+        status = PSA_ERROR_GENERIC_ERROR;
+    }
+
+    failures[failure_count].uid = entry->uid;
+    failures[failure_count].client_id = entry->client_id;
+    failures[failure_count].status = status;
+    failure_count++;
+}
+
+/**
+ * \brief Reports the failed commit of an object once, if any.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] uid        Unique identifier for the data
+ *
+ * \return Returns the error of the failed commit, or PSA_ERROR_DOES_NOT_EXIST
+ *         if the last commit of the object did not fail
+ */
+static psa_status_t report_failure(int32_t client_id, psa_storage_uid_t uid)
+{
+    uint32_t n = find_failure(client_id, uid);
+    psa_status_t status;
+
+    if (n == failure_count) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    status = failures[n].status;
+    ps_write_behind_clear_failure(client_id, uid);
+
+    return status;
+}
+
+psa_status_t ps_write_behind_set(int32_t client_id,
+                                 psa_storage_uid_t uid,
+                                 uint32_t data_length,
+                                 psa_storage_create_flags_t create_flags)
+{
+    psa_status_t err;
+    struct ps_write_behind_entry_t *entry;
+    struct psa_storage_info_t info;
+    bool is_new = false;
+    uint32_t fid_num;
+    uint32_t n;
+
+    /* Boundary check the incoming request */
+    if (data_length > PS_MAX_ASSET_SIZE) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* A set of the newest queued object replaces its data in place. Older
+     * entries are not replaced, so that the objects are still committed in
+     * the order they were set.
+     */
+    if (queue_count != 0) {
+        entry = queue_entry(queue_count - 1);
+        if ((entry->uid == uid) && (entry->client_id == client_id)) {
+            err = ps_req_mngr_read_asset_data(entry->data, data_length);
+            if (err != PSA_SUCCESS) {
+                /* The data of the entry was partially replaced */
+                (void)tfm_memset(entry, PS_DEFAULT_EMPTY_BUFF_VAL,
+                                 sizeof(*entry));
+                queue_count--;
+                return err;
+            }
+
+            entry->create_flags = create_flags;
+            entry->size = data_length;
+            ps_write_behind_clear_failure(client_id, uid);
+
+            return PSA_SUCCESS;
+        }
+    }
+
+    if (queue_count == PS_WRITE_BEHIND_QUEUE_LEN) {
+        /* A failure is reported on the committed object, not on this one */
+        (void)ps_write_behind_commit_one();
+    }
+
+    /* The checks done by ps_object_create are done here, against the state
+     * the object system will have once the queued objects are committed, so
+     * that the commit does not fail after the request has completed.
+     */
+    if (find_latest_entry(client_id, uid) == NULL) {
+        err = ps_object_table_obj_exist(uid, client_id);
+        if (err == PSA_SUCCESS) {
+            /* The stored version of the object can not be replaced if it has
+             * the write once flag set. Queued versions never have it.
+             */
+            err = ps_object_get_info(uid, client_id, &info);
+            if (err != PSA_SUCCESS) {
+                return err;
+            }
+
+            if (info.flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+                return PSA_ERROR_NOT_PERMITTED;
+            }
+        } else if (err == PSA_ERROR_DOES_NOT_EXIST) {
+            is_new = true;
+        } else {
+            return err;
+        }
+    }
+
+    /* Each new object queued before this one takes a table entry when it is
+     * committed, and ps_object_create requires 1 free entry to replace an
+     * object, or 2 to create one.
+     */
+    fid_num = is_new ? 2 : 1;
+    for (n = 0; n < queue_count; n++) {
+        if (queue_entry(n)->is_new) {
+            fid_num++;
+        }
+    }
+
+    err = ps_object_table_check_free_fids(fid_num);
+    if (err != PSA_SUCCESS) {
+        return err;
+    }
+
+    entry = queue_entry(queue_count);
+
+    err = ps_req_mngr_read_asset_data(entry->data, data_length);
+    if (err != PSA_SUCCESS) {
+        (void)tfm_memset(entry, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(*entry));
+        return err;
+    }
+
+    entry->uid = uid;
+    entry->client_id = client_id;
+    entry->create_flags = create_flags;
+    entry->size = data_length;
+    entry->is_new = is_new;
+    queue_count++;
+
+    /* The new data replaces the data which failed to be committed */
+    ps_write_behind_clear_failure(client_id, uid);
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_write_behind_get(int32_t client_id,
+                                 psa_storage_uid_t uid,
+                                 uint32_t data_offset,
+                                 uint32_t data_size,
+                                 size_t *p_data_length)
+{
+    struct ps_write_behind_entry_t *entry;
+
+    entry = find_latest_entry(client_id, uid);
+    if (entry == NULL) {
+        return report_failure(client_id, uid);
+    }
+
+    /* Boundary check the incoming request */
+    if (data_offset > entry->size) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    data_size = PS_UTILS_MIN(data_size, entry->size - data_offset);
+
+    ps_req_mngr_write_asset_data(entry->data + data_offset, data_size);
+
+    *p_data_length = data_size;
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_write_behind_get_info(int32_t client_id,
+                                      psa_storage_uid_t uid,
+                                      struct psa_storage_info_t *p_info)
+{
+    struct ps_write_behind_entry_t *entry;
+
+    entry = find_latest_entry(client_id, uid);
+    if (entry == NULL) {
+        return report_failure(client_id, uid);
+    }
+
+    p_info->size = entry->size;
+    p_info->flags = entry->create_flags;
+
+    return PSA_SUCCESS;
+}
+
+bool ps_write_behind_pending(void)
+{
+    return queue_count != 0;
+}
+
+psa_status_t ps_write_behind_commit_one(void)
+{
+    psa_status_t err;
+    struct ps_write_behind_entry_t *entry;
+
+    if (queue_count == 0) {
+        return PSA_SUCCESS;
+    }
+
+    entry = queue_entry(0);
+
+    err = ps_object_create_from_buffer(entry->uid, entry->client_id,
+                                       entry->create_flags, entry->size,
+                                       entry->data);
+    if (err == PSA_SUCCESS) {
+        ps_write_behind_clear_failure(entry->client_id, entry->uid);
+    } else {
+        /* The set request has already completed, so the error is reported
+         * by the next get or get_info request of the object. The object keeps
+         * its previous stored version, if any.
+         */
+        record_failure(entry, err);
+    }
+
+    /* Remove the object data from the queue */
+    (void)tfm_memset(entry, PS_DEFAULT_EMPTY_BUFF_VAL, sizeof(*entry));
+    queue_head = (queue_head + 1) % PS_WRITE_BEHIND_QUEUE_LEN;
+    queue_count--;
+
+    return err;
+}
+
+void ps_write_behind_flush(void)
+{
+    while (queue_count != 0) {
+        (void)ps_write_behind_commit_one();
+    }
+}
+
+void ps_write_behind_clear_failure(int32_t client_id, psa_storage_uid_t uid)
+{
+    uint32_t n = find_failure(client_id, uid);
+
+    if (n == failure_count) {
+        return;
+    }
+
+    for (; n + 1 < failure_count; n++) {
+        failures[n] = failures[n + 1];
+    }
+    failure_count--;
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PS_WRITE_BEHIND_H__
+#define __PS_WRITE_BEHIND_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+#include "psa/protected_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PS_WRITE_BEHIND_IDLE_TIMEOUT
+#define PS_WRITE_BEHIND_IDLE_TIMEOUT 100000
+#endif
+
+/**
+ * \brief Validates a set request and copies its data into the write-behind
+ *        queue. The object is encrypted and written by
+ *        \ref ps_write_behind_commit_one, after the queued objects set before
+ *        it. If the queue is full, the oldest queued object is committed
+ *        first. If the newest queued object is the same object, its data is
+ *        replaced instead, so that only the last data is committed. A failed
+ *        commit of the object is no longer reported.
+ *
+ * \param[in] client_id     Identifier of the asset's owner (client)
+ * \param[in] uid           Unique identifier for the data
+ * \param[in] data_length   Size of the data in bytes
+ * \param[in] create_flags  Flags indicating the properties of the data, which
+ *                          must not include PSA_STORAGE_FLAG_WRITE_ONCE
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_write_behind_set(int32_t client_id,
+                                 psa_storage_uid_t uid,
+                                 uint32_t data_length,
+                                 psa_storage_create_flags_t create_flags);
+
+/**
+ * \brief Reads the data of the latest queued version of an object.
+ *
+ * \param[in]  client_id      Identifier of the asset's owner (client)
+ * \param[in]  uid            Unique identifier for the data
+ * \param[in]  data_offset    Offset in the object at which to begin the read
+ * \param[in]  data_size      Size of the contents of `data` in bytes
+ * \param[out] p_data_length  On success, the size of the data read
+ *
+ * \return Returns the error of the last commit of the object if it failed
+ *         and no version of the object is queued, once. Returns
+ *         PSA_ERROR_DOES_NOT_EXIST if no version of the object is queued
+ *         otherwise, in which case the object must be read from the object
+ *         system. Otherwise, returns error code as specified in
+ *         \ref psa_status_t
+ */
+psa_status_t ps_write_behind_get(int32_t client_id,
+                                 psa_storage_uid_t uid,
+                                 uint32_t data_offset,
+                                 uint32_t data_size,
+                                 size_t *p_data_length);
+
+/**
+ * \brief Gets the information of the latest queued version of an object.
+ *
+ * \param[in]  client_id  Identifier of the asset's owner (client)
+ * \param[in]  uid        Unique identifier for the data
+ * \param[out] p_info     Pointer to the information structure to fill
+ *
+ * \return Returns the error of the last commit of the object if it failed
+ *         and no version of the object is queued, once. Returns
+ *         PSA_ERROR_DOES_NOT_EXIST if no version of the object is queued
+ *         otherwise, in which case the information must be read from the
+ *         object system. Otherwise, returns PSA_SUCCESS.
+ */
+psa_status_t ps_write_behind_get_info(int32_t client_id,
+                                      psa_storage_uid_t uid,
+                                      struct psa_storage_info_t *p_info);
+
+/**
+ * \brief Checks if objects are waiting in the write-behind queue.
+ *
+ * \return Returns true if the queue is not empty.
+ */
+bool ps_write_behind_pending(void);
+
+/**
+ * \brief Commits the oldest object of the write-behind queue to the object
+ *        system, and removes it from the queue.
+ *
+ * \note If the commit fails, the object is removed from the queue too, and
+ *       keeps its previous stored version, if any. As its set request has
+ *       already completed, the error is reported by the next get or get_info
+ *       request of the object, unless a later commit, set or remove of the
+ *       object replaces it first. The objects queued after it are still
+ *       committed.
+ *
+ * \return Returns error code specified in \ref psa_status_t
+ */
+psa_status_t ps_write_behind_commit_one(void);
+
+/**
+ * \brief Commits all the objects of the write-behind queue, in the order they
+ *        were set. The failed commits are reported on their objects, as by
+ *        \ref ps_write_behind_commit_one.
+ */
+void ps_write_behind_flush(void);
+
+/**
+ * \brief Forgets the failed commit of an object, which is replaced or removed
+ *        by a request.
+ *
+ * \param[in] client_id  Identifier of the asset's owner (client)
+ * \param[in] uid        Unique identifier for the data
+ */
+void ps_write_behind_clear_failure(int32_t client_id, psa_storage_uid_t uid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PS_WRITE_BEHIND_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
@@ -7,6 +7,9 @@
 
 #include "tfm_protected_storage.h"
 #include "ps_object_system.h"
+#ifdef PS_WRITE_BEHIND
+#include "ps_write_behind.h"
+#endif
 #include "tfm_ps_defs.h"
 
 psa_status_t tfm_ps_init(void)
@@ -60,6 +63,20 @@ psa_status_t tfm_ps_set(int32_t client_id,
         return PSA_ERROR_NOT_SUPPORTED;
     }
 
+#ifdef PS_WRITE_BEHIND
+    if ((create_flags & PSA_STORAGE_FLAG_WRITE_ONCE) == 0) {
+        /* Queue the object, to be encrypted and written while PS is idle */
+        return ps_write_behind_set(client_id, uid, data_length, create_flags);
+    }
+
+    /* Write once objects are stored before the request completes. The queued
+     * objects are committed first to keep the objects stored in the order they
+     * were set.
+     */
+    ps_write_behind_flush();
+    ps_write_behind_clear_failure(client_id, uid);
+#endif
+
     /* Create the object in the object system */
     return ps_object_create(uid, client_id, create_flags, data_length);
 }
@@ -70,11 +87,24 @@ psa_status_t tfm_ps_get(int32_t client_id,
                         uint32_t data_size,
                         size_t *p_data_length)
 {
+#ifdef PS_WRITE_BEHIND
+    psa_status_t err;
+
+#endif
     /* Check that the UID is valid */
     if (uid == TFM_PS_INVALID_UID) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#ifdef PS_WRITE_BEHIND
+    /* Read the latest version of the object, which may not be committed yet */
+    err = ps_write_behind_get(client_id, uid, data_offset, data_size,
+                              p_data_length);
+    if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+#endif
+
     /* Read the object data from the object system */
     return ps_object_read(uid, client_id, data_offset, data_size,
                           p_data_length);
@@ -83,11 +113,25 @@ psa_status_t tfm_ps_get(int32_t client_id,
 psa_status_t tfm_ps_get_info(int32_t client_id, psa_storage_uid_t uid,
                              struct psa_storage_info_t *p_info)
 {
+#ifdef PS_WRITE_BEHIND
+    psa_status_t err;
+
+#endif
     /* Check that the UID is valid */
     if (uid == TFM_PS_INVALID_UID) {
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#ifdef PS_WRITE_BEHIND
+    /* Get the info of the latest version of the object, which may not be
+     * committed yet
+     */
+    err = ps_write_behind_get_info(client_id, uid, p_info);
+    if (err != PSA_ERROR_DOES_NOT_EXIST) {
+        return err;
+    }
+#endif
+
     /* Get the info struct data from the object system */
     return ps_object_get_info(uid, client_id, p_info);
 }
@@ -101,6 +145,14 @@ psa_status_t tfm_ps_remove(int32_t client_id, psa_storage_uid_t uid)
         return PSA_ERROR_INVALID_ARGUMENT;
     }
 
+#ifdef PS_WRITE_BEHIND
+    /* Commit the queued objects first, so that the removal applies to the
+     * latest version of the object.
+     */
+    ps_write_behind_flush();
+    ps_write_behind_clear_failure(client_id, uid);
+#endif
+
     /* Delete the object from the object system */
     err = ps_object_delete(uid, client_id);
 
@@ -18,6 +18,15 @@
 #include "psa/service.h"
 #include "psa_manifest/tfm_protected_storage.h"
 #include "tfm_ps_defs.h"
+#ifdef PS_STATS
+#include "tfm_memory_utils.h"
+#include "tfm_storage_stats.h"
+#include "tfm_timer_api.h"
+#endif
+#ifdef PS_WRITE_BEHIND
+#include "ps_write_behind.h"
+#include "tfm_timer_api.h"
+#endif
 #endif
 
 #ifndef TFM_PSA_API
@@ -360,38 +369,141 @@ static psa_status_t tfm_ps_get_support_ipc(void)
     return PSA_SUCCESS;
 }
 
-static void ps_signal_handle(psa_signal_t signal)
+#ifdef PS_STATS
+static struct tfm_storage_op_stats_t ps_op_stats[TFM_PS_STATS_NUM_OPS];
+
+/**
+ * \brief Records a handled request in the PS statistics.
+ *
+ * \param[in] type    Type of the request
+ * \param[in] status  Status returned to the client
+ * \param[in] start   Timestamp taken when the request was received
+ */
+static void ps_stats_record(int32_t type, psa_status_t status, uint32_t start)
+{
+    struct tfm_storage_op_stats_t *op_stats;
+    uint32_t ticks = tfm_timer_get_timestamp() - start;
+    uint32_t bucket = 0;
+
+    /* The PS message types are numbered in the same order as the statistics,
+     * from TFM_PS_SET.
+     */
+    if ((type < TFM_PS_SET) || (type >= TFM_PS_SET + TFM_PS_STATS_NUM_OPS)) {
+        return;
+    }
+    op_stats = &ps_op_stats[type - TFM_PS_SET];
+
+    /* The bucket is the number of significant bits of the duration */
+    while ((ticks != 0) && (bucket < TFM_STORAGE_STATS_LATENCY_BUCKETS - 1)) {
+        ticks >>= 1;
+        bucket++;
+    }
+
+    op_stats->count++;
+    if (status != PSA_SUCCESS) {
+        op_stats->errors++;
+    }
+    op_stats->latency[bucket]++;
+}
+
+static psa_status_t tfm_ps_get_stats_ipc(void)
+{
+    struct tfm_ps_stats_t stats;
+
+    if ((msg.type != PSA_IPC_CALL) || (msg.out_size[0] != sizeof(stats))) {
+        /* The message type or the size of the output is incorrect */
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    tfm_memcpy(stats.ops, ps_op_stats, sizeof(stats.ops));
+
+    psa_write(msg.handle, 0, &stats, sizeof(stats));
+
+    return PSA_SUCCESS;
+}
+#endif /* PS_STATS */
+
+static psa_status_t ps_handle_msg(void)
 {
     psa_status_t status;
+#ifdef PS_STATS
+    uint32_t start = tfm_timer_get_timestamp();
+#endif
 
-    status = psa_get(signal, &msg);
     switch (msg.type) {
     case TFM_PS_SET:
         status = tfm_ps_set_ipc();
-        psa_reply(msg.handle, status);
         break;
     case TFM_PS_GET:
         status = tfm_ps_get_ipc();
-        psa_reply(msg.handle, status);
         break;
     case TFM_PS_GET_INFO:
         status = tfm_ps_get_info_ipc();
-        psa_reply(msg.handle, status);
         break;
     case TFM_PS_REMOVE:
         status = tfm_ps_remove_ipc();
-        psa_reply(msg.handle, status);
         break;
     case TFM_PS_GET_SUPPORT:
         status = tfm_ps_get_support_ipc();
-        psa_reply(msg.handle, status);
         break;
     default:
         psa_panic();
     }
+
+#ifdef PS_STATS
+    ps_stats_record(msg.type, status, start);
+#endif
+
+    return status;
 }
+
+/* The statistics service is only accessible to the secure partitions which
+ * declare it as a dependency in their manifest.
+ */
+static psa_status_t ps_stats_handle_msg(void)
+{
+#ifdef PS_STATS
+    return tfm_ps_get_stats_ipc();
+#else
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
+
+#if TFM_SP_PS_MODEL_SFN == 1
+psa_status_t tfm_ps_stats_service_sfn(const psa_msg_t *p_msg)
+{
+    msg = *p_msg;
+
+    return ps_stats_handle_msg();
+}
+
+psa_status_t tfm_protected_storage_service_sfn(const psa_msg_t *p_msg)
+{
+    msg = *p_msg;
+
+    return ps_handle_msg();
+}
+#else /* TFM_SP_PS_MODEL_SFN == 1 */
+static void ps_signal_handle(psa_signal_t signal)
+{
+    psa_status_t status;
+
+    status = psa_get(signal, &msg);
+    if (status != PSA_SUCCESS) {
+        return;
+    }
+
+    if (signal == TFM_PS_STATS_SERVICE_SIGNAL) {
+        status = ps_stats_handle_msg();
+    } else {
+        status = ps_handle_msg();
+    }
+    psa_reply(msg.handle, status);
+}
+#endif /* TFM_SP_PS_MODEL_SFN == 1 */
 #endif /* !defined(TFM_PSA_API) */
 
+#if !defined(TFM_PSA_API) || (TFM_SP_PS_MODEL_IPC == 1)
 psa_status_t tfm_ps_req_mngr_init(void)
 {
 #ifdef TFM_PSA_API
@@ -405,9 +517,26 @@ psa_status_t tfm_ps_req_mngr_init(void)
         signals = psa_wait(PSA_WAIT_ANY, PSA_BLOCK);
         if (signals & TFM_PROTECTED_STORAGE_SERVICE_SIGNAL) {
             ps_signal_handle(TFM_PROTECTED_STORAGE_SERVICE_SIGNAL);
+        } else if (signals & TFM_PS_STATS_SERVICE_SIGNAL) {
+            ps_signal_handle(TFM_PS_STATS_SERVICE_SIGNAL);
+#ifdef PS_WRITE_BEHIND
+        } else if (signals & TFM_TIMER_SIGNAL) {
+            /* No request was received for PS_WRITE_BEHIND_IDLE_TIMEOUT ticks.
+             * A failed commit is reported on its object.
+             */
+            (void)ps_write_behind_commit_one();
+#endif
         } else {
             psa_panic();
         }
+#ifdef PS_WRITE_BEHIND
+        /* Each request restarts the idle timeout of the next commit. Setting
+         * the timer also clears its signal, and cancels it once the queue is
+         * empty.
+         */
+        (void)tfm_timer_set(ps_write_behind_pending() ?
+                            PS_WRITE_BEHIND_IDLE_TIMEOUT : 0);
+#endif
     }
 #else
     /* In library mode, initialisation is delayed until the first secure
@@ -417,6 +546,7 @@ psa_status_t tfm_ps_req_mngr_init(void)
     return PSA_SUCCESS;
 #endif
 }
+#endif /* !defined(TFM_PSA_API) || (TFM_SP_PS_MODEL_IPC == 1) */
 
 psa_status_t ps_req_mngr_read_asset_data(uint8_t *out_data, uint32_t size)
 {
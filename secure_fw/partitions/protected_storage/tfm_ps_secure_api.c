@@ -7,6 +7,7 @@
 
 #include "array.h"
 #include "psa/protected_storage.h"
+#include "tfm_ps_ext_api.h"
 #ifdef TFM_PSA_API
 #include "psa/client.h"
 #include "psa_manifest/sid.h"
@@ -182,3 +183,23 @@ uint32_t psa_ps_get_support(void)
 
     return support_flags;
 }
+
+psa_status_t tfm_ps_ext_get_stats(struct tfm_ps_stats_t *stats)
+{
+#ifdef TFM_PSA_API
+    psa_outvec out_vec[] = {
+        { .base = stats, .len = sizeof(*stats) }
+    };
+
+    if (stats == NULL) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    return psa_call(TFM_PS_STATS_SERVICE_HANDLE, PSA_IPC_CALL, NULL, 0,
+                    out_vec, IOVEC_LEN(out_vec));
+#else
+    (void)stats;
+
+    return PSA_ERROR_NOT_SUPPORTED;
+#endif
+}
@@ -15,6 +15,9 @@
 #include "tfm_multi_core_api.h"
 #include "tfm_ns_mailbox.h"
 #include "psa_proxy_shared_mem_mngr.h"
+#ifdef PSA_PROXY_LOCAL_CRYPTO
+#include "psa_proxy_local_crypto.h"
+#endif
 
 #define NON_SECURE_CLIENT_ID            (-1)
 
@@ -43,8 +46,13 @@ static inline void deallocate_forward_handle(psa_handle_t *h)
     tfm_pool_free(forward_handle_pool, h);
 }
 
+/*
+ * in_vec0 is the content of the first input vector of the message, if it has
+ * already been read by the proxy, or NULL.
+ */
 static psa_status_t forward_message_to_secure_enclave(psa_signal_t signal,
-                                                       const psa_msg_t *msg)
+                                                       const psa_msg_t *msg,
+                                                       const void *in_vec0)
 {
     psa_status_t status;
     struct psa_client_params_t params;
@@ -75,7 +83,8 @@ static psa_status_t forward_message_to_secure_enclave(psa_signal_t signal,
         break;
     }
 
-    status = psa_proxy_put_msg_into_shared_mem(msg, &params);
+    status = psa_proxy_put_prefetched_msg_into_shared_mem(msg, in_vec0,
+                                                          &params);
 
     if (status != PSA_SUCCESS) {
         return status;
@@ -164,6 +173,31 @@ static psa_status_t psa_connect_to_secure_enclave(psa_signal_t signal,
     }
 }
 
+#ifdef PSA_PROXY_LOCAL_CRYPTO
+/*
+ * Serves the keyless crypto requests locally, saving the round-trip to the
+ * Secure Enclave. The other requests are forwarded.
+ */
+static psa_status_t handle_crypto_request(psa_signal_t signal,
+                                          const psa_msg_t *msg)
+{
+    struct tfm_crypto_pack_iovec iov;
+    psa_status_t status;
+
+    if (msg->in_size[0] != sizeof(iov)) {
+        return forward_message_to_secure_enclave(signal, msg, NULL);
+    }
+
+    (void)psa_read(msg->handle, 0, &iov, sizeof(iov));
+
+    if (psa_proxy_local_crypto_call(msg, &iov, &status)) {
+        return status;
+    }
+
+    return forward_message_to_secure_enclave(signal, msg, &iov);
+}
+#endif /* PSA_PROXY_LOCAL_CRYPTO */
+
 static void handle_signal(psa_signal_t signal)
 {
     psa_msg_t msg;
@@ -180,7 +214,14 @@ static void handle_signal(psa_signal_t signal)
         psa_reply(msg.handle, PSA_SUCCESS);
         break;
     default:
-        status = forward_message_to_secure_enclave(signal, &msg);
+#ifdef PSA_PROXY_LOCAL_CRYPTO
+        if (signal == TFM_CRYPTO_SIGNAL) {
+            status = handle_crypto_request(signal, &msg);
+            psa_reply(msg.handle, status);
+            break;
+        }
+#endif
+        status = forward_message_to_secure_enclave(signal, &msg, NULL);
         psa_reply(msg.handle, status);
         break;
     }
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mbedtls/sha256.h"
+#include "mbedtls/sha512.h"
+#include "psa/service.h"
+#include "psa_proxy_local_crypto.h"
+#include "tfm_crypto_defs.h"
+
+/*
+ * Only the operations below are served by the proxy. They involve no key, and
+ * their result only depends on the caller's inputs, so serving them locally
+ * gives the same result as the Secure Enclave. Any other request, or any
+ * request with an algorithm or vectors the proxy does not handle, is
+ * forwarded, so that the Secure Enclave returns the error.
+ */
+static const uint32_t local_crypto_allow_list[] = {
+    TFM_CRYPTO_HASH_COMPUTE_SID,
+    TFM_CRYPTO_HASH_COMPARE_SID,
+};
+
+/* The largest hash computed by the proxy */
+#define LOCAL_HASH_MAX_SIZE     64
+
+/* Size of the chunks the input is read in */
+#define LOCAL_HASH_CHUNK_SIZE   64
+
+struct local_hash_ctx_t {
+    psa_algorithm_t alg;
+    union {
+        mbedtls_sha256_context sha256;
+        mbedtls_sha512_context sha512;
+    } ctx;
+};
+
+static struct psa_proxy_crypto_stats_t local_crypto_stats;
+
+static bool local_crypto_allowed(uint32_t sfn_id)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(local_crypto_allow_list) /
+                    sizeof(local_crypto_allow_list[0]); i++) {
+        if (local_crypto_allow_list[i] == sfn_id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Returns the size of the hash, or 0 if the proxy does not compute it */
+static size_t local_hash_size(psa_algorithm_t alg)
+{
+    switch (alg) {
+    case PSA_ALG_SHA_224:
+        return 28;
+    case PSA_ALG_SHA_256:
+        return 32;
+    case PSA_ALG_SHA_384:
+        return 48;
+    case PSA_ALG_SHA_512:
+        return 64;
+    default:
+        return 0;
+    }
+}
+
+/*
+ * Hashes the given input vector of the message, which is read in chunks.
+ * The algorithm must be one of those of local_hash_size().
+ */
+static psa_status_t local_hash_compute(const psa_msg_t *msg,
+                                       uint32_t invec_idx,
+                                       psa_algorithm_t alg,
+                                       uint8_t *hash)
+{
+    struct local_hash_ctx_t hash_ctx;
+    uint8_t chunk[LOCAL_HASH_CHUNK_SIZE];
+    size_t remaining = msg->in_size[invec_idx];
+    size_t read_size;
+    bool is_sha512 = (alg == PSA_ALG_SHA_384) || (alg == PSA_ALG_SHA_512);
+    int ret;
+
+    hash_ctx.alg = alg;
+    if (is_sha512) {
+        mbedtls_sha512_init(&hash_ctx.ctx.sha512);
+        ret = mbedtls_sha512_starts(&hash_ctx.ctx.sha512,
+                                    alg == PSA_ALG_SHA_384);
+    } else {
+        mbedtls_sha256_init(&hash_ctx.ctx.sha256);
+        ret = mbedtls_sha256_starts(&hash_ctx.ctx.sha256,
+                                    alg == PSA_ALG_SHA_224);
+    }
+
+    while ((ret == 0) && (remaining > 0)) {
+        read_size = psa_read(msg->handle, invec_idx, chunk, sizeof(chunk));
+        if (read_size == 0) {
+            break;
+        }
+
+        ret = is_sha512 ?
+              mbedtls_sha512_update(&hash_ctx.ctx.sha512, chunk, read_size) :
+              mbedtls_sha256_update(&hash_ctx.ctx.sha256, chunk, read_size);
+        remaining -= read_size;
+    }
+
+    if (ret == 0) {
+        ret = is_sha512 ?
+              mbedtls_sha512_finish(&hash_ctx.ctx.sha512, hash) :
+              mbedtls_sha256_finish(&hash_ctx.ctx.sha256, hash);
+    }
+
+    if (is_sha512) {
+        mbedtls_sha512_free(&hash_ctx.ctx.sha512);
+    } else {
+        mbedtls_sha256_free(&hash_ctx.ctx.sha256);
+    }
+
+    return (ret == 0) ? PSA_SUCCESS : PSA_ERROR_GENERIC_ERROR;
+}
+
+/* psa_hash_compute: in_vec[1] is the input, out_vec[0] receives the hash */
+static bool local_hash_compute_call(const psa_msg_t *msg,
+                                    const struct tfm_crypto_pack_iovec *iov,
+                                    psa_status_t *status)
+{
+    uint8_t hash[LOCAL_HASH_MAX_SIZE];
+    size_t hash_size = local_hash_size(iov->alg);
+
+    if ((hash_size == 0) ||
+        (msg->in_size[2] != 0) || (msg->in_size[3] != 0) ||
+        (msg->out_size[1] != 0) || (msg->out_size[2] != 0) ||
+        (msg->out_size[3] != 0)) {
+        return false;
+    }
+
+    if (msg->out_size[0] < hash_size) {
+        *status = PSA_ERROR_BUFFER_TOO_SMALL;
+        return true;
+    }
+
+    *status = local_hash_compute(msg, 1, iov->alg, hash);
+    if (*status == PSA_SUCCESS) {
+        psa_write(msg->handle, 0, hash, hash_size);
+    }
+
+    return true;
+}
+
+/* psa_hash_compare: in_vec[1] is the input, in_vec[2] the expected hash */
+static bool local_hash_compare_call(const psa_msg_t *msg,
+                                    const struct tfm_crypto_pack_iovec *iov,
+                                    psa_status_t *status)
+{
+    uint8_t hash[LOCAL_HASH_MAX_SIZE];
+    uint8_t expected[LOCAL_HASH_MAX_SIZE];
+    size_t hash_size = local_hash_size(iov->alg);
+    size_t i;
+    uint8_t diff = 0;
+
+    if ((hash_size == 0) || (msg->in_size[3] != 0) ||
+        (msg->out_size[0] != 0) || (msg->out_size[1] != 0) ||
+        (msg->out_size[2] != 0) || (msg->out_size[3] != 0)) {
+        return false;
+    }
+
+    if (msg->in_size[2] != hash_size) {
+        *status = PSA_ERROR_INVALID_SIGNATURE;
+        return true;
+    }
+
+    *status = local_hash_compute(msg, 1, iov->alg, hash);
+    if (*status != PSA_SUCCESS) {
+        return true;
+    }
+
+    (void)psa_read(msg->handle, 2, expected, hash_size);
+
+    /* Constant time comparison, as done by the Secure Enclave */
+    for (i = 0; i < hash_size; i++) {
+        diff |= hash[i] ^ expected[i];
+    }
+
+    *status = (diff == 0) ? PSA_SUCCESS : PSA_ERROR_INVALID_SIGNATURE;
+
+    return true;
+}
+
+bool psa_proxy_local_crypto_call(const psa_msg_t *msg,
+                                 const struct tfm_crypto_pack_iovec *iov,
+                                 psa_status_t *status)
+{
+    bool served = false;
+
+    if ((msg->type == PSA_IPC_CALL) && local_crypto_allowed(iov->sfn_id)) {
+        switch (iov->sfn_id) {
+        case TFM_CRYPTO_HASH_COMPUTE_SID:
+            served = local_hash_compute_call(msg, iov, status);
+            break;
+        case TFM_CRYPTO_HASH_COMPARE_SID:
+            served = local_hash_compare_call(msg, iov, status);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (served) {
+        local_crypto_stats.local++;
+    } else {
+        local_crypto_stats.forwarded++;
+    }
+
+    return served;
+}
+
+void psa_proxy_local_crypto_get_stats(struct psa_proxy_crypto_stats_t *stats)
+{
+    *stats = local_crypto_stats;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __PSA_PROXY_LOCAL_CRYPTO_H__
+#define __PSA_PROXY_LOCAL_CRYPTO_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "psa/error.h"
+#include "psa/service.h"
+#include "tfm_crypto_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Number of crypto requests served by the proxy, and forwarded to the
+ *        Secure Enclave
+ */
+struct psa_proxy_crypto_stats_t {
+    uint32_t local;     /*!< Requests served by the proxy, each one saving a
+                         *   round-trip to the Secure Enclave
+                         */
+    uint32_t forwarded; /*!< Requests forwarded to the Secure Enclave */
+};
+
+/*!
+ * \brief Serves a crypto request in the proxy, if it is in the allow-list of
+ *        keyless operations
+ *
+ * \param[in]  msg     PSA message of the request
+ * \param[in]  iov     First input vector of the request, already read
+ * \param[out] status  Status of the request, if it was served
+ *
+ * \retval true   The request is served, and its results are written back
+ * \retval false  The request is not in the allow-list, and nothing but its
+ *                first input vector has been read. It must be forwarded.
+ */
+bool psa_proxy_local_crypto_call(const psa_msg_t *msg,
+                                 const struct tfm_crypto_pack_iovec *iov,
+                                 psa_status_t *status);
+
+/*!
+ * \brief Gets the number of crypto requests served by the proxy and forwarded
+ *        to the Secure Enclave since boot
+ *
+ * \param[out] stats  The request counters
+ */
+void psa_proxy_local_crypto_get_stats(struct psa_proxy_crypto_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PSA_PROXY_LOCAL_CRYPTO_H__ */
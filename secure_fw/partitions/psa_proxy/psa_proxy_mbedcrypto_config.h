@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Minimal configuration of the Mbed Crypto instance of the PSA proxy, which
+ * only computes the hashes served locally by the proxy.
+ */
+
+#ifndef __PSA_PROXY_MBEDCRYPTO_CONFIG_H__
+#define __PSA_PROXY_MBEDCRYPTO_CONFIG_H__
+
+/* System support */
+#define MBEDTLS_NO_PLATFORM_ENTROPY
+
+/* mbed TLS modules */
+#define MBEDTLS_SHA224_C
+#define MBEDTLS_SHA256_C
+#define MBEDTLS_SHA384_C
+#define MBEDTLS_SHA512_C
+
+#include "mbedtls/check_config.h"
+
+#endif /* __PSA_PROXY_MBEDCRYPTO_CONFIG_H__ */
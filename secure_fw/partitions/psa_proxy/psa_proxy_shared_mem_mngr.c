@@ -6,6 +6,8 @@
  *
  */
 
+#include <string.h>
+
 #include "psa_proxy_shared_mem_mngr.h"
 #include "region_defs.h"
 #include "psa/service.h"
@@ -47,7 +49,8 @@ struct shared_mem_t shared_mem;
 uint32_t shared_mem_buffer_actual_size = 0;
 
 static psa_status_t write_input_param_into_shared_mem(uint32_t param_num,
-                                                      const psa_msg_t *msg)
+                                                      const psa_msg_t *msg,
+                                                      const void *prefetched)
 {
     const void *buff_input_ptr;
 
@@ -55,10 +58,15 @@ static psa_status_t write_input_param_into_shared_mem(uint32_t param_num,
         SHARED_BUFFER_SIZE) {
         buff_input_ptr = &(shared_mem.buffer[shared_mem_buffer_actual_size]);
 
-        psa_read(msg->handle,
-                 param_num,
-                 (void *) buff_input_ptr,
-                 msg->in_size[param_num]);
+        if (prefetched != NULL) {
+            memcpy((void *) buff_input_ptr, prefetched,
+                   msg->in_size[param_num]);
+        } else {
+            psa_read(msg->handle,
+                     param_num,
+                     (void *) buff_input_ptr,
+                     msg->in_size[param_num]);
+        }
         shared_mem_buffer_actual_size += msg->in_size[param_num];
 
         shared_mem.in_vec[param_num].base = buff_input_ptr;
@@ -145,6 +153,15 @@ struct ns_mailbox_queue_t * psa_proxy_get_ns_mailbox_queue(void)
 psa_status_t psa_proxy_put_msg_into_shared_mem(
         const psa_msg_t* msg,
         struct psa_client_params_t* forward_params)
+{
+    return psa_proxy_put_prefetched_msg_into_shared_mem(msg, NULL,
+                                                        forward_params);
+}
+
+psa_status_t psa_proxy_put_prefetched_msg_into_shared_mem(
+        const psa_msg_t* msg,
+        const void *in_vec0,
+        struct psa_client_params_t* forward_params)
 {
     psa_status_t status;
     uint32_t i;
@@ -155,7 +172,8 @@ psa_status_t psa_proxy_put_msg_into_shared_mem(
 
     for (i = 0; i < PSA_MAX_IOVEC; i++) {
         if (msg->in_size[i] > 0) {
-            status = write_input_param_into_shared_mem(i, msg);
+            status = write_input_param_into_shared_mem(i, msg,
+                                                    (i == 0) ? in_vec0 : NULL);
             if ( status != PSA_SUCCESS ) {
                 return status;
             }
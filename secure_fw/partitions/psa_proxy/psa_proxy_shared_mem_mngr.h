@@ -37,6 +37,24 @@ psa_status_t psa_proxy_put_msg_into_shared_mem(
         const psa_msg_t *msg,
         struct psa_client_params_t *forward_params);
 
+/*!
+ * \brief Puts message into the shared memory, when its first input vector has
+ *        already been read by the proxy
+ *
+ * \param[in]  msg              PSA message to be forwarded
+ * \param[in]  in_vec0          Content of the first input vector, already read
+ *                              with psa_read, or NULL if it was not read
+ * \param[out] forward_params   PSA client parameters to be forwarded (pointers
+ *                              of the shared input and output vectors shall be
+ *                              written back to this structure.
+ *
+ * \return Returns values as specified by the \ref psa_status_t
+ */
+psa_status_t psa_proxy_put_prefetched_msg_into_shared_mem(
+        const psa_msg_t *msg,
+        const void *in_vec0,
+        struct psa_client_params_t *forward_params);
+
 /*!
  * \brief Writes back the results of the forwarded PSA message
  *
@@ -14,6 +14,7 @@
 #include "tfm_svcalls.h"
 #include "svc_num.h"
 #include "exception_info.h"
+#include "exception_record.h"
 
 #if !defined(__ARM_ARCH_6M__) && !defined(__ARM_ARCH_7M__) && \
     !defined(__ARM_ARCH_7EM__)
@@ -27,6 +28,9 @@ uint32_t scheduler_lock = SCHEDULER_UNLOCKED;
 #if defined(__ICCARM__)
 
 #pragma required = do_schedule
+#ifdef TFM_EXCEPTION_INFO_RECORD
+#pragma required = exception_record_pendsv
+#endif
 #pragma required = scheduler_lock
 #pragma required = tfm_core_svc_handler
 
@@ -82,6 +86,12 @@ __attribute__((naked)) void PendSV_Handler(void)
     __ASM volatile(
 #if !defined(__ICCARM__)
         ".syntax unified                    \n"
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+        "   push    {r0, lr}                \n"
+        "   bl      exception_record_pendsv \n"
+        "   pop     {r0, r1}                \n"
+        "   mov     lr, r1                  \n"
 #endif
         "   push    {r0, lr}                \n"
         "   bl      do_schedule             \n"
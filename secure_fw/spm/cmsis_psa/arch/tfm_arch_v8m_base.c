@@ -8,6 +8,7 @@
 #include <inttypes.h>
 #include "compiler_ext_defs.h"
 #include "exception_info.h"
+#include "exception_record.h"
 #include "spm_ipc.h"
 #include "svc_num.h"
 #include "tfm_hal_device_header.h"
@@ -28,6 +29,9 @@ uint32_t scheduler_lock = SCHEDULER_UNLOCKED;
 #if defined(__ICCARM__)
 
 #pragma required = do_schedule
+#ifdef TFM_EXCEPTION_INFO_RECORD
+#pragma required = exception_record_pendsv
+#endif
 #pragma required = scheduler_lock
 #pragma required = tfm_core_svc_handler
 
@@ -88,6 +92,12 @@ __attribute__((naked)) void PendSV_Handler(void)
     __ASM volatile(
 #if !defined(__ICCARM__)
         ".syntax unified                                \n"
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+        "   push    {r0, lr}                            \n"
+        "   bl      exception_record_pendsv             \n"
+        "   pop     {r0, r1}                            \n"
+        "   mov     lr, r1                              \n"
 #endif
         "   movs    r0, #"M2S(EXC_RETURN_SECURE_STACK)" \n"
         "   mov     r1, lr                              \n"
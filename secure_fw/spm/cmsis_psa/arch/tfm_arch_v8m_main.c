@@ -8,6 +8,7 @@
 #include <inttypes.h>
 #include "compiler_ext_defs.h"
 #include "exception_info.h"
+#include "exception_record.h"
 #include "region_defs.h"
 #include "spm_ipc.h"
 #include "svc_num.h"
@@ -33,6 +34,9 @@ uint32_t scheduler_lock = SCHEDULER_UNLOCKED;
 #if defined(__ICCARM__)
 
 #pragma required = do_schedule
+#ifdef TFM_EXCEPTION_INFO_RECORD
+#pragma required = exception_record_pendsv
+#endif
 #pragma required = scheduler_lock
 #pragma required = tfm_core_svc_handler
 
@@ -91,6 +95,11 @@ __attribute__((naked)) void PendSV_Handler(void)
     __ASM volatile(
 #if !defined(__ICCARM__)
         ".syntax unified                                \n"
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+        "   push    {r0, lr}                            \n"
+        "   bl      exception_record_pendsv             \n"
+        "   pop     {r0, lr}                            \n"
 #endif
         "   movs    r0, #"M2S(EXC_RETURN_SECURE_STACK)" \n"
         "   ands    r0, lr                              \n" /* NS interrupted */
@@ -144,6 +153,9 @@ __attribute__((naked)) void SVC_Handler(void)
     "BL      tfm_core_svc_handler           \n"
     "MOV     lr, r0                         \n"
     "POP     {r1, r2}                       \n" /* Orig_exc_return, PSP */
+    "CMP     r0, r1                         \n" /* Unchanged EXC_RETURN, */
+    "IT      EQ                             \n" /* not a FLIH SVC: return */
+    "BXEQ    lr                             \n" /* without mode checks */
     "AND     r0, #8                         \n" /* Mode bit */
     "AND     r3, r1, #8                     \n"
     "SUBS    r0, r3                         \n" /* Compare EXC_RETURN values */
@@ -358,4 +370,16 @@ __attribute__((naked, noinline)) void tfm_arch_clear_fp_data(void)
                     "bx   lr                 \n"
                   );
 }
+
+void tfm_arch_set_fp_access(bool enable)
+{
+    if (enable) {
+        SCB->CPACR |= (3U << 10U*2U)     /* enable CP10 full access */
+                      | (3U << 11U*2U);  /* enable CP11 full access */
+    } else {
+        SCB->CPACR &= ~((3U << 10U*2U) | (3U << 11U*2U));
+    }
+    __DSB();
+    __ISB();
+}
 #endif
@@ -7,6 +7,7 @@
 #include <string.h>
 #include "tfm_arch.h"
 #include "exception_info.h"
+#include "exception_record.h"
 #include "tfm_spm_log.h"
 #include "tfm_core_utils.h"
 
@@ -100,6 +101,7 @@ uint32_t *get_exception_frame(uint32_t lr, uint32_t msp, uint32_t psp)
 #endif
 }
 
+#ifdef TFM_EXCEPTION_INFO_DUMP
 static void dump_exception_info_t(bool stack_error,
                                   struct exception_info_t *ctx)
 {
@@ -202,6 +204,37 @@ static void dump_error(uint32_t error_type)
     }
     dump_exception_info_t(stack_error, &exception_info);
 }
+#endif /* TFM_EXCEPTION_INFO_DUMP */
+
+#ifdef TFM_EXCEPTION_INFO_RECORD
+static void record_exception(uint32_t exception_type,
+                             struct exception_info_t *ctx)
+{
+    struct tfm_exc_record_entry_t entry = {0};
+
+    entry.exception_type = exception_type;
+    entry.exc_return = ctx->EXC_RETURN;
+    entry.lr = ctx->EXC_FRAME_COPY[5];
+    entry.pc = ctx->EXC_FRAME_COPY[6];
+
+#ifdef FAULT_STATUS_PRESENT
+    entry.fault_status = ctx->CFSR;
+    if (ctx->BFARVALID) {
+        entry.fault_address = ctx->BFAR;
+    } else if (ctx->MMARVALID) {
+        entry.fault_address = ctx->MMFAR;
+    }
+#ifdef TRUSTZONE_PRESENT
+    if (exception_type == EXCEPTION_TYPE_SECUREFAULT) {
+        entry.fault_status = ctx->SFSR;
+        entry.fault_address = ctx->SFARVALID ? ctx->SFAR : 0;
+    }
+#endif
+#endif
+
+    exception_record_fault(&entry);
+}
+#endif /* TFM_EXCEPTION_INFO_RECORD */
 
 void store_and_dump_context(uint32_t LR_in, uint32_t MSP_in, uint32_t PSP_in,
                             uint32_t exception_type)
@@ -233,5 +266,10 @@ void store_and_dump_context(uint32_t LR_in, uint32_t MSP_in, uint32_t PSP_in,
 #endif
 #endif
 
+#ifdef TFM_EXCEPTION_INFO_RECORD
+    record_exception(exception_type, ctx);
+#endif
+#ifdef TFM_EXCEPTION_INFO_DUMP
     dump_error(exception_type);
+#endif
 }
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "compiler_ext_defs.h"
+#include "critical_section.h"
+#include "current.h"
+#include "exception_record.h"
+#include "spm_ipc.h"
+#include "tfm_core_utils.h"
+#include "tfm_hal_platform.h"
+#include "utilities.h"
+#include "load/partition_defs.h"
+
+/*
+ * The record is placed in a section which is not initialized at boot, so
+ * that it is kept across a warm reset. Its content is kept when the magic is
+ * valid, and the entries are indexed modulo their number, so that a corrupted
+ * record cannot make SPM write out of it.
+ */
+__section(".bss.tfm_exc_record")
+static struct tfm_exc_record_t exc_record;
+
+/* Partitions attached since boot, in load order */
+static uint32_t attached;
+
+void exception_record_init(void)
+{
+    uint32_t i;
+
+    if (exc_record.magic == EXC_RECORD_MAGIC) {
+        exc_record.boots++;
+        return;
+    }
+
+    spm_memset(&exc_record, 0, sizeof(exc_record));
+    for (i = 0; i < EXC_RECORD_PARTITIONS; i++) {
+        exc_record.counters[i].partition_id = -1;
+    }
+    exc_record.boots = 1;
+    exc_record.magic = EXC_RECORD_MAGIC;
+}
+
+struct tfm_exc_record_counters_t *exception_record_attach(int32_t partition_id)
+{
+    struct tfm_exc_record_counters_t *p_counters;
+
+    if (attached >= EXC_RECORD_PARTITIONS) {
+        return NULL;
+    }
+
+    /* A slot of another partition is taken over, such as after an update */
+    p_counters = &exc_record.counters[attached++];
+    if (p_counters->partition_id != partition_id) {
+        spm_memset(p_counters, 0, sizeof(*p_counters));
+        p_counters->partition_id = partition_id;
+    }
+
+    return p_counters;
+}
+
+void exception_record_fault(struct tfm_exc_record_entry_t *entry)
+{
+    struct partition_t *p_pt = CURRENT_THREAD ? GET_CURRENT_COMPONENT() : NULL;
+
+    entry->timestamp = tfm_hal_get_timestamp();
+    entry->partition_id = p_pt ? p_pt->p_ldinf->pid : -1;
+
+    exc_record.entries[exc_record.recorded % EXC_RECORD_ENTRIES] = *entry;
+    exc_record.recorded++;
+
+    EXC_RECORD_COUNT(p_pt, faults);
+}
+
+void exception_record_pendsv(void)
+{
+    if (CURRENT_THREAD) {
+        EXC_RECORD_COUNT(GET_CURRENT_COMPONENT(), pendsv);
+    }
+}
+
+psa_status_t exception_record_get(struct tfm_exc_record_t *record)
+{
+    struct partition_t *partition = tfm_spm_get_running_partition();
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t privileged;
+
+    if (!partition) {
+        tfm_core_panic();
+    }
+
+    privileged = tfm_spm_partition_get_privileged_mode(
+        partition->p_ldinf->flags);
+    if (privileged != TFM_PARTITION_PRIVILEGED_MODE) {
+        return PSA_ERROR_NOT_PERMITTED;
+    }
+
+    /* It is a fatal error if the record cannot be written by the caller */
+    if (tfm_memory_check(record, sizeof(*record), false, TFM_MEMORY_ACCESS_RW,
+                         privileged) != SPM_SUCCESS) {
+        tfm_core_panic();
+    }
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+    spm_memcpy(record, &exc_record, sizeof(*record));
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    return PSA_SUCCESS;
+}
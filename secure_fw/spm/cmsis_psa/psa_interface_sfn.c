@@ -11,6 +11,13 @@
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
 #include "psa/client.h"
+#include "tfm_hal_platform.h"
+#ifdef CONFIG_TFM_SPM_API_STATS
+#include "ffm/spm_api_stats.h"
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+#include "exception_record.h"
+#endif
 
 #ifdef CONFIG_TFM_PSA_API_SFN_CALL
 
@@ -117,4 +124,30 @@ void psa_panic_sfn(void)
     tfm_spm_partition_psa_panic();
 }
 
+uint32_t tfm_timer_get_timestamp_sfn(void)
+{
+    return tfm_hal_get_timestamp();
+}
+
+#ifdef CONFIG_TFM_SPM_API_STATS
+psa_status_t tfm_spm_api_stats_get_sfn(uint32_t index,
+                                       struct tfm_spm_api_stats_t *stats)
+{
+    return tfm_spm_api_stats_get_record(index, stats);
+}
+
+psa_status_t tfm_spm_idle_stats_get_sfn(uint32_t state,
+                                        struct tfm_spm_idle_stats_t *stats)
+{
+    return tfm_spm_idle_stats_get_record(state, stats);
+}
+#endif
+
+#ifdef TFM_EXCEPTION_INFO_RECORD
+psa_status_t tfm_exc_record_get_sfn(struct tfm_exc_record_t *record)
+{
+    return exception_record_get(record);
+}
+#endif
+
 #endif /* CONFIG_TFM_PSA_API_SFN_CALL */
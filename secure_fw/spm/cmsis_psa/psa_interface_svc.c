@@ -13,6 +13,9 @@
 #include "psa/client.h"
 #include "psa/lifecycle.h"
 #include "psa/service.h"
+#include "tfm_exc_record_api.h"
+#include "tfm_spm_stats_api.h"
+#include "tfm_timer_api.h"
 
 #if defined(CONFIG_TFM_PSA_API_SUPERVISOR_CALL)
 
@@ -142,4 +145,44 @@ __naked uint32_t psa_rot_lifecycle_state_svc(void)
                    "bx      lr                                 \n");
 }
 
+#ifdef CONFIG_TFM_SPM_TIMER
+__naked psa_status_t tfm_timer_set_svc(uint32_t timeout)
+{
+    __asm volatile("svc     "M2S(TFM_SVC_TIMER_SET)"           \n"
+                   "bx      lr                                 \n");
+}
+#endif
+
+__naked uint32_t tfm_timer_get_timestamp_svc(void)
+{
+    __asm volatile("svc     "M2S(TFM_SVC_TIMER_GET_TIMESTAMP)" \n"
+                   "bx      lr                                 \n");
+}
+
+#ifdef CONFIG_TFM_SPM_API_STATS
+__naked psa_status_t tfm_spm_api_stats_get_svc(
+                                            uint32_t index,
+                                            struct tfm_spm_api_stats_t *stats)
+{
+    __asm volatile("svc     "M2S(TFM_SVC_SPM_API_STATS_GET)"   \n"
+                   "bx      lr                                 \n");
+}
+
+__naked psa_status_t tfm_spm_idle_stats_get_svc(
+                                            uint32_t state,
+                                            struct tfm_spm_idle_stats_t *stats)
+{
+    __asm volatile("svc     "M2S(TFM_SVC_SPM_IDLE_STATS_GET)"  \n"
+                   "bx      lr                                 \n");
+}
+#endif
+
+#ifdef TFM_EXCEPTION_INFO_RECORD
+__naked psa_status_t tfm_exc_record_get_svc(struct tfm_exc_record_t *record)
+{
+    __asm volatile("svc     "M2S(TFM_SVC_EXC_RECORD_GET)"      \n"
+                   "bx      lr                                 \n");
+}
+#endif
+
 #endif /* CONFIG_TFM_PSA_API_SUPERVISOR_CALL */
@@ -14,6 +14,9 @@
 #include "psa/client.h"
 #include "psa/lifecycle.h"
 #include "psa/service.h"
+#include "tfm_exc_record_api.h"
+#include "tfm_spm_stats_api.h"
+#include "tfm_timer_api.h"
 
 #ifdef CONFIG_TFM_PSA_API_THREAD_CALL
 
@@ -346,6 +349,95 @@ uint32_t psa_rot_lifecycle_state_thread(void)
     );
 }
 
+#ifdef CONFIG_TFM_SPM_TIMER
+
+__naked
+__section(".psa_interface_thread_call")
+psa_status_t tfm_timer_set_thread(uint32_t timeout)
+{
+    __asm volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                    \n"
+#endif
+        "push   {r0-r4, lr}                                 \n"
+        "ldr    r0, =tfm_spm_partition_timer_set            \n"
+        "mov    r1, sp                                      \n"
+        "b      psa_interface_unified_abi                   \n"
+    );
+}
+
+#endif /* CONFIG_TFM_SPM_TIMER */
+
+__naked
+__section(".psa_interface_thread_call")
+uint32_t tfm_timer_get_timestamp_thread(void)
+{
+    __asm volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                    \n"
+#endif
+        "push   {r0-r4, lr}                                 \n"
+        "ldr    r0, =tfm_hal_get_timestamp                  \n"
+        "mov    r1, sp                                      \n"
+        "b      psa_interface_unified_abi                   \n"
+    );
+}
+
+#ifdef CONFIG_TFM_SPM_API_STATS
+
+__naked
+__section(".psa_interface_thread_call")
+psa_status_t tfm_spm_api_stats_get_thread(uint32_t index,
+                                          struct tfm_spm_api_stats_t *stats)
+{
+    __asm volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                    \n"
+#endif
+        "push   {r0-r4, lr}                                 \n"
+        "ldr    r0, =tfm_spm_api_stats_get_record           \n"
+        "mov    r1, sp                                      \n"
+        "b      psa_interface_unified_abi                   \n"
+    );
+}
+
+__naked
+__section(".psa_interface_thread_call")
+psa_status_t tfm_spm_idle_stats_get_thread(uint32_t state,
+                                           struct tfm_spm_idle_stats_t *stats)
+{
+    __asm volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                    \n"
+#endif
+        "push   {r0-r4, lr}                                 \n"
+        "ldr    r0, =tfm_spm_idle_stats_get_record          \n"
+        "mov    r1, sp                                      \n"
+        "b      psa_interface_unified_abi                   \n"
+    );
+}
+
+#endif /* CONFIG_TFM_SPM_API_STATS */
+
+#ifdef TFM_EXCEPTION_INFO_RECORD
+
+__naked
+__section(".psa_interface_thread_call")
+psa_status_t tfm_exc_record_get_thread(struct tfm_exc_record_t *record)
+{
+    __asm volatile(
+#if !defined(__ICCARM__)
+        ".syntax unified                                    \n"
+#endif
+        "push   {r0-r4, lr}                                 \n"
+        "ldr    r0, =exception_record_get                   \n"
+        "mov    r1, sp                                      \n"
+        "b      psa_interface_unified_abi                   \n"
+    );
+}
+
+#endif /* TFM_EXCEPTION_INFO_RECORD */
+
 #if PSA_FRAMEWORK_HAS_MM_IOVEC
 
 __naked
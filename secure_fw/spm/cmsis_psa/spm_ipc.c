@@ -10,6 +10,7 @@
 #include "bitops.h"
 #include "critical_section.h"
 #include "current.h"
+#include "exception_record.h"
 #include "fih.h"
 #include "psa/client.h"
 #include "psa/service.h"
@@ -33,6 +34,7 @@
 #include "region.h"
 #include "psa_manifest/pid.h"
 #include "ffm/backend.h"
+#include "ffm/spm_cpu_stats.h"
 #include "load/partition_defs.h"
 #include "load/service_defs.h"
 #include "load/asset_defs.h"
@@ -153,6 +155,11 @@ struct tfm_conn_handle_t *tfm_spm_create_conn_handle(struct service_t *service,
     /* Add handle node to list for next psa functions */
     BI_LIST_INSERT_BEFORE(&service->handle_list, &p_handle->list);
 
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    /* The owner is not unloaded while a connection to it is open */
+    service->partition->lazy_conns++;
+#endif
+
     return p_handle;
 }
 
@@ -188,6 +195,9 @@ int32_t tfm_spm_free_conn_handle(struct service_t *service,
     CRITICAL_SECTION_ENTER(cs_assert);
     /* Remove node from handle list */
     BI_LIST_REMOVE_NODE(&conn_handle->list);
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    service->partition->lazy_conns--;
+#endif
 
     /* Back handle buffer to pool */
     tfm_pool_free(conn_handle_pool, conn_handle);
@@ -624,6 +634,10 @@ uint32_t tfm_spm_init(void)
      tfm_nspm_ctx_init();
 #endif
 
+#ifdef TFM_EXCEPTION_INFO_RECORD
+    exception_record_init();
+#endif
+
     while (1) {
         partition = load_a_partition_assuredly(PARTITION_LIST_ADDR);
         if (partition == NO_MORE_PARTITION) {
@@ -632,6 +646,10 @@ uint32_t tfm_spm_init(void)
 
         p_pldi = partition->p_ldinf;
 
+#ifdef TFM_EXCEPTION_INFO_RECORD
+        partition->p_exc_counters = exception_record_attach(p_pldi->pid);
+#endif
+
         if (p_pldi->nservices) {
             service_setting = load_services_assuredly(
                                 partition,
@@ -711,7 +729,25 @@ uint64_t do_schedule(void)
                 tfm_core_panic();
             }
         }
+#if (CONFIG_TFM_SPE_FP >= 1)
+        /*
+         * A partition which does not use FP has no FP context to flush, and
+         * runs with the FP access disabled, so that an FP instruction is
+         * trapped rather than reading the registers of another partition.
+         */
+        if (PARTITION_USES_FP(p_part_curr)) {
+            ARCH_FLUSH_FP_CONTEXT();
+        }
+        if (PARTITION_USES_FP(p_part_curr) != PARTITION_USES_FP(p_part_next)) {
+            tfm_arch_set_fp_access(PARTITION_USES_FP(p_part_next));
+        }
+#else
         ARCH_FLUSH_FP_CONTEXT();
+#endif
+
+#ifdef CONFIG_TFM_SPM_CPU_STATS
+        spm_cpu_stats_switch(p_part_curr, p_part_next);
+#endif
 
         ret_ctx.ctx.next = (uint32_t)pth_next->p_context_ctrl;
         CURRENT_THREAD = pth_next;
@@ -800,6 +836,14 @@ void spm_handle_interrupt(void *p_pt, struct irq_load_info_t *p_ildi)
         tfm_core_panic();
     }
 
+#ifdef CONFIG_TFM_SPM_CPU_STATS
+    spm_cpu_stats_irq_enter();
+#endif
+
+#ifdef TFM_EXCEPTION_INFO_RECORD
+    EXC_RECORD_COUNT(p_part, irq);
+#endif
+
     if (p_ildi->flih_func == NULL) {
         /* SLIH Model Handling */
         tfm_hal_irq_disable(p_ildi->source);
@@ -820,6 +864,10 @@ void spm_handle_interrupt(void *p_pt, struct irq_load_info_t *p_ildi)
     if (flih_result == PSA_FLIH_SIGNAL) {
         spm_assert_signal(p_pt, p_ildi->signal);
     }
+
+#ifdef CONFIG_TFM_SPM_CPU_STATS
+    spm_cpu_stats_irq_exit();
+#endif
 }
 
 struct irq_load_info_t *get_irq_info_for_signal(
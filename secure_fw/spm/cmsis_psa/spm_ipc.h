@@ -8,6 +8,7 @@
 #ifndef __SPM_IPC_H__
 #define __SPM_IPC_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "config_impl.h"
 #include "tfm_arch.h"
@@ -65,6 +66,20 @@
 #define GET_THRD_OWNER(x)        TO_CONTAINER(x, struct partition_t, thrd)
 #define GET_CTX_OWNER(x)         TO_CONTAINER(x, struct partition_t, ctx_ctrl)
 
+#if (CONFIG_TFM_SPE_FP >= 1)
+#if defined(__ARM_FEATURE_MVE)
+/*
+ * SPM and the runtime library run MVE memory functions on the stack of every
+ * partition, so all the partitions use FP whatever their manifest declares.
+ */
+#define PARTITION_USES_FP(p_pt)  true
+#else
+/* Only the partitions which declare FP usage run with the FP access enabled */
+#define PARTITION_USES_FP(p_pt)  \
+                        (((p_pt)->p_ldinf->flags & PARTITION_FP_USED) != 0)
+#endif
+#endif
+
 /* Message struct to collect parameter from client */
 struct tfm_msg_body_t {
     int32_t magic;
@@ -90,6 +105,11 @@ struct tfm_msg_body_t {
 #endif
 #if PSA_FRAMEWORK_HAS_MM_IOVEC
     uint32_t iovec_status;             /* MM-IOVEC status                */
+#endif
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start;              /* Timestamp of the client request */
+    uint32_t stats_iovecs;             /* Number of vectors of the request */
+    size_t stats_bytes;                /* Size of the request vectors    */
 #endif
     struct bi_list_node_t msg_node;    /* For list operators             */
 };
@@ -113,6 +133,22 @@ struct partition_t {
     uint32_t                           signals_allowed;
     uint32_t                           signals_waiting;
     uint32_t                           signals_asserted;
+#ifdef CONFIG_TFM_SPM_TIMER
+    uint32_t                           timer_deadline;  /* In SPM time */
+    bool                               timer_armed;
+#endif
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    uintptr_t                          lazy_stack;      /* 0 if unloaded  */
+    uint32_t                           lazy_conns;      /* Open handles   */
+    uint32_t                           lazy_last_use;   /* Timestamp      */
+#endif
+#ifdef CONFIG_TFM_SPM_CPU_STATS
+    uint64_t                           cpu_cycles;      /* Cycles run     */
+    uint32_t                           cpu_activations; /* Switches in    */
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+    struct tfm_exc_record_counters_t   *p_exc_counters; /* Kept on reset  */
+#endif
     struct partition_t                 *next;
 };
 
@@ -445,6 +481,32 @@ void update_caller_outvec_len(struct tfm_msg_body_t *msg);
  */
 void spm_assert_signal(void *p_pt, psa_signal_t signal);
 
+#ifdef CONFIG_TFM_SPM_DEFERRED_INIT
+/*
+ * Start the next partition whose initialization is deferred after NS boot.
+ * Nothing happens if all of them have been started already.
+ */
+void spm_start_deferred_partition(void);
+#endif
+
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+/*
+ * Allocate the stack and start the thread of a partition which is loaded on
+ * first use, or again after it has been unloaded. Nothing happens if the
+ * partition is not lazily loaded or is loaded already.
+ * Returns PSA_ERROR_INSUFFICIENT_MEMORY if the lazy stack pool runs out.
+ */
+psa_status_t spm_load_lazy_partition(struct partition_t *p_pt);
+
+/*
+ * Unload the lazily loaded partitions which have been waiting for signals,
+ * with no connection open to their services, for longer than
+ * CONFIG_TFM_SPM_LAZY_UNLOAD_TIMEOUT, and return their stacks to the pool.
+ * Nothing happens if the timeout is 0.
+ */
+void spm_unload_idle_partitions(void);
+#endif
+
 /**
  * \brief Return the IRQ load info context pointer associated with a signal
  *
@@ -6,6 +6,8 @@
  */
 
 #include <string.h>
+#include "current.h"
+#include "exception_record.h"
 #include "region.h"
 #include "spm_ipc.h"
 #include "svc_num.h"
@@ -18,7 +20,10 @@
 #include "load/spm_load_api.h"
 #include "ffm/tfm_boot_data.h"
 #include "ffm/psa_api.h"
+#include "ffm/spm_api_stats.h"
+#include "ffm/spm_timer.h"
 #include "tfm_hal_isolation.h"
+#include "tfm_hal_platform.h"
 #include "tfm_hal_spm_logdev.h"
 #include "load/partition_defs.h"
 #include "psa/client.h"
@@ -31,79 +36,222 @@ extern int32_t platform_svc_handlers(uint8_t svc_num,
                                      uint32_t *ctx, uint32_t lr);
 #endif
 
+/*
+ * The handlers of the PSA API SVCs. They all take the stacked context of the
+ * caller, holding the arguments in ctx[0] to ctx[3].
+ */
+typedef int32_t (*tfm_svc_handler_t)(uint32_t *ctx);
+
+static int32_t svc_psa_framework_version(uint32_t *ctx)
+{
+    (void)ctx;
+
+    return tfm_spm_client_psa_framework_version();
+}
+
+static int32_t svc_psa_version(uint32_t *ctx)
+{
+    return tfm_spm_client_psa_version(ctx[0]);
+}
+
+static int32_t svc_psa_connect(uint32_t *ctx)
+{
+    return tfm_spm_client_psa_connect(ctx[0], ctx[1]);
+}
+
+static int32_t svc_psa_call(uint32_t *ctx)
+{
+    return tfm_spm_client_psa_call((psa_handle_t)ctx[0], ctx[1],
+                                   (const psa_invec *)ctx[2],
+                                   (psa_outvec *)ctx[3]);
+}
+
+static int32_t svc_psa_close(uint32_t *ctx)
+{
+    tfm_spm_client_psa_close((psa_handle_t)ctx[0]);
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_wait(uint32_t *ctx)
+{
+    return tfm_spm_partition_psa_wait((psa_signal_t)ctx[0], ctx[1]);
+}
+
+static int32_t svc_psa_get(uint32_t *ctx)
+{
+    return tfm_spm_partition_psa_get((psa_signal_t)ctx[0],
+                                     (psa_msg_t *)ctx[1]);
+}
+
+static int32_t svc_psa_set_rhandle(uint32_t *ctx)
+{
+    tfm_spm_partition_psa_set_rhandle((psa_handle_t)ctx[0], (void *)ctx[1]);
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_read(uint32_t *ctx)
+{
+    return tfm_spm_partition_psa_read((psa_handle_t)ctx[0], ctx[1],
+                                      (void *)ctx[2], (size_t)ctx[3]);
+}
+
+static int32_t svc_psa_skip(uint32_t *ctx)
+{
+    return tfm_spm_partition_psa_skip((psa_handle_t)ctx[0], ctx[1],
+                                      (size_t)ctx[2]);
+}
+
+static int32_t svc_psa_write(uint32_t *ctx)
+{
+    tfm_spm_partition_psa_write((psa_handle_t)ctx[0], ctx[1],
+                                (void *)ctx[2], (size_t)ctx[3]);
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_reply(uint32_t *ctx)
+{
+    tfm_spm_partition_psa_reply((psa_handle_t)ctx[0], (psa_status_t)ctx[1]);
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_notify(uint32_t *ctx)
+{
+    tfm_spm_partition_psa_notify((int32_t)ctx[0]);
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_clear(uint32_t *ctx)
+{
+    (void)ctx;
+
+    tfm_spm_partition_psa_clear();
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_eoi(uint32_t *ctx)
+{
+    tfm_spm_partition_psa_eoi((psa_signal_t)ctx[0]);
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_panic(uint32_t *ctx)
+{
+    (void)ctx;
+
+    tfm_spm_partition_psa_panic();
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_lifecycle(uint32_t *ctx)
+{
+    (void)ctx;
+
+    return tfm_spm_get_lifecycle_state();
+}
+
+static int32_t svc_psa_irq_enable(uint32_t *ctx)
+{
+    tfm_spm_partition_irq_enable((psa_signal_t)ctx[0]);
+
+    return PSA_SUCCESS;
+}
+
+static int32_t svc_psa_irq_disable(uint32_t *ctx)
+{
+    return tfm_spm_partition_irq_disable((psa_signal_t)ctx[0]);
+}
+
+static int32_t svc_psa_reset_signal(uint32_t *ctx)
+{
+    tfm_spm_partition_psa_reset_signal((psa_signal_t)ctx[0]);
+
+    return PSA_SUCCESS;
+}
+
+/* PSA API SVC handlers, indexed by SVC number */
+static const tfm_svc_handler_t svc_psa_handlers[TFM_SVC_PSA_NUMBER_END + 1] = {
+    [TFM_SVC_PSA_FRAMEWORK_VERSION] = svc_psa_framework_version,
+    [TFM_SVC_PSA_VERSION]           = svc_psa_version,
+    [TFM_SVC_PSA_CONNECT]           = svc_psa_connect,
+    [TFM_SVC_PSA_CALL]              = svc_psa_call,
+    [TFM_SVC_PSA_CLOSE]             = svc_psa_close,
+    [TFM_SVC_PSA_WAIT]              = svc_psa_wait,
+    [TFM_SVC_PSA_GET]               = svc_psa_get,
+    [TFM_SVC_PSA_SET_RHANDLE]       = svc_psa_set_rhandle,
+    [TFM_SVC_PSA_READ]              = svc_psa_read,
+    [TFM_SVC_PSA_SKIP]              = svc_psa_skip,
+    [TFM_SVC_PSA_WRITE]             = svc_psa_write,
+    [TFM_SVC_PSA_REPLY]             = svc_psa_reply,
+    [TFM_SVC_PSA_NOTIFY]            = svc_psa_notify,
+    [TFM_SVC_PSA_CLEAR]             = svc_psa_clear,
+    [TFM_SVC_PSA_EOI]               = svc_psa_eoi,
+    [TFM_SVC_PSA_PANIC]             = svc_psa_panic,
+    [TFM_SVC_PSA_LIFECYCLE]         = svc_psa_lifecycle,
+    [TFM_SVC_PSA_IRQ_ENABLE]        = svc_psa_irq_enable,
+    [TFM_SVC_PSA_IRQ_DISABLE]       = svc_psa_irq_disable,
+    [TFM_SVC_PSA_RESET_SIGNAL]      = svc_psa_reset_signal,
+};
+
 static int32_t SVC_Handler_IPC(uint8_t svc_num, uint32_t *ctx,
                                uint32_t lr)
 {
-    switch (svc_num) {
-    case TFM_SVC_PSA_FRAMEWORK_VERSION:
-        return tfm_spm_client_psa_framework_version();
-    case TFM_SVC_PSA_VERSION:
-        return tfm_spm_client_psa_version(ctx[0]);
-    case TFM_SVC_PSA_CONNECT:
-        return tfm_spm_client_psa_connect(ctx[0], ctx[1]);
-    case TFM_SVC_PSA_CALL:
-        return tfm_spm_client_psa_call((psa_handle_t)ctx[0], ctx[1],
-                                       (const psa_invec *)ctx[2],
-                                       (psa_outvec *)ctx[3]);
-    case TFM_SVC_PSA_CLOSE:
-        tfm_spm_client_psa_close((psa_handle_t)ctx[0]);
-        break;
-    case TFM_SVC_PSA_WAIT:
-        return tfm_spm_partition_psa_wait((psa_signal_t)ctx[0], ctx[1]);
-    case TFM_SVC_PSA_GET:
-        return tfm_spm_partition_psa_get((psa_signal_t)ctx[0],
-                                         (psa_msg_t *)ctx[1]);
-    case TFM_SVC_PSA_SET_RHANDLE:
-        tfm_spm_partition_psa_set_rhandle((psa_handle_t)ctx[0], (void *)ctx[1]);
-        break;
-    case TFM_SVC_PSA_READ:
-        return tfm_spm_partition_psa_read((psa_handle_t)ctx[0], ctx[1],
-                                          (void *)ctx[2], (size_t)ctx[3]);
-    case TFM_SVC_PSA_SKIP:
-        return tfm_spm_partition_psa_skip((psa_handle_t)ctx[0], ctx[1],
-                                          (size_t)ctx[2]);
-    case TFM_SVC_PSA_WRITE:
-        tfm_spm_partition_psa_write((psa_handle_t)ctx[0], ctx[1],
-                                    (void *)ctx[2], (size_t)ctx[3]);
-        break;
-    case TFM_SVC_PSA_REPLY:
-        tfm_spm_partition_psa_reply((psa_handle_t)ctx[0], (psa_status_t)ctx[1]);
-        break;
-    case TFM_SVC_PSA_NOTIFY:
-        tfm_spm_partition_psa_notify((int32_t)ctx[0]);
-        break;
-    case TFM_SVC_PSA_CLEAR:
-        tfm_spm_partition_psa_clear();
-        break;
-    case TFM_SVC_PSA_EOI:
-        tfm_spm_partition_psa_eoi((psa_signal_t)ctx[0]);
-        break;
-    case TFM_SVC_PSA_PANIC:
-        tfm_spm_partition_psa_panic();
-        break;
-    case TFM_SVC_PSA_LIFECYCLE:
-        return tfm_spm_get_lifecycle_state();
+    if ((svc_num <= TFM_SVC_PSA_NUMBER_END) &&
+        (svc_psa_handlers[svc_num] != NULL)) {
+        return svc_psa_handlers[svc_num](ctx);
+    }
+
+#ifdef CONFIG_TFM_SPM_TIMER
+    if (svc_num == TFM_SVC_TIMER_SET) {
+        return tfm_spm_partition_timer_set(ctx[0]);
+    }
+#endif
+
+    if (svc_num == TFM_SVC_TIMER_GET_TIMESTAMP) {
+        return (int32_t)tfm_hal_get_timestamp();
+    }
+
+#ifdef CONFIG_TFM_SPM_API_STATS
+    if (svc_num == TFM_SVC_SPM_API_STATS_GET) {
+        return tfm_spm_api_stats_get_record(
+                                        ctx[0],
+                                        (struct tfm_spm_api_stats_t *)ctx[1]);
+    }
+
+    if (svc_num == TFM_SVC_SPM_IDLE_STATS_GET) {
+        return tfm_spm_idle_stats_get_record(
+                                        ctx[0],
+                                        (struct tfm_spm_idle_stats_t *)ctx[1]);
+    }
+#endif
+
+#ifdef TFM_EXCEPTION_INFO_RECORD
+    if (svc_num == TFM_SVC_EXC_RECORD_GET) {
+        return exception_record_get((struct tfm_exc_record_t *)ctx[0]);
+    }
+#endif
+
 #if TFM_SP_LOG_RAW_ENABLED
-    case TFM_SVC_OUTPUT_UNPRIV_STRING:
+    if (svc_num == TFM_SVC_OUTPUT_UNPRIV_STRING) {
         return tfm_hal_output_spm_log((const char *)ctx[0], ctx[1]);
+    }
 #endif
-    case TFM_SVC_PSA_IRQ_ENABLE:
-        tfm_spm_partition_irq_enable((psa_signal_t)ctx[0]);
-        break;
-    case TFM_SVC_PSA_IRQ_DISABLE:
-        return tfm_spm_partition_irq_disable((psa_signal_t)ctx[0]);
-    case TFM_SVC_PSA_RESET_SIGNAL:
-        tfm_spm_partition_psa_reset_signal((psa_signal_t)ctx[0]);
-        break;
-    default:
+
 #ifdef PLATFORM_SVC_HANDLERS
-        return (platform_svc_handlers(svc_num, ctx, lr));
+    return (platform_svc_handlers(svc_num, ctx, lr));
 #else
-        SPMLOG_ERRMSG("Unknown SVC number requested!\r\n");
-        return PSA_ERROR_GENERIC_ERROR;
+    (void)lr;
+
+    SPMLOG_ERRMSG("Unknown SVC number requested!\r\n");
+    return PSA_ERROR_GENERIC_ERROR;
 #endif
-    }
-    return PSA_SUCCESS;
 }
 
 extern void tfm_flih_func_return(psa_flih_result_t result);
@@ -187,9 +335,18 @@ uint32_t tfm_flih_return_to_isr(psa_flih_result_t result, uint32_t *msp)
 uint32_t tfm_core_svc_handler(uint32_t *msp, uint32_t exc_return,
                               uint32_t *psp)
 {
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start = tfm_hal_get_timestamp();
+#endif
     uint8_t svc_number = TFM_SVC_PSA_FRAMEWORK_VERSION;
     uint32_t *svc_args = msp;
 
+#ifdef TFM_EXCEPTION_INFO_RECORD
+    if (CURRENT_THREAD) {
+        EXC_RECORD_COUNT(GET_CURRENT_COMPONENT(), svc);
+    }
+#endif
+
     if ((exc_return & EXC_RETURN_MODE) && (exc_return & EXC_RETURN_SPSEL)) {
         /* Use PSP when both EXC_RETURN.MODE and EXC_RETURN.SPSEL are set */
         svc_args = psp;
@@ -247,6 +404,9 @@ uint32_t tfm_core_svc_handler(uint32_t *msp, uint32_t exc_return,
             tfm_arch_trigger_pendsv();
         }
 
+#ifdef CONFIG_TFM_SPM_API_STATS
+        spm_api_stats_record_svc(svc_number, stats_start);
+#endif
         break;
     }
 
@@ -68,6 +68,18 @@ void thrd_start(struct thread_t *p_thrd,
                           (uintptr_t)fn&~1UL, sp_limit, sp);
 }
 
+void thrd_restart(struct thread_t *p_thrd,
+                  thrd_fn_t fn, void *param,
+                  uintptr_t sp_limit, uintptr_t sp)
+{
+    TFM_CORE_ASSERT(p_thrd != NULL);
+
+    thrd_set_state(p_thrd, THRD_STATE_RUNNABLE);
+
+    tfm_arch_init_context(p_thrd->p_context_ctrl, (uintptr_t)fn, param,
+                          (uintptr_t)fn&~1UL, sp_limit, sp);
+}
+
 void thrd_set_state(struct thread_t *p_thrd, uint32_t new_state)
 {
     TFM_CORE_ASSERT(p_thrd != NULL);
@@ -121,6 +121,22 @@ void thrd_start(struct thread_t *p_thrd,
                 thrd_fn_t fn, void *param,
                 uintptr_t sp_limit, uintptr_t sp);
 
+/*
+ * Prepare the context of a thread which is in the schedulable list already,
+ * with given info, and make it runnable. It restarts a thread from its entry
+ * function, on a stack which may differ from the previous one.
+ *
+ * Parameters :
+ *  p_thrd         -     Pointer of thread_t struct
+ *  fn             -     Thread entry function
+ *  param          -     The single parameter for thread entry function
+ *  sp_limit       -     Stack limit addr
+ *  sp             -     Current stack pointer
+ */
+void thrd_restart(struct thread_t *p_thrd,
+                  thrd_fn_t fn, void *param,
+                  uintptr_t sp_limit, uintptr_t sp);
+
 /*
  * Get the next thread to run in list.
  *
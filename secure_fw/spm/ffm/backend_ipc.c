@@ -5,6 +5,7 @@
  *
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "critical_section.h"
 #include "compiler_ext_defs.h"
@@ -15,9 +16,11 @@
 #include "ffm/backend.h"
 #include "utilities.h"
 #include "load/partition_defs.h"
+#include "tfm_timer_api.h"
 #include "load/service_defs.h"
 #include "load/spm_load_api.h"
 #include "psa/error.h"
+#include "tfm_hal_platform.h"
 
 /* Declare the global component list */
 struct partition_head_t partition_listhead;
@@ -40,6 +43,157 @@ struct context_ctrl_t *p_spm_thread_context;
 
 #endif
 
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+/*
+ * Stacks of the partitions which are loaded on first use. A stack is
+ * returned to the pool when its partition is unloaded, and the free ranges
+ * are found from the stacks of the loaded partitions.
+ */
+static uint8_t lazy_stack_pool[CONFIG_TFM_SPM_LAZY_STACK_POOL_SIZE]
+                                                                __aligned(8);
+
+#define LAZY_STACK_SIZE(p_pldi) (((p_pldi)->stack_size + 7) & ~(size_t)0x7)
+
+/* Returns true if [base, base + size) overlaps the stack of a partition */
+static bool lazy_stack_in_use(uintptr_t base, size_t size)
+{
+    struct partition_t *p_pt;
+
+    UNI_LIST_FOR_EACH(p_pt, PARTITION_LIST_ADDR) {
+        if (p_pt->lazy_stack &&
+            (base < p_pt->lazy_stack + LAZY_STACK_SIZE(p_pt->p_ldinf)) &&
+            (p_pt->lazy_stack < base + size)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * First fit: a free range starts at the beginning of the pool or right after
+ * a stack in use. Returns 0 if no free range is large enough.
+ */
+static uintptr_t lazy_stack_alloc(size_t size)
+{
+    uintptr_t pool_end = (uintptr_t)lazy_stack_pool + sizeof(lazy_stack_pool);
+    uintptr_t base = (uintptr_t)lazy_stack_pool;
+    struct partition_t *p_pt;
+
+    if ((size <= pool_end - base) && !lazy_stack_in_use(base, size)) {
+        return base;
+    }
+
+    /* Otherwise try right after each stack in use */
+    UNI_LIST_FOR_EACH(p_pt, PARTITION_LIST_ADDR) {
+        if (!p_pt->lazy_stack) {
+            continue;
+        }
+        base = p_pt->lazy_stack + LAZY_STACK_SIZE(p_pt->p_ldinf);
+        if ((size <= pool_end - base) && !lazy_stack_in_use(base, size)) {
+            return base;
+        }
+    }
+
+    return 0;
+}
+
+psa_status_t spm_load_lazy_partition(struct partition_t *p_pt)
+{
+    const struct partition_load_info_t *p_pldi = p_pt->p_ldinf;
+    size_t stack_size = LAZY_STACK_SIZE(p_pldi);
+    uintptr_t stack_base;
+    psa_status_t status = PSA_SUCCESS;
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
+    if (!(p_pldi->flags & PARTITION_LOAD_LAZY)) {
+        return PSA_SUCCESS;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+    p_pt->lazy_last_use = tfm_hal_get_timestamp();
+
+    if (!p_pt->lazy_stack) {
+        stack_base = lazy_stack_alloc(stack_size);
+        if (!stack_base) {
+            status = PSA_ERROR_INSUFFICIENT_MEMORY;
+        } else if (p_pt->thrd.state == THRD_STATE_CREATING) {
+            /* First load, the thread is not in the list yet */
+            p_pt->lazy_stack = stack_base;
+            thrd_start(&p_pt->thrd,
+                       POSITION_TO_ENTRY(p_pldi->entry, thrd_fn_t), NULL,
+                       stack_base, stack_base + stack_size);
+        } else {
+            /* Loaded again after an unload, the entry runs again */
+            p_pt->lazy_stack = stack_base;
+            thrd_restart(&p_pt->thrd,
+                         POSITION_TO_ENTRY(p_pldi->entry, thrd_fn_t), NULL,
+                         stack_base, stack_base + stack_size);
+        }
+    }
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    return status;
+}
+
+void spm_unload_idle_partitions(void)
+{
+#if CONFIG_TFM_SPM_LAZY_UNLOAD_TIMEOUT > 0
+    struct partition_t *p_pt;
+    uint32_t now;
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+    now = tfm_hal_get_timestamp();
+    UNI_LIST_FOR_EACH(p_pt, PARTITION_LIST_ADDR) {
+        /*
+         * Only a partition blocked in psa_wait() with nothing to handle can
+         * be unloaded: its stack holds no message or call in progress.
+         */
+        if (!p_pt->lazy_stack ||
+            (p_pt->thrd.state != THRD_STATE_BLOCK) ||
+            (p_pt->waitobj.owner != &p_pt->thrd) ||
+            p_pt->signals_asserted || p_pt->lazy_conns ||
+#ifdef CONFIG_TFM_SPM_TIMER
+            p_pt->timer_armed ||
+#endif
+            !BI_LIST_IS_EMPTY(&p_pt->msg_list) ||
+            (now - p_pt->lazy_last_use < CONFIG_TFM_SPM_LAZY_UNLOAD_TIMEOUT)) {
+            continue;
+        }
+
+        /* Keep the thread in the list, out of scheduling */
+        p_pt->waitobj.owner = NULL;
+        p_pt->signals_waiting = 0;
+        thrd_set_state(&p_pt->thrd, THRD_STATE_DETACH);
+        p_pt->lazy_stack = 0;
+    }
+    CRITICAL_SECTION_LEAVE(cs_assert);
+#endif
+}
+#endif
+
+#ifdef CONFIG_TFM_SPM_DEFERRED_INIT
+void spm_start_deferred_partition(void)
+{
+    struct partition_t *p_pt;
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+    UNI_LIST_FOR_EACH(p_pt, PARTITION_LIST_ADDR) {
+        /* Lazily loaded partitions are only started on first use */
+        if (((p_pt->p_ldinf->flags &
+              (PARTITION_INIT_DEFERRED | PARTITION_LOAD_LAZY)) ==
+             PARTITION_INIT_DEFERRED) &&
+            (p_pt->thrd.state == THRD_STATE_CREATING)) {
+            thrd_set_state(&p_pt->thrd, THRD_STATE_RUNNABLE);
+            break;
+        }
+    }
+    CRITICAL_SECTION_LEAVE(cs_assert);
+}
+#endif
+
 /*
  * Send message and wake up the SP who is waiting on message queue, block the
  * current thread and trigger scheduler.
@@ -59,6 +213,16 @@ static psa_status_t ipc_messaging(struct service_t *service,
     signal = service->p_ldinf->signal;
 
     CRITICAL_SECTION_ENTER(cs_assert);
+#ifdef CONFIG_TFM_SPM_DEFERRED_INIT
+    /*
+     * The owner has not been started yet. Start it now, the message is
+     * handled after its initialization completes and the caller is blocked
+     * until then.
+     */
+    if (p_owner->thrd.state == THRD_STATE_CREATING) {
+        thrd_set_state(&p_owner->thrd, THRD_STATE_RUNNABLE);
+    }
+#endif
     /* Add message to partition message list tail */
     BI_LIST_INSERT_BEFORE(&p_owner->msg_list, &msg->msg_node);
 
@@ -86,6 +250,13 @@ static psa_status_t ipc_messaging(struct service_t *service,
 
 static int32_t ipc_replying(struct tfm_msg_body_t *p_msg, int32_t status)
 {
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    /* The unload timeout counts from the end of the last request */
+    if (p_msg->service->partition->lazy_stack) {
+        p_msg->service->partition->lazy_last_use = tfm_hal_get_timestamp();
+    }
+#endif
+
     if (is_tfm_rpc_msg(p_msg)) {
         tfm_rpc_client_call_reply(p_msg, status);
     } else {
@@ -108,6 +279,9 @@ static void ipc_comp_init_assuredly(struct partition_t *p_pt,
     void *p_param = NULL;
 
     p_pt->signals_allowed |= PSA_DOORBELL | service_setting;
+#ifdef CONFIG_TFM_SPM_TIMER
+    p_pt->signals_allowed |= TFM_TIMER_SIGNAL;
+#endif
 
     THRD_SYNC_INIT(&p_pt->waitobj);
     BI_LIST_INIT_NODE(&p_pt->msg_list);
@@ -124,10 +298,28 @@ static void ipc_comp_init_assuredly(struct partition_t *p_pt,
 
     }
 
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    /* The stack is allocated and the thread started on first use */
+    if (p_pldi->flags & PARTITION_LOAD_LAZY) {
+        return;
+    }
+#endif
+
     thrd_start(&p_pt->thrd,
                POSITION_TO_ENTRY(p_pldi->entry, thrd_fn_t), p_param,
                LOAD_ALLOCED_STACK_ADDR(p_pldi),
                LOAD_ALLOCED_STACK_ADDR(p_pldi) + p_pldi->stack_size);
+
+#ifdef CONFIG_TFM_SPM_DEFERRED_INIT
+    /*
+     * Keep the partition out of scheduling, so NS is not held by its
+     * initialization. It gets started by the first message sent to it or
+     * when the secure side becomes idle.
+     */
+    if (p_pldi->flags & PARTITION_INIT_DEFERRED) {
+        thrd_set_state(&p_pt->thrd, THRD_STATE_CREATING);
+    }
+#endif
 }
 
 static uint32_t ipc_system_run(void)
@@ -145,6 +337,10 @@ static uint32_t ipc_system_run(void)
         tfm_core_panic();
     }
 
+#if (CONFIG_TFM_SPE_FP >= 1)
+    tfm_arch_set_fp_access(PARTITION_USES_FP(p_cur_pt));
+#endif
+
     return control;
 }
 
@@ -21,6 +21,7 @@
 #include "ffm/backend.h"
 #include "ffm/psa_api.h"
 #include "ffm/spm_error_base.h"
+#include "ffm/spm_api_stats.h"
 #include "tfm_rpc.h"
 #include "tfm_spm_hal.h"
 #include "tfm_hal_interrupt.h"
@@ -129,6 +130,9 @@ uint32_t tfm_spm_client_psa_version(uint32_t sid)
 
 psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
 {
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start = tfm_hal_get_timestamp();
+#endif
     struct service_t *service;
     struct tfm_msg_body_t *msg;
     struct tfm_conn_handle_t *connect_handle;
@@ -169,6 +173,13 @@ psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
 
     client_id = tfm_spm_get_client_id(ns_caller);
 
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    /* Load the RoT Service partition if this is its first use. */
+    if (spm_load_lazy_partition(service->partition) != PSA_SUCCESS) {
+        return PSA_ERROR_CONNECTION_BUSY;
+    }
+#endif
+
     /*
      * Create connection handle here since it is possible to return the error
      * code to client when creation fails.
@@ -191,6 +202,12 @@ psa_status_t tfm_spm_client_psa_connect(uint32_t sid, uint32_t version)
     tfm_spm_fill_msg(msg, service, handle, PSA_IPC_CONNECT,
                      client_id, NULL, 0, NULL, 0, NULL);
 
+#ifdef CONFIG_TFM_SPM_API_STATS
+    msg->stats_start = stats_start;
+    msg->stats_iovecs = 0;
+    msg->stats_bytes = 0;
+#endif
+
     return backend_instance.messaging(service, msg);
 }
 
@@ -199,6 +216,9 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
                                      const psa_invec *inptr,
                                      psa_outvec *outptr)
 {
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start = tfm_hal_get_timestamp();
+#endif
     psa_invec invecs[PSA_MAX_IOVEC];
     psa_outvec outvecs[PSA_MAX_IOVEC];
     struct tfm_conn_handle_t *conn_handle;
@@ -258,6 +278,13 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
             TFM_PROGRAMMER_ERROR(ns_caller, PSA_ERROR_PROGRAMMER_ERROR);
         }
 
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+        /* Load the RoT Service partition if this is its first use. */
+        if (spm_load_lazy_partition(service->partition) != PSA_SUCCESS) {
+            return PSA_ERROR_CONNECTION_BUSY;
+        }
+#endif
+
         CRITICAL_SECTION_ENTER(cs_assert);
         conn_handle = tfm_spm_create_conn_handle(service, client_id);
         CRITICAL_SECTION_LEAVE(cs_assert);
@@ -381,11 +408,26 @@ psa_status_t tfm_spm_client_psa_call(psa_handle_t handle,
     tfm_spm_fill_msg(msg, service, handle, type, client_id,
                      invecs, in_num, outvecs, out_num, outptr);
 
+#ifdef CONFIG_TFM_SPM_API_STATS
+    msg->stats_start = stats_start;
+    msg->stats_iovecs = in_num + out_num;
+    msg->stats_bytes = 0;
+    for (i = 0; i < in_num; i++) {
+        msg->stats_bytes += invecs[i].len;
+    }
+    for (i = 0; i < out_num; i++) {
+        msg->stats_bytes += outvecs[i].len;
+    }
+#endif
+
     return backend_instance.messaging(service, msg);
 }
 
 void tfm_spm_client_psa_close(psa_handle_t handle)
 {
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start = tfm_hal_get_timestamp();
+#endif
     struct service_t *service;
     struct tfm_msg_body_t *msg;
     struct tfm_conn_handle_t *conn_handle;
@@ -437,6 +479,12 @@ void tfm_spm_client_psa_close(psa_handle_t handle)
     tfm_spm_fill_msg(msg, service, handle, PSA_IPC_DISCONNECT, client_id,
                      NULL, 0, NULL, 0, NULL);
 
+#ifdef CONFIG_TFM_SPM_API_STATS
+    msg->stats_start = stats_start;
+    msg->stats_iovecs = 0;
+    msg->stats_bytes = 0;
+#endif
+
     (void)backend_instance.messaging(service, msg);
 }
 
@@ -466,6 +514,20 @@ psa_signal_t tfm_spm_partition_psa_wait(psa_signal_t signal_mask,
         tfm_core_panic();
     }
 
+#ifdef CONFIG_TFM_SPM_DEFERRED_INIT
+    /* The secure side is idle, use the time to start deferred partitions */
+    if (partition->p_ldinf->pid == TFM_SP_IDLE_ID) {
+        spm_start_deferred_partition();
+    }
+#endif
+
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    /* Give the stacks of the partitions not used for a while back */
+    if (partition->p_ldinf->pid == TFM_SP_IDLE_ID) {
+        spm_unload_idle_partitions();
+    }
+#endif
+
     /*
      * thrd_wait_on() blocks the caller thread if no signals are available.
      * In this case, the return value of this function is temporary set into
@@ -571,6 +633,9 @@ void tfm_spm_partition_psa_set_rhandle(psa_handle_t msg_handle, void *rhandle)
 size_t tfm_spm_partition_psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
                                   void *buffer, size_t num_bytes)
 {
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start = tfm_hal_get_timestamp();
+#endif
     size_t bytes;
     struct tfm_msg_body_t *msg = NULL;
     uint32_t privileged;
@@ -637,6 +702,10 @@ size_t tfm_spm_partition_psa_read(psa_handle_t msg_handle, uint32_t invec_idx,
     msg->invec[invec_idx].base = (char *)msg->invec[invec_idx].base + bytes;
     msg->msg.in_size[invec_idx] -= bytes;
 
+#ifdef CONFIG_TFM_SPM_API_STATS
+    spm_api_stats_record(TFM_SPM_API_STATS_READ, bytes, stats_start);
+#endif
+
     return bytes;
 }
 
@@ -703,6 +772,9 @@ size_t tfm_spm_partition_psa_skip(psa_handle_t msg_handle, uint32_t invec_idx,
 void tfm_spm_partition_psa_write(psa_handle_t msg_handle, uint32_t outvec_idx,
                                  const void *buffer, size_t num_bytes)
 {
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start = tfm_hal_get_timestamp();
+#endif
     struct tfm_msg_body_t *msg = NULL;
     uint32_t privileged;
     struct partition_t *partition = NULL;
@@ -768,11 +840,18 @@ void tfm_spm_partition_psa_write(psa_handle_t msg_handle, uint32_t outvec_idx,
 
     /* Update the write number */
     msg->outvec[outvec_idx].len += num_bytes;
+
+#ifdef CONFIG_TFM_SPM_API_STATS
+    spm_api_stats_record(TFM_SPM_API_STATS_WRITE, num_bytes, stats_start);
+#endif
 }
 
 int32_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
                                     psa_status_t status)
 {
+#ifdef CONFIG_TFM_SPM_API_STATS
+    uint32_t stats_start = tfm_hal_get_timestamp();
+#endif
     struct service_t *service = NULL;
     struct tfm_msg_body_t *msg = NULL;
     int32_t ret = PSA_SUCCESS;
@@ -795,6 +874,12 @@ int32_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
         tfm_core_panic();
     }
 
+#ifdef CONFIG_TFM_SPM_API_STATS
+    /* The message may be freed below, record the request it completes first */
+    spm_api_stats_record_request(msg->msg.type, msg->stats_iovecs,
+                                 msg->stats_bytes, msg->stats_start);
+#endif
+
     /*
      * Three type of message are passed in this function: CONNECTION, REQUEST,
      * DISCONNECTION. It needs to process differently for each type.
@@ -894,6 +979,10 @@ int32_t tfm_spm_partition_psa_reply(psa_handle_t msg_handle,
     ret = backend_instance.replying(msg, ret);
     CRITICAL_SECTION_LEAVE(cs_assert);
 
+#ifdef CONFIG_TFM_SPM_API_STATS
+    spm_api_stats_record(TFM_SPM_API_STATS_REPLY, 0, stats_start);
+#endif
+
     return ret;
 }
 
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "critical_section.h"
+#include "psa/service.h"
+#include "spm_ipc.h"
+#include "tfm_core_utils.h"
+#include "tfm_hal_platform.h"
+#include "utilities.h"
+#include "ffm/spm_api_stats.h"
+
+/* Statistics of one API, for one class of requests */
+struct spm_api_stats_entry_t {
+    uint32_t count;              /* Number of calls                     */
+    uint32_t min;                /* Shortest duration, in ticks         */
+    uint32_t max;                /* Longest duration, in ticks          */
+    uint64_t total;              /* Sum of the durations, in ticks      */
+};
+
+/*
+ * The requests of psa_call() are classified by number of vectors and payload
+ * size, the other APIs by payload size only.
+ */
+static struct spm_api_stats_entry_t
+    call_stats[PSA_MAX_IOVEC + 1][TFM_SPM_API_STATS_SIZE_CLASSES];
+static struct spm_api_stats_entry_t
+    api_stats[TFM_SPM_API_STATS_NUM_APIS][TFM_SPM_API_STATS_SIZE_CLASSES];
+static struct spm_api_stats_entry_t svc_stats[SPM_API_STATS_NUM_SVCS];
+static struct spm_api_stats_entry_t idle_stats[TFM_SPM_IDLE_STATS_STATES];
+
+static uint32_t size_class(size_t bytes)
+{
+    uint32_t bits = 0;
+
+    /* The class is half the number of significant bits of the size, rounded
+     * up.
+     */
+    while ((bytes != 0) &&
+           (bits < (TFM_SPM_API_STATS_SIZE_CLASSES - 1) * 2)) {
+        bytes >>= 1;
+        bits++;
+    }
+
+    return (bits + 1) / 2;
+}
+
+static void entry_update(struct spm_api_stats_entry_t *entry, uint32_t start)
+{
+    uint32_t ticks = tfm_hal_get_timestamp() - start;
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+    if ((entry->count == 0) || (ticks < entry->min)) {
+        entry->min = ticks;
+    }
+    if (ticks > entry->max) {
+        entry->max = ticks;
+    }
+    entry->total += ticks;
+    entry->count++;
+    CRITICAL_SECTION_LEAVE(cs_assert);
+}
+
+void spm_api_stats_record(uint32_t api, size_t bytes, uint32_t start)
+{
+    if (api >= TFM_SPM_API_STATS_NUM_APIS) {
+        return;
+    }
+
+    entry_update(&api_stats[api][size_class(bytes)], start);
+}
+
+void spm_api_stats_record_request(int32_t type, uint32_t iovecs, size_t bytes,
+                                  uint32_t start)
+{
+    if (type == PSA_IPC_CONNECT) {
+        entry_update(&api_stats[TFM_SPM_API_STATS_CONNECT][0], start);
+    } else if (type == PSA_IPC_DISCONNECT) {
+        entry_update(&api_stats[TFM_SPM_API_STATS_CLOSE][0], start);
+    } else if (iovecs <= PSA_MAX_IOVEC) {
+        entry_update(&call_stats[iovecs][size_class(bytes)], start);
+    }
+}
+
+void spm_api_stats_record_svc(uint8_t svc_number, uint32_t start)
+{
+    if (svc_number < SPM_API_STATS_NUM_SVCS) {
+        entry_update(&svc_stats[svc_number], start);
+    }
+}
+
+void spm_api_stats_record_idle(uint32_t state, uint32_t start)
+{
+    if (state < TFM_SPM_IDLE_STATS_STATES) {
+        entry_update(&idle_stats[state], start);
+    }
+}
+
+/*
+ * Fills a record from an entry, and returns true if the entry was recorded.
+ * To be called within a critical section.
+ */
+static bool entry_read(const struct spm_api_stats_entry_t *entry,
+                       uint32_t api, uint32_t svc_number, uint32_t iovecs,
+                       uint32_t class, struct tfm_spm_api_stats_t *stats)
+{
+    if (entry->count == 0) {
+        return false;
+    }
+
+    stats->api = (uint8_t)api;
+    stats->svc_number = (uint8_t)svc_number;
+    stats->iovecs = (uint8_t)iovecs;
+    stats->size_class = (uint8_t)class;
+    stats->count = entry->count;
+    stats->min = entry->min;
+    stats->max = entry->max;
+    stats->total = entry->total;
+
+    return true;
+}
+
+/*
+ * Finds the recorded entry of the given index, in the order of the APIs, then
+ * of the vectors and size classes, then of the SVCs. To be called within a
+ * critical section.
+ */
+static bool stats_read(uint32_t index, struct tfm_spm_api_stats_t *stats)
+{
+    const struct spm_api_stats_entry_t *entry;
+    uint32_t api, iovecs, class, svc;
+
+    for (api = 0; api < TFM_SPM_API_STATS_NUM_APIS; api++) {
+        for (iovecs = 0; iovecs <= PSA_MAX_IOVEC; iovecs++) {
+            /* Only psa_call() is classified by number of vectors */
+            if ((api != TFM_SPM_API_STATS_CALL) && (iovecs != 0)) {
+                break;
+            }
+
+            for (class = 0; class < TFM_SPM_API_STATS_SIZE_CLASSES; class++) {
+                entry = (api == TFM_SPM_API_STATS_CALL) ?
+                        &call_stats[iovecs][class] : &api_stats[api][class];
+                if (entry_read(entry, api, 0, iovecs, class, stats) &&
+                    (index-- == 0)) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    for (svc = 0; svc < SPM_API_STATS_NUM_SVCS; svc++) {
+        if (entry_read(&svc_stats[svc], TFM_SPM_API_STATS_SVC, svc, 0, 0,
+                       stats) && (index-- == 0)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* It is a fatal error if a record cannot be written by the running partition */
+static void check_caller_buffer(void *buf, size_t size)
+{
+    struct partition_t *partition = tfm_spm_get_running_partition();
+    uint32_t privileged;
+
+    if (!partition) {
+        tfm_core_panic();
+    }
+
+    privileged = tfm_spm_partition_get_privileged_mode(
+        partition->p_ldinf->flags);
+
+    if (tfm_memory_check(buf, size, false, TFM_MEMORY_ACCESS_RW,
+                         privileged) != SPM_SUCCESS) {
+        tfm_core_panic();
+    }
+}
+
+psa_status_t tfm_spm_api_stats_get_record(uint32_t index,
+                                          struct tfm_spm_api_stats_t *stats)
+{
+    struct tfm_spm_api_stats_t record;
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    bool found;
+
+    check_caller_buffer(stats, sizeof(*stats));
+
+    /* The entries are read as a whole, while no API is being recorded */
+    CRITICAL_SECTION_ENTER(cs_assert);
+    found = stats_read(index, &record);
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    if (!found) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    spm_memcpy(stats, &record, sizeof(record));
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t tfm_spm_idle_stats_get_record(uint32_t state,
+                                           struct tfm_spm_idle_stats_t *stats)
+{
+    struct tfm_spm_idle_stats_t record;
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
+    check_caller_buffer(stats, sizeof(*stats));
+
+    if (state >= TFM_SPM_IDLE_STATS_STATES) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+    record.count = idle_stats[state].count;
+    record.min = idle_stats[state].min;
+    record.max = idle_stats[state].max;
+    record.total = idle_stats[state].total;
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    spm_memcpy(stats, &record, sizeof(record));
+
+    return PSA_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include "critical_section.h"
+#include "current.h"
+#include "spm_ipc.h"
+#include "tfm_hal_platform.h"
+#include "ffm/backend.h"
+#include "ffm/spm_cpu_stats.h"
+
+/*
+ * Timestamp the running partition is accounted from. It is moved forward by
+ * the duration of each secure interrupt handling, which is accounted apart.
+ */
+static uint32_t switch_time;
+
+/* Secure interrupt handling, nested interrupts are accounted once */
+static uint32_t irq_depth;
+static uint32_t irq_start;
+static struct spm_cpu_stats_t irq_stats;
+
+void spm_cpu_stats_switch(struct partition_t *p_curr,
+                          struct partition_t *p_next)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t now;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+    now = tfm_hal_get_timestamp();
+    p_curr->cpu_cycles += now - switch_time;
+    p_next->cpu_activations++;
+    switch_time = now;
+
+    CRITICAL_SECTION_LEAVE(cs_assert);
+}
+
+void spm_cpu_stats_irq_enter(void)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+    if (irq_depth++ == 0) {
+        irq_start = tfm_hal_get_timestamp();
+    }
+    irq_stats.activations++;
+
+    CRITICAL_SECTION_LEAVE(cs_assert);
+}
+
+void spm_cpu_stats_irq_exit(void)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    uint32_t duration;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+    if (--irq_depth == 0) {
+        duration = tfm_hal_get_timestamp() - irq_start;
+        irq_stats.cycles += duration;
+        switch_time += duration;
+    }
+
+    CRITICAL_SECTION_LEAVE(cs_assert);
+}
+
+psa_status_t spm_cpu_stats_get_partition(int32_t partition_id,
+                                         struct spm_cpu_stats_t *stats)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    struct partition_t *p_pt;
+
+    UNI_LIST_FOR_EACH(p_pt, PARTITION_LIST_ADDR) {
+        if (p_pt->p_ldinf->pid == partition_id) {
+            break;
+        }
+    }
+
+    if (!p_pt) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+    stats->cycles = p_pt->cpu_cycles;
+    stats->activations = p_pt->cpu_activations;
+
+    /* The running partition is accounted up to now */
+    if (p_pt == GET_CURRENT_COMPONENT()) {
+        stats->cycles += tfm_hal_get_timestamp() - switch_time;
+    }
+
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    return PSA_SUCCESS;
+}
+
+void spm_cpu_stats_get_irq(struct spm_cpu_stats_t *stats)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+    *stats = irq_stats;
+    CRITICAL_SECTION_LEAVE(cs_assert);
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "critical_section.h"
+#include "spm_ipc.h"
+#include "tfm_arch.h"
+#include "tfm_hal_timer.h"
+#include "tfm_timer_api.h"
+#include "utilities.h"
+#include "ffm/backend.h"
+#include "ffm/spm_timer.h"
+
+/*
+ * The secure timer is tickless: it is only programmed for the nearest
+ * deadline, and stopped while no partition has a deadline. The SPM time is
+ * advanced from the timer each time it is read, and the deadlines are kept
+ * in SPM time.
+ */
+static uint32_t timer_base;     /* SPM time when the timer was last started */
+static uint32_t timer_ticks;    /* Ticks the timer was started for, or 0    */
+
+/* Returns true if the deadline is reached at the given time */
+#define DEADLINE_REACHED(deadline, now) ((int32_t)((deadline) - (now)) <= 0)
+
+/* To be called within a critical section */
+static uint32_t timer_now(void)
+{
+    uint32_t elapsed;
+
+    if (timer_ticks == 0) {
+        return timer_base;
+    }
+
+    elapsed = tfm_hal_timer_elapsed();
+    if (elapsed > timer_ticks) {
+        elapsed = timer_ticks;
+    }
+
+    return timer_base + elapsed;
+}
+
+/*
+ * Programs the timer for the nearest deadline, or stops it. To be called
+ * within a critical section.
+ */
+static enum tfm_hal_status_t timer_program(uint32_t now)
+{
+    struct partition_t *p_pt;
+    uint32_t nearest = SPM_TIMER_MAX_TIMEOUT;
+    bool armed = false;
+    enum tfm_hal_status_t status;
+
+    UNI_LIST_FOR_EACH(p_pt, PARTITION_LIST_ADDR) {
+        if (!p_pt->timer_armed) {
+            continue;
+        }
+
+        armed = true;
+        if (DEADLINE_REACHED(p_pt->timer_deadline, now)) {
+            nearest = 1;
+        } else if (p_pt->timer_deadline - now < nearest) {
+            nearest = p_pt->timer_deadline - now;
+        }
+    }
+
+    timer_base = now;
+
+    if (!armed) {
+        timer_ticks = 0;
+        tfm_hal_timer_stop();
+        return TFM_HAL_SUCCESS;
+    }
+
+    status = tfm_hal_timer_start(nearest);
+    timer_ticks = (status == TFM_HAL_SUCCESS) ? nearest : 0;
+
+    return status;
+}
+
+psa_status_t tfm_spm_partition_timer_set(uint32_t timeout)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    struct partition_t *partition = NULL;
+    enum tfm_hal_status_t status;
+    uint32_t now, prev_deadline;
+    bool prev_armed;
+
+    partition = tfm_spm_get_running_partition();
+    if (!partition) {
+        tfm_core_panic();
+    }
+
+    if (timeout > SPM_TIMER_MAX_TIMEOUT) {
+        return PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+    now = timer_now();
+    prev_armed = partition->timer_armed;
+    prev_deadline = partition->timer_deadline;
+
+    partition->signals_asserted &= ~TFM_TIMER_SIGNAL;
+    partition->timer_armed = (timeout != 0);
+    partition->timer_deadline = now + timeout;
+
+    status = timer_program(now);
+    if (status != TFM_HAL_SUCCESS) {
+        /*
+         * The timer of the caller is left as it was, and the timer is
+         * programmed again for the deadlines it was already running for, so
+         * that the other partitions keep theirs.
+         */
+        partition->timer_armed = prev_armed;
+        partition->timer_deadline = prev_deadline;
+        (void)timer_program(now);
+    }
+
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    switch (status) {
+    case TFM_HAL_SUCCESS:
+        return PSA_SUCCESS;
+    case TFM_HAL_ERROR_NOT_SUPPORTED:
+        return PSA_ERROR_NOT_SUPPORTED;
+    case TFM_HAL_ERROR_INVALID_INPUT:
+        return PSA_ERROR_INVALID_ARGUMENT;
+    default:
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+}
+
+void spm_timer_expired(void)
+{
+    struct critical_section_t cs_assert = CRITICAL_SECTION_STATIC_INIT;
+    struct partition_t *p_pt;
+    uint32_t now;
+
+    CRITICAL_SECTION_ENTER(cs_assert);
+
+    now = timer_now();
+    UNI_LIST_FOR_EACH(p_pt, PARTITION_LIST_ADDR) {
+        if (p_pt->timer_armed &&
+            DEADLINE_REACHED(p_pt->timer_deadline, now)) {
+            p_pt->timer_armed = false;
+            spm_assert_signal(p_pt, TFM_TIMER_SIGNAL);
+        }
+    }
+
+    (void)timer_program(now);
+
+    CRITICAL_SECTION_LEAVE(cs_assert);
+
+    if (THRD_EXPECTING_SCHEDULE()) {
+        tfm_arch_trigger_pendsv();
+    }
+}
@@ -1,13 +1,48 @@
 /*
- * Copyright (c) 2019-2020, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2021, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  *
  */
 
 #include <stdint.h>
+#include "mve_defs.h"
 #include "utilities.h"
 
+#if defined(__ARM_FEATURE_MVE)
+void *spm_memcpy(void *dest, const void *src, size_t n)
+{
+    uint8_t *p_dest = (uint8_t *)dest;
+    const uint8_t *p_src = (const uint8_t *)src;
+    mve_pred16_t pred;
+
+    while (n > 0) {
+        pred = vctp8q(n);
+        vstrbq_p_u8(p_dest, vldrbq_z_u8(p_src, pred), pred);
+        p_dest += MVE_VECTOR_BYTES;
+        p_src += MVE_VECTOR_BYTES;
+        n = MVE_BYTES_LEFT(n);
+    }
+
+    return dest;
+}
+
+void *spm_memset(void *s, int c, size_t n)
+{
+    uint8_t *p_mem = (uint8_t *)s;
+    uint8x16_t pattern = vdupq_n_u8((uint8_t)c);
+
+    while (n > 0) {
+        vstrbq_p_u8(p_mem, pattern, vctp8q(n));
+        p_mem += MVE_VECTOR_BYTES;
+        n = MVE_BYTES_LEFT(n);
+    }
+
+    return s;
+}
+
+#else /* __ARM_FEATURE_MVE */
+
 #define GET_MEM_ADDR_BIT0(x)        ((x) & 0x1)
 #define GET_MEM_ADDR_BIT1(x)        ((x) & 0x2)
 
@@ -81,3 +116,5 @@ void *spm_memset(void *s, int c, size_t n)
 
     return s;
 }
+
+#endif /* __ARM_FEATURE_MVE */
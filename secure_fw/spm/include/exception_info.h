@@ -30,12 +30,13 @@
  */
 #define _STRINGIFY(exception_info) #exception_info
 
-/* Store context for an exception, and print an error message with the context.
+/* Store context for an exception, and print an error message with the context,
+ * and/or add it to the exception record.
  *
  * @param[in]  exception_type  One of the EXCEPTION_TYPE_* values defined above. Any
  *                             other value will result in printing "Unknown".
  */
-#ifdef TFM_EXCEPTION_INFO_DUMP
+#if defined(TFM_EXCEPTION_INFO_DUMP) || defined(TFM_EXCEPTION_INFO_RECORD)
 #define EXCEPTION_INFO(exception_type)                  \
     __ASM volatile(                                     \
         "MOV     r0, lr\n"                              \
@@ -45,7 +46,7 @@
         "BL      store_and_dump_context\n"              \
     )
 
-/* Store context for an exception, then print the info.
+/* Store context for an exception, then print and/or record the info.
  * Call EXCEPTION_INFO() instead of calling this directly.
  */
 void store_and_dump_context(uint32_t LR_in, uint32_t MSP_in, uint32_t PSP_in,
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __EXCEPTION_RECORD_H__
+#define __EXCEPTION_RECORD_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "psa/error.h"
+#include "tfm_exc_record_api.h"
+
+/* Marks the records as valid across a warm reset */
+#define EXC_RECORD_MAGIC            0x45584352
+
+/* Counts an event of a partition, if the partition has counters */
+#define EXC_RECORD_COUNT(p_pt, event)                               \
+    do {                                                            \
+        if ((p_pt) && (p_pt)->p_exc_counters) {                     \
+            (p_pt)->p_exc_counters->event++;                        \
+        }                                                           \
+    } while (0)
+
+/**
+ * \brief Keeps the record of the previous boots if it is valid, or clears it.
+ *        Called once at SPM initialization.
+ */
+void exception_record_init(void);
+
+/**
+ * \brief Gets the counters of a partition, kept across warm reset as long as
+ *        the partitions are loaded in the same order.
+ *
+ * \param[in] partition_id      ID of the partition
+ *
+ * \return The counters of the partition, or NULL if there are no free slots.
+ */
+struct tfm_exc_record_counters_t *exception_record_attach(int32_t partition_id);
+
+/**
+ * \brief Records a fatal exception. Called by the fault handlers.
+ *
+ * \param[in] entry             The record, the timestamp and the partition ID
+ *                              are filled in.
+ */
+void exception_record_fault(struct tfm_exc_record_entry_t *entry);
+
+/**
+ * \brief Counts a PendSV of the running partition. Called on each entry of
+ *        PendSV_Handler(), including those which do not run the scheduler.
+ */
+void exception_record_pendsv(void);
+
+/**
+ * \brief Copies the exception record to a privileged partition. Serves
+ *        \ref tfm_exc_record_get.
+ *
+ * \param[out] record           The copy of the record, which must be writable
+ *                              by the caller.
+ *
+ * \retval PSA_SUCCESS                  \p record is filled.
+ * \retval PSA_ERROR_NOT_PERMITTED      The caller is not privileged.
+ */
+psa_status_t exception_record_get(struct tfm_exc_record_t *record);
+
+#endif /* __EXCEPTION_RECORD_H__ */
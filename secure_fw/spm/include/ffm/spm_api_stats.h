@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_API_STATS_H__
+#define __SPM_API_STATS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "svc_num.h"
+#include "tfm_spm_stats_api.h"
+
+/* Number of SVCs recorded, the PSA API SVCs */
+#define SPM_API_STATS_NUM_SVCS      (TFM_SVC_PSA_NUMBER_END + 1)
+
+/**
+ * \brief Records the duration of a PSA API handled within the SPM.
+ *
+ * \param[in] api     Index of the API, TFM_SPM_API_STATS_READ,
+ *                    TFM_SPM_API_STATS_WRITE or TFM_SPM_API_STATS_REPLY
+ * \param[in] bytes   Number of bytes copied by the API
+ * \param[in] start   Timestamp taken when the SPM was entered
+ */
+void spm_api_stats_record(uint32_t api, size_t bytes, uint32_t start);
+
+/**
+ * \brief Records the duration of a client request, from the time the SPM was
+ *        entered by the client to the time the RoT Service replied to it.
+ *
+ * \param[in] type    Type of the message of the request
+ * \param[in] iovecs  Number of input and output vectors of the request
+ * \param[in] bytes   Total size of the input and output vectors, in bytes
+ * \param[in] start   Timestamp taken when the SPM was entered by the client
+ */
+void spm_api_stats_record_request(int32_t type, uint32_t iovecs, size_t bytes,
+                                  uint32_t start);
+
+/**
+ * \brief Records the time spent in the SPM SVC handler for a PSA API SVC.
+ *
+ * \param[in] svc_number  Number of the SVC, other SVCs are not recorded
+ * \param[in] start       Timestamp taken when the SVC handler was entered
+ */
+void spm_api_stats_record_svc(uint8_t svc_number, uint32_t start);
+
+/**
+ * \brief Records a stay of the idle partition in a sleep state.
+ *
+ * \param[in] state       Index of the sleep state, the states from
+ *                        \ref TFM_SPM_IDLE_STATS_STATES are not recorded
+ * \param[in] start       Timestamp taken when the state was entered
+ */
+void spm_api_stats_record_idle(uint32_t state, uint32_t start);
+
+/**
+ * \brief Reads a record of the statistics into a buffer of the running
+ *        partition. Serves \ref tfm_spm_api_stats_get.
+ *
+ * \param[in]  index    Index of the record, counting the recorded classes
+ *                      of requests only
+ * \param[out] stats    The record, which must be writable by the running
+ *                      partition, or SPM panics
+ *
+ * \retval PSA_SUCCESS                  \p stats is filled.
+ * \retval PSA_ERROR_DOES_NOT_EXIST     \p index is past the last record.
+ */
+psa_status_t tfm_spm_api_stats_get_record(uint32_t index,
+                                          struct tfm_spm_api_stats_t *stats);
+
+/**
+ * \brief Reads the residency of a sleep state into a buffer of the running
+ *        partition. Serves \ref tfm_spm_idle_stats_get.
+ *
+ * \param[in]  state    Index of the sleep state
+ * \param[out] stats    The residency, which must be writable by the running
+ *                      partition, or SPM panics
+ *
+ * \retval PSA_SUCCESS                  \p stats is filled.
+ * \retval PSA_ERROR_DOES_NOT_EXIST     \p state is not recorded.
+ */
+psa_status_t tfm_spm_idle_stats_get_record(uint32_t state,
+                                           struct tfm_spm_idle_stats_t *stats);
+
+#endif /* __SPM_API_STATS_H__ */
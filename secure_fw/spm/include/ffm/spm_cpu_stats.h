@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_CPU_STATS_H__
+#define __SPM_CPU_STATS_H__
+
+#include <stdint.h>
+#include "psa/error.h"
+
+struct partition_t;
+
+/*
+ * CPU time consumed by a partition or by the secure interrupt handling.
+ *
+ * The time between two accounting points is measured modulo 2^32
+ * tfm_hal_get_timestamp() ticks. A partition which runs longer than that
+ * without a switch, such as the non-secure side when it makes no secure
+ * call, is accounted too little.
+ */
+struct spm_cpu_stats_t {
+    uint64_t cycles;            /* tfm_hal_get_timestamp() ticks consumed   */
+    uint32_t activations;       /* Switches in, or interrupts handled       */
+};
+
+/**
+ * \brief Accounts the time the current partition ran for, and the activation
+ *        of the next one. Called by the scheduler on a partition switch.
+ *
+ * \param[in] p_curr      The partition switched out
+ * \param[in] p_next      The partition switched in
+ */
+void spm_cpu_stats_switch(struct partition_t *p_curr,
+                          struct partition_t *p_next);
+
+/**
+ * \brief Marks the start of the handling of a secure interrupt. The time
+ *        until \ref spm_cpu_stats_irq_exit is not accounted to the
+ *        interrupted partition.
+ */
+void spm_cpu_stats_irq_enter(void);
+
+/**
+ * \brief Marks the end of the handling of a secure interrupt.
+ */
+void spm_cpu_stats_irq_exit(void);
+
+/**
+ * \brief Gets the CPU time consumed by a partition since boot. To be called
+ *        from privileged code.
+ *
+ * \param[in]  partition_id     ID of the partition
+ * \param[out] stats            The cycles and activations of the partition
+ *
+ * \retval PSA_SUCCESS                  \p stats is filled.
+ * \retval PSA_ERROR_DOES_NOT_EXIST     No partition has that ID.
+ */
+psa_status_t spm_cpu_stats_get_partition(int32_t partition_id,
+                                         struct spm_cpu_stats_t *stats);
+
+/**
+ * \brief Gets the CPU time consumed by the secure interrupt handling since
+ *        boot. To be called from privileged code.
+ *
+ * \param[out] stats            The cycles and number of interrupts handled
+ */
+void spm_cpu_stats_get_irq(struct spm_cpu_stats_t *stats);
+
+#endif /* __SPM_CPU_STATS_H__ */
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_TIMER_H__
+#define __SPM_TIMER_H__
+
+#include <stdint.h>
+#include "psa/error.h"
+
+/* The longest timeout, so that deadlines compare with wrapping arithmetic */
+#define SPM_TIMER_MAX_TIMEOUT       (0x7FFFFFFFu)
+
+/**
+ * \brief Set the timer of the calling partition, the SPM side of
+ *        tfm_timer_set().
+ *
+ * \param[in] timeout           Ticks until TFM_TIMER_SIGNAL is asserted on
+ *                              the caller, 0 to cancel the timer.
+ *
+ * \retval PSA_SUCCESS                  The timer is set or cancelled.
+ * \retval PSA_ERROR_INVALID_ARGUMENT   The timeout is larger than
+ *                                      \ref SPM_TIMER_MAX_TIMEOUT.
+ * \retval PSA_ERROR_NOT_SUPPORTED      The platform has no secure timer.
+ * \retval PSA_ERROR_GENERIC_ERROR      The secure timer failed to start. The
+ *                                      timer of the caller is unchanged.
+ */
+psa_status_t tfm_spm_partition_timer_set(uint32_t timeout);
+
+/**
+ * \brief Assert TFM_TIMER_SIGNAL on the partitions whose deadline is reached,
+ *        and program the secure timer for the next deadline. Called by the
+ *        interrupt handler of the secure timer.
+ */
+void spm_timer_expired(void);
+
+#endif /* __SPM_TIMER_H__ */
@@ -36,10 +36,17 @@
 #define TFM_SVC_PSA_IRQ_ENABLE          (0x11)
 #define TFM_SVC_PSA_IRQ_DISABLE         (0x12)
 #define TFM_SVC_PSA_RESET_SIGNAL        (0x13)
+/* The last PSA API SVC number, the PSA API SVCs are dispatched with a table */
+#define TFM_SVC_PSA_NUMBER_END          TFM_SVC_PSA_RESET_SIGNAL
 /* TF-M specific, starts from 0x40 */
 #define TFM_SVC_GET_BOOT_DATA           (0x40)
 #define TFM_SVC_SPM_INIT                (0x41)
 #define TFM_SVC_FLIH_FUNC_RETURN        (0x42)
+#define TFM_SVC_TIMER_SET               (0x43)
+#define TFM_SVC_TIMER_GET_TIMESTAMP     (0x44)
+#define TFM_SVC_SPM_API_STATS_GET       (0x45)
+#define TFM_SVC_SPM_IDLE_STATS_GET      (0x46)
+#define TFM_SVC_EXC_RECORD_GET          (0x47)
 #define TFM_SVC_THREAD_NUMBER_END       (0x7F)
 #if TFM_SP_LOG_RAW_ENABLED
 #define TFM_SVC_OUTPUT_UNPRIV_STRING    (TFM_SVC_THREAD_NUMBER_END)
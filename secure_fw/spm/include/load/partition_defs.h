@@ -26,6 +26,9 @@
  * bit 7-0: priority
  * bit 8: 1 - PSA_ROT, 0 - APP_ROT
  * bit 9: 1 - IPC model, 0 - SFN model
+ * bit 10: 1 - Initialization may complete after NS boot
+ * bit 11: 1 - Stack allocated and thread started on first use
+ * bit 12: 1 - Uses the floating-point extension
  */
 #define PARTITION_PRI_HIGHEST                   (0x0)
 #define PARTITION_PRI_HIGH                      (0xF)
@@ -36,6 +39,9 @@
 
 #define PARTITION_MODEL_PSA_ROT                 (1U << 8)
 #define PARTITION_MODEL_IPC                     (1U << 9)
+#define PARTITION_INIT_DEFERRED                 (1U << 10)
+#define PARTITION_LOAD_LAZY                     (1U << 11)
+#define PARTITION_FP_USED                       (1U << 12)
 
 #define PARTITION_PRIORITY(flag)                ((flag) & PARTITION_PRI_MASK)
 #define TO_THREAD_PRIORITY(x)                   (x)
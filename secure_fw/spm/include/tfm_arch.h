@@ -9,6 +9,7 @@
 
 /* This header file collects the architecture related operations. */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <inttypes.h>
 #include "tfm_hal_device_header.h"
@@ -141,6 +142,12 @@ void tfm_arch_clear_fp_status(void);
  * Clear float point data.
  */
 void tfm_arch_clear_fp_data(void);
+
+/*
+ * Enable or disable the secure access to the FP Extension. While it is
+ * disabled, an FP instruction raises a UsageFault.
+ */
+void tfm_arch_set_fp_access(bool enable);
 #endif
 
 /*
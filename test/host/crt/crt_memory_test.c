@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tests of the scalar memory functions of the secure partition runtime library
+ * and of SPM, against known answers and against the C library, for all the
+ * alignments of the buffers and for the lengths around the word size. The
+ * bytes around the destination are checked to be left untouched.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "tfm_core_utils.h"
+
+/* The runtime library functions, renamed for the host build */
+void *crt_memcpy(void *dest, const void *src, size_t n);
+void *crt_memset(void *s, int c, size_t n);
+int crt_memcmp(const void *s1, const void *s2, size_t n);
+
+/* Largest offset of a buffer from a word boundary */
+#define MAX_OFFSET          3
+
+/* Longest length tested, several words past the unaligned head */
+#define MAX_LEN             40
+
+/* Bytes checked on each side of the destination */
+#define GUARD_LEN           8
+
+#define BUF_LEN             (GUARD_LEN + MAX_OFFSET + MAX_LEN + GUARD_LEN)
+
+/* Value of the bytes which the functions must not write */
+#define GUARD_BYTE          0xA5
+
+typedef void *(*copy_func_t)(void *dest, const void *src, size_t n);
+typedef void *(*set_func_t)(void *s, int c, size_t n);
+
+/* Word aligned buffers, so that the offsets give each alignment */
+static union {
+    uint32_t align;
+    uint8_t bytes[BUF_LEN];
+} src_buf, dst_buf, ref_buf;
+
+static void fill_pattern(uint8_t *buf, size_t len, uint8_t seed)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+/*
+ * Copies each length from each source offset to each destination offset, and
+ * checks the result against the C library on the whole buffer.
+ */
+static int check_copy(copy_func_t copy)
+{
+    uint8_t *dest;
+    size_t src_off;
+    size_t dst_off;
+    size_t len;
+
+    fill_pattern(src_buf.bytes, BUF_LEN, 0x11);
+
+    for (src_off = 0; src_off <= MAX_OFFSET; src_off++) {
+        for (dst_off = 0; dst_off <= MAX_OFFSET; dst_off++) {
+            for (len = 0; len <= MAX_LEN; len++) {
+                memset(dst_buf.bytes, GUARD_BYTE, BUF_LEN);
+                memset(ref_buf.bytes, GUARD_BYTE, BUF_LEN);
+                dest = &dst_buf.bytes[GUARD_LEN + dst_off];
+
+                HOST_TEST_ASSERT(copy(dest,
+                                      &src_buf.bytes[GUARD_LEN + src_off],
+                                      len) == dest);
+                memcpy(&ref_buf.bytes[GUARD_LEN + dst_off],
+                       &src_buf.bytes[GUARD_LEN + src_off], len);
+
+                HOST_TEST_ASSERT(memcmp(dst_buf.bytes, ref_buf.bytes,
+                                        BUF_LEN) == 0);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Sets each length at each offset, with values whose upper bits are ignored */
+static int check_set(set_func_t set)
+{
+    static const int values[] = {0x00, 0x5C, 0xFF, 0x1C3, -1};
+    uint8_t *dest;
+    size_t off;
+    size_t len;
+    size_t v;
+
+    for (v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+        for (off = 0; off <= MAX_OFFSET; off++) {
+            for (len = 0; len <= MAX_LEN; len++) {
+                memset(dst_buf.bytes, GUARD_BYTE, BUF_LEN);
+                memset(ref_buf.bytes, GUARD_BYTE, BUF_LEN);
+                dest = &dst_buf.bytes[GUARD_LEN + off];
+
+                HOST_TEST_ASSERT(set(dest, values[v], len) == dest);
+                memset(&ref_buf.bytes[GUARD_LEN + off], values[v], len);
+
+                HOST_TEST_ASSERT(memcmp(dst_buf.bytes, ref_buf.bytes,
+                                        BUF_LEN) == 0);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int sign(int value)
+{
+    return (value > 0) - (value < 0);
+}
+
+static int test_memcmp_known_answers(void)
+{
+    static const uint8_t low[] = {0x01, 0x7F, 0x00};
+    static const uint8_t high[] = {0x01, 0x80, 0x00};
+
+    HOST_TEST_ASSERT(crt_memcmp("abc", "abc", 3) == 0);
+    HOST_TEST_ASSERT(crt_memcmp("abc", "abd", 3) < 0);
+    HOST_TEST_ASSERT(crt_memcmp("abd", "abc", 3) > 0);
+    HOST_TEST_ASSERT(crt_memcmp("abc", "abd", 2) == 0);
+    HOST_TEST_ASSERT(crt_memcmp("abc", "xyz", 0) == 0);
+
+    /* The first difference decides, whatever the later bytes */
+    HOST_TEST_ASSERT(crt_memcmp("azc", "bac", 3) < 0);
+
+    /* The bytes are compared as unsigned values */
+    HOST_TEST_ASSERT(crt_memcmp(low, high, sizeof(low)) < 0);
+    HOST_TEST_ASSERT(crt_memcmp(high, low, sizeof(low)) > 0);
+
+    return 0;
+}
+
+/*
+ * Compares equal buffers at each pair of offsets, then changes each byte in
+ * both directions and checks the sign of the result.
+ */
+static int test_memcmp_alignments(void)
+{
+    uint8_t *p1;
+    uint8_t *p2;
+    size_t off1;
+    size_t off2;
+    size_t len;
+    size_t i;
+
+    for (off1 = 0; off1 <= MAX_OFFSET; off1++) {
+        for (off2 = 0; off2 <= MAX_OFFSET; off2++) {
+            for (len = 0; len <= MAX_LEN; len++) {
+                p1 = &src_buf.bytes[off1];
+                p2 = &dst_buf.bytes[off2];
+                fill_pattern(p1, len, 0x40);
+                fill_pattern(p2, len, 0x40);
+
+                HOST_TEST_ASSERT(crt_memcmp(p1, p2, len) == 0);
+
+                for (i = 0; i < len; i++) {
+                    p2[i]++;
+                    HOST_TEST_ASSERT(sign(crt_memcmp(p1, p2, len)) ==
+                                     sign(memcmp(p1, p2, len)));
+                    /* Out of the compared length, the change is ignored */
+                    HOST_TEST_ASSERT(crt_memcmp(p1, p2, i) == 0);
+                    p2[i] -= 2;
+                    HOST_TEST_ASSERT(sign(crt_memcmp(p1, p2, len)) ==
+                                     sign(memcmp(p1, p2, len)));
+                    p2[i]++;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int test_memcpy_known_answer(void)
+{
+    static const uint8_t expected[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x42};
+    uint8_t out[sizeof(expected) + 1];
+
+    memset(out, GUARD_BYTE, sizeof(out));
+    crt_memcpy(out, expected, sizeof(expected));
+
+    HOST_TEST_ASSERT(memcmp(out, expected, sizeof(expected)) == 0);
+    HOST_TEST_ASSERT(out[sizeof(expected)] == GUARD_BYTE);
+
+    return 0;
+}
+
+static int test_memset_known_answer(void)
+{
+    static const uint8_t expected[] = {0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C};
+    uint8_t out[sizeof(expected) + 1];
+
+    memset(out, GUARD_BYTE, sizeof(out));
+    crt_memset(out, 0x13C, sizeof(expected));
+
+    HOST_TEST_ASSERT(memcmp(out, expected, sizeof(expected)) == 0);
+    HOST_TEST_ASSERT(out[sizeof(expected)] == GUARD_BYTE);
+
+    return 0;
+}
+
+static int test_crt_memcpy_alignments(void)
+{
+    return check_copy(crt_memcpy);
+}
+
+static int test_crt_memset_alignments(void)
+{
+    return check_set(crt_memset);
+}
+
+static int test_spm_memcpy_alignments(void)
+{
+    return check_copy(spm_memcpy);
+}
+
+static int test_spm_memset_alignments(void)
+{
+    return check_set(spm_memset);
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_memcmp_known_answers, failures);
+    HOST_TEST_RUN(test_memcmp_alignments, failures);
+    HOST_TEST_RUN(test_memcpy_known_answer, failures);
+    HOST_TEST_RUN(test_memset_known_answer, failures);
+    HOST_TEST_RUN(test_crt_memcpy_alignments, failures);
+    HOST_TEST_RUN(test_crt_memset_alignments, failures);
+    HOST_TEST_RUN(test_spm_memcpy_alignments, failures);
+    HOST_TEST_RUN(test_spm_memset_alignments, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
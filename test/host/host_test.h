@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Fails the calling test function, which returns an int, if the
+ *        condition is false.
+ */
+#define HOST_TEST_ASSERT(cond)                                              \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1;                                                       \
+        }                                                                   \
+    } while (0)
+
+/**
+ * \brief Runs a test function and counts its failure.
+ */
+#define HOST_TEST_RUN(test, failures)                                       \
+    do {                                                                    \
+        if ((test)() != 0) {                                                \
+            printf("FAIL: %s\n", #test);                                    \
+            (failures)++;                                                   \
+        } else {                                                            \
+            printf("PASS: %s\n", #test);                                    \
+        }                                                                   \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_TEST_H__ */
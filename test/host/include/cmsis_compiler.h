@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Host replacement of the CMSIS compiler header, with the definitions used by
+ * the sources built in the host tests.
+ */
+
+#ifndef __CMSIS_COMPILER_H__
+#define __CMSIS_COMPILER_H__
+
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE         static inline
+#endif
+
+#ifndef __STATIC_FORCEINLINE
+#define __STATIC_FORCEINLINE    __attribute__((always_inline)) static inline
+#endif
+
+#ifndef __WEAK
+#define __WEAK                  __attribute__((weak))
+#endif
+
+#ifndef __ASM
+#define __ASM                   __asm
+#endif
+
+#ifndef __PACKED
+#define __PACKED                __attribute__((packed))
+#endif
+
+/* The event instructions call hooks which the tests using them provide */
+void host_wfe(void);
+void host_sev(void);
+
+#ifndef __WFE
+#define __WFE()                 host_wfe()
+#endif
+
+#ifndef __SEV
+#define __SEV()                 host_sev()
+#endif
+
+#ifndef __DSB
+#define __DSB()                 __asm volatile("" ::: "memory")
+#endif
+
+#endif /* __CMSIS_COMPILER_H__ */
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Host flash layout, with the definitions required by the storage HAL
+ * headers. The filesystem tests provide their own flash device and geometry.
+ */
+
+#ifndef __FLASH_LAYOUT_H__
+#define __FLASH_LAYOUT_H__
+
+#define TFM_HAL_ITS_FLASH_DRIVER    Driver_FLASH0
+#define TFM_HAL_PS_FLASH_DRIVER     Driver_FLASH0
+
+#ifndef TFM_HAL_ITS_PROGRAM_UNIT
+#define TFM_HAL_ITS_PROGRAM_UNIT    (4)
+#endif
+#ifndef TFM_HAL_PS_PROGRAM_UNIT
+#define TFM_HAL_PS_PROGRAM_UNIT     (4)
+#endif
+
+#endif /* __FLASH_LAYOUT_H__ */
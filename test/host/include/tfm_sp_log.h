@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Partition log macros of the host tests, which discard the messages */
+
+#ifndef __TFM_SP_LOG_H__
+#define __TFM_SP_LOG_H__
+
+#define LOG_INFFMT(...)
+#define LOG_ERRFMT(...)
+#define LOG_DBGFMT(...)
+
+#endif /* __TFM_SP_LOG_H__ */
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tests of the ITS appends done in place with ITS_APPEND_IN_PLACE. The data is
+ * appended as the ITS partition does, in place from the end of the file, or
+ * from the last program unit boundary if that is not possible. It checks that
+ * the appends in place neither erase nor swap the metadata blocks, that no
+ * program unit is programmed twice, and that after a power cut during any
+ * append the file holds its content before or after that append.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "flash_fs/its_flash_fs.h"
+#include "host_test.h"
+#include "its_flash_sim.h"
+
+/* The filler file takes the space of logical data block 0, so that the log
+ * file is in a dedicated data block.
+ */
+#define MAX_FILE_SIZE       2048
+#define FILLER_SIZE         2048
+#define LOG_SIZE            2048
+
+/* Appends which are not a multiple of the program unit */
+#define APPEND_SIZE         5
+#define LARGE_APPEND_SIZE   23
+
+/* Number of appends in the sequence interrupted by the power cuts */
+#define NUM_STEPS           4
+
+static struct its_flash_fs_config_t fs_cfg;
+static its_flash_fs_ctx_t fs_ctx;
+static struct its_flash_sim_t snapshot;
+
+static const uint8_t fid_filler[ITS_FILE_ID_SIZE] = { 'F' };
+static const uint8_t fid_log[ITS_FILE_ID_SIZE] = { 'L' };
+
+/* Content of the log file at a given position */
+static uint8_t pattern(size_t pos)
+{
+    return (uint8_t)(pos * 7 + 3);
+}
+
+static psa_status_t create(const uint8_t *fid, size_t size_max)
+{
+    struct its_flash_fs_file_info_t info = {0};
+
+    info.size_max = size_max;
+    info.flags = ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE;
+
+    return its_flash_fs_file_write(&fs_ctx, fid, &info, 0, 0, NULL);
+}
+
+static size_t log_size(void)
+{
+    struct its_flash_fs_file_info_t info;
+
+    if (its_flash_fs_file_get_info(&fs_ctx, fid_log, &info) != PSA_SUCCESS) {
+        return SIZE_MAX;
+    }
+
+    return info.size_current;
+}
+
+static void drain_erase(void)
+{
+#ifdef ITS_BACKGROUND_ERASE
+    /* Erase the scratch blocks between the requests, as the partition does */
+    while (its_flash_fs_erase_pending(&fs_ctx)) {
+        if (its_flash_fs_erase_step(&fs_ctx) != PSA_SUCCESS) {
+            break;
+        }
+    }
+#endif
+}
+
+/* Appends the pattern to the log file, as tfm_its_append() does */
+static psa_status_t append(size_t size)
+{
+    struct its_flash_fs_file_info_t info = {0};
+    uint8_t buf[ITS_FLASH_SIM_PROGRAM_UNIT + LARGE_APPEND_SIZE];
+    size_t offset = log_size();
+    size_t head_size;
+    size_t i;
+    psa_status_t status;
+
+    for (i = 0; i < size; i++) {
+        buf[ITS_FLASH_SIM_PROGRAM_UNIT + i] = pattern(offset + i);
+    }
+
+    info.flags = ITS_FLASH_FS_FLAG_APPEND;
+    status = its_flash_fs_file_write(&fs_ctx, fid_log, &info, size, offset,
+                                     &buf[ITS_FLASH_SIM_PROGRAM_UNIT]);
+    if (status == PSA_ERROR_NOT_SUPPORTED) {
+        head_size = offset % ITS_FLASH_SIM_PROGRAM_UNIT;
+        status = its_flash_fs_file_read(&fs_ctx, fid_log, head_size,
+                                        offset - head_size,
+                                        &buf[ITS_FLASH_SIM_PROGRAM_UNIT
+                                             - head_size]);
+        if (status == PSA_SUCCESS) {
+            status = its_flash_fs_file_write(&fs_ctx, fid_log, &info,
+                                             head_size + size,
+                                             offset - head_size,
+                                             &buf[ITS_FLASH_SIM_PROGRAM_UNIT
+                                                  - head_size]);
+        }
+    }
+
+    if (status == PSA_SUCCESS) {
+        drain_erase();
+    }
+
+    return status;
+}
+
+/* Returns true if the log file holds the pattern up to the given size */
+static bool log_is(size_t size)
+{
+    uint8_t buf[LOG_SIZE];
+    size_t i;
+
+    if ((log_size() != size) ||
+        (its_flash_fs_file_read(&fs_ctx, fid_log, size, 0, buf)
+         != PSA_SUCCESS)) {
+        return false;
+    }
+
+    for (i = 0; i < size; i++) {
+        if (buf[i] != pattern(i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static psa_status_t mount(void)
+{
+    its_flash_sim_power_on(ITS_FLASH_SIM_NO_CUT);
+
+    if (its_flash_fs_init_ctx(&fs_ctx, &fs_cfg, &its_flash_fs_ops_sim)
+        != PSA_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return its_flash_fs_prepare(&fs_ctx);
+}
+
+static int setup(void)
+{
+    its_flash_sim_reset();
+    its_flash_sim_get_config(&fs_cfg);
+    fs_cfg.max_file_size = MAX_FILE_SIZE;
+
+    HOST_TEST_ASSERT(its_flash_fs_init_ctx(&fs_ctx, &fs_cfg,
+                                           &its_flash_fs_ops_sim)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_flash_fs_wipe_all(&fs_ctx) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(mount() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(create(fid_filler, FILLER_SIZE) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(create(fid_log, LOG_SIZE) == PSA_SUCCESS);
+    drain_erase();
+    HOST_TEST_ASSERT(log_is(0));
+
+    return 0;
+}
+
+static int test_appends_in_place(void)
+{
+    uint32_t active_metablock;
+    uint32_t erases;
+    size_t size = 0;
+    uint32_t i;
+
+    HOST_TEST_ASSERT(setup() == 0);
+
+    /* Each append only programs a journal record and the full program units */
+    for (i = 0; i < ITS_APPEND_JOURNAL_RECORDS; i++) {
+        active_metablock = fs_ctx.active_metablock;
+        erases = its_flash_sim.erases;
+
+        HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+        size += APPEND_SIZE;
+
+        HOST_TEST_ASSERT(fs_ctx.active_metablock == active_metablock);
+        HOST_TEST_ASSERT(its_flash_sim.erases == erases);
+        HOST_TEST_ASSERT(log_is(size));
+    }
+
+    /* With the journal full, the data block is copied once, and the appends
+     * are done in place again in the new journal.
+     */
+    active_metablock = fs_ctx.active_metablock;
+    HOST_TEST_ASSERT(append(LARGE_APPEND_SIZE) == PSA_SUCCESS);
+    size += LARGE_APPEND_SIZE;
+    HOST_TEST_ASSERT(fs_ctx.active_metablock != active_metablock);
+    HOST_TEST_ASSERT(log_is(size));
+
+    active_metablock = fs_ctx.active_metablock;
+    erases = its_flash_sim.erases;
+    HOST_TEST_ASSERT(append(LARGE_APPEND_SIZE) == PSA_SUCCESS);
+    size += LARGE_APPEND_SIZE;
+    HOST_TEST_ASSERT(fs_ctx.active_metablock == active_metablock);
+    HOST_TEST_ASSERT(its_flash_sim.erases == erases);
+    HOST_TEST_ASSERT(log_is(size));
+
+    /* The size and the bytes held in the journal are replayed at mount */
+    HOST_TEST_ASSERT(mount() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(log_is(size));
+    HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+    size += APPEND_SIZE;
+    HOST_TEST_ASSERT(fs_ctx.active_metablock == active_metablock);
+    HOST_TEST_ASSERT(log_is(size));
+
+    HOST_TEST_ASSERT(its_flash_sim.reprograms == 0);
+
+    return 0;
+}
+
+static int test_rewrite_after_appends(void)
+{
+    struct its_flash_fs_file_info_t info = {0};
+    uint8_t buf[APPEND_SIZE];
+    size_t i;
+
+    HOST_TEST_ASSERT(setup() == 0);
+    HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+
+    /* Appends to another file copy the log file data block */
+    HOST_TEST_ASSERT(create(fid_filler, FILLER_SIZE) == PSA_SUCCESS);
+    drain_erase();
+    HOST_TEST_ASSERT(log_is(2 * APPEND_SIZE));
+    HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(log_is(3 * APPEND_SIZE));
+
+    /* A set truncates the file and drops its journal state */
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = pattern(i);
+    }
+    info.size_max = LOG_SIZE;
+    info.flags = ITS_FLASH_FS_FLAG_TRUNCATE;
+    HOST_TEST_ASSERT(its_flash_fs_file_write(&fs_ctx, fid_log, &info,
+                                             sizeof(buf), 0, buf)
+                     == PSA_SUCCESS);
+    drain_erase();
+    HOST_TEST_ASSERT(log_is(APPEND_SIZE));
+    HOST_TEST_ASSERT(mount() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(log_is(APPEND_SIZE));
+
+    /* The partial program unit written by the set is copied once, then the
+     * appends are done in place again.
+     */
+    HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(log_is(3 * APPEND_SIZE));
+
+    HOST_TEST_ASSERT(its_flash_fs_file_delete(&fs_ctx, fid_log)
+                     == PSA_SUCCESS);
+    drain_erase();
+    HOST_TEST_ASSERT(create(fid_log, LOG_SIZE) == PSA_SUCCESS);
+    drain_erase();
+    HOST_TEST_ASSERT(log_is(0));
+    HOST_TEST_ASSERT(mount() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(log_is(0));
+
+    HOST_TEST_ASSERT(its_flash_sim.reprograms == 0);
+
+    return 0;
+}
+
+/* Size of the log file after the given number of appends of the sequence */
+static size_t step_size(size_t base, uint32_t steps)
+{
+    static const size_t sizes[NUM_STEPS] = {
+        APPEND_SIZE, LARGE_APPEND_SIZE, APPEND_SIZE, LARGE_APPEND_SIZE
+    };
+    uint32_t i;
+
+    for (i = 0; i < steps; i++) {
+        base += sizes[i];
+    }
+
+    return base;
+}
+
+static int power_cut_at_each_operation(bool cut_before)
+{
+    size_t base = 0;
+    size_t size;
+    uint32_t cut;
+    uint32_t steps;
+    uint32_t i;
+
+    HOST_TEST_ASSERT(setup() == 0);
+
+    /* Leave two free records in the journal, so that the sequence also
+     * copies the data block when the journal is full.
+     */
+    for (i = 0; i < ITS_APPEND_JOURNAL_RECORDS - 2; i++) {
+        HOST_TEST_ASSERT(append(APPEND_SIZE) == PSA_SUCCESS);
+        base += APPEND_SIZE;
+    }
+    snapshot = its_flash_sim;
+
+    for (cut = 0; ; cut++) {
+        its_flash_sim = snapshot;
+        HOST_TEST_ASSERT(mount() == PSA_SUCCESS);
+
+        if (cut_before) {
+            its_flash_sim_power_on_cut_before(cut);
+        } else {
+            its_flash_sim_power_on(cut);
+        }
+        for (steps = 0; steps < NUM_STEPS; steps++) {
+            if (append(step_size(0, steps + 1) - step_size(0, steps))
+                != PSA_SUCCESS) {
+                break;
+            }
+        }
+
+        if (its_flash_sim.powered) {
+            /* The whole sequence ran before the power cut */
+            HOST_TEST_ASSERT(steps == NUM_STEPS);
+            HOST_TEST_ASSERT(log_is(step_size(base, NUM_STEPS)));
+            break;
+        }
+
+        HOST_TEST_ASSERT(mount() == PSA_SUCCESS);
+
+        /* The interrupted append is either fully done or not at all */
+        size = log_size();
+        HOST_TEST_ASSERT((size == step_size(base, steps)) ||
+                         ((steps < NUM_STEPS) &&
+                          (size == step_size(base, steps + 1))));
+        HOST_TEST_ASSERT(log_is(size));
+
+        /* The file can still be appended to, and mounted again */
+        for (i = 0; i < 3; i++) {
+            HOST_TEST_ASSERT(append(LARGE_APPEND_SIZE) == PSA_SUCCESS);
+            size += LARGE_APPEND_SIZE;
+        }
+        HOST_TEST_ASSERT(mount() == PSA_SUCCESS);
+        HOST_TEST_ASSERT(log_is(size));
+
+        /* The interrupted program units are never programmed again */
+        HOST_TEST_ASSERT(its_flash_sim.reprograms == 0);
+    }
+
+    HOST_TEST_ASSERT(cut > NUM_STEPS);
+
+    printf("%u power cuts\n", (unsigned)cut);
+
+    return 0;
+}
+
+static int test_power_cut_during_each_operation(void)
+{
+    return power_cut_at_each_operation(false);
+}
+
+static int test_power_cut_before_each_operation(void)
+{
+    return power_cut_at_each_operation(true);
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_appends_in_place, failures);
+    HOST_TEST_RUN(test_rewrite_after_appends, failures);
+    HOST_TEST_RUN(test_power_cut_during_each_operation, failures);
+    HOST_TEST_RUN(test_power_cut_before_each_operation, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
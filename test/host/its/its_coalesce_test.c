@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tests of the ITS set coalescing, on a mock of the ITS file writes and of
+ * the partition timer. The tests check which sets are written to the files,
+ * that the data held in RAM is returned until it is written, and that the
+ * timer is set to close the oldest window when it is due.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "its_coalesce.h"
+#include "tfm_internal_trusted_storage.h"
+#include "tfm_its_req_mngr.h"
+#include "tfm_timer_api.h"
+
+#define CLIENT_ID   (-1)
+#define NUM_UIDS    4
+#define DATA_SIZE   16
+
+struct file_t {
+    bool valid;
+    psa_storage_create_flags_t flags;
+    size_t size;
+    uint8_t data[ITS_MAX_ASSET_SIZE];
+};
+
+/* Files of the mock, by UID, which start at 1 */
+static struct file_t stored[NUM_UIDS + 1];
+static uint32_t write_count;
+static bool fail_writes;
+
+/* Data of the request being handled */
+static uint8_t request_data[ITS_MAX_ASSET_SIZE];
+static uint8_t reply_data[ITS_MAX_ASSET_SIZE];
+
+/* Mock of the partition timer */
+static uint32_t now;
+static uint32_t timer_timeout;
+static uint32_t timer_deadline;
+static uint32_t timer_set_calls;
+static psa_status_t timer_status;
+
+static void make_data(uint8_t *data, size_t size, uint8_t seed)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        data[i] = (uint8_t)(seed + i);
+    }
+}
+
+static bool stored_is(psa_storage_uid_t uid, size_t size, uint8_t seed)
+{
+    uint8_t expected[ITS_MAX_ASSET_SIZE];
+
+    make_data(expected, size, seed);
+
+    return stored[uid].valid && (stored[uid].size == size) &&
+           (memcmp(stored[uid].data, expected, size) == 0);
+}
+
+/* Mocks of ITS */
+
+psa_status_t tfm_its_set_file(int32_t client_id,
+                              psa_storage_uid_t uid,
+                              size_t data_length,
+                              psa_storage_create_flags_t create_flags,
+                              const uint8_t *data)
+{
+    (void)client_id;
+
+    if (fail_writes) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    if (data == NULL) {
+        (void)its_req_mngr_read(stored[uid].data, data_length);
+    } else {
+        memcpy(stored[uid].data, data, data_length);
+    }
+    stored[uid].valid = true;
+    stored[uid].flags = create_flags;
+    stored[uid].size = data_length;
+    write_count++;
+
+    return PSA_SUCCESS;
+}
+
+size_t its_req_mngr_read(uint8_t *buf, size_t num_bytes)
+{
+    memcpy(buf, request_data, num_bytes);
+    return num_bytes;
+}
+
+void its_req_mngr_write(const uint8_t *buf, size_t num_bytes)
+{
+    memcpy(reply_data, buf, num_bytes);
+}
+
+psa_status_t tfm_timer_set(uint32_t timeout)
+{
+    timer_set_calls++;
+    if (timer_status == PSA_SUCCESS) {
+        timer_timeout = timeout;
+        timer_deadline = now + timeout;
+    }
+    return timer_status;
+}
+
+uint32_t tfm_timer_get_timestamp(void)
+{
+    return now;
+}
+
+/* Test helpers */
+
+static void reset(psa_status_t timer)
+{
+    fail_writes = false;
+    (void)its_coalesce_flush();
+
+    memset(stored, 0, sizeof(stored));
+    write_count = 0;
+    now = 1000;
+    timer_timeout = 0;
+    timer_set_calls = 0;
+    timer_status = timer;
+    (void)its_coalesce_init();
+}
+
+static psa_status_t set(psa_storage_uid_t uid, size_t size, uint8_t seed,
+                        psa_storage_create_flags_t flags)
+{
+    psa_status_t status;
+
+    make_data(request_data, size, seed);
+    status = its_coalesce_set(CLIENT_ID, uid, size, flags);
+
+    /* As after each request handled by the partition */
+    its_coalesce_set_timer();
+
+    return status;
+}
+
+/* Advances the time, and expires the windows if the timer fires */
+static void advance(uint32_t ticks)
+{
+    now += ticks;
+    if ((timer_timeout != 0) && ((int32_t)(now - timer_deadline) >= 0)) {
+        its_coalesce_expire();
+        its_coalesce_set_timer();
+    }
+}
+
+static bool held_is(psa_storage_uid_t uid, size_t size, uint8_t seed)
+{
+    uint8_t expected[ITS_MAX_ASSET_SIZE];
+    size_t length = 0;
+
+    make_data(expected, size, seed);
+    memset(reply_data, 0, sizeof(reply_data));
+
+    return (its_coalesce_get(CLIENT_ID, uid, 0, ITS_MAX_ASSET_SIZE, &length)
+            == PSA_SUCCESS) && (length == size) &&
+           (memcmp(reply_data, expected, size) == 0);
+}
+
+/* Tests */
+
+static int test_repeated_sets(void)
+{
+    struct psa_storage_info_t info;
+    uint8_t seed;
+
+    reset(PSA_SUCCESS);
+
+    /* The first set is written and opens the window */
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 0, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 1);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, 0));
+    HOST_TEST_ASSERT(timer_timeout == ITS_COALESCE_WINDOW);
+
+    /* Nothing is held until the next set */
+    HOST_TEST_ASSERT(its_coalesce_get_info(CLIENT_ID, 1, &info)
+                     == PSA_ERROR_DOES_NOT_EXIST);
+
+    /* The following sets are held in RAM, up to the last one before the
+     * maximum number of sets.
+     */
+    for (seed = 1; seed < ITS_COALESCE_MAX_SETS; seed++) {
+        HOST_TEST_ASSERT(set(1, DATA_SIZE, seed, PSA_STORAGE_FLAG_NONE)
+                         == PSA_SUCCESS);
+        HOST_TEST_ASSERT(write_count == 1);
+        HOST_TEST_ASSERT(held_is(1, DATA_SIZE, seed));
+    }
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, 0));
+
+    HOST_TEST_ASSERT(its_coalesce_get_info(CLIENT_ID, 1, &info)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(info.size == DATA_SIZE);
+    HOST_TEST_ASSERT(info.flags == PSA_STORAGE_FLAG_NONE);
+
+    /* The last set writes the data held */
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, seed, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 2);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, seed));
+    HOST_TEST_ASSERT(its_coalesce_get_info(CLIENT_ID, 1, &info)
+                     == PSA_ERROR_DOES_NOT_EXIST);
+
+    return 0;
+}
+
+static int test_timer_closes_window(void)
+{
+    reset(PSA_SUCCESS);
+
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 0, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(timer_timeout == ITS_COALESCE_WINDOW);
+
+    /* A later request sets the timer to the remaining time of the window */
+    advance(ITS_COALESCE_WINDOW / 2);
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 1, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(timer_timeout ==
+                     ITS_COALESCE_WINDOW - (ITS_COALESCE_WINDOW / 2));
+
+    /* The window of a second file expires later */
+    advance(1);
+    HOST_TEST_ASSERT(set(2, DATA_SIZE, 10, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, DATA_SIZE, 11, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 2);
+
+    /* Nothing is written before the first window is due */
+    advance(ITS_COALESCE_WINDOW - (ITS_COALESCE_WINDOW / 2) - 2);
+    HOST_TEST_ASSERT(write_count == 2);
+    HOST_TEST_ASSERT(held_is(1, DATA_SIZE, 1));
+
+    /* The timer writes the data of the first window only, and is set for
+     * the second one.
+     */
+    advance(1);
+    HOST_TEST_ASSERT(write_count == 3);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, 1));
+    HOST_TEST_ASSERT(stored_is(2, DATA_SIZE, 10));
+    HOST_TEST_ASSERT(timer_timeout == (ITS_COALESCE_WINDOW / 2) + 1);
+
+    advance(ITS_COALESCE_WINDOW / 2);
+    HOST_TEST_ASSERT(write_count == 3);
+    advance(1);
+    HOST_TEST_ASSERT(write_count == 4);
+    HOST_TEST_ASSERT(stored_is(2, DATA_SIZE, 11));
+
+    /* The timer is cancelled once no window is open */
+    HOST_TEST_ASSERT(timer_timeout == 0);
+
+    return 0;
+}
+
+static int test_failed_write_retried(void)
+{
+    reset(PSA_SUCCESS);
+
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 0, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 1, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+
+    /* The window stays open, with its data, for another full window rather
+     * than firing the timer on every tick.
+     */
+    fail_writes = true;
+    advance(ITS_COALESCE_WINDOW);
+    HOST_TEST_ASSERT(write_count == 1);
+    HOST_TEST_ASSERT(held_is(1, DATA_SIZE, 1));
+    HOST_TEST_ASSERT(timer_timeout == ITS_COALESCE_WINDOW);
+
+    fail_writes = false;
+    advance(ITS_COALESCE_WINDOW - 1);
+    HOST_TEST_ASSERT(write_count == 1);
+    advance(1);
+    HOST_TEST_ASSERT(write_count == 2);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, 1));
+    HOST_TEST_ASSERT(timer_timeout == 0);
+
+    return 0;
+}
+
+static int test_different_layout_written(void)
+{
+    reset(PSA_SUCCESS);
+
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 0, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 1, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+
+    /* A set with a different size is written straight away, and replaces
+     * the data held.
+     */
+    HOST_TEST_ASSERT(set(1, DATA_SIZE / 2, 2, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 2);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE / 2, 2));
+
+    /* So is a set with different flags */
+    HOST_TEST_ASSERT(set(1, DATA_SIZE / 2, 3,
+                         PSA_STORAGE_FLAG_NO_CONFIDENTIALITY) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 3);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE / 2, 3));
+
+    /* Write once files are never held */
+    HOST_TEST_ASSERT(set(2, DATA_SIZE, 4, PSA_STORAGE_FLAG_WRITE_ONCE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, DATA_SIZE, 5, PSA_STORAGE_FLAG_WRITE_ONCE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 5);
+
+    return 0;
+}
+
+static int test_commit_and_discard(void)
+{
+    reset(PSA_SUCCESS);
+
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 0, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 1, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, DATA_SIZE, 10, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, DATA_SIZE, 11, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 2);
+
+    /* An append first writes the data held, and closes the window */
+    HOST_TEST_ASSERT(its_coalesce_commit(CLIENT_ID, 1) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 3);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, 1));
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 2, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 4);
+
+    /* A remove discards it */
+    its_coalesce_discard(CLIENT_ID, 2);
+    HOST_TEST_ASSERT(!held_is(2, DATA_SIZE, 11));
+    HOST_TEST_ASSERT(its_coalesce_flush() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 4);
+    HOST_TEST_ASSERT(stored_is(2, DATA_SIZE, 10));
+
+    return 0;
+}
+
+static int test_flush(void)
+{
+    reset(PSA_SUCCESS);
+
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 0, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(1, DATA_SIZE, 1, PSA_STORAGE_FLAG_NONE)
+                     == PSA_SUCCESS);
+
+    /* A failed flush keeps the data held */
+    fail_writes = true;
+    HOST_TEST_ASSERT(its_coalesce_flush() == PSA_ERROR_STORAGE_FAILURE);
+    HOST_TEST_ASSERT(held_is(1, DATA_SIZE, 1));
+
+    fail_writes = false;
+    HOST_TEST_ASSERT(its_coalesce_flush() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_count == 2);
+    HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, 1));
+
+    its_coalesce_set_timer();
+    HOST_TEST_ASSERT(timer_timeout == 0);
+
+    return 0;
+}
+
+static int test_no_timer(void)
+{
+    uint8_t seed;
+
+    /* Without a timer, the windows are never opened */
+    reset(PSA_ERROR_NOT_SUPPORTED);
+    HOST_TEST_ASSERT(!its_coalesce_init());
+    timer_set_calls = 0;
+
+    for (seed = 0; seed < 4; seed++) {
+        HOST_TEST_ASSERT(set(1, DATA_SIZE, seed, PSA_STORAGE_FLAG_NONE)
+                         == PSA_SUCCESS);
+        HOST_TEST_ASSERT(write_count == (uint32_t)seed + 1);
+        HOST_TEST_ASSERT(stored_is(1, DATA_SIZE, seed));
+    }
+
+    /* The timer is not set after the requests */
+    HOST_TEST_ASSERT(timer_set_calls == 0);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_repeated_sets, failures);
+    HOST_TEST_RUN(test_timer_closes_window, failures);
+    HOST_TEST_RUN(test_failed_write_retried, failures);
+    HOST_TEST_RUN(test_different_layout_written, failures);
+    HOST_TEST_RUN(test_commit_and_discard, failures);
+    HOST_TEST_RUN(test_flush, failures);
+    HOST_TEST_RUN(test_no_timer, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
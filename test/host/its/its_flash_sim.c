@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "its_flash_sim.h"
+
+#include <string.h>
+
+#define ITS_FLASH_SIM_ERASE_VAL     0xFFU
+
+struct its_flash_sim_t its_flash_sim;
+
+/* Returns true if the power is cut during this operation */
+static bool its_flash_sim_next_op(void)
+{
+    return (its_flash_sim.ops++ == its_flash_sim.cut_at);
+}
+
+static void its_flash_sim_erase_area(size_t addr, size_t size)
+{
+    size_t unit;
+
+    memset(&its_flash_sim.data[addr], ITS_FLASH_SIM_ERASE_VAL, size);
+    for (unit = addr / ITS_FLASH_SIM_PROGRAM_UNIT;
+         unit < (addr + size) / ITS_FLASH_SIM_PROGRAM_UNIT; unit++) {
+        its_flash_sim.programmed[unit] = false;
+    }
+}
+
+static psa_status_t its_flash_sim_init(const struct its_flash_fs_config_t *cfg)
+{
+    (void)cfg;
+    return its_flash_sim.powered ? PSA_SUCCESS : PSA_ERROR_STORAGE_FAILURE;
+}
+
+static psa_status_t its_flash_sim_read(const struct its_flash_fs_config_t *cfg,
+                                       uint32_t block_id, uint8_t *buf,
+                                       size_t offset, size_t size)
+{
+    if (!its_flash_sim.powered) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    memcpy(buf, &its_flash_sim.data[cfg->flash_area_addr
+                                    + block_id * cfg->block_size + offset],
+           size);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_flash_sim_write(const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id, const uint8_t *buf,
+                                        size_t offset, size_t size)
+{
+    size_t addr = cfg->flash_area_addr + block_id * cfg->block_size + offset;
+    size_t unit;
+    size_t i;
+
+    if (!its_flash_sim.powered) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    if (its_flash_sim_next_op()) {
+        /* Only the first half of the data is programmed */
+        size = its_flash_sim.cut_before ? 0 : size / 2;
+        its_flash_sim.powered = false;
+    }
+
+    for (unit = addr / ITS_FLASH_SIM_PROGRAM_UNIT;
+         unit < (addr + size + ITS_FLASH_SIM_PROGRAM_UNIT - 1)
+                / ITS_FLASH_SIM_PROGRAM_UNIT; unit++) {
+        if (its_flash_sim.programmed[unit]) {
+            its_flash_sim.reprograms++;
+        }
+        its_flash_sim.programmed[unit] = true;
+    }
+
+    its_flash_sim.bytes_programmed += size;
+
+    /* A NOR flash can only clear the bits */
+    for (i = 0; i < size; i++) {
+        its_flash_sim.data[addr + i] &= buf[i];
+    }
+
+    return its_flash_sim.powered ? PSA_SUCCESS : PSA_ERROR_STORAGE_FAILURE;
+}
+
+static psa_status_t its_flash_sim_flush(const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id)
+{
+    (void)cfg;
+    (void)block_id;
+    return its_flash_sim.powered ? PSA_SUCCESS : PSA_ERROR_STORAGE_FAILURE;
+}
+
+static psa_status_t its_flash_sim_erase_sector(
+                                        const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id, size_t offset)
+{
+    size_t size = cfg->sector_size;
+
+    if (!its_flash_sim.powered) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    if (its_flash_sim_next_op()) {
+        /* The sector is left partially erased */
+        size = its_flash_sim.cut_before ? 0 : size / 2;
+        its_flash_sim.powered = false;
+    }
+
+    its_flash_sim.erases++;
+    its_flash_sim_erase_area(cfg->flash_area_addr
+                             + block_id * cfg->block_size + offset, size);
+
+    return its_flash_sim.powered ? PSA_SUCCESS : PSA_ERROR_STORAGE_FAILURE;
+}
+
+static psa_status_t its_flash_sim_erase(const struct its_flash_fs_config_t *cfg,
+                                        uint32_t block_id)
+{
+    size_t size = cfg->block_size;
+
+    if (!its_flash_sim.powered) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    if (its_flash_sim_next_op()) {
+        /* The block is left partially erased */
+        size = its_flash_sim.cut_before ? 0 : size / 2;
+        its_flash_sim.powered = false;
+    }
+
+    its_flash_sim.erases++;
+    its_flash_sim_erase_area(cfg->flash_area_addr
+                             + block_id * cfg->block_size, size);
+
+    return its_flash_sim.powered ? PSA_SUCCESS : PSA_ERROR_STORAGE_FAILURE;
+}
+
+const struct its_flash_fs_ops_t its_flash_fs_ops_sim = {
+    .init = its_flash_sim_init,
+    .read = its_flash_sim_read,
+    .write = its_flash_sim_write,
+    .flush = its_flash_sim_flush,
+    .erase = its_flash_sim_erase,
+    .erase_sector = its_flash_sim_erase_sector,
+};
+
+void its_flash_sim_reset(void)
+{
+    its_flash_sim_erase_area(0, ITS_FLASH_SIM_SIZE);
+    its_flash_sim_power_on(ITS_FLASH_SIM_NO_CUT);
+    its_flash_sim.erases = 0;
+    its_flash_sim.reprograms = 0;
+    its_flash_sim.bytes_programmed = 0;
+}
+
+void its_flash_sim_power_on(uint32_t cut_at)
+{
+    its_flash_sim.powered = true;
+    its_flash_sim.ops = 0;
+    its_flash_sim.cut_at = cut_at;
+    its_flash_sim.cut_before = false;
+}
+
+void its_flash_sim_power_on_cut_before(uint32_t cut_at)
+{
+    its_flash_sim_power_on(cut_at);
+    its_flash_sim.cut_before = true;
+}
+
+bool its_flash_sim_is_erased(size_t addr, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        if (its_flash_sim.data[addr + i] != ITS_FLASH_SIM_ERASE_VAL) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void its_flash_sim_get_config(struct its_flash_fs_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->flash_dev = its_flash_sim.data;
+    cfg->flash_area_addr = 0;
+    cfg->sector_size = ITS_FLASH_SIM_SECTOR_SIZE;
+    cfg->block_size = ITS_FLASH_SIM_BLOCK_SIZE;
+    cfg->num_blocks = ITS_FLASH_SIM_NUM_BLOCKS;
+    cfg->program_unit = ITS_FLASH_SIM_PROGRAM_UNIT;
+    cfg->max_file_size = 512;
+    cfg->max_num_files = 8;
+    cfg->erase_val = ITS_FLASH_SIM_ERASE_VAL;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/**
+ * \file its_flash_sim.h
+ *
+ * \brief Flash device emulated in RAM for the ITS filesystem host tests. It
+ *        programs like a NOR flash, can cut the power in the middle of a
+ *        program or erase operation, and records the program units which are
+ *        programmed more than once between two erases.
+ */
+
+#ifndef __ITS_FLASH_SIM_H__
+#define __ITS_FLASH_SIM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flash_fs/its_flash_fs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The geometry can be set by the test build */
+#ifndef ITS_FLASH_SIM_SECTOR_SIZE
+#define ITS_FLASH_SIM_SECTOR_SIZE   1024
+#endif
+#ifndef ITS_FLASH_SIM_BLOCK_SIZE
+#define ITS_FLASH_SIM_BLOCK_SIZE    4096
+#endif
+#ifndef ITS_FLASH_SIM_NUM_BLOCKS
+#define ITS_FLASH_SIM_NUM_BLOCKS    4
+#endif
+#define ITS_FLASH_SIM_PROGRAM_UNIT  4
+#define ITS_FLASH_SIM_SIZE  (ITS_FLASH_SIM_BLOCK_SIZE * ITS_FLASH_SIM_NUM_BLOCKS)
+
+/* Value of its_flash_sim_t.cut_at when the power is never cut */
+#define ITS_FLASH_SIM_NO_CUT        UINT32_MAX
+
+struct its_flash_sim_t {
+    uint8_t data[ITS_FLASH_SIM_SIZE];  /* Content of the flash */
+    bool programmed[ITS_FLASH_SIM_SIZE / ITS_FLASH_SIM_PROGRAM_UNIT];
+                                   /* Program units programmed since erase */
+    uint32_t ops;                  /* Program and erase operations done */
+    uint32_t cut_at;               /* Operation interrupted by the power cut */
+    bool cut_before;               /* True if the interrupted operation has
+                                    * no effect, false if it is half done
+                                    */
+    bool powered;                  /* False once the power has been cut */
+    uint32_t erases;               /* Block and sector erases done */
+    uint32_t reprograms;           /* Program units programmed twice */
+    size_t bytes_programmed;       /* Bytes programmed */
+};
+
+/* The flash device, shared by the filesystem configuration */
+extern struct its_flash_sim_t its_flash_sim;
+
+/* Flash operations of the device */
+extern const struct its_flash_fs_ops_t its_flash_fs_ops_sim;
+
+/**
+ * \brief Erases the whole device and clears the counters.
+ */
+void its_flash_sim_reset(void);
+
+/**
+ * \brief Restores the power, and cuts it again at the given operation.
+ *
+ * \param[in] cut_at  Index of the program or erase operation, counted from
+ *                    this call, during which the power is cut, or
+ *                    ITS_FLASH_SIM_NO_CUT
+ */
+void its_flash_sim_power_on(uint32_t cut_at);
+
+/**
+ * \brief Restores the power, and cuts it again just before the given
+ *        operation, which then has no effect.
+ *
+ * \param[in] cut_at  Index of the program or erase operation, counted from
+ *                    this call, which is not performed
+ */
+void its_flash_sim_power_on_cut_before(uint32_t cut_at);
+
+/**
+ * \brief Checks whether an area of the device is erased.
+ *
+ * \param[in] addr  Address of the area from the start of the device
+ * \param[in] size  Size of the area
+ *
+ * \return Returns true if all the bytes of the area hold the erased value.
+ */
+bool its_flash_sim_is_erased(size_t addr, size_t size);
+
+/**
+ * \brief Gets a filesystem configuration for the device.
+ *
+ * \param[out] cfg  Filesystem configuration to fill
+ */
+void its_flash_sim_get_config(struct its_flash_fs_config_t *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_FLASH_SIM_H__ */
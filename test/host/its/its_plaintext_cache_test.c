@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tests of the ITS plaintext cache. The cache is built with a pool of
+ * TFM_ITS_PLAINTEXT_CACHE_SIZE bytes and ITS_PLAINTEXT_CACHE_ENTRIES entries,
+ * set by the test build, so that eviction is reached with a few files.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "its_plaintext_cache.h"
+#include "its_utils.h"
+
+#define FILE_SIZE   (TFM_ITS_PLAINTEXT_CACHE_SIZE / \
+                     ITS_PLAINTEXT_CACHE_ENTRIES)
+
+static void make_fid(uint8_t *fid, uint32_t id)
+{
+    memset(fid, 0, ITS_FILE_ID_SIZE);
+    memcpy(fid, &id, sizeof(id));
+}
+
+static void make_data(uint8_t *data, size_t size, uint8_t seed)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        data[i] = (uint8_t)(seed + i);
+    }
+}
+
+/* Returns true if the file is cached with the expected content */
+static int is_cached(uint32_t id, size_t size, uint8_t seed)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t expected[TFM_ITS_PLAINTEXT_CACHE_SIZE];
+    uint8_t data[TFM_ITS_PLAINTEXT_CACHE_SIZE];
+
+    make_fid(fid, id);
+    make_data(expected, size, seed);
+    if (its_plaintext_cache_get(fid, data, size) != PSA_SUCCESS) {
+        return 0;
+    }
+
+    return memcmp(data, expected, size) == 0;
+}
+
+static void put(uint32_t id, size_t size, uint8_t seed)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[TFM_ITS_PLAINTEXT_CACHE_SIZE];
+
+    make_fid(fid, id);
+    make_data(data, size, seed);
+    its_plaintext_cache_put(fid, data, size);
+}
+
+static void invalidate(uint32_t id)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+
+    make_fid(fid, id);
+    its_plaintext_cache_invalidate(fid);
+}
+
+static int test_miss_then_hit(void)
+{
+    struct tfm_storage_cache_stats_t before;
+    struct tfm_storage_cache_stats_t after;
+
+    its_plaintext_cache_get_stats(&before);
+
+    HOST_TEST_ASSERT(!is_cached(1, FILE_SIZE, 0x10));
+    put(1, FILE_SIZE, 0x10);
+    HOST_TEST_ASSERT(is_cached(1, FILE_SIZE, 0x10));
+    HOST_TEST_ASSERT(is_cached(1, FILE_SIZE, 0x10));
+
+    its_plaintext_cache_get_stats(&after);
+    HOST_TEST_ASSERT(after.misses == before.misses + 1);
+    HOST_TEST_ASSERT(after.hits == before.hits + 2);
+    HOST_TEST_ASSERT(after.evictions == before.evictions);
+
+    invalidate(1);
+    return 0;
+}
+
+static int test_invalidate(void)
+{
+    put(1, FILE_SIZE, 0x10);
+    put(2, FILE_SIZE, 0x20);
+    put(3, FILE_SIZE, 0x30);
+
+    /* The plaintext after the dropped entry is moved down and stays valid */
+    invalidate(1);
+    HOST_TEST_ASSERT(!is_cached(1, FILE_SIZE, 0x10));
+    HOST_TEST_ASSERT(is_cached(2, FILE_SIZE, 0x20));
+    HOST_TEST_ASSERT(is_cached(3, FILE_SIZE, 0x30));
+
+    invalidate(3);
+    HOST_TEST_ASSERT(!is_cached(3, FILE_SIZE, 0x30));
+    HOST_TEST_ASSERT(is_cached(2, FILE_SIZE, 0x20));
+
+    /* Invalidating a file which is not cached has no effect */
+    invalidate(3);
+    HOST_TEST_ASSERT(is_cached(2, FILE_SIZE, 0x20));
+
+    invalidate(2);
+    return 0;
+}
+
+static int test_overwrite(void)
+{
+    put(1, FILE_SIZE, 0x10);
+    put(1, FILE_SIZE / 2, 0x40);
+
+    HOST_TEST_ASSERT(is_cached(1, FILE_SIZE / 2, 0x40));
+
+    invalidate(1);
+    return 0;
+}
+
+static int test_size_mismatch_is_a_miss(void)
+{
+    put(1, FILE_SIZE, 0x10);
+
+    /* An entry of another size is stale and dropped */
+    HOST_TEST_ASSERT(!is_cached(1, FILE_SIZE - 1, 0x10));
+    HOST_TEST_ASSERT(!is_cached(1, FILE_SIZE, 0x10));
+
+    return 0;
+}
+
+static int test_lru_eviction(void)
+{
+    struct tfm_storage_cache_stats_t before;
+    struct tfm_storage_cache_stats_t after;
+    uint32_t id;
+
+    for (id = 1; id <= ITS_PLAINTEXT_CACHE_ENTRIES; id++) {
+        put(id, FILE_SIZE, (uint8_t)(id << 4));
+    }
+
+    /* File 1 becomes the most recently used, file 2 the least */
+    HOST_TEST_ASSERT(is_cached(1, FILE_SIZE, 0x10));
+
+    its_plaintext_cache_get_stats(&before);
+    put(ITS_PLAINTEXT_CACHE_ENTRIES + 1, FILE_SIZE, 0xF0);
+    its_plaintext_cache_get_stats(&after);
+
+    HOST_TEST_ASSERT(after.evictions == before.evictions + 1);
+    HOST_TEST_ASSERT(!is_cached(2, FILE_SIZE, 0x20));
+    HOST_TEST_ASSERT(is_cached(1, FILE_SIZE, 0x10));
+    HOST_TEST_ASSERT(is_cached(ITS_PLAINTEXT_CACHE_ENTRIES + 1, FILE_SIZE,
+                               0xF0));
+
+    /* A file filling the whole pool evicts all the others */
+    put(ITS_PLAINTEXT_CACHE_ENTRIES + 2, TFM_ITS_PLAINTEXT_CACHE_SIZE, 0x01);
+    HOST_TEST_ASSERT(!is_cached(1, FILE_SIZE, 0x10));
+    HOST_TEST_ASSERT(is_cached(ITS_PLAINTEXT_CACHE_ENTRIES + 2,
+                               TFM_ITS_PLAINTEXT_CACHE_SIZE, 0x01));
+
+    invalidate(ITS_PLAINTEXT_CACHE_ENTRIES + 2);
+    return 0;
+}
+
+static int test_too_large_is_not_cached(void)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    static uint8_t data[TFM_ITS_PLAINTEXT_CACHE_SIZE + 1];
+
+    put(1, FILE_SIZE, 0x10);
+
+    make_fid(fid, 9);
+    its_plaintext_cache_put(fid, data, sizeof(data));
+
+    /* Nothing was evicted for it */
+    HOST_TEST_ASSERT(is_cached(1, FILE_SIZE, 0x10));
+    HOST_TEST_ASSERT(its_plaintext_cache_get(fid, data, sizeof(data)) ==
+                     PSA_ERROR_DOES_NOT_EXIST);
+
+    invalidate(1);
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_miss_then_hit, failures);
+    HOST_TEST_RUN(test_invalidate, failures);
+    HOST_TEST_RUN(test_overwrite, failures);
+    HOST_TEST_RUN(test_size_mismatch_is_a_miss, failures);
+    HOST_TEST_RUN(test_lru_eviction, failures);
+    HOST_TEST_RUN(test_too_large_is_not_cached, failures);
+
+    return failures;
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Cuts the power at each flash operation of a sequence of ITS filesystem
+ * updates, and checks that the filesystem mounted afterwards holds the files
+ * as they were before or after the interrupted update. With ITS_FAST_MOUNT,
+ * it also checks that the mount only skips the validation when the scratch
+ * blocks are erased, i.e. that the clean marker is never left valid by an
+ * interrupted update.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "flash_fs/its_flash_fs.h"
+#include "host_test.h"
+#include "its_flash_sim.h"
+
+#define FILE_A_SIZE         256
+#define FILE_A_NEW_SIZE     384
+#define FILE_B_SIZE         200
+#define FILE_C_SIZE         128
+
+/* Number of updates in the sequence interrupted by the power cuts */
+#define NUM_STEPS           4
+
+static struct its_flash_fs_config_t fs_cfg;
+static its_flash_fs_ctx_t fs_ctx;
+static struct its_flash_sim_t snapshot;
+
+static const uint8_t fid_a[ITS_FILE_ID_SIZE] = { 'A' };
+static const uint8_t fid_b[ITS_FILE_ID_SIZE] = { 'B' };
+static const uint8_t fid_c[ITS_FILE_ID_SIZE] = { 'C' };
+
+static void fill(uint8_t *buf, size_t size, uint8_t seed)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        buf[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+static psa_status_t write_file(const uint8_t *fid, uint32_t flags,
+                               size_t size, uint8_t seed)
+{
+    struct its_flash_fs_file_info_t info = {0};
+    uint8_t buf[FILE_A_NEW_SIZE];
+
+    fill(buf, size, seed);
+    info.size_max = size;
+    info.flags = flags;
+
+    return its_flash_fs_file_write(&fs_ctx, fid, &info, size, 0, buf);
+}
+
+/* Returns true if the file holds the expected content, or does not exist when
+ * size is 0.
+ */
+static bool file_is(const uint8_t *fid, size_t size, uint8_t seed)
+{
+    struct its_flash_fs_file_info_t info;
+    uint8_t expected[FILE_A_NEW_SIZE];
+    uint8_t buf[FILE_A_NEW_SIZE];
+
+    if (its_flash_fs_file_get_info(&fs_ctx, fid, &info) != PSA_SUCCESS) {
+        return (size == 0);
+    }
+
+    if ((info.size_current != size) ||
+        (its_flash_fs_file_read(&fs_ctx, fid, size, 0, buf) != PSA_SUCCESS)) {
+        return false;
+    }
+
+    fill(expected, size, seed);
+
+    return (memcmp(buf, expected, size) == 0);
+}
+
+/* Runs one update of the sequence */
+static psa_status_t run_step(uint32_t step)
+{
+    psa_status_t status;
+
+    switch (step) {
+    case 0:
+        /* Overwrite A */
+        status = write_file(fid_a, 0, FILE_A_SIZE, 2);
+        break;
+    case 1:
+        status = its_flash_fs_file_delete(&fs_ctx, fid_b);
+        break;
+    case 2:
+        status = write_file(fid_c, ITS_FLASH_FS_FLAG_CREATE, FILE_C_SIZE, 1);
+        break;
+    default:
+        /* Recreate A with another size, in two block updates */
+        status = write_file(fid_a,
+                            ITS_FLASH_FS_FLAG_CREATE | ITS_FLASH_FS_FLAG_TRUNCATE,
+                            FILE_A_NEW_SIZE, 3);
+        break;
+    }
+
+#ifdef ITS_BACKGROUND_ERASE
+    /* Erase the scratch blocks between the requests, as the partition does */
+    while ((status == PSA_SUCCESS) && its_flash_fs_erase_pending(&fs_ctx)) {
+        status = its_flash_fs_erase_step(&fs_ctx);
+    }
+#endif
+
+    return status;
+}
+
+/* Returns true if the files are as they are after the given number of
+ * updates of the sequence.
+ */
+static bool state_is(uint32_t steps)
+{
+    return file_is(fid_a,
+                   (steps >= 4) ? FILE_A_NEW_SIZE : FILE_A_SIZE,
+                   (steps >= 4) ? 3 : ((steps >= 1) ? 2 : 1)) &&
+           file_is(fid_b, (steps >= 2) ? 0 : FILE_B_SIZE, 1) &&
+           file_is(fid_c, (steps >= 3) ? FILE_C_SIZE : 0, 1);
+}
+
+/* Mounts the filesystem after a reset, and reports whether the validation of
+ * the filesystem was skipped.
+ */
+static psa_status_t mount(bool *fast)
+{
+    uint32_t erases;
+    psa_status_t status;
+
+    its_flash_sim_power_on(ITS_FLASH_SIM_NO_CUT);
+    erases = its_flash_sim.erases;
+
+    status = its_flash_fs_init_ctx(&fs_ctx, &fs_cfg, &its_flash_fs_ops_sim);
+    if (status == PSA_SUCCESS) {
+        status = its_flash_fs_prepare(&fs_ctx);
+    }
+
+    /* The full initialization always erases the scratch blocks */
+    *fast = (its_flash_sim.erases == erases);
+
+    return status;
+}
+
+/* Checks that the scratch blocks are erased, apart from the clean marker */
+static bool scratch_blocks_erased(void)
+{
+    size_t marker_size = 0;
+
+#ifdef ITS_FAST_MOUNT
+    marker_size = ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE;
+#endif
+
+    return its_flash_sim_is_erased(fs_ctx.scratch_metablock * fs_cfg.block_size,
+                                   fs_cfg.block_size - marker_size) &&
+           its_flash_sim_is_erased(
+                      fs_ctx.meta_block_header.scratch_dblock * fs_cfg.block_size,
+                      fs_cfg.block_size);
+}
+
+static int setup(void)
+{
+    bool fast;
+
+    its_flash_sim_reset();
+    its_flash_sim_get_config(&fs_cfg);
+
+    HOST_TEST_ASSERT(its_flash_fs_init_ctx(&fs_ctx, &fs_cfg,
+                                           &its_flash_fs_ops_sim)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_flash_fs_wipe_all(&fs_ctx) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(mount(&fast) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_file(fid_a, ITS_FLASH_FS_FLAG_CREATE, FILE_A_SIZE, 1)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(write_file(fid_b, ITS_FLASH_FS_FLAG_CREATE, FILE_B_SIZE, 1)
+                     == PSA_SUCCESS);
+#ifdef ITS_BACKGROUND_ERASE
+    while (its_flash_fs_erase_pending(&fs_ctx)) {
+        HOST_TEST_ASSERT(its_flash_fs_erase_step(&fs_ctx) == PSA_SUCCESS);
+    }
+#endif
+    HOST_TEST_ASSERT(state_is(0));
+
+    snapshot = its_flash_sim;
+
+    return 0;
+}
+
+static int power_cut_at_each_operation(bool cut_before)
+{
+    uint32_t cut;
+    uint32_t steps;
+    uint32_t fast_mounts = 0;
+    bool fast;
+
+    HOST_TEST_ASSERT(setup() == 0);
+
+    for (cut = 0; ; cut++) {
+        its_flash_sim = snapshot;
+        HOST_TEST_ASSERT(mount(&fast) == PSA_SUCCESS);
+
+        if (cut_before) {
+            its_flash_sim_power_on_cut_before(cut);
+        } else {
+            its_flash_sim_power_on(cut);
+        }
+        for (steps = 0; steps < NUM_STEPS; steps++) {
+            if (run_step(steps) != PSA_SUCCESS) {
+                break;
+            }
+        }
+
+        if (its_flash_sim.powered) {
+            /* The whole sequence ran before the power cut */
+            HOST_TEST_ASSERT(steps == NUM_STEPS);
+            HOST_TEST_ASSERT(state_is(NUM_STEPS));
+            break;
+        }
+
+        HOST_TEST_ASSERT(mount(&fast) == PSA_SUCCESS);
+
+        /* The interrupted update is either fully done or not at all */
+        HOST_TEST_ASSERT(state_is(steps) ||
+                         ((steps < NUM_STEPS) && state_is(steps + 1)));
+
+        if (fast) {
+            /* The marker was only left valid by a completed update */
+            HOST_TEST_ASSERT(scratch_blocks_erased());
+            fast_mounts++;
+        }
+
+        /* The filesystem can still be updated and mounted again */
+        HOST_TEST_ASSERT(write_file(fid_c,
+                                    ITS_FLASH_FS_FLAG_CREATE |
+                                    ITS_FLASH_FS_FLAG_TRUNCATE,
+                                    FILE_C_SIZE, 9) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(mount(&fast) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(file_is(fid_c, FILE_C_SIZE, 9));
+    }
+
+    HOST_TEST_ASSERT(cut > NUM_STEPS);
+    /* The filesystem never programs a program unit twice without an erase */
+    HOST_TEST_ASSERT(its_flash_sim.reprograms == 0);
+
+    printf("%u power cuts, %u followed by a fast mount\n",
+           (unsigned)cut, (unsigned)fast_mounts);
+
+    return 0;
+}
+
+static int test_power_cut_during_each_operation(void)
+{
+    return power_cut_at_each_operation(false);
+}
+
+static int test_power_cut_before_each_operation(void)
+{
+    return power_cut_at_each_operation(true);
+}
+
+#ifdef ITS_FAST_MOUNT
+static int test_fast_mount_after_clean_shutdown(void)
+{
+    bool fast;
+
+    HOST_TEST_ASSERT(setup() == 0);
+
+    HOST_TEST_ASSERT(mount(&fast) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(fast);
+    HOST_TEST_ASSERT(scratch_blocks_erased());
+    HOST_TEST_ASSERT(state_is(0));
+
+    return 0;
+}
+
+static int test_damaged_marker_is_ignored(void)
+{
+    size_t marker;
+    size_t i;
+    bool fast;
+
+    HOST_TEST_ASSERT(setup() == 0);
+
+    /* Clear one bit at a time in the marker, as a disturbed program would */
+    for (i = 0; i < sizeof(struct its_mblock_clean_marker_t); i++) {
+        its_flash_sim = snapshot;
+        HOST_TEST_ASSERT(mount(&fast) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(fast);
+
+        marker = fs_ctx.scratch_metablock * fs_cfg.block_size +
+                 fs_cfg.block_size - ITS_MBLOCK_CLEAN_MARKER_RESERVED_SIZE;
+        if ((its_flash_sim.data[marker + i] & 0x10U) == 0) {
+            continue;
+        }
+        its_flash_sim.data[marker + i] &= ~0x10U;
+
+        HOST_TEST_ASSERT(mount(&fast) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(!fast);
+        HOST_TEST_ASSERT(state_is(0));
+    }
+
+    return 0;
+}
+#endif /* ITS_FAST_MOUNT */
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_power_cut_during_each_operation, failures);
+    HOST_TEST_RUN(test_power_cut_before_each_operation, failures);
+#ifdef ITS_FAST_MOUNT
+    HOST_TEST_RUN(test_fast_mount_after_clean_shutdown, failures);
+    HOST_TEST_RUN(test_damaged_marker_is_ignored, failures);
+#endif
+
+    return (failures == 0) ? 0 : 1;
+}
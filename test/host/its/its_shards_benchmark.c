@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Scaling benchmark of the ITS shards. For each number of assets, from 16 to
+ * 4096, the ITS area is filled with small assets in a single filesystem and
+ * in shards of up to BENCH_ASSETS_PER_SHARD assets, and the flash programmed
+ * and erased by each update of an asset is reported. The cost of an update in
+ * a single filesystem grows with the number of assets, as its metadata block
+ * is rewritten in full, while it stays bounded with the shards. A single
+ * filesystem cannot hold the largest numbers of assets at all, as their
+ * metadata does not fit in a block.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "its_flash_sim.h"
+#include "its_shards.h"
+
+#define BENCH_ASSET_SIZE        16
+#define BENCH_ASSETS_PER_SHARD  64
+#define BENCH_NUM_UPDATES       16
+
+static const uint32_t bench_num_assets[] = { 16, 64, 256, 1024, 4096 };
+
+struct bench_cost_t {
+    bool supported;            /* The layout can hold all the assets */
+    size_t bytes_programmed;   /* Bytes programmed by each update */
+    size_t bytes_erased;       /* Bytes erased by each update */
+};
+
+static void make_fid(uint8_t *fid, uint32_t id)
+{
+    /* The file id of a free file metadata entry is all zeros */
+    id++;
+    memset(fid, 0, ITS_FILE_ID_SIZE);
+    memcpy(fid, &id, sizeof(id));
+}
+
+static psa_status_t write_asset(uint32_t id, uint32_t flags)
+{
+    struct its_flash_fs_file_info_t info = {0};
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[BENCH_ASSET_SIZE];
+    uint32_t shard;
+    psa_status_t status;
+
+    make_fid(fid, id);
+    memset(data, (int)id, sizeof(data));
+    info.size_max = sizeof(data);
+    info.flags = flags;
+
+    status = its_shards_get_info(fid, &info, &shard);
+    if (status == PSA_ERROR_DOES_NOT_EXIST) {
+        info.size_max = sizeof(data);
+        info.flags = flags;
+        return its_shards_create(fid, &info, sizeof(data), data, &shard);
+    } else if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    info.flags = flags;
+    return its_flash_fs_file_write(its_shards_get_ctx(shard), fid, &info,
+                                   sizeof(data), 0, data);
+}
+
+static int bench_run(uint32_t num_assets, uint32_t num_shards,
+                     struct bench_cost_t *cost)
+{
+    struct its_flash_fs_config_t area_cfg;
+    psa_status_t status;
+    uint32_t erases;
+    uint32_t id;
+
+    its_flash_sim_reset();
+    its_flash_sim_get_config(&area_cfg);
+    area_cfg.max_file_size = BENCH_ASSET_SIZE;
+    area_cfg.max_num_files = num_assets + 1;
+
+    status = its_shards_init(&area_cfg, &its_flash_fs_ops_sim, num_shards,
+                             true);
+    if ((num_shards == 1) && (status == PSA_ERROR_INVALID_ARGUMENT)) {
+        /* The metadata of all the assets does not fit in a block */
+        cost->supported = false;
+        return 0;
+    }
+    HOST_TEST_ASSERT(status == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num() == num_shards);
+    cost->supported = true;
+
+    for (id = 0; id < num_assets; id++) {
+        HOST_TEST_ASSERT(write_asset(id, ITS_FLASH_FS_FLAG_CREATE)
+                         == PSA_SUCCESS);
+    }
+
+    its_flash_sim.bytes_programmed = 0;
+    erases = its_flash_sim.erases;
+
+    for (id = 0; id < BENCH_NUM_UPDATES; id++) {
+        HOST_TEST_ASSERT(write_asset(id * (num_assets / BENCH_NUM_UPDATES),
+                                     ITS_FLASH_FS_FLAG_TRUNCATE)
+                         == PSA_SUCCESS);
+    }
+
+    cost->bytes_programmed = its_flash_sim.bytes_programmed
+                             / BENCH_NUM_UPDATES;
+    cost->bytes_erased = (its_flash_sim.erases - erases)
+                         * ITS_FLASH_SIM_BLOCK_SIZE / BENCH_NUM_UPDATES;
+
+    return 0;
+}
+
+static int bench_scaling(void)
+{
+    struct bench_cost_t single;
+    struct bench_cost_t sharded;
+    uint32_t num_shards;
+    uint32_t i;
+
+    printf("%8s %8s %20s %20s\n", "assets", "shards",
+           "programmed (single)", "programmed (shards)");
+
+    for (i = 0; i < sizeof(bench_num_assets) / sizeof(bench_num_assets[0]);
+         i++) {
+        num_shards = bench_num_assets[i] / BENCH_ASSETS_PER_SHARD;
+        if (num_shards == 0) {
+            num_shards = 1;
+        }
+
+        HOST_TEST_ASSERT(bench_run(bench_num_assets[i], 1, &single) == 0);
+        HOST_TEST_ASSERT(bench_run(bench_num_assets[i], num_shards,
+                                   &sharded) == 0);
+
+        if (!single.supported) {
+            printf("%8u %8u %20s %20u\n", (unsigned)bench_num_assets[i],
+                   (unsigned)num_shards, "n/a",
+                   (unsigned)sharded.bytes_programmed);
+            continue;
+        }
+
+        printf("%8u %8u %20u %20u\n", (unsigned)bench_num_assets[i],
+               (unsigned)num_shards, (unsigned)single.bytes_programmed,
+               (unsigned)sharded.bytes_programmed);
+
+        /* The shards only hold the assets of a single filesystem of
+         * BENCH_ASSETS_PER_SHARD assets, whatever their number.
+         */
+        if (num_shards > 1) {
+            HOST_TEST_ASSERT(sharded.bytes_programmed <
+                             single.bytes_programmed);
+            HOST_TEST_ASSERT(sharded.bytes_erased <= single.bytes_erased);
+        }
+    }
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(bench_scaling, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tests of the ITS shards and their root. The ITS area of the flash device
+ * holds the root blocks and TEST_NUM_SHARDS shards of a few files each, so
+ * that the assets hashed to a full shard are stored in the other shards.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "its_flash_sim.h"
+#include "its_shards.h"
+
+#define TEST_NUM_SHARDS     4
+#define TEST_NUM_ASSETS     16
+#define TEST_ASSET_SIZE     24
+
+/* Cycles of the spilled asset before the power cuts, and during them. The
+ * root block is full during the power cuts, so the root is written to the
+ * other root block.
+ */
+#define WARMUP_CYCLES       45
+#define SWEEP_CYCLES        10
+
+static struct its_flash_fs_config_t area_cfg;
+static struct its_flash_sim_t snapshot;
+
+static void make_fid(uint8_t *fid, uint32_t id)
+{
+    memset(fid, 0, ITS_FILE_ID_SIZE);
+    memcpy(fid, &id, sizeof(id));
+}
+
+static psa_status_t init(uint32_t num_shards)
+{
+    its_flash_sim_power_on(ITS_FLASH_SIM_NO_CUT);
+
+    return its_shards_init(&area_cfg, &its_flash_fs_ops_sim, num_shards,
+                           true);
+}
+
+static psa_status_t create(uint32_t id, uint32_t *shard)
+{
+    struct its_flash_fs_file_info_t info = {0};
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t data[TEST_ASSET_SIZE];
+
+    make_fid(fid, id);
+    memset(data, (int)id, sizeof(data));
+    info.size_max = sizeof(data);
+    info.flags = ITS_FLASH_FS_FLAG_CREATE;
+
+    return its_shards_create(fid, &info, sizeof(data), data, shard);
+}
+
+static psa_status_t delete(uint32_t id)
+{
+    struct its_flash_fs_file_info_t info;
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint32_t shard;
+    psa_status_t status;
+
+    make_fid(fid, id);
+    status = its_shards_get_info(fid, &info, &shard);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    return its_shards_delete(fid, shard);
+}
+
+/* Returns true if the asset exists with its content */
+static bool exists(uint32_t id)
+{
+    struct its_flash_fs_file_info_t info;
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint8_t expected[TEST_ASSET_SIZE];
+    uint8_t data[TEST_ASSET_SIZE];
+    uint32_t shard;
+
+    make_fid(fid, id);
+    if ((its_shards_get_info(fid, &info, &shard) != PSA_SUCCESS) ||
+        (info.size_current != sizeof(data)) ||
+        (its_flash_fs_file_read(its_shards_get_ctx(shard), fid, sizeof(data),
+                                0, data) != PSA_SUCCESS)) {
+        return false;
+    }
+
+    memset(expected, (int)id, sizeof(expected));
+
+    return memcmp(data, expected, sizeof(data)) == 0;
+}
+
+/* Gets the next asset id, from id, which is hashed to the given shard */
+static uint32_t next_id(uint32_t id, uint32_t shard)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+
+    for (;; id++) {
+        make_fid(fid, id);
+        if (its_shards_hash(fid) == shard) {
+            return id;
+        }
+    }
+}
+
+static int setup(void)
+{
+    its_flash_sim_reset();
+    its_flash_sim_get_config(&area_cfg);
+    area_cfg.max_num_files = TEST_NUM_ASSETS + 1;
+
+    HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num() == TEST_NUM_SHARDS);
+
+    return 0;
+}
+
+/* Fills shard 0 with the assets hashed to it, and returns the number stored */
+static uint32_t fill_shard0(uint32_t *ids)
+{
+    uint32_t num = 0;
+    uint32_t id = 1;
+    uint32_t shard;
+
+    for (;;) {
+        id = next_id(id, 0);
+        if ((create(id, &shard) != PSA_SUCCESS) || (shard != 0)) {
+            /* The last one is stored in another shard, remove it */
+            (void)delete(id);
+            return num;
+        }
+        ids[num++] = id++;
+    }
+}
+
+static int test_layout(void)
+{
+    uint8_t fid[ITS_FILE_ID_SIZE];
+    uint32_t shard;
+    uint32_t id;
+
+    HOST_TEST_ASSERT(setup() == 0);
+
+    /* The shards hold the assets of their hash */
+    for (id = 1; id <= TEST_NUM_SHARDS * 2; id++) {
+        make_fid(fid, id);
+        HOST_TEST_ASSERT(create(id, &shard) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(shard == its_shards_hash(fid));
+    }
+
+    /* The root is found at the next initialization */
+    HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num() == TEST_NUM_SHARDS);
+    for (id = 1; id <= TEST_NUM_SHARDS * 2; id++) {
+        HOST_TEST_ASSERT(exists(id));
+    }
+
+    /* The layout is kept when another number of shards is requested */
+    HOST_TEST_ASSERT(init(2) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num() == TEST_NUM_SHARDS);
+    HOST_TEST_ASSERT(init(ITS_NUM_SHARDS) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num() == TEST_NUM_SHARDS);
+    for (id = 1; id <= TEST_NUM_SHARDS * 2; id++) {
+        HOST_TEST_ASSERT(exists(id));
+    }
+
+    return 0;
+}
+
+static int test_single_filesystem_is_kept(void)
+{
+    its_flash_fs_ctx_t fs_ctx;
+    uint32_t shard;
+    uint32_t id;
+
+    its_flash_sim_reset();
+    its_flash_sim_get_config(&area_cfg);
+    area_cfg.max_num_files = TEST_NUM_ASSETS + 1;
+
+    /* Layout of a single filesystem over the ITS area, without a root */
+    HOST_TEST_ASSERT(init(1) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num() == 1);
+    for (id = 1; id <= TEST_NUM_ASSETS; id++) {
+        HOST_TEST_ASSERT(create(id, &shard) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(shard == 0);
+    }
+
+    /* It is the layout of the filesystem on its own */
+    HOST_TEST_ASSERT(its_flash_fs_init_ctx(&fs_ctx, &area_cfg,
+                                           &its_flash_fs_ops_sim)
+                     == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_flash_fs_prepare(&fs_ctx) == PSA_SUCCESS);
+
+    HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num() == 1);
+    for (id = 1; id <= TEST_NUM_ASSETS; id++) {
+        HOST_TEST_ASSERT(exists(id));
+    }
+
+    return 0;
+}
+
+static int test_spilled_assets(void)
+{
+    uint32_t ids[TEST_NUM_ASSETS];
+    uint32_t spilled[TEST_NUM_ASSETS];
+    uint32_t num_full;
+    uint32_t num_spilled;
+    uint32_t shard;
+    uint32_t id;
+    uint32_t i;
+
+    HOST_TEST_ASSERT(setup() == 0);
+
+    num_full = fill_shard0(ids);
+    HOST_TEST_ASSERT(num_full > 0);
+    HOST_TEST_ASSERT(its_shards_num_spilled(0) == 0);
+
+    /* The next assets of shard 0 are stored in the other shards */
+    id = ids[num_full - 1] + 1;
+    for (num_spilled = 0; num_spilled < 3; num_spilled++) {
+        id = next_id(id, 0);
+        HOST_TEST_ASSERT(create(id, &shard) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(shard != 0);
+        spilled[num_spilled] = id++;
+    }
+    HOST_TEST_ASSERT(its_shards_num_spilled(0) == num_spilled);
+
+    /* They are found through the root after the next initialization */
+    HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num_spilled(0) == num_spilled);
+    for (i = 0; i < num_full; i++) {
+        HOST_TEST_ASSERT(exists(ids[i]));
+    }
+    for (i = 0; i < num_spilled; i++) {
+        HOST_TEST_ASSERT(exists(spilled[i]));
+    }
+
+    /* The count drops as they are removed */
+    for (i = 0; i < num_spilled; i++) {
+        HOST_TEST_ASSERT(delete(spilled[i]) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(its_shards_num_spilled(0) == num_spilled - i - 1);
+        HOST_TEST_ASSERT(!exists(spilled[i]));
+    }
+
+    /* Removing an asset stored in its own shard does not change it */
+    HOST_TEST_ASSERT(create(spilled[0], &shard) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num_spilled(0) == 1);
+    HOST_TEST_ASSERT(delete(ids[0]) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num_spilled(0) == 1);
+
+    HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(its_shards_num_spilled(0) == 1);
+    HOST_TEST_ASSERT(exists(spilled[0]));
+    HOST_TEST_ASSERT(!exists(ids[0]));
+
+    return 0;
+}
+
+static int power_cut_at_each_operation(bool cut_before)
+{
+    uint32_t ids[TEST_NUM_ASSETS];
+    uint32_t num_full;
+    uint32_t id;
+    uint32_t shard;
+    uint32_t cut;
+    uint32_t cycle;
+    uint32_t i;
+
+    HOST_TEST_ASSERT(setup() == 0);
+    num_full = fill_shard0(ids);
+    id = next_id(ids[num_full - 1] + 1, 0);
+
+    /* Each cycle creates and removes an asset stored out of its shard, which
+     * writes two root records.
+     */
+    for (cycle = 0; cycle < WARMUP_CYCLES; cycle++) {
+        HOST_TEST_ASSERT(create(id, &shard) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(delete(id) == PSA_SUCCESS);
+    }
+    HOST_TEST_ASSERT(its_flash_sim_is_erased(ITS_FLASH_SIM_BLOCK_SIZE,
+                                             ITS_FLASH_SIM_BLOCK_SIZE));
+    snapshot = its_flash_sim;
+
+    for (cut = 0; ; cut++) {
+        its_flash_sim = snapshot;
+        HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+
+        if (cut_before) {
+            its_flash_sim_power_on_cut_before(cut);
+        } else {
+            its_flash_sim_power_on(cut);
+        }
+        for (cycle = 0; cycle < SWEEP_CYCLES; cycle++) {
+            if ((create(id, &shard) != PSA_SUCCESS) ||
+                (delete(id) != PSA_SUCCESS)) {
+                break;
+            }
+        }
+
+        if (its_flash_sim.powered) {
+            /* The whole sequence ran before the power cut, and the root was
+             * written to the second root block.
+             */
+            HOST_TEST_ASSERT(cycle == SWEEP_CYCLES);
+            HOST_TEST_ASSERT(!its_flash_sim_is_erased(ITS_FLASH_SIM_BLOCK_SIZE,
+                                                      sizeof(uint32_t)));
+            break;
+        }
+
+        /* The layout is found, and the count of spilled assets covers the
+         * asset if it exists.
+         */
+        HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(its_shards_num() == TEST_NUM_SHARDS);
+        for (i = 0; i < num_full; i++) {
+            HOST_TEST_ASSERT(exists(ids[i]));
+        }
+        if (exists(id)) {
+            HOST_TEST_ASSERT(its_shards_num_spilled(0) >= 1);
+            HOST_TEST_ASSERT(delete(id) == PSA_SUCCESS);
+        }
+
+        /* The root can still be written, and read back */
+        HOST_TEST_ASSERT(create(id, &shard) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(shard != 0);
+        HOST_TEST_ASSERT(init(TEST_NUM_SHARDS) == PSA_SUCCESS);
+        HOST_TEST_ASSERT(exists(id));
+        HOST_TEST_ASSERT(its_shards_num_spilled(0) >= 1);
+    }
+
+    printf("%u power cuts\n", (unsigned)cut);
+
+    return 0;
+}
+
+static int test_power_cut_during_each_operation(void)
+{
+    return power_cut_at_each_operation(false);
+}
+
+static int test_power_cut_before_each_operation(void)
+{
+    return power_cut_at_each_operation(true);
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_layout, failures);
+    HOST_TEST_RUN(test_single_filesystem_is_kept, failures);
+    HOST_TEST_RUN(test_spilled_assets, failures);
+    HOST_TEST_RUN(test_power_cut_during_each_operation, failures);
+    HOST_TEST_RUN(test_power_cut_before_each_operation, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tests of the PS write-behind queue, on a mock of the PS object system. Each
+ * object write of the mock is atomic, as in the object system, so a power
+ * failure can only happen between two commits. After each commit, the test
+ * checks that the stored objects are the result of the set requests up to one
+ * of the completed requests, in order, which is the state left by a power
+ * failure at that point.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "ps_object_system.h"
+#include "ps_object_table.h"
+#include "ps_write_behind.h"
+#include "tfm_ps_req_mngr.h"
+
+#define CLIENT_ID           (-1)
+#define NUM_UIDS            3
+#define MAX_OBJECTS         8
+#define MAX_HISTORY         64
+
+struct object_t {
+    bool valid;
+    psa_storage_create_flags_t flags;
+    uint32_t size;
+    uint8_t data[PS_MAX_ASSET_SIZE];
+};
+
+/* Objects of the mock object system, by UID, which start at 1 */
+static struct object_t stored[NUM_UIDS + 1];
+
+/* Completed set requests, in order */
+struct set_t {
+    psa_storage_uid_t uid;
+    uint32_t size;
+    uint8_t seed;
+};
+static struct set_t history[MAX_HISTORY];
+static uint32_t history_len;
+
+/* Data of the request being handled */
+static uint8_t request_data[PS_MAX_ASSET_SIZE];
+static uint8_t reply_data[PS_MAX_ASSET_SIZE];
+
+static psa_storage_uid_t commit_log[MAX_HISTORY];
+static uint32_t commit_count;
+static psa_storage_uid_t fail_uid;
+static uint32_t prefix_violations;
+
+static void make_data(uint8_t *data, uint32_t size, uint8_t seed)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++) {
+        data[i] = (uint8_t)(seed + i);
+    }
+}
+
+/* Checks that the stored objects are the result of the first sets */
+static bool stored_matches(uint32_t len)
+{
+    struct object_t expected[NUM_UIDS + 1];
+    psa_storage_uid_t uid;
+    uint32_t i;
+
+    memset(expected, 0, sizeof(expected));
+    for (i = 0; i < len; i++) {
+        uid = history[i].uid;
+        expected[uid].valid = true;
+        expected[uid].size = history[i].size;
+        make_data(expected[uid].data, history[i].size, history[i].seed);
+    }
+
+    for (uid = 1; uid <= NUM_UIDS; uid++) {
+        if (expected[uid].valid != stored[uid].valid ||
+            expected[uid].size != stored[uid].size ||
+            memcmp(expected[uid].data, stored[uid].data,
+                   stored[uid].size) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Checks that the stored objects are the result of a prefix of the history */
+static bool stored_is_prefix(void)
+{
+    uint32_t len;
+
+    for (len = 0; len <= history_len; len++) {
+        if (stored_matches(len)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Mock of the object system */
+
+psa_status_t ps_object_create_from_buffer(psa_storage_uid_t uid,
+                                          int32_t client_id,
+                                       psa_storage_create_flags_t create_flags,
+                                          uint32_t size,
+                                          const uint8_t *data)
+{
+    (void)client_id;
+
+    if (uid == fail_uid) {
+        return PSA_ERROR_STORAGE_FAILURE;
+    }
+
+    stored[uid].valid = true;
+    stored[uid].flags = create_flags;
+    stored[uid].size = size;
+    memcpy(stored[uid].data, data, size);
+    commit_log[commit_count++] = uid;
+
+    /* A power failure may happen now */
+    if (!stored_is_prefix()) {
+        prefix_violations++;
+    }
+
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_object_get_info(psa_storage_uid_t uid, int32_t client_id,
+                                struct psa_storage_info_t *info)
+{
+    (void)client_id;
+
+    if (!stored[uid].valid) {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    info->size = stored[uid].size;
+    info->flags = stored[uid].flags;
+    return PSA_SUCCESS;
+}
+
+psa_status_t ps_object_table_obj_exist(psa_storage_uid_t uid,
+                                       int32_t client_id)
+{
+    (void)client_id;
+
+    return stored[uid].valid ? PSA_SUCCESS : PSA_ERROR_DOES_NOT_EXIST;
+}
+
+psa_status_t ps_object_table_check_free_fids(uint32_t fid_num)
+{
+    return (fid_num <= MAX_OBJECTS) ? PSA_SUCCESS
+                                    : PSA_ERROR_INSUFFICIENT_STORAGE;
+}
+
+psa_status_t ps_req_mngr_read_asset_data(uint8_t *out_data, uint32_t size)
+{
+    memcpy(out_data, request_data, size);
+    return PSA_SUCCESS;
+}
+
+void ps_req_mngr_write_asset_data(const uint8_t *in_data, uint32_t size)
+{
+    memcpy(reply_data, in_data, size);
+}
+
+/* Test helpers */
+
+static void reset(void)
+{
+    psa_storage_uid_t uid;
+
+    fail_uid = 0;
+    ps_write_behind_flush();
+    for (uid = 1; uid <= NUM_UIDS; uid++) {
+        ps_write_behind_clear_failure(CLIENT_ID, uid);
+    }
+
+    memset(stored, 0, sizeof(stored));
+    history_len = 0;
+    commit_count = 0;
+    prefix_violations = 0;
+}
+
+static psa_status_t set(psa_storage_uid_t uid, uint32_t size, uint8_t seed)
+{
+    psa_status_t status;
+
+    make_data(request_data, size, seed);
+    status = ps_write_behind_set(CLIENT_ID, uid, size, PSA_STORAGE_FLAG_NONE);
+    if (status == PSA_SUCCESS) {
+        history[history_len].uid = uid;
+        history[history_len].size = size;
+        history[history_len].seed = seed;
+        history_len++;
+    }
+
+    return status;
+}
+
+/* Returns true if the latest data of the object is the expected one */
+static bool get_is(psa_storage_uid_t uid, uint32_t size, uint8_t seed)
+{
+    uint8_t expected[PS_MAX_ASSET_SIZE];
+    size_t length = 0;
+
+    make_data(expected, size, seed);
+    if (ps_write_behind_get(CLIENT_ID, uid, 0, sizeof(reply_data), &length)
+        == PSA_SUCCESS) {
+        return length == size && memcmp(reply_data, expected, size) == 0;
+    }
+
+    /* The object is not queued, so it is read from the object system */
+    return stored[uid].valid && stored[uid].size == size &&
+           memcmp(stored[uid].data, expected, size) == 0;
+}
+
+/* Tests */
+
+static int test_commit_order(void)
+{
+    reset();
+
+    HOST_TEST_ASSERT(set(1, 4, 0x10) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 4, 0x20) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(3, 4, 0x30) == PSA_SUCCESS);
+
+    /* Nothing is written before the partition is idle */
+    HOST_TEST_ASSERT(commit_count == 0);
+    HOST_TEST_ASSERT(get_is(2, 4, 0x20));
+
+    while (ps_write_behind_pending()) {
+        HOST_TEST_ASSERT(ps_write_behind_commit_one() == PSA_SUCCESS);
+    }
+
+    HOST_TEST_ASSERT(commit_count == 3);
+    HOST_TEST_ASSERT(commit_log[0] == 1);
+    HOST_TEST_ASSERT(commit_log[1] == 2);
+    HOST_TEST_ASSERT(commit_log[2] == 3);
+    HOST_TEST_ASSERT(prefix_violations == 0);
+
+    return 0;
+}
+
+static int test_full_queue_commits_oldest(void)
+{
+    reset();
+
+    HOST_TEST_ASSERT(set(1, 4, 0x10) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 4, 0x20) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(3, 4, 0x30) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(1, 4, 0x11) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(commit_count == 0);
+
+    /* The queue is full: the oldest set is committed first */
+    HOST_TEST_ASSERT(set(2, 4, 0x21) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(commit_count == 1);
+    HOST_TEST_ASSERT(commit_log[0] == 1);
+    HOST_TEST_ASSERT(stored[1].data[0] == 0x10);
+
+    /* Reads return the latest set, queued or stored */
+    HOST_TEST_ASSERT(get_is(1, 4, 0x11));
+    HOST_TEST_ASSERT(get_is(2, 4, 0x21));
+    HOST_TEST_ASSERT(get_is(3, 4, 0x30));
+
+    ps_write_behind_flush();
+    HOST_TEST_ASSERT(commit_count == 5);
+    HOST_TEST_ASSERT(get_is(1, 4, 0x11));
+    HOST_TEST_ASSERT(get_is(2, 4, 0x21));
+    HOST_TEST_ASSERT(prefix_violations == 0);
+
+    return 0;
+}
+
+static int test_coalesce_newest(void)
+{
+    reset();
+
+    HOST_TEST_ASSERT(set(1, 4, 0x10) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 4, 0x20) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 8, 0x22) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 2, 0x24) == PSA_SUCCESS);
+
+    ps_write_behind_flush();
+
+    /* The sets of the newest queued object are written once */
+    HOST_TEST_ASSERT(commit_count == 2);
+    HOST_TEST_ASSERT(get_is(2, 2, 0x24));
+    HOST_TEST_ASSERT(prefix_violations == 0);
+
+    return 0;
+}
+
+static int test_power_failure_prefix(void)
+{
+    uint32_t i;
+    psa_storage_uid_t uid;
+
+    reset();
+
+    /* Sets interleaved with idle commits and full queue commits. Each commit
+     * checks the state a power failure would leave.
+     */
+    for (i = 0; i < 40; i++) {
+        uid = 1 + (i * 7 + i / 3) % NUM_UIDS;
+        HOST_TEST_ASSERT(set(uid, 1 + i % PS_MAX_ASSET_SIZE, (uint8_t)i)
+                         == PSA_SUCCESS);
+        if (i % 5 == 0) {
+            HOST_TEST_ASSERT(ps_write_behind_commit_one() == PSA_SUCCESS);
+        }
+    }
+
+    ps_write_behind_flush();
+    HOST_TEST_ASSERT(commit_count > 0);
+    HOST_TEST_ASSERT(prefix_violations == 0);
+
+    /* Once the queue is drained, the stored objects are the latest sets */
+    HOST_TEST_ASSERT(stored_matches(history_len));
+
+    return 0;
+}
+
+static int test_failure_reported_on_object(void)
+{
+    struct psa_storage_info_t info;
+    size_t length;
+
+    reset();
+
+    /* Object 2 has a stored version */
+    HOST_TEST_ASSERT(set(2, 4, 0x20) == PSA_SUCCESS);
+    ps_write_behind_flush();
+
+    HOST_TEST_ASSERT(set(1, 4, 0x10) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 4, 0x21) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(3, 4, 0x30) == PSA_SUCCESS);
+
+    fail_uid = 2;
+    HOST_TEST_ASSERT(ps_write_behind_commit_one() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(ps_write_behind_commit_one() ==
+                     PSA_ERROR_STORAGE_FAILURE);
+
+    /* The objects queued after the failed one are still committed */
+    HOST_TEST_ASSERT(ps_write_behind_commit_one() == PSA_SUCCESS);
+    HOST_TEST_ASSERT(!ps_write_behind_pending());
+    fail_uid = 0;
+
+    /* Requests of the other objects do not see the failure */
+    HOST_TEST_ASSERT(get_is(1, 4, 0x10));
+    HOST_TEST_ASSERT(get_is(3, 4, 0x30));
+    HOST_TEST_ASSERT(set(1, 4, 0x12) == PSA_SUCCESS);
+
+    /* The failed object keeps its stored version, and the failure is
+     * reported once by its next read.
+     */
+    HOST_TEST_ASSERT(stored[2].data[0] == 0x20);
+    HOST_TEST_ASSERT(ps_write_behind_get_info(CLIENT_ID, 2, &info) ==
+                     PSA_ERROR_STORAGE_FAILURE);
+    HOST_TEST_ASSERT(ps_write_behind_get(CLIENT_ID, 2, 0, 4, &length) ==
+                     PSA_ERROR_DOES_NOT_EXIST);
+    HOST_TEST_ASSERT(ps_write_behind_get_info(CLIENT_ID, 2, &info) ==
+                     PSA_ERROR_DOES_NOT_EXIST);
+
+    return 0;
+}
+
+static int test_failure_on_full_queue(void)
+{
+    size_t length;
+
+    reset();
+
+    HOST_TEST_ASSERT(set(1, 4, 0x10) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 4, 0x20) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(3, 4, 0x30) == PSA_SUCCESS);
+    HOST_TEST_ASSERT(set(2, 4, 0x21) == PSA_SUCCESS);
+
+    /* The commit of object 1 forced by the full queue fails, but the set of
+     * object 3 is queued.
+     */
+    fail_uid = 1;
+    HOST_TEST_ASSERT(set(3, 4, 0x31) == PSA_SUCCESS);
+    fail_uid = 0;
+    HOST_TEST_ASSERT(get_is(3, 4, 0x31));
+
+    HOST_TEST_ASSERT(ps_write_behind_get(CLIENT_ID, 1, 0, 4, &length) ==
+                     PSA_ERROR_STORAGE_FAILURE);
+
+    return 0;
+}
+
+static int test_failure_cleared_by_set(void)
+{
+    size_t length;
+
+    reset();
+
+    HOST_TEST_ASSERT(set(1, 4, 0x10) == PSA_SUCCESS);
+    fail_uid = 1;
+    ps_write_behind_flush();
+    fail_uid = 0;
+
+    /* A new set replaces the data which failed to be written */
+    HOST_TEST_ASSERT(set(1, 4, 0x11) == PSA_SUCCESS);
+    ps_write_behind_flush();
+    HOST_TEST_ASSERT(get_is(1, 4, 0x11));
+    HOST_TEST_ASSERT(ps_write_behind_get(CLIENT_ID, 1, 0, 4, &length) ==
+                     PSA_ERROR_DOES_NOT_EXIST);
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_commit_order, failures);
+    HOST_TEST_RUN(test_full_queue_commits_oldest, failures);
+    HOST_TEST_RUN(test_coalesce_newest, failures);
+    HOST_TEST_RUN(test_power_failure_prefix, failures);
+    HOST_TEST_RUN(test_failure_reported_on_object, failures);
+    HOST_TEST_RUN(test_failure_on_full_queue, failures);
+    HOST_TEST_RUN(test_failure_cleared_by_set, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
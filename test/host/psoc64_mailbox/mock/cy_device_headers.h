@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Host mock of the PSoC64 device headers. An IPC channel and an IPC interrupt
+ * structure only hold the state used by the mailbox HAL.
+ */
+
+#ifndef __CY_DEVICE_HEADERS_H__
+#define __CY_DEVICE_HEADERS_H__
+
+#include <stdint.h>
+
+#define MOCK_IPC_NUM_CHANNELS       16
+#define MOCK_IPC_NUM_INTR_STRUCTS   16
+
+typedef struct {
+    uint32_t acquired;          /* The channel lock is held */
+    uint32_t data;              /* DATA register */
+    void *ptr;                  /* DATA register holding a host pointer */
+    uint32_t lock_attempts;     /* Attempts to acquire the channel lock */
+} IPC_STRUCT_Type;
+
+typedef struct {
+    uint32_t intr;              /* Release events in bits [15:0], notify
+                                 * events in bits [31:16]
+                                 */
+    uint32_t mask;
+} IPC_INTR_STRUCT_Type;
+
+extern IPC_STRUCT_Type mock_ipc_struct[MOCK_IPC_NUM_CHANNELS];
+extern IPC_INTR_STRUCT_Type mock_ipc_intr_struct[MOCK_IPC_NUM_INTR_STRUCTS];
+
+#endif /* __CY_DEVICE_HEADERS_H__ */
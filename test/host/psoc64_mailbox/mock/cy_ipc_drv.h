@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Host mock of the PDL IPC driver. The channels and the interrupt structures
+ * follow the hardware: releasing a channel raises a release event and writing
+ * its NOTIFY register raises a notify event in the interrupt structures of
+ * the given mask, whether the channel is locked or not.
+ */
+
+#ifndef __CY_IPC_DRV_H__
+#define __CY_IPC_DRV_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmsis_compiler.h"
+#include "cy_device_headers.h"
+
+#define CY_IPC_NO_NOTIFICATION      (uint32_t)(0x00000000UL)
+
+typedef enum {
+    CY_IPC_DRV_SUCCESS = 0,
+    CY_IPC_DRV_ERROR,
+} cy_en_ipcdrv_status_t;
+
+/* Called after each failed attempt to acquire a channel lock, if set */
+extern void (*mock_ipc_lock_failed_hook)(IPC_STRUCT_Type *base);
+
+__STATIC_INLINE uint32_t mock_ipc_chan(IPC_STRUCT_Type const *base)
+{
+    return (uint32_t)(base - mock_ipc_struct);
+}
+
+__STATIC_INLINE void mock_ipc_raise(uint32_t events, uint32_t intr_mask)
+{
+    uint32_t i;
+
+    for (i = 0; i < MOCK_IPC_NUM_INTR_STRUCTS; i++) {
+        if (intr_mask & (1UL << i)) {
+            mock_ipc_intr_struct[i].intr |= events;
+        }
+    }
+}
+
+__STATIC_INLINE IPC_STRUCT_Type *Cy_IPC_Drv_GetIpcBaseAddress(
+                                                            uint32_t ipcIndex)
+{
+    return &mock_ipc_struct[ipcIndex];
+}
+
+__STATIC_INLINE IPC_INTR_STRUCT_Type *Cy_IPC_Drv_GetIntrBaseAddr(
+                                                        uint32_t ipcIntrIndex)
+{
+    return &mock_ipc_intr_struct[ipcIntrIndex];
+}
+
+__STATIC_INLINE void Cy_IPC_Drv_SetInterruptMask(IPC_INTR_STRUCT_Type *base,
+                                                 uint32_t ipcReleaseMask,
+                                                 uint32_t ipcNotifyMask)
+{
+    base->mask = ipcReleaseMask | (ipcNotifyMask << 16);
+}
+
+__STATIC_INLINE uint32_t Cy_IPC_Drv_GetInterruptStatus(
+                                            IPC_INTR_STRUCT_Type const *base)
+{
+    return base->intr;
+}
+
+__STATIC_INLINE uint32_t Cy_IPC_Drv_GetInterruptStatusMasked(
+                                            IPC_INTR_STRUCT_Type const *base)
+{
+    return base->intr & base->mask;
+}
+
+__STATIC_INLINE void Cy_IPC_Drv_ClearInterrupt(IPC_INTR_STRUCT_Type *base,
+                                               uint32_t ipcReleaseMask,
+                                               uint32_t ipcNotifyMask)
+{
+    base->intr &= ~(ipcReleaseMask | (ipcNotifyMask << 16));
+}
+
+__STATIC_INLINE void Cy_IPC_Drv_AcquireNotify(IPC_STRUCT_Type *base,
+                                              uint32_t notifyEventIntr)
+{
+    mock_ipc_raise(1UL << (mock_ipc_chan(base) + 16), notifyEventIntr);
+}
+
+__STATIC_INLINE void Cy_IPC_Drv_WriteDataValue(IPC_STRUCT_Type *base,
+                                               uint32_t dataValue)
+{
+    base->data = dataValue;
+}
+
+__STATIC_INLINE uint32_t Cy_IPC_Drv_ReadDataValue(IPC_STRUCT_Type const *base)
+{
+    return base->data;
+}
+
+__STATIC_INLINE cy_en_ipcdrv_status_t Cy_IPC_Drv_LockAcquire(
+                                                IPC_STRUCT_Type const *base)
+{
+    IPC_STRUCT_Type *chan = &mock_ipc_struct[mock_ipc_chan(base)];
+
+    chan->lock_attempts++;
+    if (chan->acquired) {
+        if (mock_ipc_lock_failed_hook != NULL) {
+            mock_ipc_lock_failed_hook(chan);
+        }
+        return CY_IPC_DRV_ERROR;
+    }
+
+    chan->acquired = 1;
+    return CY_IPC_DRV_SUCCESS;
+}
+
+__STATIC_INLINE cy_en_ipcdrv_status_t Cy_IPC_Drv_LockRelease(
+                                                IPC_STRUCT_Type *base,
+                                                uint32_t releaseEventIntr)
+{
+    if (!base->acquired) {
+        return CY_IPC_DRV_ERROR;
+    }
+
+    base->acquired = 0;
+    mock_ipc_raise(1UL << mock_ipc_chan(base), releaseEventIntr);
+    return CY_IPC_DRV_SUCCESS;
+}
+
+__STATIC_INLINE void Cy_IPC_Drv_ReleaseNotify(IPC_STRUCT_Type *base,
+                                              uint32_t notifyEventIntr)
+{
+    (void)Cy_IPC_Drv_LockRelease(base, notifyEventIntr);
+}
+
+__STATIC_INLINE cy_en_ipcdrv_status_t Cy_IPC_Drv_SendMsgWord(
+                                                IPC_STRUCT_Type *base,
+                                                uint32_t notifyEventIntr,
+                                                uint32_t message)
+{
+    if (Cy_IPC_Drv_LockAcquire(base) != CY_IPC_DRV_SUCCESS) {
+        return CY_IPC_DRV_ERROR;
+    }
+
+    base->data = message;
+    Cy_IPC_Drv_AcquireNotify(base, notifyEventIntr);
+    return CY_IPC_DRV_SUCCESS;
+}
+
+__STATIC_INLINE cy_en_ipcdrv_status_t Cy_IPC_Drv_ReadMsgWord(
+                                                IPC_STRUCT_Type const *base,
+                                                uint32_t *message)
+{
+    if (!base->acquired) {
+        return CY_IPC_DRV_ERROR;
+    }
+
+    *message = base->data;
+    return CY_IPC_DRV_SUCCESS;
+}
+
+__STATIC_INLINE cy_en_ipcdrv_status_t Cy_IPC_Drv_SendMsgPtr(
+                                                IPC_STRUCT_Type *base,
+                                                uint32_t notifyEventIntr,
+                                                void const *msgPtr)
+{
+    if (Cy_IPC_Drv_LockAcquire(base) != CY_IPC_DRV_SUCCESS) {
+        return CY_IPC_DRV_ERROR;
+    }
+
+    base->ptr = (void *)msgPtr;
+    Cy_IPC_Drv_AcquireNotify(base, notifyEventIntr);
+    return CY_IPC_DRV_SUCCESS;
+}
+
+__STATIC_INLINE cy_en_ipcdrv_status_t Cy_IPC_Drv_ReadMsgPtr(
+                                                IPC_STRUCT_Type const *base,
+                                                void **msgPtr)
+{
+    if (!base->acquired) {
+        return CY_IPC_DRV_ERROR;
+    }
+
+    *msgPtr = base->ptr;
+    return CY_IPC_DRV_SUCCESS;
+}
+
+#endif /* __CY_IPC_DRV_H__ */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host mock of the PDL system interrupt driver, unused by the tests */
+
+#ifndef __CY_SYSINT_H__
+#define __CY_SYSINT_H__
+
+#endif /* __CY_SYSINT_H__ */
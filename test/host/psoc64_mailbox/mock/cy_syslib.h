@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/* Host mock of the PDL system library. The tests run in a single thread. */
+
+#ifndef __CY_SYSLIB_H__
+#define __CY_SYSLIB_H__
+
+#include <stdint.h>
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+#endif /* __CY_SYSLIB_H__ */
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Tests of the PSoC64 mailbox lock and doorbell, on a mock of the IPC driver.
+ * The HAL is built as the SPE side, on the Cortex-M0+. The NSPE side, the
+ * peer core, is simulated by the tests through the mock IPC registers, and
+ * from the WFE hook while the SPE side sleeps.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host_test.h"
+#include "cy_ipc_drv.h"
+#include "platform_multicore.h"
+#include "spe_ipc_config.h"
+
+/* IPC interrupt structure of the NSPE side */
+#define PEER_INTR_STRUCT    IPC_PSA_CLIENT_REPLY_INTR_STRUCT
+
+IPC_STRUCT_Type mock_ipc_struct[MOCK_IPC_NUM_CHANNELS];
+IPC_INTR_STRUCT_Type mock_ipc_intr_struct[MOCK_IPC_NUM_INTR_STRUCTS];
+void (*mock_ipc_lock_failed_hook)(IPC_STRUCT_Type *base);
+
+static uint32_t wfe_count;
+static uint32_t sev_count;
+/* Number of WFE after which the peer releases the mailbox lock, or 0 */
+static uint32_t peer_release_after_wfes;
+
+static IPC_STRUCT_Type *lock_chan = &mock_ipc_struct[IPC_PSA_MAILBOX_LOCK_CHAN];
+
+static void peer_release_lock(void)
+{
+    /* As platform_mailbox_lock_release() on the NSPE side */
+    (void)Cy_IPC_Drv_LockRelease(lock_chan, IPC_PSA_CLIENT_CALL_NOTIFY_MASK);
+    host_sev();
+}
+
+void host_wfe(void)
+{
+    wfe_count++;
+
+    if ((peer_release_after_wfes != 0) &&
+        (wfe_count == peer_release_after_wfes)) {
+        peer_release_lock();
+    }
+}
+
+void host_sev(void)
+{
+    sev_count++;
+}
+
+static void mock_reset(void)
+{
+    memset(mock_ipc_struct, 0, sizeof(mock_ipc_struct));
+    memset(mock_ipc_intr_struct, 0, sizeof(mock_ipc_intr_struct));
+    mock_ipc_lock_failed_hook = NULL;
+    wfe_count = 0;
+    sev_count = 0;
+    peer_release_after_wfes = 0;
+}
+
+static int test_lock_uncontended(void)
+{
+    struct platform_mailbox_stats_t before;
+    struct platform_mailbox_stats_t after;
+
+    mock_reset();
+    platform_mailbox_get_stats(&before);
+
+    platform_mailbox_lock_acquire();
+    HOST_TEST_ASSERT(lock_chan->acquired);
+    HOST_TEST_ASSERT(lock_chan->lock_attempts == 1);
+    HOST_TEST_ASSERT(wfe_count == 0);
+
+    platform_mailbox_lock_release();
+    HOST_TEST_ASSERT(!lock_chan->acquired);
+
+    /* The release event is raised for the peer, which is woken up */
+    HOST_TEST_ASSERT(mock_ipc_intr_struct[PEER_INTR_STRUCT].intr &
+                     IPC_PSA_MAILBOX_LOCK_RELEASE_MASK);
+    HOST_TEST_ASSERT(sev_count == 1);
+
+    platform_mailbox_get_stats(&after);
+    HOST_TEST_ASSERT(after.lock_acquires == before.lock_acquires + 1);
+    HOST_TEST_ASSERT(after.lock_contended == before.lock_contended);
+
+    return 0;
+}
+
+static int test_lock_contended_sleeps(void)
+{
+    struct platform_mailbox_stats_t before;
+    struct platform_mailbox_stats_t after;
+
+    mock_reset();
+    platform_mailbox_get_stats(&before);
+
+    /* The peer holds the lock, and releases it during the third WFE */
+    lock_chan->acquired = 1;
+    peer_release_after_wfes = 3;
+
+    platform_mailbox_lock_acquire();
+    HOST_TEST_ASSERT(lock_chan->acquired);
+
+    /* The lock is only tried again after its release, not in a loop */
+    HOST_TEST_ASSERT(lock_chan->lock_attempts == 2);
+    HOST_TEST_ASSERT(wfe_count == 3);
+
+    platform_mailbox_get_stats(&after);
+    HOST_TEST_ASSERT(after.lock_acquires == before.lock_acquires + 1);
+    HOST_TEST_ASSERT(after.lock_contended == before.lock_contended + 1);
+    HOST_TEST_ASSERT(after.lock_waits == before.lock_waits + 1);
+    HOST_TEST_ASSERT(after.lock_wfes == before.lock_wfes + 3);
+    HOST_TEST_ASSERT(after.lock_max_waits >= 1);
+
+    platform_mailbox_lock_release();
+
+    return 0;
+}
+
+static int test_lock_stale_release_ignored(void)
+{
+    mock_reset();
+
+    /* A release event of a previous critical section of the peer is pending
+     * while the peer holds the lock again.
+     */
+    mock_ipc_intr_struct[IPC_RX_INTR_STRUCT].intr |=
+                                            IPC_PSA_MAILBOX_LOCK_RELEASE_MASK;
+    lock_chan->acquired = 1;
+    peer_release_after_wfes = 1;
+
+    platform_mailbox_lock_acquire();
+    HOST_TEST_ASSERT(lock_chan->acquired);
+    HOST_TEST_ASSERT(lock_chan->lock_attempts == 2);
+    HOST_TEST_ASSERT(wfe_count == 1);
+
+    platform_mailbox_lock_release();
+
+    return 0;
+}
+
+static void peer_release_on_failed_attempt(IPC_STRUCT_Type *base)
+{
+    if (base == lock_chan) {
+        mock_ipc_lock_failed_hook = NULL;
+        peer_release_lock();
+    }
+}
+
+static int test_lock_release_before_wait(void)
+{
+    mock_reset();
+
+    /* The peer releases the lock between the failed attempt and the wait */
+    lock_chan->acquired = 1;
+    mock_ipc_lock_failed_hook = peer_release_on_failed_attempt;
+
+    platform_mailbox_lock_acquire();
+    HOST_TEST_ASSERT(lock_chan->acquired);
+    HOST_TEST_ASSERT(lock_chan->lock_attempts == 2);
+    HOST_TEST_ASSERT(wfe_count == 0);
+
+    platform_mailbox_lock_release();
+
+    return 0;
+}
+
+static int test_doorbell_ring(void)
+{
+    IPC_STRUCT_Type *doorbell = &mock_ipc_struct[IPC_TX_DOORBELL_CHAN];
+    struct platform_mailbox_stats_t before;
+    struct platform_mailbox_stats_t after;
+    uint32_t notify = 1UL << (IPC_TX_DOORBELL_CHAN + 16);
+    uint32_t value;
+
+    mock_reset();
+    platform_mailbox_get_stats(&before);
+
+    /* The data channel holds a message which the peer has not read */
+    mock_ipc_struct[IPC_TX_CHAN].acquired = 1;
+
+    platform_mailbox_ring_doorbell();
+    value = doorbell->data;
+    HOST_TEST_ASSERT(mock_ipc_intr_struct[PEER_INTR_STRUCT].intr & notify);
+    HOST_TEST_ASSERT(sev_count == 1);
+
+    /* The peer has not handled the first ring yet */
+    platform_mailbox_ring_doorbell();
+    HOST_TEST_ASSERT(doorbell->data == value + 1);
+    HOST_TEST_ASSERT(sev_count == 2);
+
+    /* No channel lock is taken to ring the doorbell */
+    HOST_TEST_ASSERT(doorbell->lock_attempts == 0);
+    HOST_TEST_ASSERT(mock_ipc_struct[IPC_TX_CHAN].lock_attempts == 0);
+    HOST_TEST_ASSERT(lock_chan->lock_attempts == 0);
+
+    platform_mailbox_get_stats(&after);
+    HOST_TEST_ASSERT(after.doorbell_rings == before.doorbell_rings + 2);
+
+    /* The notify event raises the interrupt of the peer */
+    HOST_TEST_ASSERT((IPC_PSA_CLIENT_REPLY_INTR_MASK <<
+                      CY_IPC_NOTIFY_SHIFT) & notify);
+
+    return 0;
+}
+
+static int test_doorbell_rung(void)
+{
+    IPC_STRUCT_Type *doorbell = &mock_ipc_struct[IPC_RX_DOORBELL_CHAN];
+
+    mock_reset();
+
+    HOST_TEST_ASSERT(!platform_mailbox_doorbell_rung());
+
+    /* As platform_mailbox_ring_doorbell() on the NSPE side */
+    doorbell->data++;
+    HOST_TEST_ASSERT(platform_mailbox_doorbell_rung());
+    HOST_TEST_ASSERT(!platform_mailbox_doorbell_rung());
+
+    /* Rings since the previous check are reported once */
+    doorbell->data += 3;
+    HOST_TEST_ASSERT(platform_mailbox_doorbell_rung());
+    HOST_TEST_ASSERT(!platform_mailbox_doorbell_rung());
+
+    /* The doorbell word wraps around */
+    doorbell->data = UINT32_MAX;
+    HOST_TEST_ASSERT(platform_mailbox_doorbell_rung());
+    doorbell->data++;
+    HOST_TEST_ASSERT(platform_mailbox_doorbell_rung());
+
+    return 0;
+}
+
+int main(void)
+{
+    int failures = 0;
+
+    HOST_TEST_RUN(test_lock_uncontended, failures);
+    HOST_TEST_RUN(test_lock_contended_sleeps, failures);
+    HOST_TEST_RUN(test_lock_stale_release_ignored, failures);
+    HOST_TEST_RUN(test_lock_release_before_wait, failures);
+    HOST_TEST_RUN(test_doorbell_ring, failures);
+    HOST_TEST_RUN(test_doorbell_rung, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
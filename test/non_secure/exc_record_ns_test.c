@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "exc_record_test_defs.h"
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "psa/client.h"
+#include "psa_manifest/pid.h"
+#include "psa_manifest/sid.h"
+
+static struct tfm_exc_record_t record_before, record_after;
+
+static int32_t exc_record_read(struct tfm_exc_record_t *record)
+{
+    if (extra_ns_call(TFM_EXC_RECORD_TEST_SERVICE_HANDLE, EXC_RECORD_TEST_READ,
+                      record, sizeof(*record)) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+static const struct tfm_exc_record_counters_t *exc_record_find(
+                                        const struct tfm_exc_record_t *record,
+                                        int32_t partition_id)
+{
+    size_t i;
+
+    for (i = 0; i < EXC_RECORD_PARTITIONS; i++) {
+        if (record->counters[i].partition_id == partition_id) {
+            return &record->counters[i];
+        }
+    }
+
+    return NULL;
+}
+
+static uint32_t exc_record_pendsv_total(const struct tfm_exc_record_t *record)
+{
+    uint32_t total = 0;
+    size_t i;
+
+    for (i = 0; i < EXC_RECORD_PARTITIONS; i++) {
+        total += record->counters[i].pendsv;
+    }
+
+    return total;
+}
+
+/*
+ * Reads the record twice. The second request needs at least one PendSV to
+ * switch to the service, which must be counted, and the record of the boot
+ * must not change in between.
+ */
+int32_t exc_record_ns_test(void)
+{
+    const struct tfm_exc_record_counters_t *p_counters;
+
+    if ((exc_record_read(&record_before) != EXTRA_TEST_SUCCESS) ||
+        (exc_record_read(&record_after) != EXTRA_TEST_SUCCESS)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    if ((record_before.boots == 0) ||
+        (record_after.boots != record_before.boots) ||
+        (record_after.recorded < record_before.recorded)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* The service partition has its counters, and has not faulted */
+    p_counters = exc_record_find(&record_after, TFM_SP_EXC_RECORD_TEST);
+    if ((p_counters == NULL) || (p_counters->faults != 0)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    if (exc_record_pendsv_total(&record_after) ==
+        exc_record_pendsv_total(&record_before)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __EXTRA_NS_SUITES_H__
+#define __EXTRA_NS_SUITES_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Each suite returns EXTRA_TEST_SUCCESS, or the negative line of its first
+ * failed check, so that a failure can be located from the returned value.
+ */
+#define EXTRA_NS_TEST_FAILED (-(int32_t)__LINE__)
+
+/**
+ * \brief Makes a request without input vector and with at most one output
+ *        vector, the request of most test services
+ *
+ * \param[in]  handle           The handle of the test service.
+ * \param[in]  type             The type of the request.
+ * \param[out] out              The output buffer, or NULL for none.
+ * \param[in]  out_size         The size of \p out.
+ *
+ * \return The status of the request
+ */
+psa_status_t extra_ns_call(psa_handle_t handle, int32_t type,
+                           void *out, size_t out_size);
+
+/**
+ * \brief Checks that ITS only maps a published uid/value pair for the readers
+ *        declared by its owner
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t its_shared_map_ns_test(void);
+
+/**
+ * \brief Checks that the non-secure side runs between the requests while ITS
+ *        erases the scratch blocks of an update in the background
+ *
+ * \note The ITS filesystem must have more than two blocks, so that an update
+ *       leaves more than one sector to erase.
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t its_background_erase_ns_test(void);
+
+/**
+ * \brief Checks that ITS stores assets until it is full or ITS_NUM_ASSETS
+ *        are stored, whatever shards they are hashed to
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t its_shard_ns_test(void);
+
+/**
+ * \brief Checks the default ITS encryption HAL against known answers, and
+ *        prints its throughput
+ *
+ * \note The known answers are only checked with the dummy HUK of
+ *       TFM_DUMMY_PROVISIONING.
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t its_encryption_ns_test(void);
+
+/**
+ * \brief Checks that the hashes the PSA proxy computes locally are the same as
+ *        those of the multipart and cloned operations, which it forwards to
+ *        the Secure Enclave, for every algorithm it serves
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t psa_proxy_hash_ns_test(void);
+
+/**
+ * \brief Checks that the lazily loaded test partitions are started by their
+ *        first request, and that a stack pool smaller than their stacks
+ *        refuses the second one
+ *
+ * \note No other lazily loaded partition may be loaded before the suite runs
+ *       when CONFIG_TFM_SPM_LAZY_STACK_POOL_SIZE is set.
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t lazy_load_ns_test(void);
+
+/**
+ * \brief Checks that the FP registers of a partition survive the switches to
+ *        partitions which use FP and which do not, and its preemption when
+ *        the partition timer is available, then prints the cost of the
+ *        switches to each kind of partition
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t fp_ns_test(void);
+
+/**
+ * \brief Checks that the calls of a batch are all made and report their own
+ *        status, then prints the ticks between the first and the last calls
+ *        of batched and unbatched rounds
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t psa_call_batch_ns_test(void);
+
+/**
+ * \brief Reads the exception record through a test service, and checks that
+ *        the PendSVs taken for the requests are counted
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t exc_record_ns_test(void);
+
+/**
+ * \brief Makes connection based requests with 0 to PSA_MAX_IOVEC vectors of
+ *        several sizes, then prints the SPM API statistics for
+ *        tools/spm_api_stats.py
+ *
+ * \return EXTRA_TEST_SUCCESS, or EXTRA_NS_TEST_FAILED of the failed check
+ */
+int32_t spm_api_bench_ns_test(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EXTRA_NS_SUITES_H__ */
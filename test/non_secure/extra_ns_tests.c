@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+
+psa_status_t extra_ns_call(psa_handle_t handle, int32_t type,
+                           void *out, size_t out_size)
+{
+    psa_outvec out_vec[] = {{out, out_size}};
+
+    return psa_call(handle, type, NULL, 0, out_vec, (out != NULL) ? 1 : 0);
+}
+
+/* The suites of the features enabled in the build */
+static int32_t (*const extra_ns_suites[])(void) = {
+#ifdef ITS_SHARED_MAP
+    its_shared_map_ns_test,
+#endif
+#if defined(ITS_BACKGROUND_ERASE) && defined(ITS_STATS)
+    its_background_erase_ns_test,
+#endif
+#ifdef TFM_PARTITION_INTERNAL_TRUSTED_STORAGE
+    its_shard_ns_test,
+#endif
+#ifdef PLATFORM_DEFAULT_ITS_ENCRYPTION
+    its_encryption_ns_test,
+#endif
+#ifdef PSA_PROXY_LOCAL_CRYPTO
+    psa_proxy_hash_ns_test,
+#endif
+#ifdef CONFIG_TFM_SPM_LAZY_LOAD
+    lazy_load_ns_test,
+#endif
+#if defined(CONFIG_TFM_SPE_FP) && (CONFIG_TFM_SPE_FP > 0)
+    fp_ns_test,
+#endif
+#ifdef PSA_CALL_BATCH_TEST
+    psa_call_batch_ns_test,
+#endif
+#ifdef TFM_EXCEPTION_INFO_RECORD
+    exc_record_ns_test,
+#endif
+    /* Last, so that its report covers the requests of the other suites */
+#ifdef CONFIG_TFM_SPM_API_STATS
+    spm_api_bench_ns_test,
+#endif
+    NULL,
+};
+
+static int32_t extra_ns_test(void)
+{
+    int32_t ret;
+    size_t i;
+
+    for (i = 0; extra_ns_suites[i] != NULL; i++) {
+        ret = extra_ns_suites[i]();
+        if (ret != EXTRA_TEST_SUCCESS) {
+            return ret;
+        }
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+static const struct extra_tests_t plat_ns_t = {
+    .test_entry = extra_ns_test,
+    .expected_ret = EXTRA_TEST_SUCCESS
+};
+
+int32_t extra_ns_tests_init(struct extra_tests_t *internal_test_t)
+{
+    return register_extra_tests(internal_test_t, &plat_ns_t);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "fp_test_defs.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+
+int32_t fp_ns_test(void)
+{
+    struct fp_test_bench_t bench;
+    psa_status_t status;
+
+    if (extra_ns_call(TFM_FP_CHECK_SERVICE_HANDLE, FP_TEST_CHECK_SWITCH,
+                      NULL, 0) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* The preemption is only checked with the partition timer */
+    status = extra_ns_call(TFM_FP_CHECK_SERVICE_HANDLE, FP_TEST_CHECK_PREEMPT,
+                           NULL, 0);
+    if ((status != PSA_SUCCESS) && (status != PSA_ERROR_NOT_SUPPORTED)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    if (extra_ns_call(TFM_FP_CHECK_SERVICE_HANDLE, FP_TEST_CHECK_BENCH,
+                      &bench, sizeof(bench)) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    printf("[FP] %u psa_call round trips: %u ticks to an FP partition, "
+           "%u ticks to a non-FP partition\r\n", (unsigned int)bench.rounds,
+           (unsigned int)bench.fp_ticks, (unsigned int)bench.no_fp_ticks);
+
+    return EXTRA_TEST_SUCCESS;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "psa/client.h"
+#include "psa/internal_trusted_storage.h"
+#include "psa_manifest/sid.h"
+
+#define TEST_UID            0x2000U
+
+/*
+ * Each request lets ITS erase one sector in the background, so this bounds
+ * the number of requests needed to erase the scratch blocks of an update.
+ */
+#define TEST_MAX_REQUESTS   256U
+
+static const uint8_t test_data[] = "ITS background erase test data";
+
+static psa_status_t erase_pending(uint32_t *pending)
+{
+    return extra_ns_call(TFM_ITS_ERASE_PROBE_SERVICE_HANDLE, PSA_IPC_CALL,
+                         pending, sizeof(*pending));
+}
+
+int32_t its_background_erase_ns_test(void)
+{
+    uint32_t pending;
+    uint32_t i;
+
+    /* The update leaves its scratch blocks to erase in the background */
+    if (psa_its_set(TEST_UID, sizeof(test_data), test_data,
+                    PSA_STORAGE_FLAG_NONE) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* The non-secure side runs again before the erase has completed */
+    if (erase_pending(&pending) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (pending == 0) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* The erase still completes, one sector after each request */
+    for (i = 0; (i < TEST_MAX_REQUESTS) && (pending != 0); i++) {
+        if (erase_pending(&pending) != PSA_SUCCESS) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+    }
+    if (pending != 0) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    if (psa_its_remove(TEST_UID) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "its_enc_test_defs.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+
+int32_t its_encryption_ns_test(void)
+{
+    psa_status_t status;
+
+    /* The known answers are only built for the dummy HUK */
+    status = extra_ns_call(TFM_ITS_ENC_TEST_SERVICE_HANDLE, ITS_ENC_TEST_KAT,
+                           NULL, 0);
+    if ((status != PSA_SUCCESS) && (status != PSA_ERROR_NOT_SUPPORTED)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* The throughput is printed by the test partition */
+    if (extra_ns_call(TFM_ITS_ENC_TEST_SERVICE_HANDLE, ITS_ENC_TEST_BENCH,
+                      NULL, 0) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
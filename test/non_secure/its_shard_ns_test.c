@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+
+int32_t its_shard_ns_test(void)
+{
+    /* The test partition fills ITS with its assets */
+    if (extra_ns_call(TFM_ITS_SHARD_TEST_SERVICE_HANDLE, PSA_IPC_CALL,
+                      NULL, 0) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "its_map_test_defs.h"
+#include "psa/client.h"
+#include "psa/storage_common.h"
+#include "psa_manifest/pid.h"
+#include "psa_manifest/sid.h"
+
+#define TEST_UID_PUBLISHED   0x1000U /* Published to the reader at the end */
+#define TEST_UID_UNPUBLISHED 0x1001U /* Stored but never published */
+#define TEST_UID_MISSING     0x1002U /* Never stored */
+
+static psa_status_t publisher_call(int32_t type, psa_storage_uid_t uid)
+{
+    psa_invec in_vec[] = {
+        { .base = &uid, .len = sizeof(uid) },
+    };
+
+    return psa_call(TFM_ITS_MAP_PUBLISHER_SERVICE_HANDLE, type,
+                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+static psa_status_t reader_map(psa_storage_uid_t uid)
+{
+    int32_t owner = TFM_SP_ITS_MAP_PUBLISHER;
+    psa_invec in_vec[] = {
+        { .base = &owner, .len = sizeof(owner) },
+        { .base = &uid, .len = sizeof(uid) },
+    };
+
+    return psa_call(TFM_ITS_MAP_READER_SERVICE_HANDLE, PSA_IPC_CALL,
+                    in_vec, IOVEC_LEN(in_vec), NULL, 0);
+}
+
+int32_t its_shared_map_ns_test(void)
+{
+    /* Another partition's data which was never stored */
+    if (reader_map(TEST_UID_MISSING) != PSA_ERROR_NOT_PERMITTED) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* Stored but not published */
+    if (publisher_call(ITS_MAP_TEST_STORE,
+                       TEST_UID_UNPUBLISHED) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (reader_map(TEST_UID_UNPUBLISHED) != PSA_ERROR_NOT_PERMITTED) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* Published, but the reader is not in the allow-list */
+    if (publisher_call(ITS_MAP_TEST_PUBLISH_NONE,
+                       TEST_UID_PUBLISHED) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (reader_map(TEST_UID_PUBLISHED) != PSA_ERROR_NOT_PERMITTED) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* The reader is allowed once the owner declares it */
+    if (publisher_call(ITS_MAP_TEST_PUBLISH_READER,
+                       TEST_UID_PUBLISHED) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (reader_map(TEST_UID_PUBLISHED) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* Only the declared readers are allowed, not any secure partition */
+    if (publisher_call(ITS_MAP_TEST_PUBLISH_NONE,
+                       TEST_UID_PUBLISHED) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (reader_map(TEST_UID_PUBLISHED) != PSA_ERROR_NOT_PERMITTED) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
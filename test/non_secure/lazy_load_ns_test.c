@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "lazy_load_test_defs.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+
+static psa_status_t lazy_load_call(psa_handle_t handle, uint32_t *served)
+{
+    return extra_ns_call(handle, PSA_IPC_CALL, served, sizeof(*served));
+}
+
+int32_t lazy_load_ns_test(void)
+{
+    uint32_t served;
+    uint32_t i;
+
+    /*
+     * The first request starts the partition, the next ones are served by the
+     * same thread.
+     */
+    for (i = 1; i <= 2; i++) {
+        served = 0;
+        if (lazy_load_call(TFM_LAZY_LOAD_FIRST_SERVICE_HANDLE,
+                           &served) != PSA_SUCCESS) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+        if (served != i) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+    }
+
+#if defined(LAZY_LOAD_TEST_POOL_SIZE) && \
+    (LAZY_LOAD_TEST_POOL_SIZE < 2 * LAZY_LOAD_TEST_STACK_SIZE)
+    /* The pool only holds the stack of the first partition */
+    for (i = 0; i < 2; i++) {
+        if (lazy_load_call(TFM_LAZY_LOAD_SECOND_SERVICE_HANDLE,
+                           &served) != PSA_ERROR_CONNECTION_BUSY) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+    }
+#else
+    served = 0;
+    if (lazy_load_call(TFM_LAZY_LOAD_SECOND_SERVICE_HANDLE,
+                       &served) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (served != 1) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+#endif
+
+    /* The first partition is not affected by the load of the second one */
+    if ((lazy_load_call(TFM_LAZY_LOAD_FIRST_SERVICE_HANDLE,
+                        &served) != PSA_SUCCESS) || (served != 3)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "batch_test_defs.h"
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+#include "tfm_psa_call_pack.h"
+
+/* Rounds of TFM_PSA_CALL_BATCH_MAX calls of the benchmark */
+#define BATCH_BENCH_ROUNDS      16
+
+/* Size of the vectors of the benchmark calls */
+#define BATCH_BENCH_SIZE        16
+
+static uint8_t batch_in[TFM_PSA_CALL_BATCH_MAX][BATCH_TEST_MAX_SIZE];
+static uint8_t batch_out[TFM_PSA_CALL_BATCH_MAX][BATCH_TEST_MAX_SIZE];
+static psa_invec batch_in_vec[TFM_PSA_CALL_BATCH_MAX];
+static psa_outvec batch_out_vec[TFM_PSA_CALL_BATCH_MAX];
+static struct tfm_psa_call_desc_t calls[TFM_PSA_CALL_BATCH_MAX + 1];
+
+/* Fills the descriptor of an echo call of the given size */
+static void batch_set_echo(uint32_t i, size_t size)
+{
+    memset(batch_in[i], (int)(0x30 + i), size);
+    memset(batch_out[i], 0xFF, BATCH_TEST_MAX_SIZE);
+
+    batch_in_vec[i].base = batch_in[i];
+    batch_in_vec[i].len = size;
+    batch_out_vec[i].base = batch_out[i];
+    batch_out_vec[i].len = BATCH_TEST_MAX_SIZE;
+
+    calls[i].handle = TFM_BATCH_TEST_SERVICE_HANDLE;
+    calls[i].type = BATCH_TEST_ECHO;
+    calls[i].in_vec = &batch_in_vec[i];
+    calls[i].in_len = 1;
+    calls[i].out_vec = &batch_out_vec[i];
+    calls[i].out_len = 1;
+    calls[i].status = PSA_ERROR_GENERIC_ERROR;
+}
+
+static int32_t batch_check_echo(uint32_t i, size_t size)
+{
+    if ((calls[i].status != PSA_SUCCESS) ||
+        (batch_out_vec[i].len != size) ||
+        (memcmp(batch_out[i], batch_in[i], size) != 0)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+static int32_t batch_get_span(struct batch_test_span_t *span)
+{
+    if (extra_ns_call(TFM_BATCH_TEST_SERVICE_HANDLE, BATCH_TEST_SPAN,
+                      span, sizeof(*span)) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+/*
+ * Makes a batch whose second call is refused by SPM, and checks that the
+ * other calls are made and that each status is written to its descriptor.
+ */
+static int32_t batch_check_calls(void)
+{
+    struct batch_test_span_t span;
+
+    /* Clears the span of the requests of other suites, if any */
+    if (batch_get_span(&span) != EXTRA_TEST_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    batch_set_echo(0, 5);
+    batch_set_echo(1, 7);
+    batch_set_echo(2, BATCH_TEST_MAX_SIZE);
+
+    /* More vectors than psa_call() takes */
+    calls[1].in_len = PSA_MAX_IOVEC + 1;
+
+    if (tfm_psa_call_batch(calls, 3) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    if ((batch_check_echo(0, 5) != EXTRA_TEST_SUCCESS) ||
+        (calls[1].status != PSA_ERROR_PROGRAMMER_ERROR) ||
+        (batch_check_echo(2, BATCH_TEST_MAX_SIZE) != EXTRA_TEST_SUCCESS)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* Only the two valid calls reached the service */
+    if ((batch_get_span(&span) != EXTRA_TEST_SUCCESS) || (span.count != 2)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* No call is made for an invalid number of descriptors */
+    if ((tfm_psa_call_batch(calls, 0) != PSA_ERROR_PROGRAMMER_ERROR) ||
+        (tfm_psa_call_batch(calls, TFM_PSA_CALL_BATCH_MAX + 1) !=
+         PSA_ERROR_PROGRAMMER_ERROR)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    if ((batch_get_span(&span) != EXTRA_TEST_SUCCESS) || (span.count != 0)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+/*
+ * Makes rounds of TFM_PSA_CALL_BATCH_MAX echo calls, one by one or batched,
+ * and sums the ticks the service measures from the first call of each round
+ * to the last one. Between two calls, the unbatched rounds return to NSPE and
+ * enter the SPE again, while the batched rounds stay in the NS Agent.
+ */
+static int32_t batch_bench(bool batched, uint32_t *ticks)
+{
+    struct batch_test_span_t span;
+    uint32_t round, i;
+
+    *ticks = 0;
+
+    for (round = 0; round < BATCH_BENCH_ROUNDS; round++) {
+        for (i = 0; i < TFM_PSA_CALL_BATCH_MAX; i++) {
+            batch_set_echo(i, BATCH_BENCH_SIZE);
+        }
+
+        if (batched) {
+            if (tfm_psa_call_batch(calls,
+                                   TFM_PSA_CALL_BATCH_MAX) != PSA_SUCCESS) {
+                return EXTRA_NS_TEST_FAILED;
+            }
+        } else {
+            for (i = 0; i < TFM_PSA_CALL_BATCH_MAX; i++) {
+                calls[i].status = psa_call(calls[i].handle, calls[i].type,
+                                           calls[i].in_vec, calls[i].in_len,
+                                           calls[i].out_vec,
+                                           calls[i].out_len);
+            }
+        }
+
+        for (i = 0; i < TFM_PSA_CALL_BATCH_MAX; i++) {
+            if (batch_check_echo(i, BATCH_BENCH_SIZE) != EXTRA_TEST_SUCCESS) {
+                return EXTRA_NS_TEST_FAILED;
+            }
+        }
+
+        if ((batch_get_span(&span) != EXTRA_TEST_SUCCESS) ||
+            (span.count != TFM_PSA_CALL_BATCH_MAX)) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+        *ticks += span.ticks;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+int32_t psa_call_batch_ns_test(void)
+{
+    uint32_t batched_ticks, unbatched_ticks;
+    int32_t ret;
+
+    ret = batch_check_calls();
+    if (ret != EXTRA_TEST_SUCCESS) {
+        return ret;
+    }
+
+    ret = batch_bench(false, &unbatched_ticks);
+    if (ret != EXTRA_TEST_SUCCESS) {
+        return ret;
+    }
+
+    ret = batch_bench(true, &batched_ticks);
+    if (ret != EXTRA_TEST_SUCCESS) {
+        return ret;
+    }
+
+    printf("psa_call batch: %u rounds of %u calls, unbatched %u ticks, "
+           "batched %u ticks\r\n", (unsigned int)BATCH_BENCH_ROUNDS,
+           (unsigned int)TFM_PSA_CALL_BATCH_MAX,
+           (unsigned int)unbatched_ticks, (unsigned int)batched_ticks);
+
+    return EXTRA_TEST_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "psa/crypto.h"
+
+#define TEST_HASH_MAX_SIZE  64
+#define TEST_INPUT_SIZE     200
+
+/* The algorithms the proxy serves locally */
+static const psa_algorithm_t test_algs[] = {
+    PSA_ALG_SHA_224,
+    PSA_ALG_SHA_256,
+    PSA_ALG_SHA_384,
+    PSA_ALG_SHA_512,
+};
+
+/*
+ * The input sizes: empty, shorter than the 64-byte chunks the proxy reads the
+ * input in, one chunk, and several chunks with a partial one.
+ */
+static const size_t test_input_sizes[] = {
+    0, 1, 64, TEST_INPUT_SIZE,
+};
+
+static uint8_t test_input[TEST_INPUT_SIZE];
+
+/*
+ * Hashes the input with a multipart operation, which is always forwarded to
+ * the Secure Enclave. The input is given in two parts, and with clone set, the
+ * second part is hashed by a clone of the operation.
+ */
+static psa_status_t forwarded_hash(psa_algorithm_t alg, size_t input_size,
+                                   int clone, uint8_t *hash, size_t hash_size,
+                                   size_t *hash_length)
+{
+    psa_hash_operation_t op = PSA_HASH_OPERATION_INIT;
+    psa_hash_operation_t clone_op = PSA_HASH_OPERATION_INIT;
+    psa_hash_operation_t *last_op = &op;
+    size_t first_size = input_size / 2;
+    psa_status_t status;
+
+    status = psa_hash_setup(&op, alg);
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_update(&op, test_input, first_size);
+    }
+    if ((status == PSA_SUCCESS) && clone) {
+        status = psa_hash_clone(&op, &clone_op);
+        last_op = &clone_op;
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_update(last_op, test_input + first_size,
+                                 input_size - first_size);
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_finish(last_op, hash, hash_size, hash_length);
+    }
+
+    (void)psa_hash_abort(&op);
+    (void)psa_hash_abort(&clone_op);
+
+    return status;
+}
+
+/* Checks the local and the forwarded requests for one algorithm and input */
+static int32_t proxy_hash_test(psa_algorithm_t alg, size_t input_size)
+{
+    uint8_t local[TEST_HASH_MAX_SIZE];
+    uint8_t forwarded[TEST_HASH_MAX_SIZE];
+    size_t hash_size = PSA_HASH_LENGTH(alg);
+    size_t local_length;
+    size_t forwarded_length;
+    psa_status_t local_status;
+    psa_status_t forwarded_status;
+    int clone;
+
+    /* psa_hash_compute is served locally */
+    if (psa_hash_compute(alg, test_input, input_size, local, sizeof(local),
+                         &local_length) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (local_length != hash_size) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    for (clone = 0; clone <= 1; clone++) {
+        memset(forwarded, 0, sizeof(forwarded));
+        if (forwarded_hash(alg, input_size, clone, forwarded,
+                           sizeof(forwarded),
+                           &forwarded_length) != PSA_SUCCESS) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+        if ((forwarded_length != local_length) ||
+            (memcmp(forwarded, local, local_length) != 0)) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+    }
+
+    /* Both fail in the same way when the hash does not fit */
+    local_status = psa_hash_compute(alg, test_input, input_size, local,
+                                    hash_size - 1, &local_length);
+    forwarded_status = forwarded_hash(alg, input_size, 0, forwarded,
+                                      hash_size - 1, &forwarded_length);
+    if ((local_status != PSA_ERROR_BUFFER_TOO_SMALL) ||
+        (forwarded_status != local_status)) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    /* psa_hash_compare is served locally too */
+    if (psa_hash_compare(alg, test_input, input_size,
+                         forwarded, hash_size) != PSA_SUCCESS) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    if (psa_hash_compare(alg, test_input, input_size,
+                         forwarded, hash_size - 1) !=
+        PSA_ERROR_INVALID_SIGNATURE) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+    forwarded[hash_size - 1] ^= 0x01;
+    if (psa_hash_compare(alg, test_input, input_size,
+                         forwarded, hash_size) !=
+        PSA_ERROR_INVALID_SIGNATURE) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+int32_t psa_proxy_hash_ns_test(void)
+{
+    int32_t ret;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < sizeof(test_input); i++) {
+        test_input[i] = (uint8_t)i;
+    }
+
+    for (i = 0; i < sizeof(test_algs) / sizeof(test_algs[0]); i++) {
+        for (j = 0; j < sizeof(test_input_sizes) /
+                        sizeof(test_input_sizes[0]); j++) {
+            ret = proxy_hash_test(test_algs[i], test_input_sizes[j]);
+            if (ret != EXTRA_TEST_SUCCESS) {
+                return ret;
+            }
+        }
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "extra_ns_suites.h"
+#include "extra_ns_tests.h"
+#include "psa/client.h"
+#include "psa_manifest/sid.h"
+#include "spm_api_bench_defs.h"
+
+/* Calls of each number of vectors and size */
+#define BENCH_ROUNDS        32
+
+/* Largest vector of the benchmark */
+#define BENCH_MAX_SIZE      1024
+
+static const size_t bench_sizes[] = {0, 16, 256, BENCH_MAX_SIZE};
+
+static uint8_t bench_in[PSA_MAX_IOVEC / 2][BENCH_MAX_SIZE];
+static uint8_t bench_out[PSA_MAX_IOVEC / 2][BENCH_MAX_SIZE];
+
+/*
+ * Makes BENCH_ROUNDS calls with the given number of vectors of the given size,
+ * the input vectors first, and checks that each output vector holds the input
+ * vector of the same index.
+ */
+static int32_t bench_calls(psa_handle_t handle, size_t num_vecs, size_t size)
+{
+    psa_invec in_vec[PSA_MAX_IOVEC / 2];
+    psa_outvec out_vec[PSA_MAX_IOVEC / 2];
+    size_t in_len = (num_vecs + 1) / 2;
+    size_t out_len = num_vecs / 2;
+    uint32_t round;
+    size_t i;
+
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        for (i = 0; i < in_len; i++) {
+            memset(bench_in[i], (int)(round + i), size);
+            in_vec[i].base = bench_in[i];
+            in_vec[i].len = size;
+        }
+        for (i = 0; i < out_len; i++) {
+            memset(bench_out[i], 0xFF, size);
+            out_vec[i].base = bench_out[i];
+            out_vec[i].len = size;
+        }
+
+        if (psa_call(handle, PSA_IPC_CALL, in_vec, in_len,
+                     out_vec, out_len) != PSA_SUCCESS) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+
+        for (i = 0; i < out_len; i++) {
+            if ((out_vec[i].len != size) ||
+                (memcmp(bench_out[i], bench_in[i], size) != 0)) {
+                return EXTRA_NS_TEST_FAILED;
+            }
+        }
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+/*
+ * Prints the report of the statistics SPM recorded, for
+ * tools/spm_api_stats.py. The report covers all the requests made since
+ * boot, including those of the other suites.
+ */
+static int32_t bench_report(void)
+{
+    char line[SPM_API_BENCH_LINE_SIZE + 1];
+    psa_status_t status;
+    uint32_t index;
+
+    for (index = 0; ; index++) {
+        psa_invec in_vec[] = {{&index, sizeof(index)}};
+        psa_outvec out_vec[] = {{line, SPM_API_BENCH_LINE_SIZE}};
+
+        status = psa_call(TFM_SPM_API_BENCH_REPORT_SERVICE_HANDLE,
+                          PSA_IPC_CALL, in_vec, 1, out_vec, 1);
+        if (status == PSA_ERROR_DOES_NOT_EXIST) {
+            break;
+        }
+        if (status != PSA_SUCCESS) {
+            return EXTRA_NS_TEST_FAILED;
+        }
+
+        line[out_vec[0].len] = '\0';
+        printf("%s\r\n", line);
+    }
+
+    /* The report has at least the header and the end line */
+    if (index < 2) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    return EXTRA_TEST_SUCCESS;
+}
+
+int32_t spm_api_bench_ns_test(void)
+{
+    psa_handle_t handle;
+    size_t num_vecs;
+    size_t i;
+    int32_t ret = EXTRA_TEST_SUCCESS;
+
+    handle = psa_connect(TFM_SPM_API_BENCH_ECHO_SERVICE_SID,
+                         TFM_SPM_API_BENCH_ECHO_SERVICE_VERSION);
+    if (handle <= 0) {
+        return EXTRA_NS_TEST_FAILED;
+    }
+
+    for (num_vecs = 0; num_vecs <= PSA_MAX_IOVEC; num_vecs++) {
+        for (i = 0; i < sizeof(bench_sizes) / sizeof(bench_sizes[0]); i++) {
+            /* The sizes only apply to the calls with vectors */
+            if ((num_vecs == 0) && (i > 0)) {
+                break;
+            }
+
+            ret = bench_calls(handle, num_vecs, bench_sizes[i]);
+            if (ret != EXTRA_TEST_SUCCESS) {
+                break;
+            }
+        }
+        if (ret != EXTRA_TEST_SUCCESS) {
+            break;
+        }
+    }
+
+    psa_close(handle);
+
+    if (ret != EXTRA_TEST_SUCCESS) {
+        return ret;
+    }
+
+    return bench_report();
+}
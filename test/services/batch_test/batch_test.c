@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "batch_test_defs.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_batch_test.h"
+#include "test_service.h"
+#include "tfm_timer_api.h"
+
+/* The span of the echo requests since the last span request */
+static struct batch_test_span_t span;
+static uint32_t first_timestamp;
+
+static uint8_t echo_buf[BATCH_TEST_MAX_SIZE];
+
+static psa_status_t batch_test_echo(const psa_msg_t *msg)
+{
+    uint32_t now = tfm_timer_get_timestamp();
+    size_t len = msg->in_size[0];
+
+    if (span.count == 0) {
+        first_timestamp = now;
+    }
+    span.ticks = now - first_timestamp;
+    span.count++;
+
+    if ((len > sizeof(echo_buf)) || (msg->out_size[0] < len)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    if (psa_read(msg->handle, 0, echo_buf, len) != len) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    psa_write(msg->handle, 0, echo_buf, len);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t batch_test_span(const psa_msg_t *msg)
+{
+    if (msg->out_size[0] != sizeof(span)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    psa_write(msg->handle, 0, &span, sizeof(span));
+    span.count = 0;
+    span.ticks = 0;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t batch_test_handle(const psa_msg_t *msg)
+{
+    switch (msg->type) {
+    case BATCH_TEST_ECHO:
+        return batch_test_echo(msg);
+    case BATCH_TEST_SPAN:
+        return batch_test_span(msg);
+    default:
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+}
+
+void batch_test_main(void)
+{
+    test_service_run(TFM_BATCH_TEST_SERVICE_SIGNAL, batch_test_handle);
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __BATCH_TEST_DEFS_H__
+#define __BATCH_TEST_DEFS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Copies in_vec[0] to out_vec[0], and takes the timestamp of the request.
+ * Each request carries at most BATCH_TEST_MAX_SIZE bytes.
+ */
+#define BATCH_TEST_ECHO             1
+/*
+ * Writes a struct batch_test_span_t to out_vec[0], for the echo requests
+ * since the previous span request.
+ */
+#define BATCH_TEST_SPAN             2
+
+#define BATCH_TEST_MAX_SIZE         64
+
+struct batch_test_span_t {
+    uint32_t count;             /* Number of echo requests                  */
+    uint32_t ticks;             /* Ticks from the first one to the last one */
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BATCH_TEST_DEFS_H__ */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __TEST_SERVICE_H__
+#define __TEST_SERVICE_H__
+
+#include "psa/service.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The message loop shared by the test partitions. The functions are inline so
+ * that each partition runs its own copy, in its own code region, whatever the
+ * isolation level.
+ */
+
+/* Handles one message, and returns the status the service replies with */
+typedef psa_status_t (*test_service_handler_t)(const psa_msg_t *msg);
+
+/**
+ * \brief Gets one message of a service and replies to it.
+ *
+ * \param[in] signal            The asserted signal of the service.
+ * \param[in] handler           The handler of the messages of the service.
+ *
+ * \note Nothing is done if no message can be got.
+ */
+static inline void test_service_serve(psa_signal_t signal,
+                                      test_service_handler_t handler)
+{
+    psa_msg_t msg;
+
+    if (psa_get(signal, &msg) != PSA_SUCCESS) {
+        return;
+    }
+
+    psa_reply(msg.handle, handler(&msg));
+}
+
+/**
+ * \brief Serves the messages of the only service of a partition, forever.
+ *
+ * \param[in] signal            The signal of the service.
+ * \param[in] handler           The handler of the messages of the service.
+ *
+ * \note The partition panics on any other signal.
+ */
+static inline void test_service_run(psa_signal_t signal,
+                                    test_service_handler_t handler)
+{
+    psa_signal_t signals;
+
+    while (1) {
+        signals = psa_wait(PSA_WAIT_ANY, PSA_BLOCK);
+        if (signals & signal) {
+            test_service_serve(signal, handler);
+        } else {
+            psa_panic();
+        }
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEST_SERVICE_H__ */
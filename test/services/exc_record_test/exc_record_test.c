@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "exc_record_test_defs.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_exc_record_test.h"
+#include "test_service.h"
+#include "tfm_exc_record_api.h"
+
+static struct tfm_exc_record_t record;
+
+static psa_status_t exc_record_test_read(const psa_msg_t *msg)
+{
+    psa_status_t status;
+
+    if (msg->out_size[0] != sizeof(record)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    status = tfm_exc_record_get(&record);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    psa_write(msg->handle, 0, &record, sizeof(record));
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t exc_record_test_handle(const psa_msg_t *msg)
+{
+    switch (msg->type) {
+    case EXC_RECORD_TEST_READ:
+        return exc_record_test_read(msg);
+    default:
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+}
+
+void exc_record_test_main(void)
+{
+    test_service_run(TFM_EXC_RECORD_TEST_SERVICE_SIGNAL,
+                     exc_record_test_handle);
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __EXC_RECORD_TEST_DEFS_H__
+#define __EXC_RECORD_TEST_DEFS_H__
+
+#include "tfm_exc_record_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Writes the struct tfm_exc_record_t read from SPM to out_vec[0] */
+#define EXC_RECORD_TEST_READ        1
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EXC_RECORD_TEST_DEFS_H__ */
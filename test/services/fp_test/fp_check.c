@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmsis_compiler.h"
+#include "fp_test_defs.h"
+#include "psa/client.h"
+#include "psa/service.h"
+#include "psa_manifest/sid.h"
+#include "psa_manifest/tfm_fp_check.h"
+#include "test_service.h"
+#include "tfm_timer_api.h"
+
+/* Round trips to each partition of the benchmark */
+#define FP_BENCH_ROUNDS             64U
+
+#if CONFIG_TFM_SPE_FP > 0
+#define FP_CHECK_VALUE(i)           (0x5A5A0000U | (i))
+
+static uint32_t check_values[FP_TEST_NUM_S_REGS];
+static uint32_t check_results[FP_TEST_NUM_S_REGS];
+
+static void fp_check_init_values(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < FP_TEST_NUM_S_REGS; i++) {
+        check_values[i] = FP_CHECK_VALUE(i);
+        check_results[i] = 0;
+    }
+}
+
+static psa_status_t fp_check_results(uint32_t first)
+{
+    uint32_t i;
+
+    for (i = first; i < FP_TEST_NUM_S_REGS; i++) {
+        if (check_results[i] != FP_CHECK_VALUE(i)) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/*
+ * Loads S16-S31, which psa_call() preserves like any function, then calls the
+ * clobber partition, which loads its own values into the registers, and the
+ * partition which does not use FP. Checks that S16-S31 still hold the values
+ * of this partition.
+ */
+static psa_status_t fp_check_switch(void)
+{
+    psa_status_t status;
+
+    fp_check_init_values();
+
+    /* No FP code is generated between the loads and the stores */
+    __ASM volatile("vldm    %[values], {s16-s31}"
+                   :
+                   : [values] "r" (&check_values[16])
+                   : FP_TEST_CALLEE_S_REGS, "memory");
+
+    status = psa_call(TFM_FP_CLOBBER_SERVICE_HANDLE, FP_TEST_CLOBBER_REGS,
+                      NULL, 0, NULL, 0);
+    if (status == PSA_SUCCESS) {
+        status = psa_call(TFM_FP_NONE_SERVICE_HANDLE, PSA_IPC_CALL,
+                          NULL, 0, NULL, 0);
+    }
+
+    __ASM volatile("vstm    %[results], {s16-s31}"
+                   :
+                   : [results] "r" (&check_results[16])
+                   : "memory");
+
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    return fp_check_results(16);
+}
+
+#ifdef CONFIG_TFM_SPM_TIMER
+/*
+ * Number of iterations of the loop run with the values in S0-S31. At a few
+ * cycles per iteration, it lasts much longer than FP_TEST_CLOBBER_TIMEOUT.
+ */
+#define FP_CHECK_LOOPS              200000U
+
+static psa_status_t fp_check_get_count(uint32_t *count)
+{
+    psa_outvec out_vec[] = {
+        {count, sizeof(*count)},
+    };
+
+    return psa_call(TFM_FP_CLOBBER_SERVICE_HANDLE, FP_TEST_CLOBBER_COUNT,
+                    NULL, 0, out_vec, IOVEC_LEN(out_vec));
+}
+
+/*
+ * Loads S0-S31, arms the timer of the higher priority clobber partition and
+ * spins until it has preempted this partition and loaded its own values into
+ * the registers, then checks that S0-S31 still hold the values of this
+ * partition.
+ */
+static psa_status_t fp_check_preempt(void)
+{
+    uint32_t count_before;
+    uint32_t count_after;
+    uint32_t start;
+    uint32_t end;
+    uint32_t loops = FP_CHECK_LOOPS;
+    psa_status_t status;
+
+    fp_check_init_values();
+
+    status = fp_check_get_count(&count_before);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    status = psa_call(TFM_FP_CLOBBER_SERVICE_HANDLE, FP_TEST_CLOBBER_ARM,
+                      NULL, 0, NULL, 0);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    start = tfm_timer_get_timestamp();
+    __ASM volatile("vldm    %[values], {s0-s31}   \n"
+                   "1:                            \n"
+                   "subs    %[loops], %[loops], #1\n"
+                   "bne     1b                    \n"
+                   "vstm    %[results], {s0-s31}  \n"
+                   : [loops] "+r" (loops)
+                   : [values] "r" (check_values),
+                     [results] "r" (check_results)
+                   : FP_TEST_S_REGS, "cc", "memory");
+    end = tfm_timer_get_timestamp();
+
+    status = fp_check_get_count(&count_after);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* The loop must have outlasted the timer, and been preempted */
+    if ((end - start < FP_TEST_CLOBBER_TIMEOUT) ||
+        (count_after == count_before)) {
+        return PSA_ERROR_BAD_STATE;
+    }
+
+    return fp_check_results(0);
+}
+#else /* CONFIG_TFM_SPM_TIMER */
+static psa_status_t fp_check_preempt(void)
+{
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+#endif /* CONFIG_TFM_SPM_TIMER */
+#else /* CONFIG_TFM_SPE_FP > 0 */
+static psa_status_t fp_check_switch(void)
+{
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+
+static psa_status_t fp_check_preempt(void)
+{
+    return PSA_ERROR_NOT_SUPPORTED;
+}
+#endif /* CONFIG_TFM_SPE_FP > 0 */
+
+/* Times FP_BENCH_ROUNDS calls to a service, which are two switches each */
+static psa_status_t fp_bench_calls(psa_handle_t handle, int32_t type,
+                                   uint32_t *ticks)
+{
+    uint32_t start;
+    uint32_t i;
+
+    start = tfm_timer_get_timestamp();
+    for (i = 0; i < FP_BENCH_ROUNDS; i++) {
+        if (psa_call(handle, type, NULL, 0, NULL, 0) != PSA_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+    *ticks = tfm_timer_get_timestamp() - start;
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t fp_check_bench(const psa_msg_t *msg)
+{
+    struct fp_test_bench_t bench;
+    psa_status_t status;
+
+    if (msg->out_size[0] != sizeof(bench)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    bench.rounds = FP_BENCH_ROUNDS;
+    status = fp_bench_calls(TFM_FP_CLOBBER_SERVICE_HANDLE, FP_TEST_CLOBBER_NOP,
+                            &bench.fp_ticks);
+    if (status == PSA_SUCCESS) {
+        status = fp_bench_calls(TFM_FP_NONE_SERVICE_HANDLE, PSA_IPC_CALL,
+                                &bench.no_fp_ticks);
+    }
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    psa_write(msg->handle, 0, &bench, sizeof(bench));
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t fp_check_handle(const psa_msg_t *msg)
+{
+    switch (msg->type) {
+    case FP_TEST_CHECK_SWITCH:
+        return fp_check_switch();
+    case FP_TEST_CHECK_PREEMPT:
+        return fp_check_preempt();
+    case FP_TEST_CHECK_BENCH:
+        return fp_check_bench(msg);
+    default:
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+}
+
+void fp_check_main(void)
+{
+    test_service_run(TFM_FP_CHECK_SERVICE_SIGNAL, fp_check_handle);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "cmsis_compiler.h"
+#include "fp_test_defs.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_fp_clobber.h"
+#include "tfm_timer_api.h"
+
+/* Number of timer expiries handled */
+static uint32_t clobber_count;
+
+#if CONFIG_TFM_SPE_FP > 0
+static uint32_t clobber_values[FP_TEST_NUM_S_REGS];
+
+/*
+ * The values are left in the registers while the partition is blocked. The
+ * registers are loaded in fp_clobber_main(), which never returns, so they are
+ * not restored by an epilogue.
+ */
+#define FP_CLOBBER_LOAD_REGS()                                              \
+    __ASM volatile("vldm    %[values], {s0-s31}"                            \
+                   :                                                        \
+                   : [values] "r" (clobber_values)                          \
+                   : FP_TEST_S_REGS, "memory")
+#else
+#define FP_CLOBBER_LOAD_REGS()
+#endif
+
+static psa_status_t fp_clobber_handle(const psa_msg_t *msg)
+{
+    switch (msg->type) {
+    case FP_TEST_CLOBBER_NOP:
+    case FP_TEST_CLOBBER_REGS:
+        return PSA_SUCCESS;
+#ifdef CONFIG_TFM_SPM_TIMER
+    case FP_TEST_CLOBBER_ARM:
+        return tfm_timer_set(FP_TEST_CLOBBER_TIMEOUT);
+#endif
+    case FP_TEST_CLOBBER_COUNT:
+        if (msg->out_size[0] != sizeof(clobber_count)) {
+            return PSA_ERROR_PROGRAMMER_ERROR;
+        }
+        psa_write(msg->handle, 0, &clobber_count, sizeof(clobber_count));
+        return PSA_SUCCESS;
+    default:
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+}
+
+void fp_clobber_main(void)
+{
+    psa_signal_t signals;
+    psa_msg_t msg;
+#if CONFIG_TFM_SPE_FP > 0
+    uint32_t i;
+
+    for (i = 0; i < FP_TEST_NUM_S_REGS; i++) {
+        clobber_values[i] = FP_TEST_CLOBBER_VALUE(i);
+    }
+#endif
+
+    while (1) {
+        signals = psa_wait(PSA_WAIT_ANY, PSA_BLOCK);
+#ifdef CONFIG_TFM_SPM_TIMER
+        if (signals & TFM_TIMER_SIGNAL) {
+            /* Cancels the timer, and clears the signal */
+            (void)tfm_timer_set(0);
+            FP_CLOBBER_LOAD_REGS();
+            clobber_count++;
+            continue;
+        }
+#endif
+        if (signals & TFM_FP_CLOBBER_SERVICE_SIGNAL) {
+            if (psa_get(TFM_FP_CLOBBER_SERVICE_SIGNAL,
+                        &msg) != PSA_SUCCESS) {
+                continue;
+            }
+            if (msg.type == FP_TEST_CLOBBER_REGS) {
+                FP_CLOBBER_LOAD_REGS();
+            }
+            psa_reply(msg.handle, fp_clobber_handle(&msg));
+        } else {
+            psa_panic();
+        }
+    }
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "psa/service.h"
+#include "psa_manifest/tfm_fp_none.h"
+#include "test_service.h"
+
+static psa_status_t fp_none_handle(const psa_msg_t *msg)
+{
+    return (msg->type == PSA_IPC_CALL) ? PSA_SUCCESS :
+                                         PSA_ERROR_PROGRAMMER_ERROR;
+}
+
+/*
+ * The partition declares that it does not use FP, so it runs with the FP
+ * access disabled, and an FP instruction in it would raise a UsageFault.
+ */
+void fp_none_main(void)
+{
+    test_service_run(TFM_FP_NONE_SERVICE_SIGNAL, fp_none_handle);
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __FP_TEST_DEFS_H__
+#define __FP_TEST_DEFS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Request types of TFM_FP_CHECK_SERVICE, which returns PSA_SUCCESS if the
+ * check passes, and PSA_ERROR_NOT_SUPPORTED without an FP configuration of
+ * SPE.
+ */
+#define FP_TEST_CHECK_SWITCH        1 /* S16-S31 across psa_call()          */
+#define FP_TEST_CHECK_PREEMPT       2 /* S0-S31 across a preemption, needs
+                                       * CONFIG_TFM_SPM_TIMER
+                                       */
+#define FP_TEST_CHECK_BENCH         3 /* struct fp_test_bench_t in
+                                       * out_vec[0]
+                                       */
+
+/*
+ * Request types of TFM_FP_CLOBBER_SERVICE, a partition which uses FP. When its
+ * timer expires, after FP_TEST_CLOBBER_TIMEOUT timestamp ticks, the partition
+ * preempts the lower priority partitions. It loads FP_TEST_CLOBBER_VALUE(i)
+ * into each Si register on FP_TEST_CLOBBER_REGS and on each expiry, and
+ * blocks with its values left in the registers.
+ */
+#define FP_TEST_CLOBBER_NOP         1 /* Reply straight away                */
+#define FP_TEST_CLOBBER_REGS        2 /* Load the registers                 */
+#define FP_TEST_CLOBBER_ARM         3 /* Start the timer                    */
+#define FP_TEST_CLOBBER_COUNT       4 /* Number of expiries, in out_vec[0]  */
+
+#define FP_TEST_CLOBBER_TIMEOUT     20000U
+#define FP_TEST_CLOBBER_VALUE(i)    (0xDEAD0000U | (i))
+
+/*
+ * TFM_FP_NONE_SERVICE, in a partition which declares that it does not use FP,
+ * replies PSA_SUCCESS to any call.
+ */
+
+/* Round trips of the benchmark, in timestamp ticks */
+struct fp_test_bench_t {
+    uint32_t rounds;         /* Number of round trips to each partition     */
+    uint32_t fp_ticks;       /* To the partition which uses FP              */
+    uint32_t no_fp_ticks;    /* To the partition which does not use FP      */
+};
+
+/* Number of single precision registers, S0-S31 */
+#define FP_TEST_NUM_S_REGS          32
+
+/* The clobber lists of assembly statements which load S0-S31 or S16-S31 */
+#define FP_TEST_CALLEE_S_REGS                                               \
+    "s16", "s17", "s18", "s19", "s20", "s21", "s22", "s23",                 \
+    "s24", "s25", "s26", "s27", "s28", "s29", "s30", "s31"
+
+#define FP_TEST_S_REGS                                                      \
+    "s0",  "s1",  "s2",  "s3",  "s4",  "s5",  "s6",  "s7",                  \
+    "s8",  "s9",  "s10", "s11", "s12", "s13", "s14", "s15",                 \
+    FP_TEST_CALLEE_S_REGS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FP_TEST_DEFS_H__ */
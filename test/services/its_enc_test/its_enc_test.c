@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "its_enc_test_defs.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_its_enc_test.h"
+#include "test_service.h"
+#include "tfm_hal_its.h"
+#include "tfm_hal_platform.h"
+#include "tfm_sp_log.h"
+
+#define TEST_TAG_SIZE       16
+
+/* Size of the buffer encrypted by the benchmark, and number of rounds */
+#define TEST_BENCH_SIZE     1024
+#define TEST_BENCH_ROUNDS   8
+
+static uint8_t test_nonce[] = {
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+    0x88, 0x99, 0xAA, 0xBB,
+};
+static uint8_t test_label[] = "ITS encryption KAT";
+static uint8_t test_add[] = "ITS encryption KAT additional data";
+
+#define TEST_LABEL_SIZE     (sizeof(test_label) - 1)
+#define TEST_ADD_SIZE       (sizeof(test_add) - 1)
+
+#ifdef ITS_ENC_TEST_KAT
+/*
+ * The expected outputs for test_nonce, test_add and the key derived by
+ * HKDF-SHA256 from the dummy HUK, with "ITS_ENC_KEY" as salt and test_label as
+ * info:
+ *   210E9251043B41F9EB5168D79E619947DE21B8CEE12955C17C64E3D3B37C51A2
+ * They were computed with OpenSSL, not with Mbed Crypto.
+ */
+static uint8_t test_plaintext[] = "ITS encryption known answer test vector";
+
+#define TEST_DATA_SIZE      (sizeof(test_plaintext) - 1)
+
+#if defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_CCM)
+static const uint8_t test_ciphertext[TEST_DATA_SIZE] = {
+    0x3A, 0x23, 0xE1, 0x7C, 0xB2, 0x64, 0x7D, 0xCE,
+    0xB5, 0x97, 0x07, 0x29, 0xCE, 0x51, 0x1A, 0x7F,
+    0x2C, 0x2D, 0x26, 0xFD, 0x54, 0x39, 0x17, 0x8D,
+    0x3A, 0xD4, 0x3B, 0xC8, 0xC1, 0x71, 0xB4, 0xBA,
+    0x0F, 0x62, 0x76, 0x73, 0x65, 0xF9, 0xA0,
+};
+static const uint8_t test_tag[TEST_TAG_SIZE] = {
+    0x37, 0x2D, 0x99, 0xD2, 0x32, 0x31, 0x3B, 0x4D,
+    0x26, 0x0F, 0x70, 0xA0, 0x4D, 0xFA, 0x8A, 0x29,
+};
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_AES_GCM)
+static const uint8_t test_ciphertext[TEST_DATA_SIZE] = {
+    0xF3, 0xB4, 0x77, 0xBE, 0x06, 0xE9, 0x96, 0x80,
+    0x38, 0x95, 0x00, 0xDD, 0xB3, 0xCD, 0xB1, 0xF2,
+    0xF6, 0x98, 0x56, 0x16, 0x83, 0x6A, 0xCE, 0xAA,
+    0x0D, 0xDF, 0x49, 0xDA, 0x9B, 0x68, 0x65, 0x44,
+    0x4E, 0x3C, 0x1C, 0x95, 0xFA, 0x63, 0x4C,
+};
+static const uint8_t test_tag[TEST_TAG_SIZE] = {
+    0x1E, 0x0A, 0x68, 0x24, 0x4B, 0x04, 0x84, 0xFB,
+    0xBE, 0xF3, 0xA6, 0xBB, 0x0D, 0xF0, 0x2B, 0xA2,
+};
+#elif defined(PLATFORM_DEFAULT_ITS_ENC_ALG_CHACHA20_POLY1305)
+static const uint8_t test_ciphertext[TEST_DATA_SIZE] = {
+    0xB7, 0xF4, 0xC5, 0x35, 0x02, 0xD0, 0xC9, 0x00,
+    0xE9, 0x3C, 0x5D, 0xF7, 0x6E, 0x15, 0x35, 0xD6,
+    0xD5, 0x0F, 0x60, 0x30, 0x03, 0xCD, 0x1A, 0xD9,
+    0xCD, 0x41, 0x38, 0xF6, 0x79, 0x8E, 0x23, 0x65,
+    0xFD, 0x9D, 0x8F, 0x81, 0x88, 0x6D, 0xE3,
+};
+static const uint8_t test_tag[TEST_TAG_SIZE] = {
+    0x19, 0xCF, 0x3F, 0x70, 0x05, 0xBB, 0x98, 0x17,
+    0x21, 0xE9, 0x6C, 0xF2, 0x36, 0xF1, 0xE1, 0x16,
+};
+#else
+#error "No known answer for the AEAD algorithm of the ITS encryption"
+#endif
+#endif /* ITS_ENC_TEST_KAT */
+
+static uint8_t bench_plaintext[TEST_BENCH_SIZE];
+static uint8_t bench_ciphertext[TEST_BENCH_SIZE];
+static uint8_t bench_decrypted[TEST_BENCH_SIZE];
+
+static bool test_set_ctx(struct tfm_hal_its_auth_crypt_ctx *ctx,
+                         uint8_t *label, size_t label_size, uint8_t *nonce)
+{
+    if ((tfm_hal_its_aead_set_deriv_label(ctx, label, label_size) !=
+         TFM_HAL_SUCCESS) ||
+        (tfm_hal_its_aead_set_nonce(ctx, nonce, sizeof(test_nonce)) !=
+         TFM_HAL_SUCCESS) ||
+        (tfm_hal_its_aead_set_add(ctx, test_add, TEST_ADD_SIZE) !=
+         TFM_HAL_SUCCESS)) {
+        return false;
+    }
+
+    return true;
+}
+
+#ifdef ITS_ENC_TEST_KAT
+/*
+ * Encrypts and decrypts the vector with the fixed nonce, and checks that a
+ * modified tag is rejected.
+ */
+static psa_status_t its_enc_test_kat(void)
+{
+    struct tfm_hal_its_auth_crypt_ctx ctx;
+    uint8_t ciphertext[TEST_DATA_SIZE];
+    uint8_t plaintext[TEST_DATA_SIZE];
+    uint8_t tag[TEST_TAG_SIZE];
+
+    if (!test_set_ctx(&ctx, test_label, TEST_LABEL_SIZE, test_nonce)) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    if (tfm_hal_its_aead_encrypt(&ctx, test_plaintext, TEST_DATA_SIZE,
+                                 ciphertext, sizeof(ciphertext),
+                                 tag, sizeof(tag)) != TFM_HAL_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    if ((memcmp(ciphertext, test_ciphertext, sizeof(ciphertext)) != 0) ||
+        (memcmp(tag, test_tag, sizeof(tag)) != 0)) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    if (tfm_hal_its_aead_decrypt(&ctx, ciphertext, sizeof(ciphertext),
+                                 tag, sizeof(tag),
+                                 plaintext, sizeof(plaintext)) !=
+        TFM_HAL_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+    if (memcmp(plaintext, test_plaintext, sizeof(plaintext)) != 0) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    tag[0] ^= 0x01;
+    if (tfm_hal_its_aead_decrypt(&ctx, ciphertext, sizeof(ciphertext),
+                                 tag, sizeof(tag),
+                                 plaintext, sizeof(plaintext)) ==
+        TFM_HAL_SUCCESS) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+#endif /* ITS_ENC_TEST_KAT */
+
+/*
+ * Encrypts and decrypts TEST_BENCH_ROUNDS buffers of TEST_BENCH_SIZE bytes of
+ * one file, with fresh nonces, and returns the ticks spent in the HAL. Only
+ * the first encryption derives the key.
+ */
+static psa_status_t its_enc_test_bench_same_key(uint32_t *enc_ticks,
+                                                uint32_t *dec_ticks)
+{
+    struct tfm_hal_its_auth_crypt_ctx ctx;
+    uint8_t nonce[sizeof(test_nonce)];
+    uint8_t tag[TEST_TAG_SIZE];
+    uint32_t start;
+    uint32_t i;
+
+    *enc_ticks = 0;
+    *dec_ticks = 0;
+
+    for (i = 0; i < TEST_BENCH_ROUNDS; i++) {
+        memset(bench_plaintext, (int)i, sizeof(bench_plaintext));
+
+        if ((tfm_hal_its_aead_generate_nonce(nonce, sizeof(nonce)) !=
+             TFM_HAL_SUCCESS) ||
+            !test_set_ctx(&ctx, test_label, TEST_LABEL_SIZE, nonce)) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        start = tfm_hal_get_timestamp();
+        if (tfm_hal_its_aead_encrypt(&ctx, bench_plaintext, TEST_BENCH_SIZE,
+                                     bench_ciphertext,
+                                     sizeof(bench_ciphertext),
+                                     tag, sizeof(tag)) != TFM_HAL_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+        *enc_ticks += tfm_hal_get_timestamp() - start;
+
+        start = tfm_hal_get_timestamp();
+        if (tfm_hal_its_aead_decrypt(&ctx, bench_ciphertext, TEST_BENCH_SIZE,
+                                     tag, sizeof(tag),
+                                     bench_decrypted,
+                                     sizeof(bench_decrypted)) !=
+            TFM_HAL_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+        *dec_ticks += tfm_hal_get_timestamp() - start;
+
+        if (memcmp(bench_decrypted, bench_plaintext, TEST_BENCH_SIZE) != 0) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    return PSA_SUCCESS;
+}
+
+/*
+ * Encrypts TEST_BENCH_ROUNDS buffers of TEST_BENCH_SIZE bytes, alternately for
+ * two files, so that each encryption derives the key and runs the key
+ * schedule again, and returns the ticks spent in the HAL.
+ */
+static psa_status_t its_enc_test_bench_new_key(uint32_t *enc_ticks)
+{
+    struct tfm_hal_its_auth_crypt_ctx ctx;
+    uint8_t labels[2][TEST_LABEL_SIZE];
+    uint8_t nonce[sizeof(test_nonce)];
+    uint8_t tag[TEST_TAG_SIZE];
+    uint32_t start;
+    uint32_t i;
+
+    memcpy(labels[0], test_label, TEST_LABEL_SIZE);
+    memcpy(labels[1], test_label, TEST_LABEL_SIZE);
+    labels[1][0] ^= 0x01;
+
+    *enc_ticks = 0;
+
+    for (i = 0; i < TEST_BENCH_ROUNDS; i++) {
+        if ((tfm_hal_its_aead_generate_nonce(nonce, sizeof(nonce)) !=
+             TFM_HAL_SUCCESS) ||
+            !test_set_ctx(&ctx, labels[i & 1], TEST_LABEL_SIZE, nonce)) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+
+        start = tfm_hal_get_timestamp();
+        if (tfm_hal_its_aead_encrypt(&ctx, bench_plaintext, TEST_BENCH_SIZE,
+                                     bench_ciphertext,
+                                     sizeof(bench_ciphertext),
+                                     tag, sizeof(tag)) != TFM_HAL_SUCCESS) {
+            return PSA_ERROR_GENERIC_ERROR;
+        }
+        *enc_ticks += tfm_hal_get_timestamp() - start;
+    }
+
+    return PSA_SUCCESS;
+}
+
+/*
+ * Logs the ticks spent by the HAL with the key kept from the previous
+ * operation, as for consecutive operations on one file, and with a new key
+ * each time. The ticks are those of tfm_hal_get_timestamp(), and are all 0 on
+ * platforms which have no cycle counter.
+ */
+static psa_status_t its_enc_test_bench(void)
+{
+    uint32_t enc_ticks;
+    uint32_t dec_ticks;
+    psa_status_t status;
+
+    status = its_enc_test_bench_same_key(&enc_ticks, &dec_ticks);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+    LOG_INFFMT("[ITS enc] %d x %d bytes, same key: ",
+               TEST_BENCH_ROUNDS, TEST_BENCH_SIZE);
+    LOG_INFFMT("encrypt %u ticks, decrypt %u ticks\r\n",
+               enc_ticks, dec_ticks);
+
+    status = its_enc_test_bench_new_key(&enc_ticks);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+    LOG_INFFMT("[ITS enc] %d x %d bytes, new key: encrypt %u ticks\r\n",
+               TEST_BENCH_ROUNDS, TEST_BENCH_SIZE, enc_ticks);
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t its_enc_test_handle(const psa_msg_t *msg)
+{
+    switch (msg->type) {
+    case ITS_ENC_TEST_KAT:
+#ifdef ITS_ENC_TEST_KAT
+        return its_enc_test_kat();
+#else
+        return PSA_ERROR_NOT_SUPPORTED;
+#endif
+    case ITS_ENC_TEST_BENCH:
+        return its_enc_test_bench();
+    default:
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+}
+
+void its_enc_test_main(void)
+{
+    test_service_run(TFM_ITS_ENC_TEST_SERVICE_SIGNAL, its_enc_test_handle);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __ITS_ENC_TEST_DEFS_H__
+#define __ITS_ENC_TEST_DEFS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Request types of TFM_ITS_ENC_TEST_SERVICE, which calls the ITS encryption
+ * HAL directly and returns PSA_SUCCESS if all the checks pass.
+ */
+#define ITS_ENC_TEST_KAT    1 /* Known-answer test of the AEAD algorithm  */
+#define ITS_ENC_TEST_BENCH  2 /* Round trip and throughput of the HAL     */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_ENC_TEST_DEFS_H__ */
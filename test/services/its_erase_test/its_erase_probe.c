@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "psa/service.h"
+#include "psa_manifest/tfm_its_erase_probe.h"
+#include "test_service.h"
+#include "tfm_its_ext_api.h"
+
+/*
+ * Returns the number of ITS scratch blocks left to erase in the background in
+ * out_vec[0]. The statistics are too large for the partition stack.
+ */
+static struct tfm_its_stats_t its_stats;
+
+static psa_status_t its_erase_probe_handle(const psa_msg_t *msg)
+{
+    psa_status_t status;
+
+    if ((msg->type != PSA_IPC_CALL) ||
+        (msg->out_size[0] != sizeof(its_stats.its_flash.erase_pending))) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    status = tfm_its_ext_get_stats(&its_stats);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    psa_write(msg->handle, 0, &its_stats.its_flash.erase_pending,
+              sizeof(its_stats.its_flash.erase_pending));
+
+    return PSA_SUCCESS;
+}
+
+void its_erase_probe_main(void)
+{
+    test_service_run(TFM_ITS_ERASE_PROBE_SERVICE_SIGNAL,
+                     its_erase_probe_handle);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "its_map_test_defs.h"
+#include "psa/internal_trusted_storage.h"
+#include "psa/service.h"
+#include "psa_manifest/pid.h"
+#include "psa_manifest/tfm_its_map_publisher.h"
+#include "test_service.h"
+#include "tfm_its_ext_api.h"
+
+/* Stores the data of the uid, unless it was stored before the last reset */
+static psa_status_t its_map_publisher_store(psa_storage_uid_t uid)
+{
+    struct psa_storage_info_t info;
+    psa_status_t status;
+
+    status = psa_its_get_info(uid, &info);
+    if (status == PSA_ERROR_DOES_NOT_EXIST) {
+        status = psa_its_set(uid, sizeof(ITS_MAP_TEST_DATA), ITS_MAP_TEST_DATA,
+                             PSA_STORAGE_FLAG_WRITE_ONCE);
+    }
+
+    return status;
+}
+
+static psa_status_t its_map_publisher_handle(const psa_msg_t *msg)
+{
+    const int32_t reader = TFM_SP_ITS_MAP_READER;
+    psa_storage_uid_t uid;
+    psa_status_t status;
+
+    if (msg->in_size[0] != sizeof(uid)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    (void)psa_read(msg->handle, 0, &uid, sizeof(uid));
+
+    status = its_map_publisher_store(uid);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    switch (msg->type) {
+    case ITS_MAP_TEST_STORE:
+        return PSA_SUCCESS;
+    case ITS_MAP_TEST_PUBLISH_NONE:
+        return tfm_its_ext_publish(uid, NULL, 0);
+    case ITS_MAP_TEST_PUBLISH_READER:
+        return tfm_its_ext_publish(uid, &reader, 1);
+    default:
+        return PSA_ERROR_NOT_SUPPORTED;
+    }
+}
+
+void its_map_publisher_main(void)
+{
+    test_service_run(TFM_ITS_MAP_PUBLISHER_SERVICE_SIGNAL,
+                     its_map_publisher_handle);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "its_map_test_defs.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_its_map_reader.h"
+#include "test_service.h"
+#include "tfm_its_ext_api.h"
+
+static psa_status_t its_map_reader_handle(const psa_msg_t *msg)
+{
+    int32_t owner;
+    psa_storage_uid_t uid;
+    const void *p_data;
+    size_t data_length;
+    psa_status_t status;
+
+    if ((msg->type != PSA_IPC_CALL) ||
+        (msg->in_size[0] != sizeof(owner)) ||
+        (msg->in_size[1] != sizeof(uid))) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    (void)psa_read(msg->handle, 0, &owner, sizeof(owner));
+    (void)psa_read(msg->handle, 1, &uid, sizeof(uid));
+
+    status = tfm_its_ext_map(owner, uid, &p_data, &data_length);
+    if (status != PSA_SUCCESS) {
+        return status;
+    }
+
+    /* The mapped data must be the one stored by the owner */
+    if ((data_length != sizeof(ITS_MAP_TEST_DATA)) ||
+        (memcmp(p_data, ITS_MAP_TEST_DATA, data_length) != 0)) {
+        return PSA_ERROR_GENERIC_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+void its_map_reader_main(void)
+{
+    test_service_run(TFM_ITS_MAP_READER_SERVICE_SIGNAL, its_map_reader_handle);
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __ITS_MAP_TEST_DEFS_H__
+#define __ITS_MAP_TEST_DEFS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Request types of TFM_ITS_MAP_PUBLISHER_SERVICE. Each request takes the uid
+ * in in_vec[0], and stores its data, created with PSA_STORAGE_FLAG_WRITE_ONCE,
+ * if it does not exist yet.
+ */
+#define ITS_MAP_TEST_STORE          1 /* Store the data only */
+#define ITS_MAP_TEST_PUBLISH_NONE   2 /* Publish the data with no reader */
+#define ITS_MAP_TEST_PUBLISH_READER 3 /* Publish the data to the reader */
+
+/*
+ * TFM_ITS_MAP_READER_SERVICE maps the data of the owner in in_vec[0], with
+ * the uid in in_vec[1], and returns the status of tfm_its_ext_map(). The
+ * mapped data is checked against ITS_MAP_TEST_DATA.
+ */
+#define ITS_MAP_TEST_DATA           "ITS shared map test data"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ITS_MAP_TEST_DEFS_H__ */
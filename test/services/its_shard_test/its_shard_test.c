@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "psa/internal_trusted_storage.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_its_shard_test.h"
+#include "test_service.h"
+
+/* First uid of the assets of the test */
+#define TEST_UID_BASE       0x3000U
+
+/*
+ * Stores assets until ITS is full or ITS_NUM_ASSETS are stored, checks that
+ * each one can be read back, then removes them. The assets of the other tests
+ * may be left in ITS, so ITS can be full before ITS_NUM_ASSETS are stored, but
+ * only with PSA_ERROR_INSUFFICIENT_STORAGE, as an asset hashed to a full shard
+ * is stored in another one.
+ */
+static psa_status_t its_shard_test_run(void)
+{
+    psa_status_t status = PSA_SUCCESS;
+    size_t num_stored;
+    size_t length;
+    uint8_t data;
+    size_t i;
+
+    for (num_stored = 0; num_stored < ITS_NUM_ASSETS; num_stored++) {
+        data = (uint8_t)num_stored;
+        status = psa_its_set(TEST_UID_BASE + num_stored, sizeof(data), &data,
+                             PSA_STORAGE_FLAG_NONE);
+        if (status != PSA_SUCCESS) {
+            break;
+        }
+    }
+
+    if ((status == PSA_ERROR_INSUFFICIENT_STORAGE) && (num_stored > 0)) {
+        status = PSA_SUCCESS;
+    }
+
+    for (i = 0; (status == PSA_SUCCESS) && (i < num_stored); i++) {
+        status = psa_its_get(TEST_UID_BASE + i, 0, sizeof(data), &data,
+                             &length);
+        if ((status == PSA_SUCCESS) &&
+            ((length != sizeof(data)) || (data != (uint8_t)i))) {
+            status = PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    /* Remove the assets even if the test failed */
+    for (i = 0; i < num_stored; i++) {
+        if ((psa_its_remove(TEST_UID_BASE + i) != PSA_SUCCESS) &&
+            (status == PSA_SUCCESS)) {
+            status = PSA_ERROR_GENERIC_ERROR;
+        }
+    }
+
+    return status;
+}
+
+static psa_status_t its_shard_test_handle(const psa_msg_t *msg)
+{
+    return (msg->type == PSA_IPC_CALL) ? its_shard_test_run() :
+                                         PSA_ERROR_PROGRAMMER_ERROR;
+}
+
+void its_shard_test_main(void)
+{
+    test_service_run(TFM_ITS_SHARD_TEST_SERVICE_SIGNAL, its_shard_test_handle);
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdint.h>
+
+#include "psa/service.h"
+#include "psa_manifest/tfm_lazy_load_second.h"
+#include "test_service.h"
+
+/* Number of requests served since the partition started */
+static uint32_t served;
+
+static psa_status_t lazy_load_second_handle(const psa_msg_t *msg)
+{
+    if (msg->out_size[0] != sizeof(served)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    served++;
+    psa_write(msg->handle, 0, &served, sizeof(served));
+
+    return PSA_SUCCESS;
+}
+
+void lazy_load_second_main(void)
+{
+    test_service_run(TFM_LAZY_LOAD_SECOND_SERVICE_SIGNAL,
+                     lazy_load_second_handle);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __LAZY_LOAD_TEST_DEFS_H__
+#define __LAZY_LOAD_TEST_DEFS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * TFM_LAZY_LOAD_FIRST_SERVICE and TFM_LAZY_LOAD_SECOND_SERVICE return the
+ * number of requests their partition has served since it started, this one
+ * included, as a uint32_t in out_vec[0].
+ */
+
+/* The stack size of each test partition, as in its manifest */
+#define LAZY_LOAD_TEST_STACK_SIZE   0x400
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LAZY_LOAD_TEST_DEFS_H__ */
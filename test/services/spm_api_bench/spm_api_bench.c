@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config_impl.h"
+#include "psa/service.h"
+#include "psa_manifest/tfm_spm_api_bench.h"
+#include "spm_api_bench_defs.h"
+#include "test_service.h"
+#include "tfm_spm_stats_api.h"
+
+/* Chunk of a vector copied by the echo service */
+#define ECHO_CHUNK_SIZE             64
+
+/* More than the number of API classes SPM can record */
+#define BENCH_MAX_RECORDS           128
+
+#if CONFIG_TFM_SPM_BACKEND_SFN == 1
+#define BENCH_BACKEND               "SFN"
+#else
+#define BENCH_BACKEND               "IPC"
+#endif
+
+#if defined(CONFIG_TFM_PSA_API_SUPERVISOR_CALL)
+#define BENCH_ABI                   "SVC"
+#elif defined(CONFIG_TFM_PSA_API_THREAD_CALL)
+#define BENCH_ABI                   "THREAD"
+#elif defined(CONFIG_TFM_PSA_API_SFN_CALL)
+#define BENCH_ABI                   "SFN"
+#else
+#define BENCH_ABI                   "NONE"
+#endif
+
+static const char *const api_names[TFM_SPM_API_STATS_NUM_APIS] = {
+    "psa_connect", "psa_call", "psa_close", "psa_read", "psa_write",
+    "psa_reply"
+};
+
+/* Snapshot of the statistics, taken when line 0 of the report is read */
+static struct tfm_spm_api_stats_t records[BENCH_MAX_RECORDS];
+static uint32_t num_records;
+static struct tfm_spm_idle_stats_t idle_records[TFM_SPM_IDLE_STATS_STATES];
+
+static uint8_t echo_buf[ECHO_CHUNK_SIZE];
+
+static void echo_call(const psa_msg_t *msg)
+{
+    size_t room;
+    size_t num;
+    uint32_t i;
+
+    for (i = 0; i < PSA_MAX_IOVEC; i++) {
+        room = msg->out_size[i];
+        while ((num = psa_read(msg->handle, i, echo_buf,
+                               sizeof(echo_buf))) > 0) {
+            /* The data which does not fit in the output vector is dropped */
+            if (num > room) {
+                num = room;
+            }
+            if (num > 0) {
+                psa_write(msg->handle, i, echo_buf, num);
+                room -= num;
+            }
+        }
+    }
+}
+
+static size_t line_append(char *line, size_t len, const char *str)
+{
+    while ((*str != '\0') && (len < SPM_API_BENCH_LINE_SIZE)) {
+        line[len++] = *str++;
+    }
+
+    return len;
+}
+
+/* Appends the hexadecimal value of a number, with the given number of digits */
+static size_t line_append_digits(char *line, size_t len, uint64_t value,
+                                 uint32_t digits)
+{
+    static const char hex_table[] = "0123456789ABCDEF";
+
+    if (len + digits > SPM_API_BENCH_LINE_SIZE) {
+        return len;
+    }
+
+    while (digits > 0) {
+        digits--;
+        line[len++] = hex_table[(value >> (digits * 4)) & 0xF];
+    }
+
+    return len;
+}
+
+/* Appends ",0x" and the hexadecimal value of a number */
+static size_t line_append_hex(char *line, size_t len, uint64_t value,
+                              uint32_t digits)
+{
+    len = line_append(line, len, ",0x");
+
+    return line_append_digits(line, len, value, digits);
+}
+
+/* Takes the snapshot and writes the header, with the number of replies */
+static size_t report_begin(char *line)
+{
+    uint32_t replies = 0;
+    uint32_t state;
+    size_t len;
+
+    for (num_records = 0; num_records < BENCH_MAX_RECORDS; num_records++) {
+        if (tfm_spm_api_stats_get(num_records,
+                                  &records[num_records]) != PSA_SUCCESS) {
+            break;
+        }
+        if (records[num_records].api == TFM_SPM_API_STATS_REPLY) {
+            replies += records[num_records].count;
+        }
+    }
+
+    for (state = 0; state < TFM_SPM_IDLE_STATS_STATES; state++) {
+        if (tfm_spm_idle_stats_get(state, &idle_records[state]) !=
+            PSA_SUCCESS) {
+            idle_records[state].count = 0;
+        }
+    }
+
+    /* The header identifies the configuration the statistics were taken in */
+    len = line_append(line, 0, "SPM_API_STATS,BEGIN," BENCH_BACKEND ","
+                               BENCH_ABI);
+    len = line_append_hex(line, len, TFM_LVL, 2);
+    len = line_append_hex(line, len, replies, 8);
+
+    return len;
+}
+
+static size_t report_record(char *line,
+                            const struct tfm_spm_api_stats_t *record)
+{
+    size_t len;
+
+    len = line_append(line, 0, "SPM_API_STATS,");
+    if (record->api < TFM_SPM_API_STATS_NUM_APIS) {
+        len = line_append(line, len, api_names[record->api]);
+    } else {
+        len = line_append(line, len, "svc_");
+        len = line_append_digits(line, len, record->svc_number, 2);
+    }
+    len = line_append_hex(line, len, record->iovecs, 2);
+    len = line_append_hex(line, len, record->size_class, 2);
+    len = line_append_hex(line, len, record->count, 8);
+    len = line_append_hex(line, len, record->min, 8);
+    len = line_append_hex(line, len, record->max, 8);
+    len = line_append_hex(line, len, record->total, 16);
+
+    return len;
+}
+
+/* The residency of a sleep state of the idle partition */
+static size_t report_idle(char *line, uint32_t state,
+                          const struct tfm_spm_idle_stats_t *record)
+{
+    size_t len;
+
+    len = line_append(line, 0, "SPM_API_STATS,IDLE");
+    len = line_append_hex(line, len, state, 2);
+    len = line_append_hex(line, len, record->count, 8);
+    len = line_append_hex(line, len, record->min, 8);
+    len = line_append_hex(line, len, record->max, 8);
+    len = line_append_hex(line, len, record->total, 16);
+
+    return len;
+}
+
+static psa_status_t report_call(const psa_msg_t *msg)
+{
+    char line[SPM_API_BENCH_LINE_SIZE];
+    uint32_t index;
+    size_t len;
+
+    if ((msg->in_size[0] != sizeof(index)) ||
+        (msg->out_size[0] < SPM_API_BENCH_LINE_SIZE)) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    (void)psa_read(msg->handle, 0, &index, sizeof(index));
+
+    if (index == 0) {
+        len = report_begin(line);
+    } else if (index <= num_records) {
+        len = report_record(line, &records[index - 1]);
+    } else if (index <= num_records + TFM_SPM_IDLE_STATS_STATES) {
+        len = report_idle(line, index - num_records - 1,
+                          &idle_records[index - num_records - 1]);
+    } else if (index == num_records + TFM_SPM_IDLE_STATS_STATES + 1) {
+        len = line_append(line, 0, "SPM_API_STATS,END");
+    } else {
+        return PSA_ERROR_DOES_NOT_EXIST;
+    }
+
+    psa_write(msg->handle, 0, line, len);
+
+    return PSA_SUCCESS;
+}
+
+/*
+ * The connection and disconnection messages are accepted, for the benchmark of
+ * psa_connect() and psa_close().
+ */
+static psa_status_t echo_handle(const psa_msg_t *msg)
+{
+    if (msg->type == PSA_IPC_CALL) {
+        echo_call(msg);
+    } else if (msg->type >= 0) {
+        return PSA_ERROR_PROGRAMMER_ERROR;
+    }
+
+    return PSA_SUCCESS;
+}
+
+static psa_status_t report_handle(const psa_msg_t *msg)
+{
+    return (msg->type == PSA_IPC_CALL) ? report_call(msg) :
+                                         PSA_ERROR_PROGRAMMER_ERROR;
+}
+
+void spm_api_bench_main(void)
+{
+    psa_signal_t signals;
+
+    while (1) {
+        signals = psa_wait(PSA_WAIT_ANY, PSA_BLOCK);
+        if (signals & TFM_SPM_API_BENCH_ECHO_SERVICE_SIGNAL) {
+            test_service_serve(TFM_SPM_API_BENCH_ECHO_SERVICE_SIGNAL,
+                               echo_handle);
+        } else if (signals & TFM_SPM_API_BENCH_REPORT_SERVICE_SIGNAL) {
+            test_service_serve(TFM_SPM_API_BENCH_REPORT_SERVICE_SIGNAL,
+                               report_handle);
+        } else {
+            psa_panic();
+        }
+    }
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2021, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __SPM_API_BENCH_DEFS_H__
+#define __SPM_API_BENCH_DEFS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * TFM_SPM_API_BENCH_ECHO_SERVICE copies each input vector of a psa_call() to
+ * the output vector of the same index, if any, with psa_read() and
+ * psa_write().
+ *
+ * TFM_SPM_API_BENCH_REPORT_SERVICE writes the line of the given index of the
+ * SPM API statistics report, in the format of tools/spm_api_stats.py, to the
+ * output vector: in_vec[0] holds the uint32_t index of the line, and out_vec[0]
+ * takes at most SPM_API_BENCH_LINE_SIZE characters. Line 0 takes a snapshot of
+ * the statistics, which the following lines report. PSA_ERROR_DOES_NOT_EXIST
+ * is returned past the last line.
+ */
+#define SPM_API_BENCH_LINE_SIZE     96
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPM_API_BENCH_DEFS_H__ */
@@ -75,6 +75,11 @@ macro(tfm_toolchain_set_processor_arch)
                 string(APPEND CMAKE_SYSTEM_PROCESSOR "+nodsp")
             endif()
         endif()
+        if (DEFINED TFM_SYSTEM_MVE)
+            if (NOT TFM_SYSTEM_MVE)
+                string(APPEND CMAKE_SYSTEM_PROCESSOR "+nomve")
+            endif()
+        endif()
         if(GCC_VERSION VERSION_GREATER_EQUAL "8.0.0")
             if (DEFINED CONFIG_TFM_SPE_FP)
                 if(CONFIG_TFM_SPE_FP STREQUAL "0")
@@ -109,6 +114,10 @@ macro(tfm_toolchain_set_processor_arch)
             endif()
         endif()
     endif()
+
+    if (TFM_SYSTEM_MVE)
+        string(APPEND CMAKE_SYSTEM_ARCH "+mve")
+    endif()
 endmacro()
 
 macro(tfm_toolchain_reload_compiler)
@@ -0,0 +1,131 @@
+# -----------------------------------------------------------------------------
+# Copyright (c) 2021, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# -----------------------------------------------------------------------------
+
+import multiprocessing
+import os
+import sys
+
+from iatverifier.util import get_cose_payload, read_keyfile
+from iatverifier.verify import decode_and_validate_iat
+
+
+STATUS_OK = 'OK'
+STATUS_READ_ERROR = 'READ_ERROR'
+STATUS_BAD_COSE = 'BAD_COSE'
+STATUS_BAD_SIGNATURE = 'BAD_SIGNATURE'
+STATUS_INVALID_IAT = 'INVALID_IAT'
+
+# Verification settings of the current process. They are set once per process
+# by _init_worker, so that the key is only read and parsed once per worker
+# rather than once per token.
+_worker_key = None
+_worker_method = 'sign'
+_worker_strict = False
+
+
+def verify_token(raw_token, key=None, method='sign', strict=False):
+    """
+    Verifies one encoded token, and returns a tuple of (status, error, claims).
+    """
+    try:
+        payload = get_cose_payload(raw_token, key, method)
+    except ValueError as e:
+        if 'Bad signature' in str(e):
+            return STATUS_BAD_SIGNATURE, str(e), None
+        return STATUS_BAD_COSE, str(e), None
+    except Exception as e:
+        return STATUS_BAD_COSE, str(e), None
+
+    try:
+        claims = decode_and_validate_iat(payload, strict=strict)
+    except Exception as e:
+        return STATUS_INVALID_IAT, str(e), None
+
+    return STATUS_OK, None, claims
+
+
+def find_token_files(paths):
+    """
+    Yields the token files to verify. Directories are expanded to the regular
+    files they contain, in name order, and a path of '-' is expanded to the
+    paths read from standard input, one per line.
+    """
+    for path in paths:
+        if path == '-':
+            for line in sys.stdin:
+                line = line.strip()
+                if line:
+                    yield line
+        elif os.path.isdir(path):
+            for name in sorted(os.listdir(path)):
+                file_path = os.path.join(path, name)
+                if os.path.isfile(file_path):
+                    yield file_path
+        else:
+            yield path
+
+
+def verify_token_files(token_files, keyfile=None, method='sign',
+                       strict=False, jobs=None, chunksize=8,
+                       include_claims=False):
+    """
+    Verifies a sequence of token files with a pool of `jobs` worker processes
+    (one per CPU if None), and yields one result dict per token file, in the
+    order of `token_files`.
+    """
+    # Parse the key here first, so that a bad key file is reported once rather
+    # than by every worker.
+    read_keyfile(keyfile, method)
+
+    initargs = (keyfile, method, strict)
+
+    if jobs == 1:
+        _init_worker(*initargs)
+        for token_file in token_files:
+            yield _verify_file(token_file, include_claims)
+        return
+
+    pool = multiprocessing.Pool(jobs, _init_worker, initargs)
+    try:
+        args = ((token_file, include_claims) for token_file in token_files)
+        for result in pool.imap(_verify_file_star, args, chunksize):
+            yield result
+    finally:
+        pool.terminate()
+        pool.join()
+
+
+def _init_worker(keyfile, method, strict):
+    global _worker_key, _worker_method, _worker_strict
+    _worker_key = read_keyfile(keyfile, method)
+    _worker_method = method
+    _worker_strict = strict
+
+
+def _verify_file(token_file, include_claims):
+    result = {'token': token_file}
+
+    try:
+        with open(token_file, 'rb') as fh:
+            raw_token = fh.read()
+    except OSError as e:
+        result['status'] = STATUS_READ_ERROR
+        result['error'] = str(e)
+        return result
+
+    status, error, claims = verify_token(raw_token, _worker_key,
+                                         _worker_method, _worker_strict)
+    result['status'] = status
+    if error is not None:
+        result['error'] = error
+    if include_claims and claims is not None:
+        result['claims'] = claims
+    return result
+
+
+def _verify_file_star(args):
+    return _verify_file(*args)
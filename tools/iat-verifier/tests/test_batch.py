@@ -0,0 +1,107 @@
+# -----------------------------------------------------------------------------
+# Copyright (c) 2021, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# -----------------------------------------------------------------------------
+
+import os
+import shutil
+import tempfile
+import time
+import unittest
+
+from iatverifier.batch import (STATUS_OK, STATUS_BAD_COSE,
+                               STATUS_BAD_SIGNATURE, STATUS_INVALID_IAT,
+                               STATUS_READ_ERROR, find_token_files,
+                               verify_token_files)
+from iatverifier.util import convert_map_to_token_files
+from iatverifier.verify import extract_iat_from_cose, decode_and_validate_iat
+
+
+THIS_DIR = os.path.dirname(__file__)
+
+DATA_DIR = os.path.join(THIS_DIR, 'data')
+KEYFILE = os.path.join(DATA_DIR, 'key.pem')
+KEYFILE_ALT = os.path.join(DATA_DIR, 'key-alt.pem')
+
+# Number of tokens verified by the throughput benchmark
+BENCHMARK_TOKENS = int(os.environ.get('IAT_BENCHMARK_TOKENS', '64'))
+
+
+class TestBatchVerifier(unittest.TestCase):
+
+    def setUp(self):
+        self.token_dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.token_dir)
+
+    def create_token(self, name, source_name, keyfile=KEYFILE):
+        source_path = os.path.join(DATA_DIR, source_name)
+        dest_path = os.path.join(self.token_dir, name)
+        convert_map_to_token_files(source_path, keyfile, dest_path)
+        return dest_path
+
+    def create_valid_tokens(self, count):
+        # Sign the token once and copy it, as signing dominates the set up time
+        first = self.create_token('token-00000.cbor', 'valid-iat.yaml')
+        paths = [first]
+        for i in range(1, count):
+            path = os.path.join(self.token_dir, 'token-{:05d}.cbor'.format(i))
+            shutil.copyfile(first, path)
+            paths.append(path)
+        return paths
+
+    def test_results(self):
+        good = self.create_token('a-good.cbor', 'valid-iat.yaml')
+        bad_sig = self.create_token('b-bad-sig.cbor', 'valid-iat.yaml',
+                                    KEYFILE_ALT)
+        invalid = self.create_token('c-invalid.cbor', 'missing-claim.yaml')
+        malformed = os.path.join(self.token_dir, 'd-malformed.cbor')
+        shutil.copyfile(os.path.join(DATA_DIR, 'malformed.cbor'), malformed)
+        missing = os.path.join(self.token_dir, 'e-missing.cbor')
+
+        token_files = list(find_token_files([self.token_dir, missing]))
+        self.assertEqual(token_files,
+                         [good, bad_sig, invalid, malformed, missing])
+
+        for jobs in (1, 2):
+            results = list(verify_token_files(token_files, KEYFILE,
+                                              jobs=jobs, include_claims=True))
+            self.assertEqual([r['token'] for r in results], token_files)
+            self.assertEqual([r['status'] for r in results],
+                             [STATUS_OK, STATUS_BAD_SIGNATURE,
+                              STATUS_INVALID_IAT, STATUS_BAD_COSE,
+                              STATUS_READ_ERROR])
+            self.assertEqual(results[0]['claims']['SECURITY_LIFECYCLE'],
+                             'SL_SECURED')
+            self.assertNotIn('error', results[0])
+            self.assertIn('missing MANDATORY claim', results[2]['error'])
+
+    def test_throughput(self):
+        token_files = self.create_valid_tokens(BENCHMARK_TOKENS)
+
+        # Baseline: one check_iat invocation per token, which reads the key
+        # every time
+        start = time.perf_counter()
+        for token_file in token_files:
+            decode_and_validate_iat(extract_iat_from_cose(KEYFILE, token_file))
+        single_time = time.perf_counter() - start
+
+        start = time.perf_counter()
+        results = list(verify_token_files(token_files, KEYFILE, jobs=1))
+        batch_time = time.perf_counter() - start
+
+        start = time.perf_counter()
+        pool_results = list(verify_token_files(token_files, KEYFILE))
+        pool_time = time.perf_counter() - start
+
+        self.assertTrue(all(r['status'] == STATUS_OK for r in results))
+        self.assertEqual(results, pool_results)
+
+        print('\n{} tokens: single {:.1f}/s, batch {:.1f}/s, '
+              'batch with {} workers {:.1f}/s'.format(
+                  len(token_files), len(token_files) / single_time,
+                  len(token_files) / batch_time, os.cpu_count(),
+                  len(token_files) / pool_time))
@@ -0,0 +1,145 @@
+#-------------------------------------------------------------------------------
+# Copyright (c) 2021, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+#-------------------------------------------------------------------------------
+
+import sys
+import json
+import argparse
+
+PREFIX = 'SPM_API_STATS'
+
+def parse_log(log_file):
+    """
+    Returns the last complete report of the SPM API statistics found in the log
+    as a dict, or None if the log holds no complete report.
+    """
+    report = None
+    current = None
+
+    for line in log_file:
+        fields = line.strip().split(',')
+        if fields[0] != PREFIX or len(fields) < 2:
+            continue
+
+        if fields[1] == 'BEGIN' and len(fields) == 6:
+            current = {'backend': fields[2],
+                       'abi': fields[3],
+                       'isolation_level': int(fields[4], 16),
+                       'replies': int(fields[5], 16),
+                       'entries': [],
+                       'idle': []}
+        elif fields[1] == 'END':
+            if current is not None:
+                report = current
+            current = None
+        elif current is not None and len(fields) == 8:
+            count = int(fields[4], 16)
+            total = int(fields[7], 16)
+            current['entries'].append({'api': fields[1],
+                                       'iovecs': int(fields[2], 16),
+                                       'size_class': int(fields[3], 16),
+                                       'count': count,
+                                       'min': int(fields[5], 16),
+                                       'max': int(fields[6], 16),
+                                       'mean': total // count})
+        elif current is not None and fields[1] == 'IDLE' and len(fields) == 7:
+            # The idle residency is reported, but not compared
+            current['idle'].append({'state': int(fields[2], 16),
+                                    'count': int(fields[3], 16),
+                                    'min': int(fields[4], 16),
+                                    'max': int(fields[5], 16),
+                                    'total': int(fields[6], 16)})
+
+    return report
+
+def entry_key(entry):
+    return (entry['api'], entry['iovecs'], entry['size_class'])
+
+def compare(report, baseline, tolerance):
+    """
+    Returns the list of entries whose mean duration is more than `tolerance`
+    percent longer than in the baseline.
+    """
+    regressions = []
+    baseline_entries = {entry_key(e): e for e in baseline['entries']}
+
+    for entry in report['entries']:
+        ref = baseline_entries.get(entry_key(entry))
+        if ref is None:
+            continue
+        if entry['mean'] * 100 > ref['mean'] * (100 + tolerance):
+            regressions.append((entry, ref))
+
+    return regressions
+
+def main():
+    parser = argparse.ArgumentParser(description='Extract the SPM API statistics from a TF-M log, built with CONFIG_TFM_SPM_API_STATS, and compare them to a baseline')
+
+    parser.add_argument('log'
+                        , type=argparse.FileType('r', errors='replace')
+                        , help='The log file, or - for standard input')
+
+    parser.add_argument('-o', '--output'
+                        , dest='output'
+                        , required=False
+                        , default=None
+                        , metavar='json-file'
+                        , help='Write the statistics in JSON to this file')
+
+    parser.add_argument('-b', '--baseline'
+                        , dest='baseline'
+                        , required=False
+                        , default=None
+                        , metavar='json-file'
+                        , help='Compare the statistics with a previous output of this tool')
+
+    parser.add_argument('-t', '--tolerance'
+                        , dest='tolerance'
+                        , required=False
+                        , type=int
+                        , default=5
+                        , metavar='percent'
+                        , help='Mean duration increase reported as a regression (default 5)')
+
+    args = parser.parse_args()
+
+    report = parse_log(args.log)
+    if report is None:
+        print('No complete ' + PREFIX + ' report found in the log',
+              file=sys.stderr)
+        exit(1)
+
+    if args.output is None:
+        json.dump(report, sys.stdout, indent=2)
+        print('')
+    else:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2)
+
+    if args.baseline is None:
+        return
+
+    with open(args.baseline, 'r') as f:
+        baseline = json.load(f)
+
+    for item in ['backend', 'abi', 'isolation_level']:
+        if report[item] != baseline[item]:
+            print('The baseline {} is {}, not {}'.format(item, baseline[item],
+                                                         report[item]),
+                  file=sys.stderr)
+            exit(1)
+
+    regressions = compare(report, baseline, args.tolerance)
+    for entry, ref in regressions:
+        print('{}, {} iovecs, size class {}: mean {} ticks, baseline {}'
+              .format(entry['api'], entry['iovecs'], entry['size_class'],
+                      entry['mean'], ref['mean']), file=sys.stderr)
+
+    if regressions:
+        exit(1)
+
+if __name__ == '__main__':
+    main()
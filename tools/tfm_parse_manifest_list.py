@@ -77,7 +77,27 @@ def manifest_validation(partition_manifest):
 
     return partition_manifest
 
-def process_partition_manifests(manifest_list_files, extra_manifests_list):
+def process_partition_model(manifest, backend):
+    """
+    A partition which supports both the IPC and the SFN model sets its "model"
+    to "dual" and provides both an "entry_point" for the IPC model and an
+    "entry_init" for the SFN model. The model of such a partition follows the
+    SPM backend of the build, and the entry of the other model is dropped.
+    """
+    if manifest['psa_framework_version'] != 1.1 or \
+       manifest.get('model') != 'dual':
+        return manifest
+
+    manifest['model'] = backend
+    if backend == 'SFN':
+        manifest.pop('entry_point', None)
+    else:
+        manifest.pop('entry_init', None)
+
+    return manifest
+
+def process_partition_manifests(manifest_list_files, extra_manifests_list,
+                                backend):
     """
     Parse the input manifest, generate the data base for genereated files
     and generate manifest header files.
@@ -88,6 +108,8 @@ def process_partition_manifests(manifest_list_files, extra_manifests_list):
         The manifest lists to parse.
     extra_manifests_list:
         The extra manifest list to parse and its original path.
+    backend:
+        The SPM backend, which selects the model of the "dual" partitions.
 
     Returns
     -------
@@ -169,6 +191,8 @@ def process_partition_manifests(manifest_list_files, extra_manifests_list):
         with open(manifest_path) as manifest_file:
             manifest = manifest_validation(yaml.safe_load(manifest_file))
 
+        manifest = process_partition_model(manifest, backend)
+
         # Count the number of IPC partitions
         if manifest['psa_framework_version'] == 1.1 and manifest['model'] == 'IPC':
             ipc_partition_num += 1
@@ -218,6 +242,10 @@ def process_partition_manifests(manifest_list_files, extra_manifests_list):
 
     context['stateless_services'] = process_stateless_services(partition_list, 32)
 
+    process_lazy_load(partition_list)
+    process_fp_usage(partition_list)
+    process_init_dependencies(partition_list)
+
     return context
 
 def gen_per_partition_files(context):
@@ -401,6 +429,103 @@ def process_stateless_services(partitions, stateless_index_max_num):
 
     return reordered_stateless_services
 
+def process_lazy_load(partitions):
+    """
+    This function validates the "lazy_load" attribute in the manifest list.
+    A lazily loaded partition gets its stack allocated and its thread started
+    by the first connection or stateless call to one of its services, so it
+    must be an IPC model partition with services and without interrupts.
+    The effective value is stored back into the manifest list attributes.
+    """
+    for partition in partitions:
+        manifest = partition['manifest']
+        lazy = partition['attr'].get('lazy_load', False) is True
+
+        if lazy:
+            if manifest['psa_framework_version'] == 1.1 and \
+               manifest['model'] != 'IPC':
+                raise Exception('Lazy loading of {} requires IPC model'
+                                .format(manifest['name']))
+            if len(manifest.get('services', [])) == 0:
+                raise Exception('Lazy loading of {} requires services'
+                                .format(manifest['name']))
+            if len(manifest.get('irqs', [])) > 0:
+                raise Exception('Lazy loading of {} is not supported with '
+                                'interrupts'.format(manifest['name']))
+
+        partition['attr']['lazy_load'] = lazy
+
+def process_fp_usage(partitions):
+    """
+    This function validates the "fp_used" attribute in the partition manifests.
+    When SPE is built with FP support, only the partitions which use FP run
+    with the FP access enabled and have their FP context flushed when they are
+    switched out. A partition without the attribute is treated as using FP.
+    The effective value is stored into the manifest list attributes.
+    """
+    for partition in partitions:
+        manifest = partition['manifest']
+        fp_used = manifest.get('fp_used', True)
+
+        if not isinstance(fp_used, bool):
+            raise Exception('The fp_used attribute of {} must be a boolean'
+                            .format(manifest['name']))
+
+        partition['attr']['fp_used'] = fp_used
+
+def process_init_dependencies(partitions):
+    """
+    This function builds the initialization dependency graph of partitions
+    from the manifest 'dependencies' and 'weak_dependencies' and decides which
+    partitions are allowed to finish their initialization after the
+    non-secure image is started.
+    A partition can ask for deferred initialization with the "deferred_init"
+    attribute in the manifest list. The request is dropped if any partition
+    whose initialization is not deferred depends on it, directly or through
+    other partitions, as that partition would wait for it during boot anyway.
+    The effective value is stored back into the manifest list attributes.
+    """
+    service_owner = {}
+    dep_graph = {}
+
+    for partition in partitions:
+        manifest = partition['manifest']
+        if 'services' not in manifest.keys():
+            continue
+        for service in manifest['services']:
+            service_owner[service['name']] = manifest['name']
+
+    for partition in partitions:
+        manifest = partition['manifest']
+        deps = []
+        # A weak dependency is only followed if its service is built, which
+        # is also the only case where it can block the initialization
+        for dep in manifest.get('dependencies', []) + \
+                   manifest.get('weak_dependencies', []):
+            if dep in service_owner and service_owner[dep] != manifest['name']:
+                deps.append(service_owner[dep])
+        dep_graph[manifest['name']] = deps
+
+    # Collect all partitions reachable from the non-deferred ones
+    required = set()
+    pending = [partition['manifest']['name'] for partition in partitions
+               if partition['attr'].get('deferred_init', False) is not True]
+    while len(pending) > 0:
+        name = pending.pop()
+        for dep in dep_graph[name]:
+            if dep not in required:
+                required.add(dep)
+                pending.append(dep)
+
+    for partition in partitions:
+        name = partition['manifest']['name']
+        deferred = partition['attr'].get('deferred_init', False) is True
+        if deferred and name in required:
+            print('Deferred initialization of {} is dropped, '
+                  'required by boot critical partitions'.format(name))
+            deferred = False
+        partition['attr']['deferred_init'] = deferred
+
 def parse_args():
     parser = argparse.ArgumentParser(description='Parse secure partition manifest list and generate files listed by the file list',
                                      epilog='Note that environment variables in template files will be replaced with their values')
@@ -433,6 +558,14 @@ def parse_args():
                         , metavar='out-of-tree-manifest-list'
                         , help='Optional. Manifest lists and original paths for out-of-tree secure partitions.')
 
+    parser.add_argument('-b', '--backend'
+                        , dest='backend'
+                        , required=False
+                        , default='IPC'
+                        , choices=['IPC', 'SFN']
+                        , metavar='backend'
+                        , help='Optional. The SPM backend, IPC or SFN, used by the partitions whose model is "dual". Defaults to IPC.')
+
     args = parser.parse_args()
 
     return args
@@ -476,7 +609,8 @@ def main():
     """
     os.chdir(os.path.join(sys.path[0], '..'))
 
-    context = process_partition_manifests(manifest_lists, extra_manifests_lists)
+    context = process_partition_manifests(manifest_lists, extra_manifests_lists,
+                                          args.backend)
 
     utilities = {}
     utilities['donotedit_warning'] = donotedit_warning